@@ -0,0 +1,59 @@
+#!/bin/bash
+# ====================================================================
+# City Designer - Benchmark Build Script
+# ====================================================================
+#
+# Builds CityBenchmark, the fixed-seed performance suite in
+# benchmarks/city_benchmark.cpp. It only runs CPU code (generation,
+# meshing, save/load, traffic), so it needs GLM but no GLFW or OpenGL.
+#
+# Usage (from the repository root):
+#   ./benchmarks/build_benchmark.sh
+#   ./CityBenchmark --output benchmark_results.json
+#
+# ====================================================================
+
+echo "📊 Building City Designer benchmarks..."
+echo ""
+
+BENCHMARK_SOURCES=(
+    "benchmarks/city_benchmark.cpp"
+    "src/core/city_config.cpp"
+    "src/generation/city_generator.cpp"
+    "src/generation/road_generator.cpp"
+    "src/generation/road_network.cpp"
+    "src/generation/placement_index.cpp"
+    "src/rendering/mesh/building_mesh.cpp"
+    "src/rendering/mesh/road_mesh.cpp"
+    "src/rendering/mesh/park_mesh.cpp"
+    "src/rendering/mesh/mesh_utils.cpp"
+    "src/features/traffic_system/traffic_generator.cpp"
+    "src/features/traffic_system/traffic_lanes.cpp"
+    "src/features/traffic_system/traffic_recorder.cpp"
+    "src/features/save_load/city_serializer.cpp"
+    "src/utils/algorithms.cpp"
+    "src/utils/spatial_grid.cpp"
+    "src/utils/job_system.cpp"
+    "src/utils/json_reader.cpp"
+)
+
+# Optimized like a release build; Homebrew's include path is harmless elsewhere
+${CXX:-c++} "${BENCHMARK_SOURCES[@]}" \
+    -o CityBenchmark \
+    -Iinclude \
+    -I/opt/homebrew/include \
+    -O2 \
+    -pthread \
+    -std=c++17
+
+if [ $? -eq 0 ]; then
+    echo ""
+    echo "✅ Build successful!"
+    echo ""
+    echo "Run with: ./CityBenchmark (see --help)"
+    echo ""
+else
+    echo ""
+    echo "❌ Build failed!"
+    exit 1
+fi
@@ -0,0 +1,367 @@
+/**
+ * @file city_benchmark.cpp
+ * @brief Reproducible Performance Benchmarks
+ *
+ * Times the CPU side of the pipeline on fixed-seed scenarios so results
+ * can be compared between commits and releases:
+ * - CityGenerator::generateCity
+ * - Building instance records (writeBuildingInstance) and mesh builders
+ *   (roadTo3DMesh, parkTo3DMesh, fountainTo3DMesh, fountainLightsTo3DMesh)
+ * - CitySerializer binary and JSON save/load
+ * - TrafficGenerator::updateTraffic throughput (car steps per second)
+ *
+ * Scenarios cross four city sizes (small, medium, 10k and 100k requested
+ * buildings) with the GRID, RADIAL and RANDOM road patterns. Results are
+ * written as JSON (see README, "Benchmarks").
+ *
+ * Usage:
+ *   CityBenchmark [--output FILE] [--repeats N] [--threads N]
+ *                 [--scenario SUBSTRING] [--skip-large]
+ *
+ * Build with benchmarks/build_benchmark.sh (no window or GL needed).
+ *
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#include "core/city_config.h"
+#include "core/world_extent.h"
+#include "generation/city_generator.h"
+#include "rendering/mesh/building_mesh.h"
+#include "rendering/mesh/road_mesh.h"
+#include "rendering/mesh/park_mesh.h"
+#include "features/traffic_system/traffic_generator.h"
+#include "features/save_load/city_serializer.h"
+#include "utils/job_system.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+
+namespace {
+
+constexpr int FORMAT_VERSION = 1;               ///< Bump when the JSON layout changes
+constexpr uint64_t BENCHMARK_SEED = 20251101;   ///< Every scenario generates from this seed
+constexpr int TRAFFIC_STEPS = 600;              ///< Fixed steps per traffic run (10 simulated seconds)
+const char* SCRATCH_SAVE = "benchmark_scratch"; ///< Save name used by the serializer timings
+
+/// One city to benchmark
+struct Scenario {
+    std::string size;       ///< small, medium, 10k, 100k
+    RoadPattern pattern;
+    int buildings;          ///< Requested building count
+    int worldWidth;
+    int worldHeight;
+    int layoutSize;
+    int parks;
+    int cars;
+    bool large;             ///< Skipped by --skip-large
+};
+
+/// Wall times of repeated runs, in milliseconds
+struct Timing {
+    std::vector<double> runs;
+
+    double median() const {
+        std::vector<double> sorted = runs;
+        std::sort(sorted.begin(), sorted.end());
+        size_t n = sorted.size();
+        return n == 0 ? 0.0 : (n % 2 ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]));
+    }
+    double min() const { return runs.empty() ? 0.0 : *std::min_element(runs.begin(), runs.end()); }
+    double max() const { return runs.empty() ? 0.0 : *std::max_element(runs.begin(), runs.end()); }
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// Run work repeats times and collect the wall time of each run
+Timing measure(int repeats, const std::function<void()>& work) {
+    Timing timing;
+    for (int i = 0; i < repeats; i++) {
+        auto start = std::chrono::steady_clock::now();
+        work();
+        timing.runs.push_back(elapsedMs(start));
+    }
+    return timing;
+}
+
+std::string patternName(RoadPattern pattern) {
+    switch (pattern) {
+        case RoadPattern::GRID: return "grid";
+        case RoadPattern::RADIAL: return "radial";
+        case RoadPattern::RANDOM: return "random";
+    }
+    return "unknown";
+}
+
+std::vector<Scenario> allScenarios() {
+    // World sizes keep the requested buildings at a density the placer can reach
+    const Scenario sizes[] = {
+        {"small",  RoadPattern::GRID, 30,     800,   600,   10,  3,  50,    false},
+        {"medium", RoadPattern::GRID, 1000,   3200,  2400,  16,  12, 500,   false},
+        {"10k",    RoadPattern::GRID, 10000,  10000, 7500,  24,  40, 5000,  false},
+        {"100k",   RoadPattern::GRID, 100000, 32000, 24000, 40,  120, 20000, true},
+    };
+    const RoadPattern patterns[] = {RoadPattern::GRID, RoadPattern::RADIAL, RoadPattern::RANDOM};
+
+    std::vector<Scenario> scenarios;
+    for (const Scenario& size : sizes) {
+        for (RoadPattern pattern : patterns) {
+            Scenario scenario = size;
+            scenario.pattern = pattern;
+            scenarios.push_back(scenario);
+        }
+    }
+    return scenarios;
+}
+
+std::string scenarioName(const Scenario& scenario) {
+    return patternName(scenario.pattern) + "_" + scenario.size;
+}
+
+CityConfig makeConfig(const Scenario& scenario) {
+    CityConfig config;
+    config.seed = BENCHMARK_SEED;
+    config.numBuildings = scenario.buildings;
+    config.layoutSize = scenario.layoutSize;
+    config.roadPattern = scenario.pattern;
+    config.numParks = scenario.parks;
+    config.useStandardSize = false;     // Sizes independent of the layout
+    config.numCars = scenario.cars;
+    return config;
+}
+
+long fileSize(const std::string& path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 ? static_cast<long>(info.st_size) : -1;
+}
+
+void writeTiming(std::ostream& out, const char* name, const Timing& timing, bool last = false) {
+    out << "        \"" << name << "\": {\"median_ms\": " << timing.median()
+        << ", \"min_ms\": " << timing.min() << ", \"max_ms\": " << timing.max()
+        << ", \"runs\": " << timing.runs.size() << "}" << (last ? "\n" : ",\n");
+}
+
+/**
+ * @brief Run every measurement of one scenario and append its JSON object
+ */
+bool runScenario(const Scenario& scenario, int repeats, JobSystem* jobs, std::ostream& out) {
+    std::string name = scenarioName(scenario);
+    std::cout << "▶️  " << name << " (" << scenario.buildings << " buildings, "
+              << scenario.worldWidth << "x" << scenario.worldHeight << ")\n" << std::flush;
+
+    CityConfig config = makeConfig(scenario);
+    WorldExtent extent(scenario.worldWidth, scenario.worldHeight);
+    CityGenerator generator(extent);
+    generator.setVerbose(false);
+    generator.setJobSystem(jobs);
+
+    // The largest cities run once; the seed makes every run generate the same city anyway
+    int runs = scenario.large ? 1 : repeats;
+
+    // 1. Generation
+    Timing generate = measure(runs, [&] { generator.generateCity(config); });
+    const CityData& city = generator.getCityData();
+
+    // 2. Meshing: each builder over every object of its kind (the float count keeps the work observable)
+    size_t vertexFloats = 0;
+    std::vector<float> instances(city.buildings.size() * BUILDING_INSTANCE_FLOATS);
+    Timing buildingInstances = measure(runs, [&] {
+        for (size_t i = 0; i < city.buildings.size(); i++) {
+            writeBuildingInstance(city.buildings[i], instances.data() + i * BUILDING_INSTANCE_FLOATS);
+        }
+        vertexFloats += instances.size();
+    });
+    Timing roadMeshes = measure(runs, [&] {
+        for (const Road& road : city.roads) {
+            vertexFloats += roadTo3DMesh(road, city.extent).vertices.size();
+        }
+    });
+    Timing parkMeshes = measure(runs, [&] {
+        for (const Circle& park : city.parks) {
+            for (int lod = 0; lod < MESH_LOD_LEVELS; lod++) {
+                vertexFloats += parkTo3DMesh(park, city.extent, lod).size();
+            }
+        }
+    });
+    Timing fountainMeshes = measure(runs, [&] {
+        for (int lod = 0; lod < MESH_LOD_LEVELS; lod++) {
+            vertexFloats += fountainTo3DMesh(city.fountain, city.extent, lod).size();
+            vertexFloats += fountainLightsTo3DMesh(city.fountain, city.extent, lod).size();
+        }
+    });
+
+    // 3. Serialization (the save directory is prefixed by the serializer)
+    bool ok = true;
+    CityData loaded;
+    Timing saveBinary = measure(runs, [&] { ok &= CitySerializer::saveCityBinary(city, SCRATCH_SAVE); });
+    Timing loadBinary = measure(runs, [&] { ok &= CitySerializer::loadCityBinary(loaded, SCRATCH_SAVE); });
+    Timing saveJson = measure(runs, [&] { ok &= CitySerializer::saveCity(city, SCRATCH_SAVE); });
+    Timing loadJson = measure(runs, [&] { ok &= CitySerializer::loadCity(loaded, SCRATCH_SAVE); });
+
+    std::string scratchPath = CitySerializer::getSaveDirectory() + SCRATCH_SAVE;
+    long binaryBytes = fileSize(scratchPath + ".city");
+    long jsonBytes = fileSize(scratchPath + ".json");
+    std::remove((scratchPath + ".city").c_str());
+    std::remove((scratchPath + ".json").c_str());
+    if (!ok) {
+        std::cout << "❌ Serialization failed in " << name << "\n";
+        return false;
+    }
+
+    // 4. Traffic: fixed steps, so every run simulates the same cars
+    TrafficGenerator traffic;
+    traffic.setJobSystem(jobs);
+    traffic.generateTraffic(city.roads, city.network, scenario.cars, city.parks, city.fountain,
+                            city.extent, config.seed);
+    size_t cars = traffic.getTrafficData().size();
+    Timing trafficRun = measure(runs, [&] {
+        for (int step = 0; step < TRAFFIC_STEPS; step++) {
+            traffic.updateTraffic(TrafficGenerator::FIXED_TIMESTEP, city.roads, city.network);
+        }
+    });
+    double carStepsPerSecond = trafficRun.median() > 0.0
+        ? cars * static_cast<double>(TRAFFIC_STEPS) / (trafficRun.median() / 1000.0) : 0.0;
+
+    out << "    {\n";
+    out << "      \"name\": \"" << name << "\",\n";
+    out << "      \"size\": \"" << scenario.size << "\",\n";
+    out << "      \"road_pattern\": \"" << patternName(scenario.pattern) << "\",\n";
+    out << "      \"seed\": \"" << config.seed << "\",\n";
+    out << "      \"world\": {\"width\": " << scenario.worldWidth << ", \"height\": " << scenario.worldHeight << "},\n";
+    out << "      \"requested\": {\"buildings\": " << scenario.buildings << ", \"layout_size\": " << scenario.layoutSize
+        << ", \"parks\": " << scenario.parks << ", \"cars\": " << scenario.cars << "},\n";
+    out << "      \"counts\": {\"buildings\": " << city.buildings.size() << ", \"roads\": " << city.roads.size()
+        << ", \"road_nodes\": " << city.network.nodes.size() << ", \"parks\": " << city.parks.size()
+        << ", \"cars\": " << cars << ", \"mesh_floats\": " << vertexFloats / runs << "},\n";
+    out << "      \"file_bytes\": {\"binary\": " << binaryBytes << ", \"json\": " << jsonBytes << "},\n";
+    out << "      \"timings\": {\n";
+    writeTiming(out, "generate_city", generate);
+    writeTiming(out, "building_instances", buildingInstances);
+    writeTiming(out, "road_to_3d_mesh", roadMeshes);
+    writeTiming(out, "park_to_3d_mesh", parkMeshes);
+    writeTiming(out, "fountain_to_3d_mesh", fountainMeshes);
+    writeTiming(out, "save_binary", saveBinary);
+    writeTiming(out, "load_binary", loadBinary);
+    writeTiming(out, "save_json", saveJson);
+    writeTiming(out, "load_json", loadJson);
+    writeTiming(out, "update_traffic", trafficRun, true);
+    out << "      },\n";
+    out << "      \"traffic\": {\"steps\": " << TRAFFIC_STEPS << ", \"car_steps_per_second\": "
+        << std::fixed << std::setprecision(0) << carStepsPerSecond << std::defaultfloat << std::setprecision(6) << "}\n";
+    out << "    }";
+
+    std::cout << "   generate " << generate.median() << " ms, " << city.buildings.size() << " buildings, "
+              << city.roads.size() << " roads\n" << std::flush;
+    return true;
+}
+
+void printUsage() {
+    std::cout << "Usage: CityBenchmark [options]\n"
+              << "  --output FILE          Results file (default benchmark_results.json)\n"
+              << "  --repeats N            Runs per measurement (default 3; 100k scenarios run once)\n"
+              << "  --threads N            Job system threads including the caller (default 1)\n"
+              << "  --scenario SUBSTRING   Only scenarios whose name contains SUBSTRING (e.g. grid, 10k)\n"
+              << "  --skip-large           Leave out the 100k-building scenarios\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string outputPath = "benchmark_results.json";
+    std::string filter;
+    int repeats = 3;
+    int threads = 1;
+    bool skipLarge = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "--help") {
+            printUsage();
+            return 0;
+        }
+        if (option == "--skip-large") {
+            skipLarge = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cout << "❌ Missing value for " << option << "\n";
+            printUsage();
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (option == "--output") {
+            outputPath = value;
+        } else if (option == "--repeats") {
+            repeats = std::atoi(value.c_str());
+        } else if (option == "--threads") {
+            threads = std::atoi(value.c_str());
+        } else if (option == "--scenario") {
+            filter = value;
+        } else {
+            std::cout << "❌ Unknown option: " << option << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+    if (repeats <= 0 || threads <= 0) {
+        std::cout << "❌ --repeats and --threads must be positive\n";
+        return 1;
+    }
+
+    CitySerializer::setVerbose(false);
+    mkdir(CitySerializer::getSaveDirectory().c_str(), 0755);
+
+    // A single-threaded run has no pool at all, like the generator's default
+    std::unique_ptr<JobSystem> jobs;
+    if (threads > 1) jobs.reset(new JobSystem(static_cast<unsigned>(threads - 1)));
+
+    std::ostringstream scenarios;
+    int count = 0;
+    for (const Scenario& scenario : allScenarios()) {
+        if (skipLarge && scenario.large) continue;
+        if (!filter.empty() && scenarioName(scenario).find(filter) == std::string::npos) continue;
+
+        if (count > 0) scenarios << ",\n";
+        if (!runScenario(scenario, repeats, jobs.get(), scenarios)) return 1;
+        count++;
+    }
+    if (count == 0) {
+        std::cout << "❌ No scenario matches \"" << filter << "\"\n";
+        return 1;
+    }
+
+    std::ofstream file(outputPath);
+    if (!file.is_open()) {
+        std::cout << "❌ Failed to open file for writing: " << outputPath << "\n";
+        return 1;
+    }
+    file << "{\n";
+    file << "  \"format_version\": " << FORMAT_VERSION << ",\n";
+    file << "  \"timestamp\": " << time(nullptr) << ",\n";
+    file << "  \"threads\": " << threads << ",\n";
+    file << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+    file << "  \"repeats\": " << repeats << ",\n";
+    file << "  \"scenarios\": [\n" << scenarios.str() << "\n  ]\n";
+    file << "}\n";
+
+    if (!file.good()) {
+        std::cout << "❌ Failed to write " << outputPath << "\n";
+        return 1;
+    }
+    std::cout << "\n✅ " << count << " scenarios written to " << outputPath << "\n";
+    return 0;
+}
@@ -28,20 +28,31 @@ FEATURES=(
     "src/features/building_lights/building_lighting_system.cpp"
     "src/features/day_night_cycle/day_night_cycle.cpp"
     "src/features/traffic_system/traffic_generator.cpp"
+    "src/features/traffic_system/traffic_lanes.cpp"
+    "src/features/traffic_system/traffic_recorder.cpp"
+    "src/features/traffic_system/traffic_replay.cpp"
+    "src/features/traffic_system/gpu_traffic_simulator.cpp"
     "src/features/building_placement/building_placement_system.cpp"
     "src/features/save_load/city_serializer.cpp"
+    "src/features/save_load/city_tile_streamer.cpp"
 )
 
 # Core System Files
 CORE=(
     "src/core/application.cpp"
     "src/core/city_config.cpp"
+    "src/core/headless_runner.cpp"
+    "src/core/quality_governor.cpp"
+    "src/core/render_thread.cpp"
 )
 
 # Generation System Files
 GENERATION=(
     "src/generation/city_generator.cpp"
+    "src/generation/async_city_generator.cpp"
     "src/generation/road_generator.cpp"
+    "src/generation/road_network.cpp"
+    "src/generation/placement_index.cpp"
 )
 
 # Rendering System Files
@@ -49,6 +60,8 @@ RENDERING=(
     "src/rendering/city_renderer.cpp"
     "src/rendering/texture_manager.cpp"
     "src/rendering/3d/camera.cpp"
+    "src/rendering/3d/frustum.cpp"
+    "src/rendering/3d/occlusion_buffer.cpp"
     "src/rendering/shaders/shader_manager.cpp"
     "src/rendering/mesh/building_mesh.cpp"
     "src/rendering/mesh/road_mesh.cpp"
@@ -60,6 +73,11 @@ RENDERING=(
 # Utility System Files
 UTILS=(
     "src/utils/algorithms.cpp"
+    "src/utils/spatial_grid.cpp"
+    "src/utils/job_system.cpp"
+    "src/utils/profiler.cpp"
+    "src/utils/gpu_frame_timer.cpp"
+    "src/utils/json_reader.cpp"
     "src/utils/input_handler.cpp"
 )
 
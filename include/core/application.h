@@ -8,6 +8,9 @@
  * - OpenGL context setup
  * - Callback registration
  * 
+ * Events are polled on the main thread (GLFW requires it); buffers may be
+ * swapped on whichever thread holds the context.
+ * 
  * @author City Designer Team
  * @date November 2025
  */
@@ -63,11 +66,27 @@ public:
     bool shouldClose() const;
     
     /**
-     * @brief Swap buffers and poll events
+     * @brief Present the frame (waits for vsync when it is on)
      * 
-     * Call this at the end of each frame.
+     * Call from the thread that holds the context.
+     */
+    void swapBuffers();
+    
+    /**
+     * @brief Process pending window and input events (main thread only)
+     */
+    void pollEvents();
+    
+    /**
+     * @brief Make the OpenGL context current on the calling thread (or release it)
+     * @param current false detaches it, so another thread can take it over
+     */
+    void makeContextCurrent(bool current);
+    
+    /**
+     * @brief Latest framebuffer size reported by the window (any thread)
      */
-    void update();
+    void getFramebufferSize(int& framebufferWidth, int& framebufferHeight) const;
     
     /**
      * @brief Set up camera-related callbacks
@@ -13,6 +13,8 @@
 #define CITY_CONFIG_H
 
 #include <string>
+#include <cstdint>
+#include "utils/random_stream.h"
 
 /**
  * @enum RoadPattern
@@ -55,6 +57,9 @@ enum class TextureTheme {
  * be modified at runtime through keyboard controls.
  */
 struct CityConfig {
+    // ===== Generation Seed =====
+    uint64_t seed;              ///< Seeds every generation stream: same seed + settings = same city
+    
     // ===== Building Parameters =====
     int numBuildings;           ///< Number of buildings to generate (1-100)
     int layoutSize;             ///< Size of the city grid, e.g., 10 = 10x10 (5-20)
@@ -81,6 +86,7 @@ struct CityConfig {
     
     // ===== View Mode =====
     bool view3D;                ///< Toggle: false=2D orthographic, true=3D perspective
+    bool occlusionCulling;      ///< 3D: skip buildings and cars hidden behind nearer buildings
     
     // ===== Time of Day =====
     float timeOfDay;            ///< Time in hours (0-24): 0=midnight, 6=sunrise, 12=noon, 18=sunset
@@ -89,6 +95,17 @@ struct CityConfig {
     // ===== Traffic Parameters =====
     int numCars;                ///< Number of cars for traffic animation (0-50)
     bool showTraffic;           ///< Toggle traffic visibility
+    bool gpuTraffic;            ///< Step cars on the GPU (TrafficBackend::GPU) instead of the CPU
+    int gpuNumCars;             ///< Cars to spawn with the GPU backend (as many as fit the roads)
+    
+    // ===== Adaptive Quality (QualityGovernor) =====
+    bool adaptiveQuality;       ///< Let QualityGovernor trade detail for frame time
+    float frameBudgetMs;        ///< Frame time the governor holds, in milliseconds
+    int qualityLevel;           ///< Governor level the settings below come from (0 = full quality)
+    float lodDistanceScale;     ///< Multiplies the distances where meshes switch to coarser levels
+    float cullAngleScale;       ///< Multiplies the smallest building chunk angle still drawn
+    float pointSizeScale;       ///< Multiplies the 2D map's point sizes
+    int trafficStepsPerUpdate;  ///< Traffic steps taken per frame at most (TrafficGenerator::MAX_STEPS_PER_UPDATE at full rate)
     
     /**
      * @brief Construct a new City Config with sensible defaults
@@ -99,9 +116,11 @@ struct CityConfig {
      * - Mixed building heights
      * - 3 parks and a fountain
      * - Starting in 2D view mode
+     * - A fresh random seed (set seed to reproduce a city)
      */
     CityConfig() 
-        : numBuildings(20),
+        : seed(RandomStream::randomSeed()),
+          numBuildings(20),
           layoutSize(10),
           roadPattern(RoadPattern::GRID),
           roadWidth(14),
@@ -114,10 +133,20 @@ struct CityConfig {
           standardWidth(50.0f),
           standardDepth(50.0f),
           view3D(false),
+          occlusionCulling(true),
           timeOfDay(14.0f),         // Start at 2 PM (afternoon)
           autoTimeProgress(true),   // Automatic time progression enabled
           numCars(15),              // Default 15 cars
-          showTraffic(true)         // Traffic enabled by default
+          showTraffic(true),        // Traffic enabled by default
+          gpuTraffic(false),
+          gpuNumCars(100000),
+          adaptiveQuality(false),
+          frameBudgetMs(16.6f),     // 60 FPS
+          qualityLevel(0),
+          lodDistanceScale(1.0f),
+          cullAngleScale(1.0f),
+          pointSizeScale(1.0f),
+          trafficStepsPerUpdate(5)
     {
         // Initialize building size based on default layout
         updateStandardBuildingSize();
@@ -166,16 +195,16 @@ struct CityConfig {
     
     /**
      * @brief Calculate optimal building size based on layout grid
-     * @param screenWidth Width of the screen/window in pixels
-     * @param margin Margin from screen edges in pixels
+     * @param worldWidth Width of the city extent in world units
+     * @param margin Margin from the city edges in world units
      * 
      * Automatically adjusts standardWidth and standardDepth to fit
      * buildings within the grid cells, accounting for roads.
      * Buildings are sized to ~40% of cell size for proper spacing.
      */
-    void updateStandardBuildingSize(int screenWidth = 800, int margin = 50) {
+    void updateStandardBuildingSize(int worldWidth = 800, int margin = 50) {
         // Calculate grid cell size
-        float cellSize = static_cast<float>(screenWidth - 2 * margin) / layoutSize;
+        float cellSize = static_cast<float>(worldWidth - 2 * margin) / layoutSize;
         // Buildings should be about 40% of cell size to fit within one grid square
         // This accounts for road width and proper spacing
         standardWidth = cellSize * 0.40f;
@@ -189,6 +218,36 @@ struct CityConfig {
      * Useful for debugging and showing the user current settings.
      */
     void printConfig() const;
+    
+    /**
+     * @brief Check whether two configs generate the same city
+     * @param other Config to compare with
+     * @return true if every setting the generator reads is equal
+     * 
+     * View, time, traffic and quality settings are ignored: changing
+     * them never needs a new city.
+     */
+    bool generatesSameCity(const CityConfig& other) const;
+    
+    /**
+     * @return Cars to spawn with the selected traffic backend
+     */
+    int trafficCarCount() const { return gpuTraffic ? gpuNumCars : numCars; }
+    
+    /**
+     * @brief Override settings from a "key = value" text file
+     * @param path File to read
+     * @return true if every line parsed; on failure the config may be partly updated
+     * 
+     * Keys are the member names (seed, numBuildings, layoutSize, roadPattern,
+     * roadWidth, skylineType, textureTheme, parkRadius, numParks,
+     * fountainRadius, useStandardSize, standardWidth, standardDepth,
+     * numCars, gpuTraffic, gpuNumCars, adaptiveQuality, frameBudgetMs). Enum values use the names printed by printConfig, in
+     * any case (e.g. "roadPattern = radial"). '#' starts a comment.
+     * The standard building size is re-derived when layoutSize changes
+     * unless the file sets it explicitly.
+     */
+    bool loadFromFile(const std::string& path);
 };
 
 #endif // CITY_CONFIG_H
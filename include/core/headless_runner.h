@@ -0,0 +1,91 @@
+/**
+ * @file headless_runner.h
+ * @brief Headless Batch Generation Mode
+ *
+ * Runs `CityDesigner --headless ...` without creating a window or GL
+ * context: generates many cities in parallel across cores and writes each
+ * through CitySerializer, then reports throughput.
+ *
+ * Usage:
+ *   CityDesigner --headless [--config FILE] [--count N] [--threads N]
+ *                [--world WIDTHxHEIGHT] [--output PREFIX]
+ *                [--format city|json|both|none] [--seed S | --seeds FILE]
+ *
+ * Cities are written as saves/PREFIX_00000.city, saves/PREFIX_00001.city, ...
+ * City i of a --seed S batch is generated from RandomStream::deriveSeed(S, i),
+ * so a batch is reproducible whatever the thread count; --seeds lists one
+ * seed per line and produces one city per seed.
+ *
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef HEADLESS_RUNNER_H
+#define HEADLESS_RUNNER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "core/city_config.h"
+#include "core/world_extent.h"
+
+/**
+ * @class HeadlessRunner
+ * @brief Command-line batch city production
+ *
+ * Each worker thread owns its own CityGenerator, so generations never
+ * share state; only the output files and the final counters are common.
+ */
+class HeadlessRunner {
+public:
+    HeadlessRunner();
+
+    /**
+     * @brief True if the command line asks for headless mode (--headless)
+     */
+    static bool isRequested(int argc, char** argv);
+
+    /**
+     * @brief Parse the command line (the --config file is loaded here)
+     * @return false on an invalid or incomplete argument (usage is printed)
+     */
+    bool parseArguments(int argc, char** argv);
+
+    /**
+     * @brief Generate and save every city
+     * @return Process exit code: 0 if every city was generated and saved
+     */
+    int run();
+
+    /**
+     * @brief Print the command-line options
+     */
+    static void printUsage();
+
+private:
+    CityConfig config;          ///< Settings shared by every generated city
+    WorldExtent extent;         ///< Bounds of every generated city
+    int cityCount;              ///< Number of cities to generate
+    std::vector<uint64_t> seeds;    ///< Explicit per-city seeds (--seeds); overrides cityCount
+    unsigned threadCount;       ///< Threads generating cities (workers + caller)
+    std::string outputPrefix;   ///< Save name prefix, relative to the save directory
+    bool writeBinary;           ///< Write .city files
+    bool writeJson;             ///< Write .json exports
+
+    /**
+     * @brief Create the save directory and any directory in outputPrefix
+     */
+    bool prepareOutputDirectory() const;
+
+    /**
+     * @brief Read one decimal seed per line ('#' starts a comment)
+     */
+    bool loadSeeds(const std::string& path);
+
+    /**
+     * @brief Seed of city index in the batch
+     */
+    uint64_t seedFor(size_t index) const;
+};
+
+#endif // HEADLESS_RUNNER_H
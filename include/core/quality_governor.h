@@ -0,0 +1,85 @@
+/**
+ * @file quality_governor.h
+ * @brief Adaptive Quality Governor Holding a Frame-Time Budget
+ * 
+ * Frame time grows with the building and car counts, the view mode and
+ * the blended night passes, and left alone nothing adapts to it. The
+ * governor watches what each frame costs (the main thread's work, the
+ * render thread's CPU time and the frame's GPU time, whichever is
+ * largest) and steps through quality levels to hold
+ * CityConfig::frameBudgetMs. A lower level:
+ * - switches circular meshes (parks, fountain, its lights) to coarser
+ *   levels closer to the camera
+ * - skips building chunks that subtend a larger angle
+ * - draws the 2D map's points smaller
+ * - takes fewer traffic steps per frame: after a slow frame the cars fall
+ *   behind real time instead of making the next frame slower still
+ * 
+ * The level moves one step at a time, at most every ADJUST_INTERVAL
+ * seconds, and rises again only well under the budget so it does not
+ * oscillate.
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef QUALITY_GOVERNOR_H
+#define QUALITY_GOVERNOR_H
+
+#include <cstddef>
+#include "core/city_config.h"
+
+/**
+ * @class QualityGovernor
+ * @brief Adjusts CityConfig's quality settings to a frame-time budget (main thread)
+ */
+class QualityGovernor {
+public:
+    static constexpr int LEVEL_COUNT = 5;              ///< Level 0 is full quality
+    static constexpr double ADJUST_INTERVAL = 0.5;     ///< Seconds of frames behind each decision
+    static constexpr double HEADROOM = 0.7;            ///< Raise quality only below this fraction of the budget
+    
+    QualityGovernor();
+    
+    /**
+     * @brief Record the main thread's work for one iteration (sleep excluded)
+     */
+    void addMainFrame(double milliseconds);
+    
+    /**
+     * @brief Record a frame the render thread drew
+     * @param cpuMilliseconds Render thread time issuing it (swap excluded)
+     * @param gpuMilliseconds GPU time of a recent frame (negative = not known yet)
+     */
+    void addRenderFrame(float cpuMilliseconds, float gpuMilliseconds);
+    
+    /**
+     * @brief Move the level when the frames of the last interval ask for it
+     * @param seconds Time since the last call
+     * @param config Settings to adjust (adaptiveQuality off returns them to level 0)
+     * @return true if the quality settings changed
+     */
+    bool update(double seconds, CityConfig& config);
+    
+    /**
+     * @brief Write a level's settings into a config
+     */
+    static void applyLevel(int level, CityConfig& config);
+    
+    /**
+     * @brief Cost of an average frame in the last interval, in milliseconds
+     */
+    double getFrameMs() const { return frameMs; }
+
+private:
+    // Frames of the interval being collected
+    double elapsed;
+    double mainTotal;
+    size_t mainFrames;
+    double renderTotal;
+    size_t renderFrames;
+    
+    double frameMs;
+};
+
+#endif // QUALITY_GOVERNOR_H
@@ -0,0 +1,181 @@
+/**
+ * @file render_thread.h
+ * @brief Render Thread Fed by Frame Snapshots
+ * 
+ * The main thread polls input and advances the simulation; the render
+ * thread owns the OpenGL context and does every GL call. Once per
+ * simulation frame the main thread fills a FrameSnapshot (city version,
+ * traffic state, camera, time of day, settings) and publishes it, and
+ * the render thread draws the newest snapshot it has been given.
+ * 
+ * Snapshots circulate through two lock-free SPSC queues: published ones
+ * to the render thread, drawn ones back to the main thread for reuse.
+ * Neither thread ever waits for the other, so a vsync wait in the swap
+ * no longer holds up input or the simulation.
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "core/city_config.h"
+#include "features/save_load/city_tile_streamer.h"
+#include "features/traffic_system/gpu_traffic_simulator.h"
+#include "features/traffic_system/traffic_generator.h"
+#include "rendering/city_renderer.h"
+#include "rendering/shaders/shader_manager.h"
+#include "utils/gpu_frame_timer.h"
+#include "utils/spsc_queue.h"
+
+class Application;
+class BuildingLightingSystem;
+class TextureManager;
+class Profiler;
+struct CityData;
+
+/**
+ * @struct FrameSnapshot
+ * @brief Everything the render thread needs to draw one frame
+ * 
+ * Filled by the main thread, then read-only until the render thread hands
+ * it back. The city is shared, not copied per frame: a new CityData is
+ * made only when the city is replaced, and it is never modified
+ * afterwards. Buildings placed since then travel in placedBuildings, so
+ * a placement copies those alone rather than every road and park.
+ * Streamed tiles travel as pointers to the streamer's immutable tiles:
+ * the render thread compares them with the tiles it holds and uploads or
+ * frees only the ones that differ.
+ */
+struct FrameSnapshot {
+    std::shared_ptr<const CityData> city;   ///< Displayed city (nullptr = none yet)
+    uint64_t cityVersion = 0;               ///< Changes whenever the city changes
+    uint64_t cityLayoutVersion = 0;         ///< Changes whenever city is replaced
+    std::shared_ptr<const std::vector<Building>> placedBuildings;  ///< Appended to city->buildings since it was copied (nullptr = none)
+    std::shared_ptr<const StreamedTiles> tiles;  ///< Streamed tiles shown on top of city (nullptr = none)
+    
+    TrafficData traffic;                    ///< Cars to draw (see TrafficData::copyDrawState())
+    float trafficAlpha = 1.0f;              ///< Blend between the last two fixed steps
+    std::shared_ptr<const GpuTrafficSetup> gpuTraffic;  ///< Cars of the GPU backend (nullptr = none)
+    uint32_t gpuTrafficStep = 0;            ///< Fixed steps the GPU cars should have taken
+    
+    CityConfig config;                      ///< Settings of the frame (view mode, layers)
+    FrameGlobals globals = {};              ///< Camera matrices, time of day and light factors
+    glm::mat4 viewProjection = glm::mat4(1.0f);
+    glm::vec3 eye = glm::vec3(0.0f);
+    glm::vec3 skyColor = glm::vec3(0.0f);
+    
+    bool profilerOverlay = false;           ///< F3 state, mirrored by the render thread's profiler
+    bool profilerTracing = false;           ///< F4 state, mirrored by the render thread's profiler
+    
+    // Written by the render thread once drawn, read by the main thread when the snapshot comes back
+    bool drawn = false;                     ///< Drawn, not superseded (the main thread clears it)
+    float drawCpuMs = 0.0f;                 ///< Render thread time issuing the frame (swap excluded)
+    float drawGpuMs = -1.0f;                ///< GPU time of a recent frame (GpuFrameTimer; -1 = none yet)
+};
+
+/**
+ * @class RenderThread
+ * @brief Draws published FrameSnapshots on a thread of its own
+ * 
+ * The renderer, shaders, textures, window lights and profiler passed in are used only
+ * by the render thread between start() and stop(); the main thread must
+ * not touch them meanwhile.
+ */
+class RenderThread {
+public:
+    static constexpr size_t FRAME_COUNT = 4;   ///< Snapshots in circulation: one drawn, the rest in flight
+    static constexpr const char* TRACE_FILE = "profile_trace_render.json";  ///< Render thread's F4 capture
+    
+    RenderThread(Application& app, CityRenderer& renderer, ShaderManager& shaderManager,
+                 TextureManager& textureManager, BuildingLightingSystem& buildingLights, Profiler& profiler);
+    
+    /**
+     * @brief Stop the thread if it is still running
+     */
+    ~RenderThread();
+    
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+    
+    /**
+     * @brief Hand the GL context over from the calling thread and start drawing
+     */
+    void start();
+    
+    /**
+     * @brief Finish the frame being drawn, join, and make the context current here again
+     */
+    void stop();
+    
+    /**
+     * @brief A snapshot to fill (main thread)
+     * @return nullptr while every snapshot is in flight; skip publishing that frame
+     */
+    FrameSnapshot* acquireFrame();
+    
+    /**
+     * @brief Pass a filled snapshot to the render thread (main thread)
+     */
+    void publishFrame(FrameSnapshot* frame);
+
+private:
+    void run();
+    
+    // Newest published snapshot (older ones are recycled), or nullptr if none arrived
+    FrameSnapshot* takeNewestFrame();
+    
+    void drawFrame(const FrameSnapshot& frame);
+    
+    // Rebuild or extend the renderer's city (and the window lights) when the snapshot's is newer
+    void syncCity(const FrameSnapshot& frame);
+    
+    // Free the tiles the snapshot no longer shows, then upload the ones it added
+    void syncTiles(const FrameSnapshot& frame);
+    
+    // Follow the main thread's overlay and trace toggles
+    void syncProfiler(const FrameSnapshot& frame);
+    
+    Application& app;
+    CityRenderer& renderer;
+    ShaderManager& shaderManager;
+    TextureManager& textureManager;
+    BuildingLightingSystem& buildingLights;
+    Profiler& profiler;
+    
+    FrameSnapshot frames[FRAME_COUNT];
+    SpscQueue<FrameSnapshot*, FRAME_COUNT> published;   ///< Main thread -> render thread
+    SpscQueue<FrameSnapshot*, FRAME_COUNT> recycled;    ///< Render thread -> main thread
+    std::thread thread;
+    std::atomic<bool> stopping;
+    
+    // Render thread only
+    GpuTrafficSimulator gpuTraffic; ///< Steps and holds the GPU backend's cars
+    GpuFrameTimer gpuTimer;         ///< GPU time of each drawn frame, for the quality governor
+    FrameSnapshot* shown;           ///< Snapshot drawn last, held until a newer one arrives
+    uint64_t builtCityVersion;      ///< City the renderer's meshes were built from
+    uint64_t builtLayoutVersion;
+    std::vector<Building> builtBuildings;   ///< The city's, then the placed and the streamed tiles' buildings
+    size_t builtPlacedCount;        ///< Placed buildings in builtBuildings
+    
+    /// A streamed tile the renderer holds, with the building indices it was given
+    struct BuiltTile {
+        std::shared_ptr<const StreamedTile> tile;
+        std::vector<uint32_t> buildings;    ///< Indices into builtBuildings
+    };
+    std::unordered_map<uint32_t, BuiltTile> builtTiles;     ///< Tile index -> tile
+    std::vector<uint32_t> freeBuildingIndices;  ///< Holes in builtBuildings left by evicted tiles
+    int viewportWidth;
+    int viewportHeight;
+};
+
+#endif // RENDER_THREAD_H
@@ -0,0 +1,98 @@
+/**
+ * @file world_extent.h
+ * @brief World Extent and Coordinate Systems
+ *
+ * The city lives in world units: an integer grid (roads are rasterized on
+ * it) whose origin is the top-left corner, X to the right and Y downwards.
+ * Generation, collision checks, traffic and save files all work in these
+ * units, independently of the window the city is shown in.
+ *
+ * The renderer converts world units to render space (X right, Y up for
+ * height, Z towards the top of the map) with a fixed scale centred on the
+ * extent, so a larger city is a physically larger scene rather than the
+ * same 2x2 square at a finer resolution. The scale is the one the
+ * original 800x600 window used, so that city renders exactly as before.
+ *
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef WORLD_EXTENT_H
+#define WORLD_EXTENT_H
+
+/**
+ * @struct WorldExtent
+ * @brief Size of the city in world units, plus the world -> render mapping
+ */
+struct WorldExtent {
+    static constexpr int DEFAULT_WIDTH = 800;      ///< Historical extent (the old window size)
+    static constexpr int DEFAULT_HEIGHT = 600;
+    static constexpr float RENDER_SCALE_X = 2.0f / DEFAULT_WIDTH;    ///< Render units per world unit along X
+    static constexpr float RENDER_SCALE_Z = 2.0f / DEFAULT_HEIGHT;   ///< ... along Z and for heights
+
+    int width;      ///< Extent along X in world units
+    int height;     ///< Extent along Y (render Z) in world units
+
+    WorldExtent() : width(DEFAULT_WIDTH), height(DEFAULT_HEIGHT) {}
+    WorldExtent(int w, int h) : width(w), height(h) {}
+
+    bool isValid() const { return width > 0 && height > 0; }
+
+    /**
+     * @brief True if (x, y) lies at least margin units inside the extent
+     */
+    bool contains(float x, float y, float margin = 0.0f) const {
+        return x >= margin && x <= width - margin && y >= margin && y <= height - margin;
+    }
+
+    /// World X -> render X (the extent is centred on the origin)
+    float toRenderX(float x) const { return (x - width * 0.5f) * RENDER_SCALE_X; }
+
+    /// World Y -> render Z (world Y grows down the map, render Z up it)
+    float toRenderZ(float y) const { return (height * 0.5f - y) * RENDER_SCALE_Z; }
+
+    /// Render X -> world X (inverse of toRenderX())
+    float fromRenderX(float x) const { return x / RENDER_SCALE_X + width * 0.5f; }
+
+    /// Render Z -> world Y (inverse of toRenderZ())
+    float fromRenderZ(float z) const { return height * 0.5f - z / RENDER_SCALE_Z; }
+
+    /// World length along X -> render units
+    float scaleX(float length) const { return length * RENDER_SCALE_X; }
+
+    /// World length along Y, a radius or a height -> render units
+    float scaleZ(float length) const { return length * RENDER_SCALE_Z; }
+
+    /**
+     * @brief Coefficients of the world -> render mapping, for shaders
+     * @param mapping Receives (RENDER_SCALE_X, RENDER_SCALE_Z, origin X, origin Z):
+     *        render X = origin X + x * scale X, render Z = origin Z - y * scale Z
+     */
+    void renderMapping(float (&mapping)[4]) const {
+        mapping[0] = RENDER_SCALE_X;
+        mapping[1] = RENDER_SCALE_Z;
+        mapping[2] = toRenderX(0.0f);
+        mapping[3] = toRenderZ(0.0f);
+    }
+
+    /// Half of the extent in render units, for the top-down projection
+    float renderHalfWidth() const { return scaleX(width * 0.5f); }
+    float renderHalfDepth() const { return scaleZ(height * 0.5f); }
+
+    /**
+     * @brief Map a cursor position in the top-down view to world units
+     * @param cursorX Cursor X in framebuffer pixels
+     * @param cursorY Cursor Y in framebuffer pixels
+     * @param viewportWidth Framebuffer width in pixels
+     * @param viewportHeight Framebuffer height in pixels
+     * @param x Receives world X
+     * @param y Receives world Y
+     */
+    void fromViewport(double cursorX, double cursorY, int viewportWidth, int viewportHeight,
+                      float& x, float& y) const {
+        x = static_cast<float>(cursorX / viewportWidth * width);
+        y = static_cast<float>(cursorY / viewportHeight * height);
+    }
+};
+
+#endif // WORLD_EXTENT_H
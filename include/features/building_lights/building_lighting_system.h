@@ -12,7 +12,11 @@
 #ifndef BUILDING_LIGHTING_SYSTEM_H
 #define BUILDING_LIGHTING_SYSTEM_H
 
+#include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "generation/city_generator.h"
 
 /**
  * @class BuildingLightingSystem
@@ -22,14 +26,36 @@
  * - Day (6am-6pm): Windows off
  * - Night (6pm-6am): Windows on with warm yellow glow
  * - Smooth transitions at sunrise/sunset
+ * 
+ * Which windows are lit is kept per building in a window occupancy
+ * texture: one RG32UI texel per building holding a 64-bit mask of its
+ * 8x8 window grid, so the fragment shader needs a single texelFetch.
+ * Every building follows its own schedule (evenings start up to
+ * SCHEDULE_SPREAD hours early or late, and each type fills up to its own
+ * share of windows), and its windows switch on one at a time as the
+ * evening goes on. Only buildings whose lit count changed are rewritten
+ * and uploaded. The texture is GL state: use it on the thread that owns
+ * the context.
  */
 class BuildingLightingSystem {
 public:
+    static constexpr int WINDOWS_PER_BUILDING = 64;    ///< 8x8 window grid of a face, one mask bit each
+    static constexpr int OCCUPANCY_WIDTH = 1024;       ///< Buildings per texture row (building i at i % width, i / width)
+    static constexpr float SCHEDULE_SPREAD = 0.75f;    ///< Most hours a building's evening starts early or late
+    
     /**
      * @brief Construct the lighting system
      */
     BuildingLightingSystem();
     
+    /**
+     * @brief Delete the occupancy texture
+     */
+    ~BuildingLightingSystem();
+    
+    BuildingLightingSystem(const BuildingLightingSystem&) = delete;
+    BuildingLightingSystem& operator=(const BuildingLightingSystem&) = delete;
+    
     /**
      * @brief Calculate window light emission color for current time
      * @param timeOfDay Current time in hours (0-24)
@@ -59,7 +85,65 @@ public:
      */
     bool areLightsActive(float timeOfDay) const;
     
+    /**
+     * @brief Take over the buildings of a new or changed city
+     * @param buildings The city's buildings; texel i belongs to buildings[i]
+     * 
+     * A building's schedule and window order derive from its position and
+     * type, so buildings keep their lights when others are added or
+     * removed. Every mask is rewritten by the next update().
+     */
+    void setBuildings(const std::vector<Building>& buildings);
+    
+    /**
+     * @brief Take over one building, appended or in place of another
+     * @param index Its texel (the texture grows past the last one as needed)
+     * @param building The building
+     * 
+     * Only its mask is rewritten by the next update().
+     */
+    void setBuilding(size_t index, const Building& building);
+    
+    /**
+     * @brief Advance the lit windows to a time of day and upload the changes
+     * @param timeOfDay Current time in hours (0-24)
+     * 
+     * Creates the texture on first use and grows it with the city. Only
+     * the rows holding buildings whose lit count changed are uploaded.
+     */
+    void update(float timeOfDay);
+    
+    /**
+     * @brief Get the occupancy texture (GL_RG32UI, 0 before the first update())
+     */
+    GLuint getOccupancyTexture() const { return occupancyTexture; }
+    
+    /**
+     * @brief Count the lit windows of a building (0 to WINDOWS_PER_BUILDING)
+     */
+    int getLitWindowCount(size_t building) const;
+    
 private:
+    /// Light schedule of one building
+    struct BuildingSchedule {
+        uint32_t seed;              ///< Orders the windows and shifts the evening
+        float hourOffset;           ///< Added to the time of day (-SCHEDULE_SPREAD..SCHEDULE_SPREAD)
+        float litShare;             ///< Share of windows lit at full night
+        int litLevel;               ///< Windows lit in the uploaded mask (-1 = not written yet)
+    };
+    
+    // Mask with the first litLevel windows of the building's order lit
+    static void writeMask(const BuildingSchedule& schedule, uint32_t* texel);
+    
+    // Create or grow the texture to hold every building
+    void ensureTexture();
+    
+    std::vector<BuildingSchedule> schedules;   ///< One per building
+    std::vector<uint32_t> masks;               ///< Two words (windows 0-31, 32-63) per building
+    GLuint occupancyTexture;
+    int textureRows;                           ///< Rows the texture was allocated with
+    
+
     glm::vec3 warmYellowColor;  ///< Warm yellow color for window glow
     float sunriseStart;         ///< Hour when sunrise begins (4.0)
     float sunriseEnd;           ///< Hour when sunrise ends (6.0)
@@ -12,12 +12,10 @@
 #ifndef BUILDING_PLACEMENT_SYSTEM_H
 #define BUILDING_PLACEMENT_SYSTEM_H
 
-#include <vector>
+#include "generation/placement_index.h"
 
 // Forward declarations
-struct Building;
-struct Road;
-struct Point;
+struct CityData;
 struct CityConfig;
 
 /**
@@ -28,7 +26,10 @@ struct CityConfig;
  * - Click on the 2D view to place buildings
  * - Automatically check for collisions with roads, parks, fountains
  * - Ensure buildings don't overlap
- * - Respect screen boundaries
+ * - Respect the city boundaries
+ * 
+ * All checks go through the city's placement index, so placement follows
+ * exactly the rules of generation and costs O(nearby items) per click.
  */
 class BuildingPlacementSystem {
 public:
@@ -38,90 +39,30 @@ public:
     BuildingPlacementSystem();
     
     /**
-     * @brief Attempt to place a building at screen coordinates
+     * @brief Attempt to place a building at world coordinates
      * @param worldX X coordinate in world space
      * @param worldY Y coordinate in world space
-     * @param buildings Existing buildings list (will be modified if placement succeeds)
-     * @param roads Roads to check for collisions
-     * @param parks Parks to check for collisions
-     * @param fountain Fountain area to check for collision
+     * @param city City to add the building to (buildings and index)
      * @param config City configuration for building size
-     * @param screenWidth Screen width for boundary checking
-     * @param screenHeight Screen height for boundary checking
      * @return true if building was successfully placed
      * 
      * This function:
-     * 1. Checks if position is within screen boundaries
-     * 2. Checks for collision with roads
-     * 3. Checks for collision with parks and fountain
+     * 1. Checks if position is within the city boundaries
+     * 2. Checks for collision with parks and fountain
+     * 3. Checks for collision with roads
      * 4. Checks for overlap with existing buildings
-     * 5. If all checks pass, adds new building to the list
-     */
-    bool tryPlaceBuilding(float worldX, float worldY,
-                          std::vector<Building>& buildings,
-                          const std::vector<Road>& roads,
-                          const std::vector<std::vector<Point>>& parks,
-                          const std::vector<Point>& fountain,
-                          const CityConfig& config,
-                          int screenWidth, int screenHeight);
-    
-private:
-    /**
-     * @brief Check if position collides with any road
-     * @param x X position
-     * @param y Y position
-     * @param width Building width
-     * @param depth Building depth
-     * @param roads List of roads
-     * @return true if collision detected
-     */
-    bool collidesWithRoads(float x, float y, float width, float depth,
-                           const std::vector<Road>& roads) const;
-    
-    /**
-     * @brief Check if position collides with parks
-     * @param x X position
-     * @param y Y position
-     * @param width Building width
-     * @param depth Building depth
-     * @param parks List of park areas
-     * @return true if collision detected
+     * 5. If all checks pass, adds new building to the city
      */
-    bool collidesWithParks(float x, float y, float width, float depth,
-                           const std::vector<std::vector<Point>>& parks) const;
+    bool tryPlaceBuilding(float worldX, float worldY, CityData& city, const CityConfig& config);
     
     /**
-     * @brief Check if position collides with fountain
-     * @param x X position
-     * @param y Y position
-     * @param width Building width
-     * @param depth Building depth
-     * @param fountain Fountain area
-     * @return true if collision detected
-     */
-    bool collidesWithFountain(float x, float y, float width, float depth,
-                              const std::vector<Point>& fountain) const;
-    
-    /**
-     * @brief Check if position collides with existing buildings
-     * @param x X position
-     * @param y Y position
-     * @param width Building width
-     * @param depth Building depth
-     * @param buildings List of existing buildings
-     * @return true if collision detected
-     */
-    bool collidesWithBuildings(float x, float y, float width, float depth,
-                               const std::vector<Building>& buildings) const;
-    
-    /**
-     * @brief Check if point is inside circle
-     * @param px Point X
-     * @param py Point Y
-     * @param circlePoints Circle boundary points
-     * @return true if point is inside
+     * @brief Check a placement without placing or printing anything
+     * @return PlacementConflict::NONE if tryPlaceBuilding would succeed
+     * 
+     * Cheap enough to call every frame for a hover preview.
      */
-    bool isInsideCircle(float px, float py, const std::vector<Point>& circlePoints) const;
+    PlacementConflict checkPlacement(float worldX, float worldY, const CityData& city,
+                                     const CityConfig& config) const;
 };
 
 #endif // BUILDING_PLACEMENT_SYSTEM_H
@@ -85,6 +85,15 @@ public:
      */
     float getAmbientLightFactor() const;
     
+    /**
+     * @brief Get how strongly lit windows show through building textures
+     * @return Blend factor toward the window light color
+     * 
+     * Windows glow brighter at night and early morning (7pm - 7am): 0.5,
+     * otherwise 0.25.
+     */
+    float getWindowLightFactor() const;
+    
     /**
      * @brief Toggle automatic time progression
      */
@@ -0,0 +1,84 @@
+/**
+ * @file city_file_format.h
+ * @brief Binary City Save Format (.city)
+ * 
+ * Layout of the binary save written by CitySerializer::saveCityBinary.
+ * A fixed header is followed by flat little-endian arrays, each starting
+ * at an 8-byte aligned offset recorded in the header:
+ * 
+ *   Header | BuildingRecord[] | RoadRecord[] | PointRecord[] | CircleRecord[]
+ * 
+ * Road polylines are stored as (firstPoint, pointCount) ranges into one
+ * shared point array, so the whole file can be mapped and read in place.
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef CITY_FILE_FORMAT_H
+#define CITY_FILE_FORMAT_H
+
+#include <cstdint>
+
+namespace CityFileFormat {
+
+constexpr char MAGIC[4] = {'C', 'I', 'T', 'Y'};
+constexpr uint32_t VERSION = 2;     ///< Bump when a record layout changes
+constexpr uint32_t MIN_VERSION = 1; ///< Oldest version the loader still reads
+constexpr uint32_t HEADER_SIZE_V1 = 80;   ///< Version 1 headers end before seed
+constexpr uint32_t ALIGNMENT = 8;   ///< Every array starts on this boundary
+
+/**
+ * @struct Header
+ * @brief Fixed-size file header (offsets are from the start of the file)
+ */
+struct Header {
+    char magic[4];              ///< "CITY"
+    uint32_t version;           ///< Format version (VERSION)
+    uint32_t headerSize;        ///< sizeof(Header) when written
+    uint32_t buildingCount;
+    uint32_t roadCount;
+    uint32_t pointCount;        ///< Total polyline vertices over all roads
+    uint32_t parkCount;
+    uint32_t worldWidth;        ///< City extent in world units (0 = default extent)
+    float fountainX;
+    float fountainY;
+    float fountainRadius;       ///< 0 = no fountain
+    uint32_t worldHeight;       ///< (0 = default extent)
+    uint64_t buildingsOffset;
+    uint64_t roadsOffset;
+    uint64_t pointsOffset;
+    uint64_t parksOffset;
+    uint64_t seed;              ///< Generation seed (0 = unknown; added in version 2)
+};
+
+struct BuildingRecord {
+    float x, y;
+    float width, depth, height;
+    uint32_t type;              ///< BuildingType value
+};
+
+struct RoadRecord {
+    uint32_t firstPoint;        ///< Index of the first vertex in the point array
+    uint32_t pointCount;
+    int32_t width;
+    uint32_t reserved;
+};
+
+struct PointRecord {
+    int32_t x, y;
+};
+
+struct CircleRecord {
+    float x, y, radius;
+};
+
+static_assert(sizeof(Header) == 88, "City file header layout changed");
+static_assert(sizeof(BuildingRecord) == 24, "Building record layout changed");
+static_assert(sizeof(RoadRecord) == 16, "Road record layout changed");
+static_assert(sizeof(PointRecord) == 8, "Point record layout changed");
+static_assert(sizeof(CircleRecord) == 12, "Circle record layout changed");
+
+}  // namespace CityFileFormat
+
+#endif // CITY_FILE_FORMAT_H
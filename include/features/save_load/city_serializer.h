@@ -8,6 +8,11 @@
  * Provides JSON serialization and deserialization for CityData.
  * Allows saving cities to files and loading them back.
  * 
+ * The default save is the compact binary .city format (see
+ * city_file_format.h), loaded through a read-only memory map. JSON is
+ * kept as a human-readable export/interchange format, and the tiled
+ * .ctiles format (city_tile_format.h) for cities streamed from disk.
+ * 
  * @author City Designer Team
  * @date November 2025
  */
@@ -15,8 +20,12 @@
 #ifndef CITY_SERIALIZER_H
 #define CITY_SERIALIZER_H
 
+#include <cstdint>
 #include <string>
 #include "generation/city_generator.h"
+#include "features/save_load/city_tile_format.h"
+
+class JsonReader;
 
 class CitySerializer {
 public:
@@ -33,16 +42,75 @@ public:
      * @param city Reference to city data object to populate
      * @param filename Name of the file to load (without path or extension)
      * @return true if load was successful, false otherwise
+     * 
+     * Streams the file through JsonReader in a single pass, so layout and
+     * whitespace do not matter (minified files load too) and memory stays
+     * bounded by the city itself. Unknown members are skipped. On a parse
+     * error city is left untouched.
      */
     static bool loadCity(CityData& city, const std::string& filename);
     
+    /**
+     * @brief Save city data to a binary .city file
+     * @param city The city data to save
+     * @param filename Name of the file (without path or extension)
+     * @return true if save was successful, false otherwise
+     */
+    static bool saveCityBinary(const CityData& city, const std::string& filename);
+    
+    /**
+     * @brief Load city data from a binary .city file
+     * @param city Reference to city data object to populate
+     * @param filename Name of the file to load (without path or extension)
+     * @return true if load was successful, false otherwise
+     * 
+     * The file is memory-mapped and validated (magic, version, array
+     * bounds) before anything is read into city; city is left untouched
+     * when the file is rejected.
+     */
+    static bool loadCityBinary(CityData& city, const std::string& filename);
+    
+    /**
+     * @brief Check whether a binary save with this name exists
+     */
+    static bool hasBinarySave(const std::string& filename);
+    
+    /**
+     * @brief Save city data as a tiled .ctiles file for streaming
+     * @param city The city data to save
+     * @param filename Name of the file (without path or extension)
+     * @param tileSize Tile edge in world units
+     * @return true if save was successful, false otherwise
+     * 
+     * Cuts the city into square tiles (see city_tile_format.h) that
+     * CityTileStreamer loads one by one, so cities larger than memory can
+     * be shown around the camera.
+     */
+    static bool saveCityTiled(const CityData& city, const std::string& filename,
+                              uint32_t tileSize = CityTileFormat::DEFAULT_TILE_SIZE);
+    
+    /**
+     * @brief Path of the tiled save with this name (as saveCityTiled() writes it)
+     */
+    static std::string tiledSavePath(const std::string& filename);
+    
     /**
      * @brief Get the default save directory path
      * @return Path to saves directory
      */
     static std::string getSaveDirectory();
     
+    /**
+     * @brief Enable or disable progress/summary output (on by default)
+     * 
+     * Errors are always reported. Set it before saving from several
+     * threads; the flag itself is not synchronized.
+     */
+    static void setVerbose(bool enabled) { verbose = enabled; }
+    
 private:
+    static bool verbose;    ///< Print progress and summaries to stdout
+    
     /**
      * @brief Convert building type enum to string
      */
@@ -57,6 +125,28 @@ private:
      * @brief Escape special characters for JSON strings
      */
     static std::string escapeJson(const std::string& str);
+    
+    /**
+     * @brief Read a JSON array of {"x", "y"} points into out (cleared first)
+     */
+    static void readPoints(JsonReader& json, std::vector<Point>& out);
+    
+    /**
+     * @brief Read a circle object, or a legacy array of outline points
+     * @param scratch Reused point buffer for the legacy form
+     */
+    static Circle readCircle(JsonReader& json, std::vector<Point>& scratch);
+    
+    /**
+     * @brief Read the "buildings" array, appending to city.buildings
+     */
+    static void readBuildings(JsonReader& json, CityData& city);
+    
+    /**
+     * @brief Read the "roads" array, appending to city.roads
+     * @param scratch Reused point buffer for each road path
+     */
+    static void readRoads(JsonReader& json, CityData& city, std::vector<Point>& scratch);
 };
 
 #endif // CITY_SERIALIZER_H
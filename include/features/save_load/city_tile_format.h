@@ -0,0 +1,78 @@
+/**
+ * @file city_tile_format.h
+ * @brief Tiled Binary City Format (.ctiles)
+ * 
+ * Layout of the tiled save written by CitySerializer::saveCityTiled and
+ * streamed in by CityTileStreamer. The city is cut into a grid of square
+ * tiles; a fixed header and a tile index are followed by each tile's own
+ * arrays, so one tile is read without touching the rest of the file:
+ * 
+ *   Header | TileRecord[tilesX * tilesY] | tile 0 arrays | tile 1 arrays | ...
+ * 
+ * A tile's arrays use the records of the .city format (city_file_format.h)
+ * in the same order, each starting at an 8-byte aligned offset stored in
+ * its TileRecord. Buildings and parks belong to the tile holding their
+ * center. Roads are cut where they cross tile edges, and every piece is
+ * stored with the tile it runs through, so a resident tile always has
+ * its own streets. Road point indices are relative to the tile.
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef CITY_TILE_FORMAT_H
+#define CITY_TILE_FORMAT_H
+
+#include <cstdint>
+#include "features/save_load/city_file_format.h"
+
+namespace CityTileFormat {
+
+constexpr char MAGIC[4] = {'C', 'T', 'I', 'L'};
+constexpr uint32_t VERSION = 1;     ///< Bump when a record layout changes
+constexpr uint32_t ALIGNMENT = 8;   ///< Every array starts on this boundary
+constexpr uint32_t DEFAULT_TILE_SIZE = 256;   ///< Tile edge in world units
+constexpr uint32_t MAX_TILES = 1u << 20;      ///< Upper bound on tilesX * tilesY the loader accepts
+
+/**
+ * @struct Header
+ * @brief Fixed-size file header (offsets are from the start of the file)
+ */
+struct Header {
+    char magic[4];              ///< "CTIL"
+    uint32_t version;           ///< Format version (VERSION)
+    uint32_t headerSize;        ///< sizeof(Header) when written
+    uint32_t tileSize;          ///< Tile edge in world units
+    uint32_t tilesX;            ///< Tile columns (covering worldWidth)
+    uint32_t tilesY;            ///< Tile rows (covering worldHeight)
+    uint32_t worldWidth;        ///< City extent in world units
+    uint32_t worldHeight;
+    float fountainX;            ///< The fountain is kept resident, so it lives here
+    float fountainY;
+    float fountainRadius;       ///< 0 = no fountain
+    uint32_t reserved;
+    uint64_t seed;              ///< Generation seed (0 = unknown)
+    uint64_t tilesOffset;       ///< TileRecord array, row-major (tile x + y * tilesX)
+};
+
+/**
+ * @struct TileRecord
+ * @brief Where one tile's arrays are (counts of 0 leave the offset unused)
+ */
+struct TileRecord {
+    uint64_t buildingsOffset;   ///< CityFileFormat::BuildingRecord[buildingCount]
+    uint64_t roadsOffset;       ///< CityFileFormat::RoadRecord[roadCount]
+    uint64_t pointsOffset;      ///< CityFileFormat::PointRecord[pointCount]
+    uint64_t parksOffset;       ///< CityFileFormat::CircleRecord[parkCount]
+    uint32_t buildingCount;
+    uint32_t roadCount;
+    uint32_t pointCount;
+    uint32_t parkCount;
+};
+
+static_assert(sizeof(Header) == 64, "Tiled city header layout changed");
+static_assert(sizeof(TileRecord) == 48, "Tile record layout changed");
+
+}  // namespace CityTileFormat
+
+#endif // CITY_TILE_FORMAT_H
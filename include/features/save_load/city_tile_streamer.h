@@ -0,0 +1,241 @@
+/**
+ * @file city_tile_streamer.h
+ * @brief Streaming of Tiled Cities Around the Camera
+ * 
+ * Shows cities that are too large to keep in memory. A tiled save (see
+ * city_tile_format.h) is memory-mapped, and a loader thread keeps only
+ * the tiles near the camera resident: the nearest tiles within the load
+ * radius, as many as the memory budget allows. Tiles that fall out of
+ * that set are evicted, and missing ones are read and meshed in
+ * parallel, each into a StreamedTile of its own. Only the tiles added and
+ * evicted are published: the main loop passes the tile pointers on, and
+ * the render thread uploads and frees each tile's buffers on its own, so
+ * entering a tile costs the tiles that changed, not the resident set.
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef CITY_TILE_STREAMER_H
+#define CITY_TILE_STREAMER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "features/save_load/city_tile_format.h"
+#include "generation/city_generator.h"
+#include "rendering/city_renderer.h"
+#include "utils/job_system.h"
+#include "utils/mapped_file.h"
+
+/**
+ * @struct StreamedTile
+ * @brief One loaded tile: its objects and their static meshes, immutable once published
+ * 
+ * Shared by the loader, the main thread and the render thread, so a
+ * tile's objects and meshes exist once however many threads hold it.
+ */
+struct StreamedTile {
+    uint32_t index = 0;                 ///< Tile index in the file
+    CityData city;                      ///< The tile's buildings, roads and parks (whole map's extent; no fountain, network or index)
+    std::shared_ptr<const CityRenderer::PreparedMeshes> meshes;  ///< Roads, parks and 2D points of city
+    size_t bytes = 0;                   ///< Memory the tile costs while shown (see CityTileStreamer::tileBytes())
+};
+
+/// Streamed tiles on show, as shared with the render thread (FrameSnapshot::tiles)
+using StreamedTiles = std::vector<std::shared_ptr<const StreamedTile>>;
+
+/**
+ * @struct TileUpdate
+ * @brief Tiles added and evicted since the last CityTileStreamer::takeTiles()
+ * 
+ * Apply removed before added: a tile evicted and loaded again in between
+ * is in both.
+ */
+struct TileUpdate {
+    StreamedTiles added;
+    std::vector<uint32_t> removed;      ///< Indices of evicted tiles
+};
+
+/**
+ * @class CityTileStreamer
+ * @brief One loader thread keeping the tiles around the camera resident
+ * 
+ * All public methods are called from the main thread. Like
+ * AsyncCityGenerator, the streamer has its own worker pool, since the
+ * main loop's pool runs traffic and mesh jobs concurrently.
+ */
+class CityTileStreamer {
+public:
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 64u << 20;   ///< Bytes of resident tiles, meshes included
+    static constexpr float DEFAULT_LOAD_RADIUS = 1024.0f;        ///< World units around the camera
+    
+    /**
+     * @brief Start the loader thread (idle until open())
+     * @param workerCount Threads of the loading and meshing pool
+     */
+    explicit CityTileStreamer(unsigned workerCount = JobSystem::defaultWorkerCount());
+    
+    /**
+     * @brief Stop loading and join the loader thread
+     */
+    ~CityTileStreamer();
+    
+    CityTileStreamer(const CityTileStreamer&) = delete;
+    CityTileStreamer& operator=(const CityTileStreamer&) = delete;
+    
+    /**
+     * @brief Map a tiled save and stream it from the next update()
+     * @param filename Name of the file (without path or extension)
+     * @return false if the file is missing or fails validation (the
+     *         previous file, if any, keeps streaming)
+     * 
+     * The header and tile index are checked up front, so the loader never
+     * reads outside the file.
+     */
+    bool open(const std::string& filename);
+    
+    /**
+     * @brief Stop streaming; the tiles are dropped and nothing more is published
+     * 
+     * Like open(), forgets any update not taken yet: the caller drops the
+     * tiles it holds itself.
+     */
+    void close();
+    
+    /**
+     * @brief True between a successful open() and close()
+     */
+    bool isOpen() const { return source != nullptr; }
+    
+    /**
+     * @brief Most bytes of tiles to keep resident (at least the nearest tile is)
+     * 
+     * Counts everything a shown tile costs (see tileBytes()), its meshes
+     * on the CPU and GPU included.
+     */
+    void setMemoryBudget(size_t bytes);
+    
+    /**
+     * @brief Distance from the camera within which tiles are wanted, in world units
+     */
+    void setLoadRadius(float worldUnits);
+    
+    /**
+     * @brief Follow the camera (call every frame while open)
+     * @param worldX Camera position in world units (see WorldExtent::fromRenderX())
+     * @param worldY Camera position in world units (see WorldExtent::fromRenderZ())
+     * 
+     * Cheap: the loader is only woken when the camera enters another tile.
+     */
+    void update(float worldX, float worldY);
+    
+    /**
+     * @brief Take the tiles added and evicted since the last call
+     * @param update Receives the changes (replaced, not merged)
+     * @return false if no tile changed
+     * 
+     * Updates the caller did not take pile up into one, so none is lost.
+     */
+    bool takeTiles(TileUpdate& update);
+    
+    /**
+     * @brief The open file's city without its tiles: extent, seed and fountain (isGenerated set)
+     * 
+     * The tiles are shown on top of it, which keeps the fountain in view
+     * wherever it lies.
+     */
+    CityData baseCity() const;
+    
+    /**
+     * @brief Extent of the open file's city (the default extent when closed)
+     */
+    WorldExtent getExtent() const;
+
+private:
+    /// A mapped tiled save with its validated header and index; shared with the loader
+    struct Source {
+        std::unique_ptr<MappedFile> file;
+        CityTileFormat::Header header;
+        const CityTileFormat::TileRecord* tiles;
+    };
+    
+    /**
+     * @brief Loader loop: wait for a new camera tile, bring the resident set up to date, repeat
+     */
+    void run();
+    
+    /**
+     * @brief Tiles whose square comes within radius of a camera position, nearest first
+     */
+    std::vector<uint32_t> tilesNear(const Source& from, float x, float y, float radius) const;
+    
+    /**
+     * @brief How many of tiles, taken in order, fit a budget (at least one)
+     */
+    static size_t tilesWithin(const std::vector<uint32_t>& tiles, size_t budget,
+                              const std::function<size_t(uint32_t)>& bytesOf);
+    
+    /**
+     * @brief Bytes of a tile's objects while shown, from their counts
+     * 
+     * The tile's own copy plus the render thread's copy of its buildings;
+     * roads count one Road and their points.
+     */
+    static size_t objectBytes(size_t buildings, size_t roads, size_t points, size_t parks);
+    
+    /**
+     * @brief Bytes a loaded tile costs while shown
+     * 
+     * objectBytes() plus its meshes twice: the prepared copy the tile
+     * keeps and the GPU buffers uploaded from it.
+     */
+    static size_t tileBytes(const StreamedTile& tile);
+    
+    /**
+     * @brief Bytes a tile not loaded yet is expected to cost, from its record
+     * 
+     * objectBytes() scaled by the ratio measured on the tiles loaded so
+     * far, so the meshes are counted before the tile is meshed.
+     */
+    size_t estimatedBytes(const CityTileFormat::TileRecord& record) const;
+    
+    /**
+     * @brief Read one tile's records out of the mapping and mesh them
+     */
+    static std::shared_ptr<StreamedTile> loadTile(const Source& from, uint32_t index);
+    
+    JobSystem jobs;                     ///< Loading and meshing pool, used only by the loader
+    
+    std::mutex mutex;                   ///< Guards everything below up to the thread
+    std::condition_variable wake;       ///< Signals a new request or shutdown
+    std::shared_ptr<const Source> pendingSource;
+    float pendingX;
+    float pendingY;
+    float loadRadius;
+    size_t memoryBudget;
+    uint64_t sourceGeneration;          ///< Incremented by open() and close(); updates of older files are dropped
+    bool hasPending;
+    bool stopping;
+    TileUpdate published;               ///< Changes not taken yet
+    std::thread loader;
+    
+    // Loader thread only
+    std::shared_ptr<const Source> loadedSource;     ///< File the resident tiles come from
+    std::unordered_map<uint32_t, std::shared_ptr<const StreamedTile>> resident;  ///< Tile index -> tile
+    uint64_t measuredObjectBytes;       ///< objectBytes() of every tile loaded so far
+    uint64_t measuredTileBytes;         ///< tileBytes() of the same tiles
+    
+    // Main thread only
+    std::shared_ptr<const Source> source;           ///< Open file (nullptr = closed)
+    int64_t cameraTile;                             ///< Tile of the last request (-1 = none yet)
+};
+
+#endif // CITY_TILE_STREAMER_H
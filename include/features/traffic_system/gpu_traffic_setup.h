@@ -0,0 +1,64 @@
+/**
+ * @file gpu_traffic_setup.h
+ * @brief Starting State of the GPU Traffic Backend
+ * 
+ * With TrafficBackend::GPU, TrafficGenerator spawns the cars as usual and
+ * then hands them over in a GpuTrafficSetup: the cars at step 0 and the
+ * road graph flattened into the tables the step shader reads. The setup
+ * is built once per generation and never changed, so it is shared with
+ * the render thread like a city snapshot; GpuTrafficSimulator uploads it
+ * and steps the cars on the GPU from then on.
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef GPU_TRAFFIC_SETUP_H
+#define GPU_TRAFFIC_SETUP_H
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * @struct GpuCarState
+ * @brief One car as the step shader reads and writes it (56 bytes, interleaved)
+ * 
+ * Groups match the shader's vec4 Motion, ivec4 Route, vec4 Pose and
+ * vec2 Heading outputs, in the order they are captured.
+ */
+struct GpuCarState {
+    float progress;         ///< Road parameter (Road::sample())
+    float speed;            ///< Current speed in world units per second
+    float desiredSpeed;     ///< Speed the car accelerates toward
+    float reserved;
+    int32_t road;           ///< Index into CityData::roads
+    int32_t edge;           ///< Network edge it is on (-1 = road has no edges)
+    int32_t nodeAhead;      ///< Node at the end of that edge (-1 = road has no edges)
+    int32_t direction;      ///< +1 toward increasing progress, -1 backward
+    float x, y;             ///< Position (world units)
+    float prevX, prevY;     ///< Position at the previous step (for interpolation)
+    float headingX;         ///< Unit direction of travel (world units)
+    float headingY;
+};
+
+static_assert(sizeof(GpuCarState) == 56, "GpuCarState must match the step shader's outputs");
+
+/**
+ * @struct GpuTrafficSetup
+ * @brief Cars at step 0 and the road graph, laid out as buffer texture texels
+ */
+struct GpuTrafficSetup {
+    std::vector<GpuCarState> cars;
+    std::vector<uint8_t> colors;            ///< (r, g, b, 255) per car
+    
+    std::vector<float> roadPoints;          ///< (x, y, distance from the road's start, 0) per path point
+    std::vector<uint32_t> roads;            ///< (first point, point count, length as float bits, 0) per road
+    std::vector<uint32_t> edges;            ///< (road, start node, end node, 0) per network edge
+    std::vector<float> edgeRanges;          ///< (startT, endT) per network edge
+    std::vector<uint32_t> nodes;            ///< (first nodeEdges entry, degree) per network node
+    std::vector<uint32_t> nodeEdges;        ///< RoadNetwork::nodeEdges
+    
+    uint32_t seed = 0;                      ///< Mixed into every turn, so a city seed replays the same traffic
+};
+
+#endif // GPU_TRAFFIC_SETUP_H
@@ -0,0 +1,120 @@
+/**
+ * @file gpu_traffic_simulator.h
+ * @brief GPU Traffic Backend: Cars Stepped by Transform Feedback
+ * 
+ * Steps the cars of TrafficBackend::GPU where they are drawn. The car
+ * states sit in two buffers; a vertex shader reads one, advances every
+ * car one fixed step along the road graph (kept in buffer textures) and
+ * writes the other through transform feedback, with rasterization off.
+ * The car draw reads the newest buffer as instance attributes
+ * (SHADER_GPU_CARS), so no car data crosses between CPU and GPU after
+ * the upload.
+ * 
+ * OpenGL 3.3 has no compute shaders or storage buffers; transform
+ * feedback is its way of running one shader invocation per car and
+ * keeping the results on the GPU.
+ * 
+ * The model is free-flowing: cars accelerate to their desired speed and
+ * take a random other edge at every node, without car following or
+ * queueing, so each car's step needs no other car. Turns are hashed from
+ * the car, the step and the city seed, so the same seed replays the
+ * same traffic.
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef GPU_TRAFFIC_SIMULATOR_H
+#define GPU_TRAFFIC_SIMULATOR_H
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "features/traffic_system/gpu_traffic_setup.h"
+
+/**
+ * @class GpuTrafficSimulator
+ * @brief Follows the main thread's GPU traffic (render thread only)
+ * 
+ * Creates no GL objects until the first sync() with cars, so it may be
+ * constructed before a context exists; destroy it with the context current.
+ */
+class GpuTrafficSimulator {
+public:
+    static constexpr GLuint FIRST_TABLE_UNIT = 2;   ///< Road graph tables use texture units 2-7 (ShaderManager has 0 and 1)
+    static constexpr int TABLE_COUNT = 6;           ///< roadPoints, roads, edges, edgeRanges, nodes, nodeEdges
+    
+    GpuTrafficSimulator();
+    ~GpuTrafficSimulator();
+    
+    GpuTrafficSimulator(const GpuTrafficSimulator&) = delete;
+    GpuTrafficSimulator& operator=(const GpuTrafficSimulator&) = delete;
+    
+    /**
+     * @brief Upload new cars and step them up to the main thread's step count
+     * @param setup TrafficGenerator::getGpuSetup() (nullptr releases the cars)
+     * @param step TrafficGenerator::getStepCount()
+     * 
+     * Call before ShaderManager::use(): stepping switches programs. At most
+     * TrafficGenerator::MAX_STEPS_PER_UPDATE steps run per call; a larger
+     * backlog is dropped, as the CPU backend does after a hitch.
+     */
+    void sync(const std::shared_ptr<const GpuTrafficSetup>& setup, uint32_t step);
+    
+    /**
+     * @brief True once cars were uploaded (false if the GPU lacks what the backend needs)
+     */
+    bool hasCars() const { return carCount > 0; }
+    size_t getCarCount() const { return carCount; }
+    
+    /**
+     * @brief VAO drawing the unit car mesh once per car of the newest step
+     * 
+     * Attributes: mesh at 0 and 1, car pose at ShaderManager::CAR_POSE_ATTRIBUTE,
+     * color at CAR_COLOR_ATTRIBUTE and heading at CAR_HEADING_ATTRIBUTE.
+     */
+    GLuint getDrawVAO() const { return drawVAOs[current]; }
+
+private:
+    /**
+     * @brief Create the buffers, tables and VAOs for a setup
+     * @return false if a table exceeds GL_MAX_TEXTURE_BUFFER_SIZE or the step program failed
+     */
+    bool upload(const GpuTrafficSetup& setup);
+    
+    /**
+     * @brief Run steps transform feedback passes, swapping the state buffers after each
+     */
+    void runSteps(uint32_t steps);
+    
+    /**
+     * @brief Compile and link the step program (once)
+     */
+    bool buildProgram();
+    
+    /**
+     * @brief Delete every car buffer, table and VAO (the program is kept)
+     */
+    void release();
+    
+    std::shared_ptr<const GpuTrafficSetup> uploaded;   ///< Setup the buffers hold (nullptr = none)
+    size_t carCount;
+    uint32_t stepsDone;         ///< Steps taken since upload
+    
+    GLuint program;             ///< Step program (0 until built)
+    GLint stepLocation;
+    GLint seedLocation;
+    bool programFailed;         ///< Do not try to build it again
+    
+    GLuint stateBuffers[2];     ///< GpuCarState arrays, read from one and written to the other
+    GLuint stepVAOs[2];         ///< Step program input from stateBuffers[i]
+    GLuint drawVAOs[2];         ///< Car draw with stateBuffers[i] as instances
+    int current;                ///< Buffer holding the newest step
+    GLuint colorBuffer;         ///< (r, g, b, 255) per car
+    GLuint meshBuffer;          ///< Unit car mesh (carUnitMesh())
+    GLuint tableBuffers[TABLE_COUNT];
+    GLuint tableTextures[TABLE_COUNT];
+};
+
+#endif // GPU_TRAFFIC_SIMULATOR_H
@@ -0,0 +1,131 @@
+/**
+ * @file traffic_file_format.h
+ * @brief Binary Traffic Recording Format (.traffic)
+ * 
+ * Layout of the recordings written by TrafficRecorder and played back by
+ * TrafficReplay. The car states of every fixed step (tick) are quantized
+ * and grouped into chunks; each chunk opens with a keyframe holding every
+ * car in full, followed by one delta frame per further tick:
+ * 
+ *   Header | ColorRecord[] | Chunk | Chunk | ... | ChunkIndexRecord[]
+ *   Chunk = ChunkHeader | KeyframeRecord[carCount] | DeltaFrame[tickCount - 1]
+ * 
+ * A delta frame stores, per car in order, zigzag varints of the change
+ * in x, y and speed since the previous tick (speed shifted left by one,
+ * its low bit set when the heading changed, followed then by the new
+ * heading as two bytes). A car cruising along an edge costs three bytes.
+ * 
+ * The chunk index and tick count are written when recording stops; a
+ * recording cut short (index offset 0) is still readable by walking the
+ * chunk headers from the first chunk.
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef TRAFFIC_FILE_FORMAT_H
+#define TRAFFIC_FILE_FORMAT_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace TrafficFileFormat {
+
+constexpr char MAGIC[4] = {'T', 'R', 'F', 'C'};
+constexpr uint32_t VERSION = 1;             ///< Bump when a record layout changes
+constexpr float POSITION_SCALE = 16.0f;     ///< Stored units per world unit (1/16 pixel)
+constexpr float SPEED_SCALE = 16.0f;        ///< Stored units per world unit per second
+constexpr float HEADING_SCALE = 127.0f;     ///< Stored heading components per unit
+constexpr uint32_t HEADING_CHANGED = 1;     ///< Low bit of a delta frame's speed varint
+constexpr size_t MAX_VARINT_BYTES = 5;      ///< Longest encoding of a 32-bit value
+constexpr size_t MAX_DELTA_BYTES = 3 * MAX_VARINT_BYTES + 2;  ///< Longest delta of one car
+
+/**
+ * @struct Header
+ * @brief Fixed-size file header (offsets are from the start of the file)
+ */
+struct Header {
+    char magic[4];              ///< "TRFC"
+    uint32_t version;           ///< Format version (VERSION)
+    uint32_t headerSize;        ///< sizeof(Header) when written
+    uint32_t carCount;          ///< Cars in every tick
+    uint32_t worldWidth;        ///< City extent in world units
+    uint32_t worldHeight;
+    uint32_t keyframeInterval;  ///< Ticks per chunk (the last chunk may be shorter)
+    uint32_t tickCount;         ///< Ticks recorded (0 until recording stops)
+    float tickSeconds;          ///< Simulated time per tick
+    uint32_t chunkCount;        ///< Entries in the chunk index (0 until recording stops)
+    uint64_t seed;              ///< Seed of the recorded city and its traffic
+    uint64_t colorsOffset;      ///< ColorRecord[carCount]
+    uint64_t indexOffset;       ///< ChunkIndexRecord[chunkCount] (0 = walk the chunks)
+};
+
+struct ColorRecord {
+    uint8_t r, g, b, a;
+};
+
+struct ChunkHeader {
+    uint32_t firstTick;
+    uint32_t tickCount;         ///< Keyframe tick plus delta frames
+    uint64_t payloadSize;       ///< Bytes after this header up to the next chunk
+};
+
+struct ChunkIndexRecord {
+    uint32_t firstTick;
+    uint32_t tickCount;
+    uint64_t offset;            ///< Offset of the ChunkHeader
+};
+
+struct KeyframeRecord {
+    int32_t x, y;               ///< Position * POSITION_SCALE
+    uint16_t speed;             ///< Speed * SPEED_SCALE
+    int8_t headingX, headingY;  ///< Unit direction of travel * HEADING_SCALE
+};
+
+static_assert(sizeof(Header) == 64, "Traffic file header layout changed");
+static_assert(sizeof(ColorRecord) == 4, "Color record layout changed");
+static_assert(sizeof(ChunkHeader) == 16, "Chunk header layout changed");
+static_assert(sizeof(ChunkIndexRecord) == 16, "Chunk index record layout changed");
+static_assert(sizeof(KeyframeRecord) == 12, "Keyframe record layout changed");
+
+/**
+ * @brief Map a signed delta onto an unsigned value with small magnitudes first
+ */
+inline uint32_t zigzag(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+inline int32_t unzigzag(uint32_t value) {
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+/**
+ * @brief Write value as a little-endian base-128 varint (1-5 bytes)
+ * @return Position after the last byte written
+ */
+inline unsigned char* writeVarint(unsigned char* out, uint32_t value) {
+    while (value >= 0x80) {
+        *out++ = static_cast<unsigned char>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<unsigned char>(value);
+    return out;
+}
+
+/**
+ * @brief Read a varint from [cursor, end)
+ * @return false if the varint runs past end or is longer than 5 bytes
+ */
+inline bool readVarint(const unsigned char*& cursor, const unsigned char* end, uint32_t& value) {
+    value = 0;
+    for (size_t shift = 0; shift < 7 * MAX_VARINT_BYTES && cursor < end; shift += 7) {
+        unsigned char byte = *cursor++;
+        value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+}  // namespace TrafficFileFormat
+
+#endif // TRAFFIC_FILE_FORMAT_H
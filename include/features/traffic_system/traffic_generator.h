@@ -3,7 +3,13 @@
  * @brief Feature 3: Traffic System
  * 
  * Manages vehicle generation, movement, and collision avoidance.
- * Vehicles follow roads and avoid parks, fountains, and other cars.
+ * Vehicles follow roads and avoid parks and fountains. Each car keeps its
+ * distance to the car ahead with the Intelligent Driver Model and queues
+ * at intersections another car is crossing.
+ * 
+ * The GPU backend (TrafficBackend::GPU) spawns the same cars and hands
+ * them to GpuTrafficSimulator, which steps them on the GPU where they
+ * are drawn; the main thread then only counts the fixed steps.
  * 
  * @author City Designer Team
  * @date November 2025
@@ -13,65 +19,215 @@
 #define TRAFFIC_GENERATOR_H
 
 #include <vector>
-#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
 #include <glm/glm.hpp>
+#include "core/world_extent.h"
+#include "utils/random_stream.h"
 #include "generation/road_generator.h"
+#include "generation/road_network.h"
+#include "features/traffic_system/traffic_lanes.h"
+
+class JobSystem;
+class TrafficRecorder;
+struct GpuTrafficSetup;
 
-// Single car entity
+// Where the cars are stepped
+enum class TrafficBackend {
+    CPU,    // TrafficGenerator steps TrafficData (car following, node claims, recording)
+    GPU     // GpuTrafficSimulator steps the cars in GPU buffers (free-flowing, for very large fleets)
+};
+
+// Single car entity (used when spawning or reading back one car)
 struct Car {
     float x, y;          // Current position
     float vx, vy;        // Velocity components
     float speed;         // Speed magnitude
+    float direction;     // +1 = travelling toward increasing road progress, -1 = backward
     int roadIndex;       // Which road segment it's on
     float roadProgress;  // Progress along the road (0-1)
+    int edgeIndex;       // Network edge it's on (-1 = road has no edges)
+    float edgeEnd;       // Road progress at which it reaches the next node
+    int nodeAhead;       // Network node at edgeEnd (-1 = road has no edges)
     glm::vec3 color;     // Car color
 };
 
-// Collection of all traffic data
+// Collection of all traffic data, stored as a structure of arrays so the
+// per-frame update streams only the fields it touches
 struct TrafficData {
-    std::vector<Car> cars;
+    std::vector<float> x, y;          // Current positions
+    std::vector<float> prevX, prevY;  // Positions at the previous fixed step (for interpolation)
+    std::vector<float> vx, vy;        // Velocity components
+    std::vector<float> headingX;      // Unit direction of travel (kept while a car is stopped)
+    std::vector<float> headingY;
+    std::vector<float> speed;         // Current speed magnitudes
+    std::vector<float> desiredSpeed;  // Speed each car drives at on a free road
+    std::vector<float> direction;     // +1 forward along the road, -1 backward
+    std::vector<float> progress;      // Progress along the road (0-1)
+    std::vector<float> progressRate;  // Progress per second (direction * speed / road length)
+    std::vector<int> roadIndex;       // Which road segment each car is on
+    std::vector<int> edgeIndex;       // Which network edge each car is on
+    std::vector<float> edgeEnd;       // Road progress of the node each car is heading for
+    std::vector<int> nodeAhead;       // That node (-1 = road has no edges)
+    std::vector<float> waitTime;      // Seconds spent held at the node ahead
+    std::vector<glm::vec3> color;     // Car colors (only read by the renderer)
+    
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+    void clear();
+    void reserve(size_t count);
+    
+    // Copy only what the renderer reads (positions, previous positions, headings,
+    // colors) into storage that is reused from call to call
+    void copyDrawState(const TrafficData& source);
+    
+    // Append a car with the given progress rate; it wants to keep its spawn speed
+    void addCar(const Car& car, float rate);
+    
+    // Gather one car back into a Car record
+    Car getCar(size_t index) const;
 };
 
 class TrafficGenerator {
+public:
+    // Simulation advances in fixed steps regardless of frame rate
+    static constexpr float FIXED_TIMESTEP = 1.0f / 60.0f;
+    static constexpr int MAX_STEPS_PER_UPDATE = 5;   // Drop time beyond this after a hitch
+    
+    // Car following (Intelligent Driver Model), in pixels and seconds
+    static constexpr float CAR_LENGTH = 16.0f;           // Bumper to bumper length of a car
+    static constexpr float MIN_GAP = 4.0f;               // Gap kept to a stopped car ahead
+    static constexpr float TIME_HEADWAY = 1.0f;          // Following distance in seconds of travel
+    static constexpr float MAX_ACCELERATION = 30.0f;
+    static constexpr float COMFORT_BRAKING = 45.0f;      // Deceleration a car plans for
+    static constexpr float MAX_BRAKING = 300.0f;         // Emergency deceleration limit
+    
+    // Intersections
+    static constexpr uint32_t NODE_CLEAR_STEPS = 30;     // Steps a node stays claimed by the car crossing it
+    static constexpr float MAX_WAIT_TIME = 4.0f;         // A car held this long crosses anyway (breaks gridlock)
+    
 private:
     TrafficData trafficData;
-    std::mt19937 rng;
-    std::uniform_real_distribution<float> dist01;
+    RandomStream rng;   // Traffic stream of the city seed (reseeded per generation)
     
     // Collision data
-    std::vector<std::vector<Point>> parkAreas;
-    std::vector<Point> fountainArea;
+    std::vector<Circle> parkAreas;
+    Circle fountainArea;
+    
+    // Per-road lookup tables, rebuilt whenever the road set changes
+    std::vector<float> roadLengths;        // Arc length of each road in pixels
+    std::vector<uint32_t> blockedOffsets;  // Road r owns intervals [blockedOffsets[r], blockedOffsets[r + 1])
+    std::vector<float> blockedIntervals;   // (start, end) progress pairs that lie inside a park or the fountain
     
-    // Screen dimensions for boundary checking
-    int screenWidth;
-    int screenHeight;
+    // City bounds (world units) for boundary checking
+    WorldExtent extent;
+    
+    // Car following state
+    TrafficLanes lanes;                    // Cars per road and direction, rear to front
+    std::vector<float> nextSpeed;          // Speed each car takes in the current step
+    std::vector<uint32_t> nodeBusyUntil;   // Per network node: step until which a crossing car holds it
+    
+    // Fixed-timestep state
+    float timeAccumulator;   // Frame time not yet consumed by a fixed step
+    uint32_t stepCount;      // Fixed steps since the traffic was generated
+    int maxStepsPerUpdate;   // Steps one updateTraffic() takes at most (<= MAX_STEPS_PER_UPDATE)
+    JobSystem* jobSystem;    // Optional worker pool for stepping cars in chunks
+    TrafficRecorder* recorder;  // Optional sink for the state after every fixed step
+    
+    // GPU backend
+    TrafficBackend backend;
+    std::shared_ptr<const GpuTrafficSetup> gpuSetup;   // Cars handed to the GPU (nullptr with the CPU backend)
     
     // Helper to get random color for cars
     glm::vec3 getRandomCarColor();
     
-    // Helper to check if a position is inside a circular area
-    bool isInsideCircle(float x, float y, const std::vector<Point>& circlePoints);
+    // Helper to check if a position is inside any park or the fountain
+    bool isInsideObstacle(float x, float y) const;
+    
+    // Precompute road lengths and the progress intervals blocked by obstacles
+    void buildRoadTables(const std::vector<Road>& roads);
+    
+    // Check a road progress value against the blocked-interval table
+    bool isProgressBlocked(int roadIndex, float progress) const;
+    
+    // Progress per second for a car travelling at speed on a road
+    float progressRateFor(int roadIndex, float speed) const;
+    
+    // Move a car that reached a node onto a random connected edge (or turn it around).
+    // Returns false if the node is claimed or the chosen lane has no room at its start.
+    bool enterNextEdge(size_t index, const std::vector<Road>& roads, const RoadNetwork& network);
+    
+    // Place a car at the start of an edge (startT -> endT on road, ending at node)
+    void enterEdge(size_t index, int road, int edge, int node, float startT, float endT,
+                   const std::vector<Road>& roads);
+    
+    // Check that a car entering road at startT heading to endT would not land on or just in front of another car
+    bool isLaneEntryClear(size_t index, int road, float startT, float endT) const;
+    
+    // Stop a car at the node it reached because it may not cross yet
+    void holdAtNode(size_t index, const std::vector<Road>& roads);
+    
+    // Advance every car by one fixed step (previous positions become prevX/prevY)
+    void stepTraffic(const std::vector<Road>& roads, const RoadNetwork& network);
+    
+    // Car-following speeds of cars [begin, end) for the next step (reads each car's leader only)
+    void planSpeeds(size_t begin, size_t end, const std::vector<Road>& roads);
+    
+    // Advance cars [begin, end) by one fixed step; safe to run concurrently on disjoint ranges
+    void stepCars(size_t begin, size_t end, const std::vector<Road>& roads);
+    
+    // Move the spawned cars and the road graph into gpuSetup (trafficData is left empty)
+    void buildGpuSetup(const std::vector<Road>& roads, const RoadNetwork& network, uint64_t seed);
     
 public:
     TrafficGenerator();
     
-    // Generate cars along roads (with collision avoidance)
-    void generateTraffic(const std::vector<Road>& roads, int numCars,
-                        const std::vector<std::vector<Point>>& parks,
-                        const std::vector<Point>& fountain,
-                        int screenWidth, int screenHeight);
+    // Generate cars along roads (with collision avoidance); the same seed places the same cars
+    void generateTraffic(const std::vector<Road>& roads, const RoadNetwork& network, int numCars,
+                        const std::vector<Circle>& parks,
+                        const Circle& fountain,
+                        const WorldExtent& extent,
+                        uint64_t seed);
+    
+    // Consume frame time in fixed steps and update car positions (with collision avoidance)
+    void updateTraffic(float deltaTime, const std::vector<Road>& roads, const RoadNetwork& network);
+    
+    // Run car steps on a worker pool (nullptr = step on the calling thread)
+    void setJobSystem(JobSystem* jobs) { jobSystem = jobs; }
+    
+    // Hand every fixed step to a recorder while it is recording (nullptr = no recording)
+    void setRecorder(TrafficRecorder* sink) { recorder = sink; }
+    
+    // Cap the steps per updateTraffic() (1 to MAX_STEPS_PER_UPDATE); a lower cap bounds the
+    // cost of a slow frame, and the cars fall behind real time instead of catching up
+    void setMaxStepsPerUpdate(int steps) { maxStepsPerUpdate = std::min(std::max(steps, 1), MAX_STEPS_PER_UPDATE); }
+    
+    // Backend of the next generateTraffic() (the current cars keep theirs)
+    void setBackend(TrafficBackend use) { backend = use; }
+    TrafficBackend getBackend() const { return backend; }
+    
+    // Cars of the GPU backend at step 0 (nullptr unless generated with TrafficBackend::GPU)
+    const std::shared_ptr<const GpuTrafficSetup>& getGpuSetup() const { return gpuSetup; }
+    
+    // Fixed steps since the traffic was generated (the GPU backend catches up to this)
+    uint32_t getStepCount() const { return stepCount; }
     
-    // Update car positions based on time (with collision avoidance)
-    void updateTraffic(float deltaTime, const std::vector<Road>& roads);
+    // Blend factor (0-1) between the previous and current fixed-step positions
+    float getInterpolationAlpha() const { return timeAccumulator / FIXED_TIMESTEP; }
     
-    // Get traffic data
+    // Get traffic data (empty with the GPU backend, whose cars only exist on the GPU)
     const TrafficData& getTrafficData() const { return trafficData; }
     
     // Check if traffic exists
-    bool hasTraffic() const { return !trafficData.cars.empty(); }
+    bool hasTraffic() const { return !trafficData.empty() || gpuSetup != nullptr; }
     
     // Clear traffic
-    void clear() { trafficData.cars.clear(); }
+    void clear() {
+        trafficData.clear();
+        lanes.clear();
+        gpuSetup.reset();
+    }
 };
 
 #endif
@@ -0,0 +1,77 @@
+/**
+ * @file traffic_recorder.h
+ * @brief Traffic Recording to a .traffic File
+ * 
+ * Captures the car states of every fixed simulation step so a run can be
+ * replayed exactly as it was simulated (see TrafficReplay) or analysed
+ * offline. States are quantized and delta-compressed in memory and
+ * written a chunk at a time, so recording costs one pass over the cars
+ * per step and an occasional sequential write.
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef TRAFFIC_RECORDER_H
+#define TRAFFIC_RECORDER_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "core/world_extent.h"
+#include "features/traffic_system/traffic_file_format.h"
+
+struct TrafficData;
+
+class TrafficRecorder {
+public:
+    static constexpr const char* DEFAULT_NAME = "traffic_recording";   // Recording toggled by F5
+    static constexpr uint32_t DEFAULT_KEYFRAME_INTERVAL = 120;          // Two seconds of fixed steps
+    
+    TrafficRecorder();
+    ~TrafficRecorder() { stop(); }
+    
+    TrafficRecorder(const TrafficRecorder&) = delete;
+    TrafficRecorder& operator=(const TrafficRecorder&) = delete;
+    
+    // Path of a recording in the save directory (filename without extension)
+    static std::string getRecordingPath(const std::string& filename);
+    
+    // Start a recording with cars as its first tick (stops any recording in progress)
+    bool start(const std::string& filename, const TrafficData& cars, const WorldExtent& extent,
+               uint64_t seed, float tickSeconds, uint32_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+    
+    // Append the state after one fixed step; a change in car count ends the recording
+    void recordTick(const TrafficData& cars);
+    
+    // Write the last chunk and the chunk index; returns false if anything failed to write
+    bool stop();
+    
+    bool isRecording() const { return recording; }
+    uint32_t getTickCount() const { return tickCount; }
+
+private:
+    // Write the open chunk (if it has ticks) and start a new one
+    bool flushChunk();
+    
+    // Report a failed write and abandon the recording
+    void fail(const char* what);
+    
+    std::ofstream file;
+    std::string path;
+    bool recording;
+    TrafficFileFormat::Header header;
+    uint64_t written;                                        // Bytes written so far
+    
+    std::vector<TrafficFileFormat::KeyframeRecord> current;  // Quantized cars of the last tick
+    std::vector<TrafficFileFormat::KeyframeRecord> next;     // Quantized cars of the tick being added
+    std::vector<unsigned char> payload;                      // Open chunk after its header
+    std::vector<unsigned char> frame;                        // Delta frame being encoded
+    uint32_t chunkFirstTick;
+    uint32_t chunkTicks;
+    uint32_t tickCount;
+    std::vector<TrafficFileFormat::ChunkIndexRecord> index;  // Chunks already written
+};
+
+#endif
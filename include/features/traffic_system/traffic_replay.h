@@ -0,0 +1,91 @@
+/**
+ * @file traffic_replay.h
+ * @brief Playback of a .traffic Recording
+ * 
+ * Plays a recording written by TrafficRecorder back in real time and
+ * exposes each tick as TrafficData, so CityRenderer draws a replay the
+ * same way as live traffic. The file is memory-mapped; seeking jumps to
+ * the keyframe of the chunk holding the target tick and decodes forward
+ * from there, so any tick is at most one chunk of delta frames away.
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef TRAFFIC_REPLAY_H
+#define TRAFFIC_REPLAY_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "features/traffic_system/traffic_file_format.h"
+#include "features/traffic_system/traffic_generator.h"
+
+struct MappedFile;
+
+class TrafficReplay {
+public:
+    TrafficReplay();
+    ~TrafficReplay();
+    
+    TrafficReplay(const TrafficReplay&) = delete;
+    TrafficReplay& operator=(const TrafficReplay&) = delete;
+    
+    // Map and validate a recording (filename without extension) and show its first tick
+    bool open(const std::string& filename);
+    
+    void close();
+    
+    bool isOpen() const { return mapping != nullptr; }
+    
+    // Show the state at tick (clamped to the recording); false if the data is corrupt
+    bool seek(uint32_t tick);
+    
+    // Advance in real time; stops on the last tick
+    void update(float deltaTime);
+    
+    uint32_t getTick() const { return tick; }
+    uint32_t getTickCount() const { return tickCount; }
+    float getTickSeconds() const { return header.tickSeconds; }
+    bool isFinished() const { return tick + 1 >= tickCount; }
+    uint64_t getSeed() const { return header.seed; }
+    
+    // Blend factor (0-1) between the previous and current tick
+    float getInterpolationAlpha() const { return timeAccumulator / header.tickSeconds; }
+    
+    // Cars of the current tick: positions (with the previous tick as prevX/prevY),
+    // headings, speeds and colors; the simulation-only fields are empty
+    const TrafficData& getTrafficData() const { return cars; }
+
+private:
+    // Load the keyframe of chunk as the current tick
+    bool loadKeyframe(size_t chunk);
+    
+    // Apply the next delta frame of the current chunk (or open the next chunk)
+    bool decodeTick();
+    
+    // Convert the quantized states into cars
+    void publish();
+    
+    // Report corrupt data and close the replay
+    bool fail(const char* what);
+    
+    std::unique_ptr<MappedFile> mapping;
+    std::string path;
+    TrafficFileFormat::Header header;
+    std::vector<TrafficFileFormat::ChunkIndexRecord> chunks;
+    uint32_t tickCount;
+    
+    size_t chunkIndex;                  // Chunk holding the current tick
+    const unsigned char* cursor;        // Next delta frame of that chunk
+    const unsigned char* chunkEnd;
+    uint32_t tick;
+    float timeAccumulator;
+    
+    std::vector<TrafficFileFormat::KeyframeRecord> state;     // Quantized cars of the current tick
+    std::vector<TrafficFileFormat::KeyframeRecord> previous;  // Quantized cars of the previous tick
+    TrafficData cars;
+};
+
+#endif
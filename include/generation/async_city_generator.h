@@ -0,0 +1,119 @@
+/**
+ * @file async_city_generator.h
+ * @brief Background City Generation
+ *
+ * Runs CityGenerator on a worker thread so the window keeps rendering
+ * while a city is built. The worker publishes snapshots of the city:
+ * first the parks and roads, then the buildings phase by phase, then the
+ * finished city. The main loop takes the newest snapshot once per frame
+ * and shows it; snapshots it was too slow to see are dropped.
+ *
+ * A new request cancels the one in progress, so changing the settings
+ * mid-generation never waits for a stale city to finish.
+ *
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef ASYNC_CITY_GENERATOR_H
+#define ASYNC_CITY_GENERATOR_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "generation/city_generator.h"
+#include "utils/cancellation_token.h"
+#include "utils/job_system.h"
+
+/**
+ * @class AsyncCityGenerator
+ * @brief One worker thread that generates the most recently requested city
+ *
+ * All public methods are called from the main thread. The generator
+ * owns its own worker pool: the main loop's pool runs traffic and mesh
+ * jobs concurrently, and a JobSystem runs one parallelFor at a time.
+ */
+class AsyncCityGenerator {
+public:
+    /**
+     * @brief Start the worker thread (idle until start())
+     * @param extent City bounds in world units
+     * @param workerCount Threads of the generation pool
+     */
+    explicit AsyncCityGenerator(const WorldExtent& extent = WorldExtent(),
+                                unsigned workerCount = JobSystem::defaultWorkerCount());
+
+    /**
+     * @brief Cancel any generation and join the worker
+     */
+    ~AsyncCityGenerator();
+
+    AsyncCityGenerator(const AsyncCityGenerator&) = delete;
+    AsyncCityGenerator& operator=(const AsyncCityGenerator&) = delete;
+
+    /**
+     * @brief Generate a city from config in the background
+     *
+     * Cancels the generation in progress (its snapshots are no longer
+     * published) and returns immediately.
+     */
+    void start(const CityConfig& config);
+
+    /**
+     * @brief Abandon the requested city; nothing more is published for it
+     */
+    void cancel();
+
+    /**
+     * @brief True from start() until the finished city was taken or cancel()
+     */
+    bool isBusy() const { return busy; }
+
+    /**
+     * @brief Settings of the most recent start()
+     */
+    const CityConfig& getConfig() const { return requestedConfig; }
+
+    /**
+     * @brief Take the newest snapshot of the requested city, if one arrived
+     * @param city Receives the snapshot (isGenerated is set, even on partial cities)
+     * @param complete Set to true if it is the finished city
+     * @return false if nothing new was published since the last call
+     *
+     * Parks, fountain and roads of every snapshot are final; only the
+     * buildings grow.
+     */
+    bool takeSnapshot(CityData& city, bool& complete);
+
+private:
+    /**
+     * @brief Worker loop: wait for a request, generate it, repeat
+     */
+    void run();
+
+    /**
+     * @brief Make city the newest snapshot if it still belongs to the latest request
+     */
+    void publish(CityData city, uint64_t request, bool complete);
+
+    JobSystem jobs;                     ///< Generation pool, used only by the worker
+    CityGenerator generator;            ///< Used only by the worker
+    CancellationToken cancelToken;      ///< Stops the generation in progress
+
+    std::mutex mutex;                   ///< Guards everything below up to the thread
+    std::condition_variable wake;       ///< Signals a new request or shutdown
+    CityConfig pendingConfig;           ///< Request not yet picked up by the worker
+    uint64_t requestId;                 ///< Incremented by every start() and cancel()
+    bool hasPending;
+    bool stopping;
+    CityData snapshot;                  ///< Newest published city
+    bool hasSnapshot;
+    bool snapshotComplete;
+    std::thread worker;
+
+    // Main thread only
+    CityConfig requestedConfig;
+    bool busy;
+};
+
+#endif // ASYNC_CITY_GENERATOR_H
@@ -22,9 +22,17 @@
 #define CITY_GENERATOR_H
 
 #include <vector>
+#include <functional>
 #include "core/city_config.h"
+#include "core/world_extent.h"
 #include "generation/road_generator.h"
+#include "generation/road_network.h"
+#include "generation/placement_index.h"
 #include "utils/algorithms.h"
+#include "utils/random_stream.h"
+
+class JobSystem;
+class CancellationToken;
 
 /**
  * @enum BuildingType
@@ -80,36 +88,71 @@ struct Building {
  * 
  * This structure holds the complete city state including:
  * - Roads: Network of connected road segments
- * - Parks: Circular green spaces (array of boundary points)
+ * - Network: Intersection graph derived from the roads
+ * - Parks: Circular green spaces (center + radius)
  * - Fountain: Special central circular feature
  * - Buildings: 3D structures with positions and heights
  * 
  * The isGenerated flag tracks whether a valid city exists.
  * This data can be serialized to JSON for save/load functionality.
+ * 
+ * placementIndex is derived like the network. Code that adds buildings
+ * goes through addBuilding(), which keeps it current; code that fills
+ * the arrays directly (loaders) calls rebuildIndex() afterwards.
  */
 struct CityData {
     std::vector<Road> roads;                    ///< Road network (Bresenham lines)
-    std::vector<std::vector<Point>> parks;      ///< Parks (each is circle of points)
-    std::vector<Point> fountain;                ///< Central fountain (circle points)
+    RoadNetwork network;                        ///< Intersection graph over roads (derived)
+    std::vector<Circle> parks;                  ///< Parks (analytic circles)
+    Circle fountain;                            ///< Central fountain (radius 0 = none)
     std::vector<Building> buildings;            ///< 3D building structures
+    WorldExtent extent;                         ///< City bounds in world units
+    uint64_t seed;                              ///< Seed the city was generated from (0 = unknown)
     bool isGenerated;                           ///< True if city has been generated
+    PlacementIndex placementIndex;              ///< Collision index over the above (derived)
     
     /**
      * @brief Construct empty city data
      */
-    CityData() : isGenerated(false) {}
+    CityData() : seed(0), isGenerated(false) {}
     
     /**
      * @brief Clear all city data
-     * Resets to empty state, ready for new generation
+     * Resets to empty state, ready for new generation (the extent is kept)
      */
     void clear() {
         roads.clear();
+        network.clear();
         parks.clear();
-        fountain.clear();
+        fountain = Circle();
         buildings.clear();
+        seed = 0;
         isGenerated = false;
+        placementIndex.clear();
     }
+    
+    /**
+     * @brief Append a building and index it
+     */
+    void addBuilding(const Building& building);
+    
+    /**
+     * @brief Index the parks, fountain, roads and buildings from scratch
+     */
+    void rebuildIndex();
+    
+    /**
+     * @brief First placement rule a building footprint would break
+     * @param x Center X position
+     * @param y Center Y position
+     * @param width Building width
+     * @param depth Building depth
+     * @return PlacementConflict::NONE if the building can be placed
+     * 
+     * Only items near the footprint are tested, so it is cheap enough to
+     * run at mouse rate (hover previews).
+     */
+    PlacementConflict findPlacementConflict(float x, float y, float width, float depth) const;
 };
 
 /**
@@ -132,27 +175,115 @@ struct CityData {
  * 
  * The generator maintains screen boundaries and proper spacing
  * between all elements using configurable buffer zones.
+ * 
+ * Parallel generation: building placement is split into square tiles,
+ * each with its own random stream, run in four phases so that the tiles
+ * of one phase are a full tile apart and cannot produce conflicting
+ * buildings. Later phases see the buildings of earlier ones, which
+ * resolves conflicts at tile borders. The road network is rasterized
+ * while the tiles pre-sample their first candidates. The result depends
+ * only on the config (and its seed), never on the thread count.
+ * 
+ * Background generation: a progress callback sees the city after the
+ * roads and after every building phase, and a cancellation token is
+ * polled between those steps (see AsyncCityGenerator).
  */
 class CityGenerator {
+public:
+    static constexpr int PLACEMENT_TILE_SIZE = 200;      ///< Minimum tile edge in world units
+    static constexpr int ATTEMPTS_PER_BUILDING = 50;     ///< Candidate budget per requested building
+    static constexpr int PRESAMPLED_PER_BUILDING = 4;    ///< Candidates drawn while roads are built
+    static constexpr int MAX_PLACEMENT_ROUNDS = 3;       ///< Rounds that move unmet quota to other tiles
+    
 private:
     RoadGenerator roadGen;      ///< Road network generator instance
     CityData cityData;          ///< Container for all generated elements
-    int screenWidth;            ///< Screen width in pixels (800)
-    int screenHeight;           ///< Screen height in pixels (600)
+    WorldExtent extent;         ///< Bounds of the next generated city (world units)
+    bool verbose;               ///< Print generation progress to stdout
+    RandomStream placementRng;  ///< Heights for interactive placement (reseeded per city)
+    JobSystem* jobSystem;       ///< Optional worker pool for tiled generation
+    std::function<void(const CityData&)> progressCallback;  ///< Optional, called between steps
+    const CancellationToken* cancelToken;  ///< Token of the running generateCity (nullptr = none)
+    
+    /// A building drawn for a tile, not yet checked against roads and buildings
+    struct BuildingCandidate {
+        float x, y, width, depth, height;
+        BuildingType type;
+    };
+    
+    /// One square of the world whose buildings are placed independently
+    struct PlacementTile {
+        int minX, minY, maxX, maxY;     ///< Building centres are drawn from this integer box
+        int phase;                      ///< 0-3; tiles of one phase are a tile apart
+        RandomStream rng;               ///< Tile stream of the city seed
+        int quota;                      ///< Buildings requested from the tile so far
+        int attemptLimit;               ///< Candidates the tile may draw so far
+        int attempts;                   ///< Candidates drawn
+        std::vector<BuildingCandidate> presampled;  ///< Drawn early; passed the edge/park checks
+        size_t nextPresampled;
+        std::vector<Building> placed;   ///< Accepted this phase, merged into cityData afterwards
+        
+        PlacementTile(const RandomStream& stream)
+            : minX(0), minY(0), maxX(0), maxY(0), phase(0), rng(stream),
+              quota(0), attemptLimit(0), attempts(0), nextPresampled(0) {}
+    };
+    
+    std::vector<PlacementTile> placementTiles;  ///< Tiles of the city being generated
     
 public:
     /**
      * @brief Construct a new City Generator
-     * @param width Screen width in pixels
-     * @param height Screen height in pixels
+     * @param extent City bounds in world units
+     * 
+     * Initializes the road generator with the same bounds.
+     */
+    explicit CityGenerator(const WorldExtent& extent = WorldExtent());
+    
+    /**
+     * @brief Change the bounds of later generations
+     * @param newExtent City bounds in world units
+     * 
+     * The current city keeps its own extent until it is regenerated.
+     */
+    void setExtent(const WorldExtent& newExtent);
+    
+    /**
+     * @brief Bounds of the next generated city
+     */
+    const WorldExtent& getExtent() const { return extent; }
+    
+    /**
+     * @brief Enable or disable generation progress output (on by default)
+     * 
+     * Batch runs turn it off; generations on different threads would
+     * otherwise interleave their reports.
+     */
+    void setVerbose(bool enabled);
+    
+    /**
+     * @brief Generate on a worker pool (nullptr = everything on the calling thread)
      * 
-     * Initializes the road generator with screen dimensions.
+     * The pool must not be running another parallelFor while a city is
+     * generated (generating from inside one of its jobs would deadlock).
      */
-    CityGenerator(int width, int height);
+    void setJobSystem(JobSystem* jobs) { jobSystem = jobs; }
+    
+    /**
+     * @brief Report the partial city during generation (empty = no reports)
+     * 
+     * Called on the generating thread once the parks and roads are final
+     * and again after every building phase, with the city so far
+     * (isGenerated is still false). The city must not be kept: copy it.
+     */
+    void setProgressCallback(std::function<void(const CityData&)> callback) {
+        progressCallback = std::move(callback);
+    }
     
     /**
      * @brief Generate a complete city from scratch
      * @param config City configuration (parameters for generation)
+     * @param cancel Polled between steps; generation stops early once set
+     * @return false if cancelled (the city is left partial and not generated)
      * 
      * This is the main generation method that:
      * 1. Clears existing city data
@@ -164,7 +295,16 @@ public:
      * 
      * The entire process takes ~100-500ms depending on complexity.
      */
-    void generateCity(const CityConfig& config);
+    bool generateCity(const CityConfig& config, const CancellationToken* cancel = nullptr);
+    
+    /**
+     * @brief Replace the current city with one generated elsewhere
+     * @param city City to take over (a snapshot of a background generation)
+     * 
+     * The city brings its own placement index, so interactive placement
+     * works on it straight away.
+     */
+    void adoptCity(CityData&& city);
     
     /**
      * @brief Get read-only access to city data
@@ -195,14 +335,13 @@ public:
      * @return true if building was successfully placed
      * 
      * This method supports Feature 4 (Click-to-Place Buildings).
-     * It performs comprehensive collision checks:
-     * - Screen boundaries (60px margin)
-     * - Roads (20px buffer)
-     * - Parks (35px buffer)
-     * - Fountain (35px buffer)
+     * It applies the same rules as generation (CityData::findPlacementConflict):
+     * - City boundaries (60px margin)
+     * - Roads (5px beyond the road's half width)
+     * - Parks and fountain (35px buffer)
      * - Existing buildings (25px buffer)
      * 
-     * If all checks pass, creates a MID_RISE building.
+     * If all checks pass, creates a building of the configured skyline.
      * Used only in 2D view mode.
      */
     bool placeBuilding(float x, float y, const CityConfig& config);
@@ -214,8 +353,10 @@ private:
      * 
      * Creates circular parks by:
      * 1. Finding valid random positions (avoiding roads)
-     * 2. Using midpoint circle algorithm to generate boundary
-     * 3. Adding to cityData.parks vector
+     * 2. Adding the circle (center + radius) to cityData.parks
+     * 
+     * The boundary is only rasterized (midpoint circle algorithm) by the
+     * 2D renderer.
      * 
      * Also creates the central fountain as a special park.
      */
@@ -231,31 +372,52 @@ private:
      * - Avoiding other buildings (with buffer)
      * - Staying within screen boundaries
      * 
-     * Uses multiple attempts per building (up to 100 tries)
-     * to find valid positions. Buildings vary in height
-     * based on skyline type configuration.
+     * Each tile rejection-samples its share of the buildings (up to
+     * ATTEMPTS_PER_BUILDING tries each); tiles run in parallel within a
+     * phase. Quota a full tile could not meet moves to tiles that met
+     * theirs in the next round. Requires planPlacementTiles().
      */
     void generateBuildings(const CityConfig& config);
     
     /**
-     * @brief Check if position is valid for building placement
-     * @param x Center X position
-     * @param y Center Y position
-     * @param width Building width
-     * @param depth Building depth
-     * @return true if position is valid (no collisions)
+     * @brief Split the sampling area into tiles and share out the building count
+     */
+    void planPlacementTiles(const CityConfig& config);
+    
+    /**
+     * @brief Draw a tile's first candidates, keeping those clear of edges and parks
      * 
-     * Performs comprehensive collision detection:
-     * 1. Screen boundary check (60px margin)
-     * 2. Building-building AABB collision (25px buffer)
-     * 3. Building-park circle collision (35px buffer)
-     * 4. Building-fountain circle collision (35px buffer)
-     * 5. Building-road point collision (checked per road point)
+     * Needs only the parks, so it runs while the roads are generated.
+     */
+    void presampleTile(PlacementTile& tile, const CityConfig& config) const;
+    
+    /**
+     * @brief Place buildings in a tile until its quota or attempt limit is reached
      * 
-     * This is the core validation used by both automatic
-     * generation and interactive placement.
+     * Reads the shared index (earlier phases) and writes only the tile,
+     * so tiles of one phase can run concurrently.
+     */
+    void placeTileBuildings(PlacementTile& tile, const CityConfig& config) const;
+    
+    /**
+     * @brief Draw the next candidate of a tile's stream
+     */
+    static BuildingCandidate sampleCandidate(PlacementTile& tile, const CityConfig& config);
+    
+    /**
+     * @brief True once the running generation was asked to stop
+     */
+    bool isCancelled() const;
+    
+    /**
+     * @brief Pass the city so far to the progress callback, if there is one
+     */
+    void reportProgress() const;
+    
+    /**
+     * @brief Run job(i) for i in [0, count), on the job system when there is one
      */
-    bool isValidBuildingPosition(float x, float y, float width, float depth) const;
+    void forEach(size_t count, const std::function<void(size_t)>& job) const;
 };
 
 #endif // CITY_GENERATOR_H
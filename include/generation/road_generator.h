@@ -31,23 +31,26 @@
 #define ROAD_GENERATOR_H
 
 #include <vector>
-#include <random>
 #include "utils/algorithms.h"
 #include "core/city_config.h"
+#include "core/world_extent.h"
+#include "utils/random_stream.h"
 
 /**
  * @struct Road
  * @brief Represents a single road segment
  * 
- * A road is defined by a sequence of points generated using
- * Bresenham's Line Algorithm. Each road has a width that
- * determines how thick it appears when rendered.
+ * A road is stored compactly as a polyline: only the segment endpoints
+ * (a straight Bresenham road is just its two end points). The per-pixel
+ * Bresenham form is computed on demand with rasterize() for the places
+ * that really need pixels (2D point rendering). Each road has a width
+ * that determines how thick it appears when rendered.
  * 
  * In 2D view, roads are rendered as lines.
  * In 3D view, roads become textured 3D meshes (flat rectangles).
  */
 struct Road {
-    std::vector<Point> points;  ///< Points along road (Bresenham output)
+    std::vector<Point> path;    ///< Polyline vertices (segment endpoints)
     int width;                  ///< Road width in pixels (default: 14)
     
     /**
@@ -56,11 +59,65 @@ struct Road {
     Road() : width(8) {}
     
     /**
-     * @brief Construct road with specific points and width
-     * @param pts Points along the road path
+     * @brief Construct road with specific polyline and width
+     * @param pts Polyline vertices along the road path
      * @param w Road width in pixels
      */
-    Road(const std::vector<Point>& pts, int w) : points(pts), width(w) {}
+    Road(const std::vector<Point>& pts, int w) : path(pts), width(w) {}
+    
+    /**
+     * @brief Rasterize the polyline into Bresenham pixels
+     * @return std::vector<Point> Every pixel along the road, in order
+     */
+    std::vector<Point> rasterize() const;
+    
+    /**
+     * @brief Number of pixels rasterize() produces
+     */
+    size_t rasterizedLength() const { return bresenhamPolylineLength(path.data(), path.size()); }
+    
+    /**
+     * @brief Rasterize into a caller-provided buffer
+     * @param out Receives rasterizedLength() points
+     * @return size_t Number of points written
+     */
+    size_t rasterize(Point* out) const { return bresenhamPolyline(path.data(), path.size(), out); }
+    
+    /**
+     * @brief Total polyline length in pixels
+     */
+    float length() const;
+    
+    /**
+     * @brief Sample a position and direction along the road
+     * @param t Arc-length parameter (0 = start, 1 = end), clamped
+     * @param x Output X position in pixels
+     * @param y Output Y position in pixels
+     * @param dirX Output unit direction X (0 for a degenerate road)
+     * @param dirY Output unit direction Y (0 for a degenerate road)
+     */
+    void sample(float t, float& x, float& y, float& dirX, float& dirY) const;
+    
+    /**
+     * @brief Test whether any part of the road centerline touches a rectangle
+     * @param left Rectangle left edge in pixels
+     * @param top Rectangle top edge in pixels
+     * @param right Rectangle right edge in pixels
+     * @param bottom Rectangle bottom edge in pixels
+     * @return true if a polyline segment (or a lone point) lies in the rectangle
+     */
+    bool intersectsRect(float left, float top, float right, float bottom) const;
+    
+    /**
+     * @brief Build compact roads from a pixel chain
+     * @param pixels Ordered pixels (may contain gaps)
+     * @param width Road width in pixels
+     * @return std::vector<Road> One road per gap-free run
+     * 
+     * Used for obstacle filtering and for loading legacy saves that
+     * stored every pixel.
+     */
+    static std::vector<Road> fromPixels(const std::vector<Point>& pixels, int width);
 };
 
 /**
@@ -96,19 +153,28 @@ struct Road {
  */
 class RoadGenerator {
 private:
-    int screenWidth;    ///< Screen width (800) for boundary checks
-    int screenHeight;   ///< Screen height (600) for boundary checks
-    std::mt19937 rng;   ///< Mersenne Twister RNG for random patterns
+    WorldExtent extent; ///< City bounds in world units for boundary checks
+    bool verbose;       ///< Print progress to stdout
+    RandomStream rng;   ///< Road stream of the city seed (reseeded per generation)
     
 public:
     /**
      * @brief Construct a new Road Generator
-     * @param width Screen width in pixels
-     * @param height Screen height in pixels
+     * @param extent City bounds in world units
      * 
-     * Initializes RNG with random seed for non-deterministic generation.
+     * The RNG is reseeded from config.seed by every generateRoads call.
+     */
+    explicit RoadGenerator(const WorldExtent& extent);
+    
+    /**
+     * @brief Change the bounds used by later generations
+     */
+    void setExtent(const WorldExtent& newExtent) { extent = newExtent; }
+    
+    /**
+     * @brief Enable or disable progress output (on by default)
      */
-    RoadGenerator(int width, int height);
+    void setVerbose(bool enabled) { verbose = enabled; }
     
     /**
      * @brief Generate roads based on configuration pattern
@@ -125,21 +191,35 @@ public:
     std::vector<Road> generateRoads(const CityConfig& config);
     
     /**
-     * @brief Generate roads with obstacle avoidance (FUTURE FEATURE)
+     * @brief Generate roads with obstacle avoidance
      * @param config City configuration
      * @param parks Existing parks to avoid
      * @param fountain Existing fountain to avoid
      * @return std::vector<Road> Road network avoiding obstacles
      * 
-     * This method can be used for adaptive road generation
-     * that routes around pre-placed parks and fountains.
-     * Currently not used in main generation flow.
+     * Generates the pattern, then clips every road segment against the
+     * park and fountain circles analytically (see clipRoad()). The result
+     * is compact polylines, one per uncovered stretch, ready for the road
+     * mesher. Cost is O(segments x obstacles), independent of road length.
      */
     std::vector<Road> generateRoadsAvoidingObstacles(const CityConfig& config, 
-                                                       const std::vector<std::vector<Point>>& parks,
-                                                       const std::vector<Point>& fountain);
+                                                       const std::vector<Circle>& parks,
+                                                       const Circle& fountain);
     
 private:
+    /**
+     * @brief Append the parts of a road outside every circle to out
+     * @param road Road to clip
+     * @param circles Obstacles (pixels on a circle count as inside)
+     * @param out Receives one road per kept stretch
+     * @return int Number of segments that touched a circle
+     * 
+     * Keeps the pixels of each segment outside the circles' covered
+     * intervals, as pixel-by-pixel filtering would, without rasterizing;
+     * cut ends are moved onto pixels outside every circle.
+     */
+    static int clipRoad(const Road& road, const std::vector<Circle>& circles, std::vector<Road>& out);
+    
     /**
      * @brief Generate grid-based (Manhattan) road network
      * @param config City configuration
@@ -148,7 +228,7 @@ private:
      * Creates a regular grid of roads:
      * - Horizontal roads: top to bottom at regular intervals
      * - Vertical roads: left to right at regular intervals
-     * - Spacing: (screenWidth - 2*margin) / layoutSize
+     * - Spacing: (extent.width - 2*margin) / layoutSize
      * 
      * Example for layoutSize=10:
      * - 11 horizontal roads (0 to 10)
@@ -196,13 +276,11 @@ private:
      * @param x1 Ending X coordinate
      * @param y1 Ending Y coordinate
      * @param width Road width in pixels
-     * @return Road Road segment with all points
+     * @return Road Road segment stored as its two endpoints
      * 
      * Implementation details:
-     * - Uses Bresenham's algorithm from algorithms.cpp
-     * - Integer-only arithmetic (fast)
-     * - Perfect line with no gaps
-     * - Handles all octants (all directions)
+     * - Only the endpoints are stored; Road::rasterize() runs Bresenham's
+     *   algorithm from algorithms.cpp when pixels are needed
      * - Width parameter stored but not used in point generation
      */
     Road createRoad(int x0, int y0, int x1, int y1, int width);
@@ -0,0 +1,97 @@
+/**
+ * @file road_network.h
+ * @brief Road Network Graph
+ * 
+ * Turns the generated road polylines into a graph: nodes at road
+ * endpoints and crossings, edges for the stretches of road between
+ * consecutive nodes. Adjacency is stored in CSR form (one offsets array,
+ * one flat index array) so "which edges leave this node" is a slice
+ * lookup with no searching.
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef ROAD_NETWORK_H
+#define ROAD_NETWORK_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "generation/road_generator.h"
+
+/**
+ * @struct RoadNode
+ * @brief Intersection or dead end, in pixel coordinates
+ */
+struct RoadNode {
+    float x;
+    float y;
+};
+
+/**
+ * @struct RoadEdge
+ * @brief Stretch of one road between two adjacent nodes
+ * 
+ * startT/endT are Road::sample() parameters with startT < endT, so an
+ * edge is travelled forward from startNode or backward from endNode.
+ */
+struct RoadEdge {
+    uint32_t road;        ///< Index into CityData::roads
+    float startT;         ///< Road parameter at startNode
+    float endT;           ///< Road parameter at endNode
+    uint32_t startNode;   ///< Node at startT
+    uint32_t endNode;     ///< Node at endT
+    
+    /**
+     * @brief The node at the other end of the edge
+     */
+    uint32_t otherNode(uint32_t node) const { return node == startNode ? endNode : startNode; }
+};
+
+/**
+ * @struct RoadNetwork
+ * @brief Graph over a road list with CSR adjacency
+ * 
+ * Derived data: it is rebuilt from the roads after generation or load
+ * and never saved.
+ */
+struct RoadNetwork {
+    std::vector<RoadNode> nodes;
+    std::vector<RoadEdge> edges;
+    std::vector<uint32_t> nodeEdgeOffsets;   ///< Node n's edges are nodeEdges[offsets[n], offsets[n + 1])
+    std::vector<uint32_t> nodeEdges;         ///< Edge indices grouped by node
+    std::vector<uint32_t> roadEdgeOffsets;   ///< Road r's edges are edges[offsets[r], offsets[r + 1]), by t
+    
+    /**
+     * @brief Build the graph from a road list
+     * @param roads Road polylines
+     * 
+     * Endpoints on the same pixel share a node, an endpoint
+     * within half a road width of another road's centerline joins it
+     * (T-junction), and every crossing of two centerlines becomes a node
+     * on both roads.
+     */
+    void build(const std::vector<Road>& roads);
+    
+    void clear();
+    bool empty() const { return edges.empty(); }
+    
+    /**
+     * @brief Number of edges meeting at a node
+     */
+    uint32_t degree(uint32_t node) const { return nodeEdgeOffsets[node + 1] - nodeEdgeOffsets[node]; }
+    
+    /**
+     * @brief The i-th edge meeting at a node (i < degree(node))
+     */
+    uint32_t nodeEdge(uint32_t node, uint32_t i) const { return nodeEdges[nodeEdgeOffsets[node] + i]; }
+    
+    /**
+     * @brief Find the edge of a road that contains parameter t
+     * @return Edge index, or -1 if the road has no edges
+     */
+    int findEdge(uint32_t road, float t) const;
+};
+
+#endif // ROAD_NETWORK_H
@@ -18,10 +18,23 @@
 
 #include <glad/glad.h>
 #include <vector>
+#include <functional>
+#include <memory>
+#include <unordered_map>
 #include "generation/city_generator.h"
 #include "features/traffic_system/traffic_generator.h"
 #include "rendering/shaders/shader_manager.h"
+#include "rendering/texture_manager.h"
+#include "rendering/mesh/mesh_utils.h"
+#include "rendering/mesh/building_mesh.h"
+#include "rendering/frustum.h"
+#include "rendering/occlusion_buffer.h"
 #include "core/city_config.h"
+#include "utils/profiler.h"
+#include "utils/frame_arena.h"
+
+class JobSystem;
+class GpuTrafficSimulator;
 
 /**
  * @class CityRenderer
@@ -37,10 +50,11 @@ class CityRenderer {
 public:
     /**
      * @brief Construct a new City Renderer
-     * @param screenWidth Window width in pixels
-     * @param screenHeight Window height in pixels
+     * 
+     * Meshes are built in render space from each city's own extent, so the
+     * renderer does not depend on the window size.
      */
-    CityRenderer(int screenWidth, int screenHeight);
+    CityRenderer();
     
     /**
      * @brief Destroy the City Renderer and cleanup all buffers
@@ -48,40 +62,187 @@ public:
     ~CityRenderer();
     
     /**
-     * @brief Update rendering data when city changes or view mode changes
+     * @brief Update rendering data when the city changes
      * @param city City data to render
-     * @param view3D Whether to use 3D rendering mode
      * 
-     * Regenerates all VAO/VBO buffers for the current city and view mode.
+     * Regenerates all VAO/VBO buffers for the current city.
+     * Meshes of the same kind are packed into one batch buffer (roads,
+     * parks, 2D points), so the whole city draws in a handful of calls
+     * regardless of object count. Buildings are instances of one unit box:
+     * each is a record of its packed fields in an instance buffer, sorted
+     * by type, and the vertex shader scales and places the box.
      * Automatically cleans up old buffers before creating new ones.
+     * 
+     * Both views stay resident: 3D meshes are built once in world space
+     * (Y up) and the 2D view draws them through a Y/Z-swapping view matrix
+     * next to the 2D point batch, so switching views uploads nothing.
+     * 
+     * Runs in two phases: every mesh is built and packed on the job
+     * system (see setJobSystem()) without touching GL, then each batch is
+     * uploaded with a single glBufferData per buffer.
+     */
+    void updateCity(const CityData& city);
+    
+    /// Static meshes (roads, parks, fountain, 2D points) of one city, built without GL
+    struct PreparedMeshes;
+    
+    /**
+     * @brief Build a city's static meshes on any thread (phase one of updateCity())
+     * @param city City data the meshes are built from
+     * @param jobs Worker pool for the meshing jobs (nullptr = the calling thread)
+     * @return Meshes to pass to addTile() on the render thread
+     * 
+     * Makes no GL calls and touches no renderer, so loaders can mesh a
+     * streamed tile on their own threads and leave only the upload to the
+     * render thread.
+     */
+    static std::shared_ptr<const PreparedMeshes> prepareMeshes(const CityData& city, JobSystem* jobs);
+    
+    /**
+     * @brief Bytes a city's prepared meshes take (their uploaded buffers take as many)
+     */
+    static size_t meshBytes(const PreparedMeshes& meshes);
+    
+    /**
+     * @brief Upload the static meshes of a streamed tile next to the city's
+     * @param key Identifies the tile for removeTile() (a key in use is replaced)
+     * @param meshes Output of prepareMeshes() for the tile's roads and parks
+     * 
+     * Each tile's roads, parks and 2D points get batches of their own, so
+     * tiles are uploaded and freed one at a time without touching the
+     * city's buffers or each other's. Their buildings go through
+     * addBuildings() and removeBuildings() like any others. updateCity()
+     * drops every tile.
      */
-    void updateCity(const CityData& city, bool view3D);
+    void addTile(uint32_t key, const PreparedMeshes& meshes);
+    
+    /**
+     * @brief Free the buffers of a tile added with addTile() (unknown keys are ignored)
+     */
+    void removeTile(uint32_t key);
+    
+    /**
+     * @brief Upload a building that was just appended to the city's buildings
+     * @param buildings The city's buildings (the new one is buildings[index])
+     * @param index Index of the new building (must be the last one)
+     * 
+     * Writes the building's instance record into a spare slot of its
+     * type's region with one glBufferSubData. Only when that region
+     * is full is the building batch (and nothing else) rebuilt, with fresh
+     * headroom, so repeated placement stays amortized O(1).
+     */
+    void addBuilding(const std::vector<Building>& buildings, size_t index);
+    
+    /**
+     * @brief Upload several buildings at once
+     * @param buildings Every building; slot owners are indices into it
+     * @param indices Buildings to add: each appended since the last call,
+     *                or written into a hole left by removeBuildings()
+     * 
+     * Each type's new buildings take the spare slots right after its used
+     * ones, so a type costs one glBufferSubData rather than one per
+     * building. A region without room for them rebuilds the batch (holes
+     * stay holes).
+     */
+    void addBuildings(const std::vector<Building>& buildings, const std::vector<uint32_t>& indices);
+    
+    /**
+     * @brief Free the slots of several buildings, leaving holes at their indices
+     * @param buildings Every building (the removed ones may still be in it)
+     * @param indices Buildings to remove
+     * 
+     * Regions stay dense: the last used slot of a region moves into each
+     * freed one, and the freed tail is cleared with one write per type.
+     * Other buildings keep their indices, so a hole can be refilled with
+     * addBuildings().
+     */
+    void removeBuildings(const std::vector<Building>& buildings, const std::vector<uint32_t>& indices);
     
     /**
      * @brief Update traffic rendering buffers
      * @param trafficData Traffic data to render
-     * @param view3D Whether to use 3D rendering mode
+     * @param alpha Blend factor between the previous and current simulation step
      * 
      * Updates only traffic-related buffers without regenerating city.
+     * All cars share one unit car mesh; each car is an instance record
+     * (position, heading, color) in a GL_DYNAMIC_DRAW buffer that is sized
+     * to the car count and only reallocated when that count changes.
+     * Every other frame only the range of cars whose record changed is
+     * streamed with glBufferSubData. The layout is the same in 2D and 3D,
+     * so view switches need no reallocation.
      */
-    void updateTraffic(const TrafficData& trafficData, bool view3D);
+    void updateTraffic(const TrafficData& trafficData, float alpha = 1.0f);
     
     /**
-     * @brief Render the city
-     * @param city City data
+     * @brief Set the camera used for frustum culling and level of detail
+     * @param viewProjection Column-major projection * view matrix (as from glm::value_ptr)
+     * @param eyeX Camera position X in world space
+     * @param eyeY Camera position Y (height) in world space
+     * @param eyeZ Camera position Z in world space
+     * 
+     * Buildings are partitioned into square chunks of the city, each with
+     * a world-space bounding box. In 3D only chunks that intersect this
+     * frustum are drawn; the 2D map always shows the whole city.
+     * 
+     * The eye position picks a detail level per object: parks and the
+     * fountain switch between MESH_LOD_LEVELS tessellations by distance,
+     * buildings drop their hidden ground face while the camera is above
+     * ground, and chunks whose largest building would cover less than
+     * about a pixel are skipped entirely.
+     * 
+     * With CityConfig::occlusionCulling, the buildings that cover the most
+     * of this view are drawn into an OcclusionBuffer the first time a 3D
+     * pass needs it; chunks and cars entirely behind them are not drawn.
+     */
+    void setCamera(const float* viewProjection, float eyeX, float eyeY, float eyeZ);
+    
+    /**
+     * @brief Time each render pass on the CPU and GPU (nullptr = no profiling)
+     */
+    void setProfiler(Profiler* frameProfiler) { profiler = frameProfiler; }
+    
+    /**
+     * @brief Build meshes on a worker pool (nullptr = everything on the calling thread)
+     * 
+     * Other threads may share the pool (their jobs run in turn), but
+     * updateCity() must not be called from inside one of its jobs.
+     */
+    void setJobSystem(JobSystem* jobs) { jobSystem = jobs; }
+    
+    /**
+     * @brief Submit the visible buildings as one indirect multi-draw where the driver allows
+     * @param loader GL function loader (as passed to gladLoadGLLoader)
+     * @return false without OpenGL 4.3 or GL_ARB_multi_draw_indirect and
+     *         GL_ARB_base_instance (buildings then draw one range per call)
+     * 
+     * Culling writes a draw command per visible slot run into an indirect
+     * buffer; the base instance of each command starts it at its slot, so
+     * no attribute is re-pointed and no hidden box is drawn between runs.
+     * The entry points are beyond the 3.3 loader, hence the loader. Call
+     * with the context current.
+     */
+    bool enableIndirectDraws(GLADloadproc loader);
+    
+    /**
+     * @brief Render the city uploaded by updateCity()
      * @param config City configuration (includes texture theme)
      * @param view3D Whether to use 3D mode
      * @param shaderManager Shader manager for rendering
-     * @param brickTexture Texture ID for brick (low-rise buildings)
-     * @param concreteTexture Texture ID for concrete (mid-rise buildings)
-     * @param glassTexture Texture ID for glass (high-rise buildings)
+     * @param materialArray Building material array (TextureManager::getMaterialArray())
      * @param roadTexture Texture ID for roads
      * @param grassTexture Texture ID for grass/parks
      * @param fountainTexture Texture ID for fountains
+     * 
+     * Each pass is a draw item carrying the shader features and texture it
+     * needs. Items are sorted by that state (then texture), with blended
+     * items last, so every state change happens once per group of passes
+     * rather than once per pass.
+     * 
+     * The config's quality settings (LOD distances, chunk cull angle, 2D
+     * point sizes) apply from this frame on.
      */
-    void render(const CityData& city, const CityConfig& config, bool view3D, ShaderManager& shaderManager,
-                GLuint brickTexture, GLuint concreteTexture, GLuint glassTexture,
-                GLuint roadTexture, GLuint grassTexture, GLuint fountainTexture);
+    void render(const CityConfig& config, bool view3D, ShaderManager& shaderManager,
+                GLuint materialArray, GLuint roadTexture, GLuint grassTexture, GLuint fountainTexture);
     
     /**
      * @brief Render traffic (cars)
@@ -89,52 +250,232 @@ public:
      * @param config City configuration
      * @param view3D Whether to use 3D mode
      * @param shaderManager Shader manager for rendering
+     * 
+     * The whole fleet is drawn with a single glDrawArraysInstanced call
+     * (car boxes in 3D, one point per car in 2D). In 3D, cars outside the
+     * frustum or behind occluding buildings are left out: the visible
+     * records are compacted into a second instance buffer first.
      */
     void renderTraffic(const TrafficData& trafficData, const CityConfig& config, bool view3D, ShaderManager& shaderManager);
     
+    /**
+     * @brief Render the cars of the GPU traffic backend
+     * @param traffic Simulator holding the cars (drawn from its newest state buffer)
+     * @param config City configuration
+     * @param view3D Whether to use 3D mode
+     * @param shaderManager Shader manager for rendering
+     * 
+     * One instanced draw like renderTraffic(), but the shader places each
+     * car from its simulation record (SHADER_GPU_CARS). The positions never
+     * reach the CPU, so every car is drawn: there is no culling.
+     */
+    void renderGpuTraffic(const GpuTrafficSimulator& traffic, const CityConfig& config, bool view3D,
+                          ShaderManager& shaderManager);
+    
     /**
      * @brief Check if rendering data is ready
      * @return true if buffers are created and ready to render
      */
-    bool isReady() const { return !VAOs.empty(); }
+    bool isReady() const { return pointBatch.VAO != 0 || buildingBatch.VAO != 0 || !tileMeshes.empty(); }
     
 private:
-    // Screen dimensions
-    int screenWidth;
-    int screenHeight;
-    
-    // 2D point rendering buffers (for 2D mode)
-    std::vector<GLuint> VAOs;
-    std::vector<GLuint> VBOs;
-    std::vector<int> vertexCounts;
-    
-    // 3D mesh rendering buffers - Roads
-    std::vector<GLuint> road3DVAOs;
-    std::vector<GLuint> road3DVBOs;
-    std::vector<int> road3DVertexCounts;
-    
-    // 3D mesh rendering buffers - Parks
-    std::vector<GLuint> park3DVAOs;
-    std::vector<GLuint> park3DVBOs;
-    std::vector<int> park3DVertexCounts;
-    
-    // 3D mesh rendering buffers - Fountain
-    GLuint fountain3DVAO;
-    GLuint fountain3DVBO;
-    int fountain3DVertexCount;
-    
-    // 3D mesh rendering buffers - Fountain Lights
-    GLuint fountainLights3DVAO;
-    GLuint fountainLights3DVBO;
-    int fountainLights3DVertexCount;
-    
-    // Traffic rendering buffers
-    std::vector<GLuint> traffic3DVAOs;
-    std::vector<GLuint> traffic3DVBOs;
-    std::vector<int> traffic3DVertexCounts;
-    std::vector<GLuint> trafficVAOs;      // 2D traffic
-    std::vector<GLuint> trafficVBOs;      // 2D traffic
-    std::vector<int> trafficVertexCounts; // 2D traffic
+    // Bounds of the city the buffers were built from
+    WorldExtent extent;
+    
+    /// Contiguous vertex (or index, for indexed batches) range inside a batch buffer
+    struct DrawRange {
+        GLint first = 0;
+        GLsizei count = 0;
+    };
+    
+    /// Many meshes packed back-to-back into one VAO/VBO (plus EBO if indexed)
+    struct GeometryBatch {
+        GLuint VAO = 0;
+        GLuint VBO = 0;
+        GLuint EBO = 0;                   ///< 0 for non-indexed batches
+        GLsizei vertexCount = 0;
+        GLsizei indexCount = 0;
+        GLenum indexType = GL_UNSIGNED_INT;  ///< GL_UNSIGNED_SHORT when vertices fit
+        bool quantized = false;           ///< Vertices packed to 16 bits against quantization
+        VertexQuantization quantization;
+        
+        /// Elements to draw: indices if indexed, vertices otherwise
+        GLsizei drawCount() const { return EBO != 0 ? indexCount : vertexCount; }
+    };
+    
+    // 2D point rendering buffer (roads, then parks, then fountain)
+    GeometryBatch pointBatch;
+    DrawRange roadPointRange;
+    DrawRange parkPointRange;
+    DrawRange fountainPointRange;
+    
+    /// Circular object drawn at one of MESH_LOD_LEVELS detail levels
+    struct LodObject {
+        float x = 0.0f;                   ///< World-space center X
+        float z = 0.0f;                   ///< World-space center Z
+        float radius = 0.0f;              ///< World-space radius
+        DrawRange levels[MESH_LOD_LEVELS];  ///< Vertex range of each level in its buffer
+    };
+    
+    // 3D mesh rendering buffers - all roads and all parks in one batch each
+    GeometryBatch road3DBatch;
+    GeometryBatch park3DBatch;            ///< Every park at every level, level-major
+    std::vector<LodObject> parkLods;
+    
+    /// Static meshes of one streamed tile, in batches of their own
+    struct TileMeshes {
+        GeometryBatch points;             ///< Roads, then parks
+        GeometryBatch roads;
+        GeometryBatch parks;              ///< Level-major
+        DrawRange roadPointRange;
+        DrawRange parkPointRange;
+        std::vector<LodObject> parkLods;
+    };
+    std::unordered_map<uint32_t, TileMeshes> tileMeshes;  ///< Tile key -> its meshes (see addTile())
+    
+    /// Fixed-size building slots reserved for one BuildingType in buildingBatch
+    struct BuildingRegion {
+        uint32_t firstSlot = 0;
+        uint32_t capacity = 0;
+        uint32_t used = 0;                ///< Slots [firstSlot, firstSlot + used) are drawn
+    };
+    
+    // Unit box plus instance buffer, one region of slots per BuildingType so each type is one slot range
+    GeometryBatch buildingBatch;          ///< Unit box, every detail level in its index buffer
+    GLuint buildingInstanceVBO;           ///< BUILDING_INSTANCE_FLOATS per slot (zero = empty box)
+    DrawRange buildingTypeRanges[3];      ///< Slot ranges, indexed by BuildingType
+    BuildingRegion buildingRegions[3];    ///< Indexed by BuildingType
+    std::vector<uint32_t> buildingSlots;  ///< Building index -> slot (NO_BUILDING for a hole)
+    std::vector<uint32_t> slotBuildings;  ///< Slot -> building index (NO_BUILDING if free)
+    GLuint buildingLayerVBO;              ///< BuildingMaterial per slot (GL_UNSIGNED_BYTE)
+    GLuint buildingIndexVBO;              ///< slotBuildings on the GPU, for the window occupancy lookup
+    TextureTheme buildingLayerTheme;      ///< Theme the layer buffer was written for
+    GLint buildingInstanceBase;           ///< Slot the instance attributes point at (-1 = unset)
+    
+    /// Buildings whose centers fall in one square of the city
+    struct BuildingChunk {
+        float minBounds[3];               ///< World-space box around every building (grows only)
+        float maxBounds[3];
+        float maxExtent = 0.0f;           ///< Largest building dimension in the chunk (grows only)
+        std::vector<uint32_t> slots[3];   ///< Occupied slots per BuildingType
+        std::vector<DrawRange> runs[3];   ///< Slots merged into contiguous slot ranges
+        bool dirty = true;                ///< runs must be rebuilt from slots
+    };
+    
+    // Building chunk grid used for frustum culling
+    std::vector<BuildingChunk> buildingChunks;
+    int chunkColumns;
+    int chunkRows;
+    std::vector<uint32_t> slotChunks;     ///< Slot -> chunk index (NO_BUILDING if free)
+    GLint buildingLodFirst[BUILDING_LOD_LEVELS][BUILDING_FAR_VIEWS];  ///< First index of each level (and view) in the unit box's indices
+    Frustum frustum;                      ///< Camera frustum of the current frame
+    float cameraEye[3];                   ///< Camera position of the current frame
+    float cameraViewProjection[16];       ///< Camera transform of the current frame
+    
+    // Occlusion culling against the largest buildings in view (3D only)
+    OcclusionBuffer occlusion;
+    bool occlusionStale;                  ///< Camera moved since the buffer was built
+    bool occlusionEnabled;                ///< CityConfig::occlusionCulling of the current frame
+    
+    // Quality settings of the current frame (QualityGovernor, through CityConfig)
+    float lodDistanceScale;               ///< CityConfig::lodDistanceScale
+    float cullAngleScale;                 ///< CityConfig::cullAngleScale
+    float pointSizeScale;                 ///< CityConfig::pointSizeScale
+    std::vector<float> slotBounds;        ///< Slot -> world box (min x, y, z, max x, y, z) of its building
+    std::vector<std::pair<float, uint32_t>> occluderCandidates;  ///< Scratch (score, slot)
+    std::vector<uint8_t> chunkVisibility; ///< Scratch for drawVisibleBuildings(): 0 untested, 1 visible, 2 hidden
+    std::vector<GLsizei> multiDrawCounts; ///< Scratch for glMultiDraw*
+    std::vector<GLint> multiDrawFirsts;
+    std::vector<DrawRange> visibleBuildingRuns[BUILDING_LOD_LEVELS][BUILDING_FAR_VIEWS];  ///< Scratch for drawVisibleBuildings(), per level and view
+    
+    /// One command of glMultiDrawElementsIndirect (layout fixed by GL)
+    struct DrawElementsCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+    
+    // Indirect building draws (ARB_multi_draw_indirect entry point, loaded at runtime)
+    typedef void (APIENTRYP MultiDrawElementsIndirectProc)(GLenum, GLenum, const void*, GLsizei, GLsizei);
+    MultiDrawElementsIndirectProc multiDrawElementsIndirect;  ///< nullptr = one draw per range
+    GLuint buildingCommandBuffer;         ///< GL_DRAW_INDIRECT_BUFFER of the visible runs
+    std::vector<DrawElementsCommand> buildingCommands;  ///< Scratch for drawVisibleBuildings()
+    
+    // 3D mesh rendering buffers - Fountain (every level, level-major)
+    GeometryBatch fountain3DBatch;
+    LodObject fountainLod;
+    
+    // 3D mesh rendering buffers - Fountain Lights (every level, level-major)
+    GeometryBatch fountainLights3DBatch;
+    LodObject fountainLightsLod;
+    
+    /// A quantized batch packed on the CPU, waiting for uploadBatch()
+    struct BatchData {
+        std::vector<uint16_t> vertices;   ///< PACKED_TEXTURED_VERTEX_SHORTS or PACKED_POINT_VERTEX_SHORTS each
+        std::vector<uint16_t> shortIndices;  ///< Indices when every vertex fits 16 bits
+        std::vector<uint32_t> indices;    ///< Indices otherwise (both empty if not indexed)
+        GLsizei vertexCount = 0;
+        bool hasTexCoords = false;
+        VertexQuantization quantization;
+    };
+    
+    /// Every static batch of a city with its draw ranges, built without GL
+    struct CityMeshes {
+        BatchData points;                 ///< Roads, then parks, then fountain
+        BatchData roads;
+        BatchData parks;                  ///< Level-major
+        BatchData fountain;
+        BatchData fountainLights;
+        DrawRange roadPointRange;
+        DrawRange parkPointRange;
+        DrawRange fountainPointRange;
+        std::vector<LodObject> parkLods;
+        LodObject fountainLod;
+        LodObject fountainLightsLod;
+    };
+    
+    // Traffic rendering buffers (shared unit car mesh + per-car instance stream)
+    GLuint trafficVAO;
+    GLuint trafficMeshVBO;                ///< Unit car mesh (static)
+    GLuint trafficInstanceVBO;            ///< Per-car instance records (dynamic)
+    size_t trafficCarCapacity;            ///< Number of cars the instance VBO is sized for
+    std::vector<float> trafficStaging;    ///< CPU mirror of the uploaded instance records
+    GLuint trafficVisibleVAO;             ///< Unit car mesh with trafficVisibleVBO as instances
+    GLuint trafficVisibleVBO;             ///< Instance records of the cars that passed culling
+    std::vector<float> trafficVisibleStaging;
+    
+    Profiler* profiler;                   ///< Optional pass timing
+    JobSystem* jobSystem;                 ///< Optional worker pool for updateCity()
+    FrameArena meshArena;                 ///< Staging for buildCityMeshes(), reused every regeneration
+    
+    /// Render pass of render(), ordered by the shader state it needs
+    enum class DrawPass : uint8_t {
+        ROADS,
+        PARKS,
+        FOUNTAIN,
+        FOUNTAIN_LIGHTS,
+        BUILDINGS
+    };
+    
+    /// One pass with the shader features and texture it draws with
+    struct DrawItem {
+        DrawPass pass;
+        bool is2D;
+        bool useTexture;
+        bool showWindowLights;
+        bool materialArray;               ///< texture is the building material array
+        bool blended;                     ///< Additive and drawn after every opaque item
+        GLuint texture;                   ///< Texture bound for the pass (0 = none)
+        
+        /// Sort key: items with equal state end up next to each other
+        uint32_t stateKey() const {
+            return (blended ? 16u : 0u) | (is2D ? 8u : 0u) | (useTexture ? 4u : 0u) |
+                   (materialArray ? 2u : 0u) | (showWindowLights ? 1u : 0u);
+        }
+    };
+    std::vector<DrawItem> drawItems;      ///< Scratch for render()
     
     /**
      * @brief Cleanup all rendering buffers
@@ -144,64 +485,297 @@ private:
      */
     void cleanup();
     
+    /**
+     * @brief Delete the traffic VAO/VBO
+     */
+    void cleanupTraffic();
+    
+    /**
+     * @brief (Re)allocate the traffic instance VBO for a given car count
+     * @param carCount Number of cars the buffer must hold
+     * 
+     * Creates the traffic VAO and unit car mesh on first use.
+     */
+    void allocateTrafficBuffer(size_t carCount);
+    
     /**
      * @brief Create buffer for a mesh
      * @param vertices Vertex data (position + optional texture coordinates)
      * @param hasTexCoords Whether vertices include texture coordinates (5 floats vs 3 floats per vertex)
+     * @param usage Buffer usage hint
      * @return Pair of (VAO, VBO) handles
      */
-    std::pair<GLuint, GLuint> createBuffer(const std::vector<float>& vertices, bool hasTexCoords);
+    std::pair<GLuint, GLuint> createBuffer(const std::vector<float>& vertices, bool hasTexCoords,
+                                           GLenum usage = GL_STATIC_DRAW);
+    
+    /**
+     * @brief Create an indexed buffer (VAO + VBO + EBO) for a float mesh
+     * @param mesh Indexed mesh with textured (x, y, z, u, v) vertices
+     * @param usage Vertex buffer usage hint (GL_DYNAMIC_DRAW if patched later)
+     * @return Batch handles (empty batch if the mesh is empty)
+     * 
+     * Indices are narrowed to GL_UNSIGNED_SHORT when every vertex is
+     * addressable with 16 bits, halving index memory.
+     */
+    GeometryBatch createIndexedBuffer(const IndexedMesh& mesh, GLenum usage = GL_STATIC_DRAW);
+    
+    /**
+     * @brief Pack meshes for a quantized batch (no GL calls, any thread)
+     * @param vertices Concatenated vertex data of every mesh in the batch
+     * @param vertexCount Vertices (5 floats each if hasTexCoords, else 3)
+     * @param hasTexCoords Whether vertices include texture coordinates
+     * @param indices Triangle indices into vertices (nullptr for a non-indexed batch)
+     * @param indexCount Number of indices
+     * @return Packed data for uploadBatch()
+     * 
+     * Packed vertices are 16-bit normalized against the batch's bounding
+     * box: 12 bytes with texture coordinates instead of 20, 8 without
+     * instead of 12. They are drawn with SHADER_QUANTIZED (see bindBatch()).
+     */
+    static BatchData packBatch(const float* vertices, size_t vertexCount, bool hasTexCoords,
+                               const uint32_t* indices = nullptr, size_t indexCount = 0);
+    
+    /**
+     * @brief Upload packed meshes as a single batch
+     * @param data Output of packBatch()
+     * @return Batch handles (empty batch if there are no vertices)
+     */
+    GeometryBatch uploadBatch(const BatchData& data);
+    
+    /**
+     * @brief Build and pack every static mesh of a city (phase one of updateCity)
+     * 
+     * Every object's mesh size (exact, or an upper bound for points and
+     * roads) is measured first, the staging arrays are carved out of
+     * meshArena in one go, and the objects are meshed in parallel straight
+     * into their slices. The gaps upper bounds left are closed, and each
+     * batch is packed in its own job. Makes no GL calls and uses no
+     * renderer state, so any thread may call it with its own arena.
+     */
+    static CityMeshes buildCityMeshes(const CityData& city, JobSystem* jobs, FrameArena& arena);
+    
+    /**
+     * @brief Upload prepared meshes and adopt their draw ranges (phase two of updateCity)
+     */
+    void uploadCityMeshes(const CityMeshes& meshes);
+    
+    /**
+     * @brief Phase two of updateCity(): upload the meshes, then rebuild the buildings
+     */
+    void installCity(const CityData& city, const CityMeshes& meshes);
+    
+    /**
+     * @brief Run job(i) for i in [0, count) on the job system, or inline without one
+     */
+    void forEach(size_t count, const std::function<void(size_t)>& job) const;
+    static void forEach(JobSystem* jobs, size_t count, const std::function<void(size_t)>& job);
+    
+    /**
+     * @brief Rebuild the building batch with spare slots in every type region
+     * @param buildings The city's buildings
+     * @param live Per building, 0 to leave it out as a hole (nullptr = every building)
+     */
+    void rebuildBuildings(const std::vector<Building>& buildings, const std::vector<uint8_t>* live = nullptr);
+    
+    /**
+     * @brief Delete the building batch and its instance buffers
+     */
+    void deleteBuildingBatch();
+    
+    /**
+     * @brief Rewrite the material layer of every building slot for a theme
+     * @param theme Texture theme the layers are resolved under
+     * 
+     * A theme change is one glBufferSubData of a byte per slot.
+     */
+    void writeBuildingLayers(TextureTheme theme);
+    
+    /**
+     * @brief Point the per-instance attributes at a slot (building VAO bound)
+     */
+    void pointBuildingInstances(GLint firstSlot);
+    
+    /**
+     * @brief Draw a slot range of unit box instances (building VAO bound)
+     * @param slots Slot range (empty slots draw nothing)
+     * @param lod Building detail level
+     * @param view Side of the box the eye is on (level 2 only, see buildingLodIndices())
+     */
+    void drawBuildingInstances(DrawRange slots, int lod, int view = 0);
     
     /**
-     * @brief Render roads (both 2D and 3D)
-     * @param city City data
+     * @brief Write one building's instance record into a slot
+     */
+    void writeBuildingSlot(uint32_t slot, const Building& building);
+    
+    /**
+     * @brief Type region a slot lies in
+     */
+    BuildingRegion& regionOfSlot(uint32_t slot);
+    
+    /**
+     * @brief Upload slotBuildings[firstSlot, firstSlot + count) to the building index buffer
+     */
+    void writeSlotOwners(uint32_t firstSlot, uint32_t count);
+    
+    /**
+     * @brief Refresh buildingTypeRanges from the region fill counts
+     */
+    void syncBuildingRanges();
+    
+    /**
+     * @brief Reset the chunk grid to empty chunks covering the city
+     */
+    void resetBuildingChunks();
+    
+    /**
+     * @brief Chunk that contains a building's center
+     */
+    uint32_t chunkOfBuilding(const Building& building) const;
+    
+    /**
+     * @brief Record that a slot now holds a building (moving it between chunks)
+     */
+    void assignSlotChunk(uint32_t slot, const Building& building);
+    
+    /**
+     * @brief Record that a slot no longer holds a building
+     */
+    void clearSlotChunk(uint32_t slot);
+    
+    /**
+     * @brief Build the occlusion buffer for the current camera if it is stale
+     * @return true if the buffer holds occluders to test against
+     * 
+     * Every building in a frustum-visible chunk is scored by its size over
+     * its distance from the eye; the MAX_OCCLUDERS best above a minimum
+     * angular size are rasterized.
+     */
+    bool updateOcclusion();
+    
+    /**
+     * @brief Draw the buildings of types [firstType, lastType] in visible chunks
+     * 
+     * Slot runs of the visible chunks are sorted and merged where they lie
+     * within MAX_BUILDING_RUN_GAP slots of each other, and each merged
+     * range is one glDrawElementsInstanced. Chunks beyond LOD_DISTANCES[0]
+     * (times lodDistanceScale) that lie off the eye's position on both axes
+     * draw at level 2 (roof and the walls facing the eye); the rest at
+     * level 1 while the eye is above ground. Nearer chunks keep one level,
+     * so their runs still merge into few draws. With indirect draws, only touching runs merge and every run is a
+     * command of a single multi-draw (see submitBuildingCommands()).
+     */
+    void drawVisibleBuildings(int firstType, int lastType);
+    
+    /**
+     * @brief Upload the sorted visibleBuildingRuns of every level as commands and draw them in one call
+     * 
+     * The building VAO must be bound.
+     */
+    void submitBuildingCommands();
+    
+    /**
+     * @brief Detail level for a circular object at the current camera position
+     * @return 0 (full detail) to MESH_LOD_LEVELS - 1
+     */
+    int lodOf(const LodObject& object) const;
+    
+    /**
+     * @brief Fill an object's render-space circle from world coordinates
+     */
+    static LodObject makeLodObject(const Circle& circle, const WorldExtent& extent);
+    
+    /**
+     * @brief Draw a range of a batch
+     * @param batch Batch to draw from (must already be bound)
+     * @param mode Primitive mode
+     * @param range Vertex range, or index range for indexed batches
+     */
+    static void drawBatchRange(const GeometryBatch& batch, GLenum mode, DrawRange range);
+    
+    /**
+     * @brief Bind a batch's VAO and, if it is quantized, its box
+     * @param batch Batch about to be drawn
+     * @param shaderManager Receives the batch's quantization
+     */
+    static void bindBatch(const GeometryBatch& batch, ShaderManager& shaderManager);
+    
+    /**
+     * @brief Delete a batch's VAO/VBO and reset it
+     * @param batch Batch to release
+     */
+    void deleteBatch(GeometryBatch& batch);
+    
+    /**
+     * @brief Apply a draw item's shader features and texture
+     * 
+     * ShaderManager skips values that are already set, so this costs GL
+     * calls only where consecutive items differ.
+     */
+    static void applyDrawState(const DrawItem& item, ShaderManager& shaderManager);
+    
+    /**
+     * @brief Brightness of the fountain lights at a time of day
+     * @param timeOfDay Current time of day (0-24 hours)
+     * @return 0 (off, daytime) to 1 (full night)
+     */
+    static float fountainGlow(float timeOfDay);
+    
+    /**
+     * @brief Render the roads of the city and of every streamed tile (both 2D and 3D)
      * @param view3D Render mode
-     * @param shaderManager Shader manager
-     * @param roadTexture Road texture ID
-     * @param roadCount Number of roads
+     * @param shaderManager Shader manager (2D point color)
+     */
+    void renderRoads(bool view3D, ShaderManager& shaderManager);
+    
+    /**
+     * @brief Draw every park of a batch at the level for its distance, in one multi-draw
      */
-    void renderRoads(const CityData& city, bool view3D, ShaderManager& shaderManager,
-                     GLuint roadTexture, size_t roadCount);
+    void drawParkLods(const GeometryBatch& batch, const std::vector<LodObject>& lods, ShaderManager& shaderManager);
     
     /**
-     * @brief Render parks (both 2D and 3D)
-     * @param city City data
+     * @brief Render the parks of the city and of every streamed tile (both 2D and 3D)
      * @param view3D Render mode
-     * @param shaderManager Shader manager
-     * @param grassTexture Grass texture ID
-     * @param roadCount Number of roads (for offset calculation)
-     * @param parkCount Number of parks
+     * @param shaderManager Shader manager (color when the grass texture is missing)
      */
-    void renderParks(const CityData& city, bool view3D, ShaderManager& shaderManager,
-                     GLuint grassTexture, size_t roadCount, size_t parkCount);
+    void renderParks(bool view3D, ShaderManager& shaderManager);
     
     /**
-     * @brief Render fountain (both 2D and 3D)
-     * @param city City data
+     * @brief Render the fountain structure (both 2D and 3D)
      * @param view3D Render mode
-     * @param shaderManager Shader manager
-     * @param fountainTexture Fountain texture ID
-     * @param fountainOffset Offset in VAO array
-     * @param fountainCount Number of fountains (0 or 1)
-     * @param timeOfDay Current time of day (0-24 hours)
+     * @param shaderManager Shader manager (2D point color)
+     */
+    void renderFountain(bool view3D, ShaderManager& shaderManager);
+    
+    /**
+     * @brief Render the glowing fountain light bulbs (3D, at night)
+     * @param shaderManager Shader manager (light color)
+     * @param glowIntensity Brightness from fountainGlow()
+     * 
+     * Drawn additively without depth writes, after every opaque pass so
+     * geometry behind the lights cannot overwrite them.
      */
-    void renderFountain(const CityData& city, bool view3D, ShaderManager& shaderManager,
-                        GLuint fountainTexture, size_t fountainOffset, size_t fountainCount, float timeOfDay);
+    void renderFountainLights(ShaderManager& shaderManager, float glowIntensity);
     
     /**
      * @brief Render buildings (both 2D and 3D)
-     * @param city City data
      * @param config City configuration (includes texture theme)
      * @param view3D Render mode
      * @param shaderManager Shader manager
-     * @param brickTexture Brick texture ID
-     * @param concreteTexture Concrete texture ID
-     * @param glassTexture Glass texture ID
-     * @param buildingStart Starting index in VAO array
-     */
-    void renderBuildings(const CityData& city, const CityConfig& config, bool view3D, ShaderManager& shaderManager,
-                         GLuint brickTexture, GLuint concreteTexture, GLuint glassTexture,
-                         size_t buildingStart);
+     * 
+     * In 3D every building samples its material from the array bound by
+     * the draw item, so visible buildings need only as many instanced
+     * draws as there are separate slot ranges, whatever the theme.
+     */
+    void renderBuildings(const CityConfig& config, bool view3D, ShaderManager& shaderManager);
+    
+    /**
+     * @brief Select the building material for a type under a theme
+     * @param theme Active texture theme
+     * @param type Building type
+     * @return BuildingMaterial layer of the material array
+     */
+    static uint8_t selectBuildingLayer(TextureTheme theme, BuildingType type);
 };
 
 #endif // CITY_RENDERER_H
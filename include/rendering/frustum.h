@@ -0,0 +1,45 @@
+/**
+ * @file frustum.h
+ * @brief View Frustum for Visibility Culling
+ * 
+ * Extracts the six clip planes from a combined projection * view matrix
+ * (Gribb/Hartmann) and tests world-space axis-aligned boxes against them.
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+/**
+ * @struct Frustum
+ * @brief Six inward-facing planes (a, b, c, d) with ax + by + cz + d >= 0 inside
+ */
+struct Frustum {
+    float planes[6][4];
+    
+    /**
+     * @brief Construct a frustum that contains everything
+     */
+    Frustum();
+    
+    /**
+     * @brief Build the frustum of a clip transform
+     * @param viewProjection Column-major 4x4 projection * view matrix (as from glm::value_ptr)
+     */
+    static Frustum fromMatrix(const float* viewProjection);
+    
+    /**
+     * @brief Test whether a box is at least partly inside
+     * @param minCorner Box minimum (x, y, z)
+     * @param maxCorner Box maximum (x, y, z)
+     * @return false only if the box lies entirely outside one plane
+     * 
+     * Conservative: boxes near a frustum corner may pass without being
+     * visible, but no visible box is ever rejected.
+     */
+    bool intersectsBox(const float (&minCorner)[3], const float (&maxCorner)[3]) const;
+};
+
+#endif // FRUSTUM_H
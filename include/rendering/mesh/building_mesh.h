@@ -14,29 +14,76 @@
 
 #include <vector>
 #include "generation/city_generator.h" // For Building struct
+#include "rendering/mesh/mesh_utils.h" // For IndexedMesh
+
+constexpr int BUILDING_MESH_VERTICES = 24;  ///< 6 faces * 4 shared corners
+constexpr int BUILDING_MESH_INDICES = 36;   ///< 6 faces * 2 triangles * 3 indices
+constexpr int BUILDING_LOD_LEVELS = 3;
+constexpr int BUILDING_LOD_INDICES[BUILDING_LOD_LEVELS] = {36, 30, 18};  ///< Indices per level
+constexpr int BUILDING_FAR_VIEWS = 4;       ///< Level 2 variants, one per side of the box the eye is on
+constexpr int BUILDING_INSTANCE_FLOATS = 5; ///< x, y, width, depth, height (world units)
 
 /**
- * @brief Generate 3D cube vertices for a building
+ * @brief Generate an indexed 3D cube mesh for a building
+ * 
+ * Creates a cube with 24 vertices (4 per face, so each face keeps its own
+ * UVs) and 36 indices, instead of 36 unshared vertices.
  * 
- * Creates a 3D cube mesh with 36 vertices (6 faces * 2 triangles * 3 vertices each)
- * in format (x, y, z, u, v) where (u, v) are texture coordinates.
+ * @param building Building structure containing position and dimensions
+ * @param extent City bounds, maps world units to render space
+ * @return IndexedMesh Vertex data (x, y, z, u, v) plus triangle indices
  * 
+ * World coordinates: X=left/right, Y=height(UP!), Z=depth. The 2D view
+ * draws the same mesh through a view matrix that swaps Y and Z.
+ */
+IndexedMesh buildingToMesh(const Building& building, 
+                           const WorldExtent& extent);
+
+/**
+ * @brief Generate the unit box every building instance is drawn from
+ * 
+ * Same faces, UVs and indices as buildingToMesh(), spanning -1..1 along X
+ * and Z and 0..1 in height, so scaling by a building's half-width, height
+ * and half-depth and moving it to the building's center gives its box.
+ * 
+ * @return IndexedMesh Vertex data (x, y, z, u, v) plus triangle indices
+ */
+IndexedMesh unitBuildingMesh();
+
+/**
+ * @brief Pack a building into an instance record for unitBuildingMesh()
  * @param building Building structure containing position and dimensions
- * @param screenWidth Width of the viewport in pixels
- * @param screenHeight Height of the viewport in pixels
- * @param is3D If true, uses 3D coordinate system (Y is up); if false, uses 2D system (Z is up)
- * @return std::vector<float> Vertex data with positions and UV coordinates
+ * @param record Receives BUILDING_INSTANCE_FLOATS floats
  * 
- * Coordinate systems:
- * - 3D mode: X=left/right, Y=height(UP!), Z=depth
- * - 2D mode: X=left/right, Y=depth, Z=height
+ * The record keeps world units; the vertex shader applies the world ->
+ * render mapping (WorldExtent::renderMapping()) itself, so records stay
+ * valid whatever the extent.
+ */
+void writeBuildingInstance(const Building& building, float* record);
+
+/**
+ * @brief Triangle indices of a building mesh at a detail level
+ * @param lod 0 for the full box, 1 for the box without its ground face,
+ *            2 for the roof and the two walls facing the eye
+ * @param view Level 2 only: bit 0 set if the eye is beyond the box's +X
+ *             side (else its -X side), bit 1 likewise for +Z
+ * @return Indices relative to the mesh's first vertex (BUILDING_LOD_INDICES[lod] of them)
  * 
- * Each vertex has 5 floats: (x, y, z, u, v)
- * Total vertices: 36 (6 faces * 6 vertices per face)
+ * The ground face lies on the ground plane facing down, so it cannot be
+ * seen while the camera is above ground; level 1 simply leaves it out.
+ * Seen from outside its footprint on both axes, a box shows at most two
+ * walls, so level 2 drops the other two as well.
+ */
+std::vector<uint32_t> buildingLodIndices(int lod, int view = 0);
+
+/**
+ * @brief World-space bounding box of a building's mesh
+ * @param building Building structure containing position and dimensions
+ * @param extent City bounds, maps world units to render space
+ * @param minCorner Receives the box minimum (x, y, z)
+ * @param maxCorner Receives the box maximum (x, y, z)
  */
-std::vector<float> buildingToVertices(const Building& building, 
-                                      int screenWidth, 
-                                      int screenHeight, 
-                                      bool is3D = true);
+void buildingBounds(const Building& building, const WorldExtent& extent,
+                    float (&minCorner)[3], float (&maxCorner)[3]);
 
 #endif // BUILDING_MESH_H
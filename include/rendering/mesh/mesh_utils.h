@@ -12,24 +12,162 @@
 #define MESH_UTILS_H
 
 #include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <initializer_list>
 #include "utils/algorithms.h" // For Point struct
+#include "core/world_extent.h"
+
+constexpr int MESH_LOD_LEVELS = 3;  ///< Detail levels of park/fountain meshes (0 = full detail)
+constexpr int PACKED_TEXTURED_VERTEX_SHORTS = 6;  ///< x, y, z, padding, u, v (12 bytes)
+constexpr int PACKED_POINT_VERTEX_SHORTS = 4;     ///< x, y, z, padding (8 bytes)
+
+/**
+ * @struct VertexQuantization
+ * @brief Box that 16-bit normalized vertex components are relative to
+ * 
+ * A packed component c (0..65535) stands for origin + c / 65535 * scale,
+ * so precision is the box size / 65535 along each axis whatever the
+ * distance from the world origin.
+ */
+struct VertexQuantization {
+    float origin[3] = {0.0f, 0.0f, 0.0f};           ///< Box minimum
+    float scale[3] = {1.0f, 1.0f, 1.0f};            ///< Box size (0 on flat axes)
+    float texCoordTransform[4] = {0.0f, 0.0f, 1.0f, 1.0f};  ///< UV minimum (u, v), then UV range
+};
+
+/**
+ * @struct MeshSink
+ * @brief Fixed-capacity destination the write*Mesh functions fill
+ * 
+ * Points at storage owned by the caller (a slice of a staging arena, or a
+ * vector sized with the matching *MeshFloats function), so meshes are
+ * written in place instead of growing a vector of their own. A write that
+ * does not fit is dropped and sets overflowed rather than running past
+ * the storage.
+ */
+struct MeshSink {
+    float* vertices = nullptr;
+    size_t floatCapacity = 0;
+    size_t floatCount = 0;            ///< Floats written so far
+    uint32_t* indices = nullptr;      ///< nullptr for non-indexed meshes
+    size_t indexCapacity = 0;
+    size_t indexCount = 0;            ///< Indices written so far
+    bool overflowed = false;
+    
+    MeshSink() = default;
+    MeshSink(float* vertexStorage, size_t floats, uint32_t* indexStorage = nullptr, size_t indexSlots = 0)
+        : vertices(vertexStorage), floatCapacity(floats), indices(indexStorage), indexCapacity(indexSlots) {}
+    
+    /**
+     * @brief Append vertex floats (whole vertices)
+     */
+    void addVertices(std::initializer_list<float> values) {
+        if (floatCount + values.size() > floatCapacity) {
+            overflowed = true;
+            return;
+        }
+        std::copy(values.begin(), values.end(), vertices + floatCount);
+        floatCount += values.size();
+    }
+    
+    /**
+     * @brief Append indices, relative to the first vertex of this sink
+     */
+    void addIndices(std::initializer_list<uint32_t> values) {
+        if (indexCount + values.size() > indexCapacity) {
+            overflowed = true;
+            return;
+        }
+        std::copy(values.begin(), values.end(), indices + indexCount);
+        indexCount += values.size();
+    }
+    
+    /**
+     * @brief Textured (x, y, z, u, v) vertices written so far
+     */
+    size_t texturedVertexCount() const { return floatCount / 5; }
+};
+
+/**
+ * @struct IndexedMesh
+ * @brief Deduplicated mesh: shared vertices plus a triangle index list
+ * 
+ * Vertices use the textured layout (x, y, z, u, v); every 3 indices form
+ * one triangle. Indices are always 32-bit here - the renderer narrows
+ * them to 16-bit on upload when the vertex count allows it.
+ */
+struct IndexedMesh {
+    std::vector<float> vertices;      ///< 5 floats per vertex
+    std::vector<uint32_t> indices;    ///< 3 indices per triangle
+    
+    /**
+     * @brief Number of vertices in the mesh
+     */
+    size_t vertexCount() const { return vertices.size() / 5; }
+    
+    /**
+     * @brief Append another mesh, rebasing its indices
+     * @param other Mesh to append
+     */
+    void append(const IndexedMesh& other);
+    
+    /**
+     * @brief Append one quad as 4 vertices and 2 triangles (0-1-2, 0-2-3)
+     * @param quad 4 vertices of 5 floats each, in winding order
+     */
+    void appendQuad(const float (&quad)[4][5]);
+};
+
+/**
+ * @brief Bounding boxes of a vertex array's positions and UVs
+ * @param vertices Vertex data, 5 floats per vertex if hasTexCoords, else 3
+ * @param hasTexCoords Whether vertices include texture coordinates
+ * @return Quantization spanning every vertex exactly
+ */
+VertexQuantization computeQuantization(const std::vector<float>& vertices, bool hasTexCoords);
+VertexQuantization computeQuantization(const float* vertices, size_t vertexCount, bool hasTexCoords);
+
+/**
+ * @brief Pack vertices into 16-bit normalized components
+ * @param vertices Vertex data, 5 floats per vertex if hasTexCoords, else 3
+ * @param hasTexCoords Whether vertices include texture coordinates
+ * @param quantization Box from computeQuantization()
+ * @return PACKED_TEXTURED_VERTEX_SHORTS or PACKED_POINT_VERTEX_SHORTS
+ *         values per vertex (the padding keeps attributes 4-byte aligned)
+ */
+std::vector<uint16_t> packVertices(const std::vector<float>& vertices, bool hasTexCoords,
+                                   const VertexQuantization& quantization);
+std::vector<uint16_t> packVertices(const float* vertices, size_t vertexCount, bool hasTexCoords,
+                                   const VertexQuantization& quantization);
 
 /**
  * @brief Convert 2D points to OpenGL vertices
  * 
- * Converts a series of 2D pixel coordinates to normalized device coordinates (-1 to 1)
- * for use with OpenGL. Filters out points outside the screen boundaries.
+ * Converts a series of 2D world-unit coordinates to top-down render space
+ * (X, Z on the map) for use with OpenGL. Filters out points outside the city boundaries.
  * 
- * @param points Vector of 2D points in pixel coordinates
- * @param screenWidth Width of the viewport in pixels
- * @param screenHeight Height of the viewport in pixels
+ * @param points Vector of 2D points in world units
+ * @param extent City bounds, maps world units to render space
  * @return std::vector<float> Vertex data in format (x, y, z) where z=0 for 2D elements
  * 
  * Each vertex has 3 floats: (x, y, 0.0)
- * Points outside the screen margins are filtered out
+ * Points outside the city margins are filtered out
  */
 std::vector<float> pointsToVertices(const std::vector<Point>& points, 
-                                     int screenWidth, 
-                                     int screenHeight);
+                                     const WorldExtent& extent);
+
+/**
+ * @brief Write 2D points as vertices into a sink
+ * 
+ * Same output as pointsToVertices(); needs at most 3 floats per point.
+ */
+void writePointVertices(const std::vector<Point>& points, const WorldExtent& extent, MeshSink& out);
+
+/**
+ * @brief Write count 2D points from a buffer (e.g. a rasterizer's output)
+ */
+void writePointVertices(const Point* points, size_t count, const WorldExtent& extent, MeshSink& out);
 
 #endif // MESH_UTILS_H
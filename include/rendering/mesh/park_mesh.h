@@ -13,7 +13,8 @@
 #define PARK_MESH_H
 
 #include <vector>
-#include "utils/algorithms.h" // For Point struct
+#include "utils/algorithms.h" // For Circle struct
+#include "rendering/mesh/mesh_utils.h" // For MESH_LOD_LEVELS
 
 /**
  * @brief Generate 3D mesh for a park (filled circle)
@@ -21,23 +22,19 @@
  * Creates a circular filled mesh using a triangle fan approach.
  * The mesh represents a grass-covered park area.
  * 
- * @param parkPoints Points defining the circular boundary of the park
- * @param screenWidth Width of the viewport in pixels
- * @param screenHeight Height of the viewport in pixels
- * @param is3D If true, uses 3D coordinate system (Y is up); if false, uses 2D system (Z is up)
+ * @param park Park circle in world units
+ * @param extent City bounds, maps world units to render space
+ * @param lod Detail level, 0 (32 segments x 4 rings) to MESH_LOD_LEVELS - 1 (8 x 1)
  * @return std::vector<float> Vertex data with positions and UV coordinates (x, y, z, u, v)
  * 
- * Coordinate systems:
- * - 3D mode: X=left/right, Y=height (park on ground plane), Z=depth
- * - 2D mode: X=left/right, Y=depth, Z=height
+ * World coordinates: X=left/right, Y=height (park on ground plane), Z=depth
  * 
  * Each vertex has 5 floats: (x, y, z, u, v)
  * Creates 32 triangles forming a filled circle
  */
-std::vector<float> parkTo3DMesh(const std::vector<Point>& parkPoints, 
-                                 int screenWidth, 
-                                 int screenHeight, 
-                                 bool is3D);
+std::vector<float> parkTo3DMesh(const Circle& park, 
+                                 const WorldExtent& extent,
+                                 int lod = 0);
 
 /**
  * @brief Generate 3D mesh for a fountain (filled circle)
@@ -45,10 +42,9 @@ std::vector<float> parkTo3DMesh(const std::vector<Point>& parkPoints,
  * Similar to parkTo3DMesh but slightly raised above the ground plane
  * to make it visually distinct from parks.
  * 
- * @param fountainPoints Points defining the circular boundary of the fountain
- * @param screenWidth Width of the viewport in pixels
- * @param screenHeight Height of the viewport in pixels
- * @param is3D If true, uses 3D coordinate system (Y is up); if false, uses 2D system (Z is up)
+ * @param fountain Fountain circle in world units
+ * @param extent City bounds, maps world units to render space
+ * @param lod Detail level, 0 (24 segments) to MESH_LOD_LEVELS - 1 (8 segments)
  * @return std::vector<float> Vertex data with positions and UV coordinates (x, y, z, u, v)
  * 
  * Height hierarchy (to prevent z-fighting):
@@ -56,10 +52,9 @@ std::vector<float> parkTo3DMesh(const std::vector<Point>& parkPoints,
  * - Parks: 0.006f
  * - Fountains: 0.008f
  */
-std::vector<float> fountainTo3DMesh(const std::vector<Point>& fountainPoints, 
-                                     int screenWidth, 
-                                     int screenHeight, 
-                                     bool is3D);
+std::vector<float> fountainTo3DMesh(const Circle& fountain, 
+                                     const WorldExtent& extent,
+                                     int lod = 0);
 
 /**
  * @brief Generate 3D mesh for fountain light bulbs (small spheres)
@@ -67,13 +62,47 @@ std::vector<float> fountainTo3DMesh(const std::vector<Point>& fountainPoints,
  * Creates small spherical meshes representing light bulbs placed around
  * and on the fountain structure for nighttime illumination effect.
  * 
- * @param fountainPoints Points defining the circular boundary of the fountain
- * @param screenWidth Width of the viewport in pixels
- * @param screenHeight Height of the viewport in pixels
+ * @param fountain Fountain circle in world units
+ * @param extent City bounds, maps world units to render space
+ * @param lod Detail level; coarser levels use fewer sphere segments and
+ *            the last level has no bulbs at all (they are sub-pixel there)
  * @return std::vector<float> Vertex data with positions and UV coordinates (x, y, z, u, v)
  */
-std::vector<float> fountainLightsTo3DMesh(const std::vector<Point>& fountainPoints,
-                                          int screenWidth,
-                                          int screenHeight);
+std::vector<float> fountainLightsTo3DMesh(const Circle& fountain,
+                                          const WorldExtent& extent,
+                                          int lod = 0);
+
+/**
+ * @brief Floats parkTo3DMesh() writes at a detail level (exact for a valid park)
+ */
+size_t parkMeshFloats(int lod = 0);
+
+/**
+ * @brief Floats fountainTo3DMesh() writes at a detail level (exact for a valid fountain)
+ */
+size_t fountainMeshFloats(int lod = 0);
+
+/**
+ * @brief Floats fountainLightsTo3DMesh() writes at a detail level (exact for a valid fountain)
+ */
+size_t fountainLightsMeshFloats(int lod = 0);
+
+/**
+ * @brief Write a park mesh into a sink (same vertices as parkTo3DMesh())
+ * @param out Needs room for parkMeshFloats(lod) floats
+ */
+void writeParkMesh(const Circle& park, const WorldExtent& extent, int lod, MeshSink& out);
+
+/**
+ * @brief Write a fountain mesh into a sink (same vertices as fountainTo3DMesh())
+ * @param out Needs room for fountainMeshFloats(lod) floats
+ */
+void writeFountainMesh(const Circle& fountain, const WorldExtent& extent, int lod, MeshSink& out);
+
+/**
+ * @brief Write the fountain light bulbs into a sink (same vertices as fountainLightsTo3DMesh())
+ * @param out Needs room for fountainLightsMeshFloats(lod) floats
+ */
+void writeFountainLightsMesh(const Circle& fountain, const WorldExtent& extent, int lod, MeshSink& out);
 
 #endif // PARK_MESH_H
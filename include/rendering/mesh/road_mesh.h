@@ -15,29 +15,45 @@
 #include <vector>
 #include "generation/road_generator.h" // For Road struct
 #include "utils/algorithms.h" // For Point struct
+#include "rendering/mesh/mesh_utils.h" // For IndexedMesh
 
 /**
- * @brief Generate 3D mesh for a road from points
+ * @brief Generate indexed 3D mesh for a road from its polyline
  * 
- * Creates a textured 3D mesh representing a road surface from a series of points.
- * The road is rendered as a strip of connected quads (2 triangles each).
+ * Creates a textured 3D mesh representing a road surface from the road's
+ * polyline vertices (not its rasterized pixels), so a straight road is a
+ * single quad.
+ * The road is rendered as a strip of connected quads (2 triangles each) where
+ * consecutive quads share their joint vertices.
  * 
- * @param road Road structure containing points defining the road path
- * @param screenWidth Width of the viewport in pixels
- * @param screenHeight Height of the viewport in pixels
- * @param is3D If true, uses 3D coordinate system (Y is up); if false, uses 2D system (Z is up)
- * @return std::vector<float> Vertex data with positions and UV coordinates (x, y, z, u, v)
+ * @param road Road structure containing the polyline defining the road path
+ * @param extent City bounds, maps world units to render space
+ * @return IndexedMesh Vertex data (x, y, z, u, v) plus triangle indices
  * 
- * Coordinate systems:
- * - 3D mode: X=left/right, Y=height (roads on ground plane), Z=depth
- * - 2D mode: X=left/right, Y=depth, Z=height
+ * World coordinates: X=left/right, Y=height (roads on ground plane), Z=depth
  * 
- * Each vertex has 5 floats: (x, y, z, u, v)
- * Each road segment produces 6 vertices (2 triangles)
+ * Each polyline vertex in a visible run produces 2 vertices (left/right edge) and
+ * each segment 6 indices (2 triangles). Segments outside the city
+ * margins are skipped, splitting the strip into separate runs.
  */
-std::vector<float> roadTo3DMesh(const Road& road, 
-                                 int screenWidth, 
-                                 int screenHeight, 
-                                 bool is3D);
+IndexedMesh roadTo3DMesh(const Road& road, 
+                         const WorldExtent& extent);
+
+/**
+ * @brief Upper bound on the floats roadTo3DMesh() writes for a road
+ */
+size_t roadMeshFloats(const Road& road);
+
+/**
+ * @brief Upper bound on the indices roadTo3DMesh() writes for a road
+ */
+size_t roadMeshIndices(const Road& road);
+
+/**
+ * @brief Write a road mesh into a sink (same mesh as roadTo3DMesh())
+ * @param out Needs room for roadMeshFloats() floats and roadMeshIndices()
+ *            indices; indices count from the sink's first vertex
+ */
+void writeRoadMesh(const Road& road, const WorldExtent& extent, MeshSink& out);
 
 #endif // ROAD_MESH_H
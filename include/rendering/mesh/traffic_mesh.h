@@ -4,10 +4,24 @@
 #include <vector>
 #include "features/traffic_system/traffic_generator.h"
 
-// Generate 3D mesh for a single car (small cube)
-std::vector<float> carTo3DMesh(const Car& car, int screenWidth, int screenHeight);
+// All cars share one unit mesh and differ only by a small per-instance record
+constexpr int CAR_3D_VERTEX_COUNT = 36;                     // 6 faces * 2 triangles
+constexpr int CAR_3D_FLOATS = CAR_3D_VERTEX_COUNT * 5;      // (x, y, z, u, v)
+constexpr int CAR_INSTANCE_FLOATS = 7;                      // (x, z, sin, cos, r, g, b)
 
-// Generate 2D vertices for a car (single point)
-std::vector<float> carTo2DVertices(const Car& car, int screenWidth, int screenHeight);
+// Unit car box in render units: half extents across and along its heading, height above its base
+constexpr float CAR_3D_HALF_WIDTH = 0.015f;
+constexpr float CAR_3D_HALF_LENGTH = 0.025f;
+constexpr float CAR_3D_HEIGHT = 0.012f;
+constexpr float CAR_3D_BASE = 0.01f;                        // Slightly above ground
+
+// Generate the unit car mesh (small box centered on the origin, length along +z)
+std::vector<float> carUnitMesh();
+
+// Write the per-instance record for car index into out (must hold CAR_INSTANCE_FLOATS floats)
+// Position is blended alpha of the way from the previous to the current fixed step and is in
+// render coordinates; heading follows the car's direction of travel (also while it is stopped)
+void writeCarInstance(const TrafficData& cars, size_t index, float alpha,
+                      const WorldExtent& extent, float* out);
 
 #endif
@@ -0,0 +1,95 @@
+/**
+ * @file occlusion_buffer.h
+ * @brief Software Hierarchical-Z Buffer for Occlusion Culling
+ * 
+ * The largest occluders of a frame (building boxes near the camera) are
+ * rasterized on the CPU into a small depth buffer, which is then reduced
+ * into a pyramid holding the farthest depth of each 2x2 block (Hi-Z). A
+ * box is hidden when its nearest point lies behind the occluders over
+ * every texel it covers; the pyramid answers that with a few reads at the
+ * level where the box spans a handful of texels. Built from the current
+ * frame's camera, so culling has no query round trip or frame of delay.
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef OCCLUSION_BUFFER_H
+#define OCCLUSION_BUFFER_H
+
+#include <vector>
+
+/**
+ * @class OcclusionBuffer
+ * @brief Conservative CPU depth pyramid: a box reported hidden is never visible
+ */
+class OcclusionBuffer {
+public:
+    static constexpr int WIDTH = 128;    ///< Texels across the viewport
+    static constexpr int HEIGHT = 96;    ///< Texels down the viewport
+    static constexpr int LEVELS = 6;     ///< Pyramid levels, WIDTH x HEIGHT down to 4 x 3
+    
+    OcclusionBuffer();
+    
+    /**
+     * @brief Clear the buffer for a new camera
+     * @param viewProjection Column-major 4x4 projection * view matrix (as from glm::value_ptr)
+     * @param eye Camera position, used to skip occluder faces turned away from it
+     */
+    void begin(const float* viewProjection, const float (&eye)[3]);
+    
+    /**
+     * @brief Rasterize a solid box (its faces toward the eye) as an occluder
+     * 
+     * Faces are clipped at the near plane, so boxes around or beside the
+     * camera still occlude. Each texel keeps the nearest occluder, at the
+     * farthest depth the occluder reaches inside that texel.
+     */
+    void addOccluder(const float (&minCorner)[3], const float (&maxCorner)[3]);
+    
+    /**
+     * @brief Build the pyramid; call after the last addOccluder() of a frame
+     */
+    void finish();
+    
+    /**
+     * @brief Test whether any part of a box may be visible past the occluders
+     * @return false only if the box is behind occluders everywhere it projects
+     * 
+     * Boxes that cross the near plane always count as visible. The box's
+     * screen rectangle is widened by a texel, making up for occluder texels
+     * that are only partly covered.
+     */
+    bool isBoxVisible(const float (&minCorner)[3], const float (&maxCorner)[3]) const;
+    
+    /**
+     * @brief Whether anything was rasterized since begin()
+     */
+    bool hasOccluders() const { return occluderCount > 0; }
+    
+    int getOccluderCount() const { return occluderCount; }
+
+private:
+    /// Clip-space vertex (x, y, z, w)
+    struct ClipVertex {
+        float x, y, z, w;
+    };
+    
+    // Transform a world-space point to clip space
+    ClipVertex toClip(float x, float y, float z) const;
+    
+    // Clip a convex polygon at the near plane and rasterize what is left
+    void rasterizePolygon(const ClipVertex* polygon, int count);
+    
+    // Rasterize one screen-space triangle (x, y in texels, z depth 0-1)
+    void rasterizeTriangle(const float (&a)[3], const float (&b)[3], const float (&c)[3]);
+    
+    float viewProjection[16];
+    float eye[3];
+    int occluderCount;
+    std::vector<float> levels[LEVELS];   ///< Level 0 is the depth buffer; each level above holds 2x2 maxima
+    int levelWidth[LEVELS];
+    int levelHeight[LEVELS];
+};
+
+#endif // OCCLUSION_BUFFER_H
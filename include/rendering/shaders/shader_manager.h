@@ -14,6 +14,45 @@
 
 #include <glad/glad.h>
 #include <string>
+#include <cstdint>
+
+/**
+ * @struct FrameGlobals
+ * @brief Values shared by every draw of a frame (std140 block "FrameGlobals")
+ * 
+ * Mirrors the GLSL uniform block member for member; std140 places the two
+ * matrices at offsets 0 and 64, the world mapping at 128 and the scalars
+ * at 144, 148, 152 and 156, 160 bytes in all.
+ */
+struct FrameGlobals {
+    float view[16];             ///< Column-major view matrix
+    float projection[16];       ///< Column-major projection matrix
+    float worldToRender[4];     ///< WorldExtent::renderMapping() of the drawn city
+    float timeOfDay;            ///< Time in hours (0-24)
+    float ambient;              ///< DayNightCycle::getAmbientLightFactor()
+    float windowLight;          ///< DayNightCycle::getWindowLightFactor()
+    float trafficAlpha;         ///< Blend between the last two traffic steps (SHADER_GPU_CARS)
+};
+
+static_assert(sizeof(FrameGlobals) == 160, "FrameGlobals must match the std140 layout");
+
+/**
+ * @enum ShaderFeature
+ * @brief Feature bits selecting a program permutation
+ * 
+ * Each combination is compiled as its own program with the matching
+ * #defines, so shaders never branch on these at runtime.
+ */
+enum ShaderFeature : unsigned {
+    SHADER_MAP_2D = 1,          ///< 2D map: points projected straight onto the map
+    SHADER_INSTANCED = 2,       ///< Per-instance position, heading and color (cars)
+    SHADER_TEXTURED = 4,        ///< Sample buildingTex instead of the flat color
+    SHADER_WINDOW_LIGHTS = 8,   ///< Window grid lit from windowOccupancy (with SHADER_TEXTURED and SHADER_BUILDING_INSTANCES)
+    SHADER_MATERIAL_ARRAY = 16, ///< Texture from materialTex at the vertex's material layer (with SHADER_TEXTURED)
+    SHADER_BUILDING_INSTANCES = 32, ///< Unit box scaled and placed per building instance (instead of SHADER_INSTANCED)
+    SHADER_QUANTIZED = 64,      ///< 16-bit normalized positions and UVs, see setVertexQuantization()
+    SHADER_GPU_CARS = 128       ///< Instances are GpuCarState records, placed in the shader (with SHADER_INSTANCED)
+};
 
 /**
  * @class ShaderManager
@@ -21,25 +60,31 @@
  * 
  * Handles all shader-related operations including:
  * - Vertex and fragment shader source code
- * - Shader compilation
- * - Program linking
+ * - Compilation of one program per ShaderFeature combination
+ * - Program binary caching on disk (when the driver supports it)
  * - Uniform location caching
+ * - Shadowing of uniform values and the bound texture
+ * 
+ * The flag setters (setIs2D, setUseTexture, ...) pick the permutation and
+ * switch programs only when the combination changes. Every setter
+ * remembers the value it last sent and skips the GL call when asked for
+ * the same value again, so render passes can state the full state they
+ * need without paying for redundant glUseProgram, glUniform* or
+ * glBindTexture calls. This relies on the programs' uniforms only being
+ * changed through this class.
  */
 class ShaderManager {
-private:
-    GLuint shaderProgram;           ///< Compiled shader program ID
-    bool isCompiled;                ///< Compilation status flag
-    
-    // Cached uniform locations
-    GLint colorLocation;
-    GLint viewLocation;
-    GLint projectionLocation;
-    GLint useTextureLocation;
-    GLint is2DLocation;
-    GLint showWindowLightsLocation;
-    GLint timeOfDayLocation;
-    
 public:
+    static constexpr GLuint FRAME_GLOBALS_BINDING = 0;  ///< Uniform buffer binding point
+    static constexpr unsigned PERMUTATION_COUNT = 256;  ///< One slot per ShaderFeature combination
+    static constexpr GLuint MATERIAL_LAYER_ATTRIBUTE = 4;  ///< Vertex attribute with the material layer
+    static constexpr GLuint BUILDING_INSTANCE_ATTRIBUTE = 5;  ///< (x, y, width, depth), then height at + 1
+    static constexpr GLuint BUILDING_INDEX_ATTRIBUTE = 7;  ///< city.buildings index of an instance (integer)
+    static constexpr GLuint CAR_POSE_ATTRIBUTE = 2;     ///< SHADER_GPU_CARS: (x, y, previous x, previous y) in world units
+    static constexpr GLuint CAR_COLOR_ATTRIBUTE = 3;    ///< Car color (SHADER_INSTANCED)
+    static constexpr GLuint CAR_HEADING_ATTRIBUTE = 8;  ///< SHADER_GPU_CARS: unit heading in world units
+    static constexpr GLuint WINDOW_OCCUPANCY_UNIT = 1;  ///< Texture unit of windowOccupancy
+    
     /**
      * @brief Construct a new Shader Manager
      */
@@ -51,26 +96,68 @@ public:
     ~ShaderManager();
     
     /**
-     * @brief Compile and link the city designer shader program
+     * @brief Store linked programs in a directory and reuse them next run
+     * @param directory Cache directory (created if missing), e.g. "shader_cache/"
+     * @param loader GL function loader (as passed to gladLoadGLLoader)
+     * @return false if the driver cannot save program binaries (shaders
+     *         then always compile from source)
+     * 
+     * Needs OpenGL 4.1 or GL_ARB_get_program_binary, whose entry points the
+     * 3.3 loader does not provide. Call before compileShaders(). Binaries
+     * are keyed by the GL renderer, its version and the shader source, so
+     * driver updates and shader edits simply miss the cache.
+     */
+    bool enableProgramCache(const std::string& directory, GLADloadproc loader);
+    
+    /**
+     * @brief Compile and link the city designer shader programs
      * @return true if compilation successful, false otherwise
      * 
-     * Compiles vertex and fragment shaders, links them into a program,
-     * and caches uniform locations for faster access.
+     * Builds (or loads from the program cache) the permutations the
+     * renderer draws with, so errors surface at startup. Any other
+     * combination is built the first time it is requested.
      */
     bool compileShaders();
     
     /**
-     * @brief Use this shader program for rendering
+     * @brief Use the current permutation for rendering
+     * 
+     * Calls glUseProgram with the program of the current feature set. Call
+     * once per frame before drawing: it also forgets the bound texture,
+     * since texture creation binds textures behind this class's back.
+     * Uniform shadows stay valid (uniforms are program state).
+     */
+    void use();
+    
+    /**
+     * @brief Bind a 2D texture to unit 0 unless it is already bound
+     * @param texture Texture ID (0 leaves the current binding alone)
+     */
+    void bindTexture(GLuint texture);
+    
+    /**
+     * @brief Bind a 2D array texture to unit 0 unless it is already bound
+     * @param texture Texture ID (0 leaves the current binding alone)
+     * 
+     * The array binding is separate from the 2D one; permutations with
+     * SHADER_MATERIAL_ARRAY sample it instead of buildingTex.
+     */
+    void bindTextureArray(GLuint texture);
+    
+    /**
+     * @brief Bind the window occupancy texture to WINDOW_OCCUPANCY_UNIT
+     * @param texture BuildingLightingSystem::getOccupancyTexture() (0 leaves the binding alone)
      * 
-     * Calls glUseProgram with the compiled shader program ID.
+     * Nothing else uses that unit, so the binding lasts across frames and
+     * is only redone when the texture changes. Unit 0 stays active.
      */
-    void use() const;
+    void bindWindowOccupancy(GLuint texture);
     
     /**
-     * @brief Get the shader program ID
+     * @brief Get the program ID of the current permutation
      * @return OpenGL shader program ID
      */
-    GLuint getProgram() const { return shaderProgram; }
+    GLuint getProgram() const { return programs[features].id; }
     
     /**
      * @brief Check if shaders are compiled
@@ -78,47 +165,191 @@ public:
      */
     bool isReady() const { return isCompiled; }
     
-    // Uniform setters for convenience
-    void setColor(float r, float g, float b) const;
-    void setView(const float* viewMatrix) const;
-    void setProjection(const float* projectionMatrix) const;
-    void setUseTexture(bool use) const;
-    void setIs2D(bool is2D) const;
-    void setShowWindowLights(bool show) const;
-    void setTimeOfDay(float time) const;
-    
-    // Get uniform locations (for advanced usage)
-    GLint getColorLocation() const { return colorLocation; }
-    GLint getViewLocation() const { return viewLocation; }
-    GLint getProjectionLocation() const { return projectionLocation; }
-    GLint getUseTextureLocation() const { return useTextureLocation; }
-    GLint getIs2DLocation() const { return is2DLocation; }
+    /**
+     * @brief Upload the per-frame globals (once per frame, before drawing)
+     * @param globals View, projection and lighting of the frame
+     * 
+     * Every program reads them from one uniform buffer, so a single upload
+     * serves all programs. Skipped when nothing changed since the last
+     * frame (a still camera with paused time).
+     */
+    void setFrameGlobals(const FrameGlobals& globals);
     
+    /**
+     * @brief Select the permutation for a combination of ShaderFeature bits
+     * @param featureBits OR of ShaderFeature values
+     * 
+     * Switches programs only if the combination differs from the current
+     * one. SHADER_WINDOW_LIGHTS and SHADER_MATERIAL_ARRAY are dropped
+     * unless SHADER_TEXTURED is set (SHADER_WINDOW_LIGHTS also without
+     * SHADER_BUILDING_INSTANCES), SHADER_INSTANCED is dropped next
+     * to SHADER_BUILDING_INSTANCES, SHADER_GPU_CARS without SHADER_INSTANCED,
+     * and SHADER_QUANTIZED next to either instancing bit (instanced
+     * meshes are never packed).
+     */
+    void setFeatures(unsigned featureBits);
+    unsigned getFeatures() const { return features; }
+    
+    // Uniform setters for convenience (unchanged values are not re-sent)
+    void setColor(float r, float g, float b);
+    
+    /**
+     * @brief Set the pixel diameter of 2D map points (SHADER_MAP_2D)
+     * @param size Diameter written to gl_PointSize (GL_PROGRAM_POINT_SIZE)
+     */
+    void setPointSize(float size);
+    
+    /**
+     * @brief Set the box packed vertices are relative to (SHADER_QUANTIZED)
+     * @param origin Position of component value 0 (x, y, z)
+     * @param scale Position span of the full 0..65535 range
+     * @param texCoordTransform UV of value 0, then the UV span (u, v, du, dv)
+     * 
+     * Like the color, the box applies to every quantized program and is
+     * sent again only to programs that have not seen it.
+     */
+    void setVertexQuantization(const float origin[3], const float scale[3], const float texCoordTransform[4]);
+    
+    // Feature flags; each selects the permutation with that bit changed
+    void setUseTexture(bool use) { setFeature(SHADER_TEXTURED, use); }
+    void setIs2D(bool is2D) { setFeature(SHADER_MAP_2D, is2D); }
+    void setShowWindowLights(bool show) { setFeature(SHADER_WINDOW_LIGHTS, show); }
+    void setInstanced(bool instanced) { setFeature(SHADER_INSTANCED, instanced); }
+
 private:
+    /// One linked permutation
+    struct Program {
+        GLuint id = 0;
+        GLint colorLocation = -1;       ///< -1 where the permutation has no flat color
+        float color[3] = {};            ///< Last color sent to this program
+        bool colorKnown = false;
+        GLint pointSizeLocation = -1;   ///< -1 outside the MAP_2D permutations
+        float pointSize = 0.0f;         ///< Last point size sent to this program
+        bool pointSizeKnown = false;
+        GLint quantizationLocations[3] = {-1, -1, -1};  ///< positionOrigin, positionScale, texCoordTransform
+        float quantization[10] = {};    ///< Last box sent to this program
+        bool quantizationKnown = false;
+    };
+    
+    Program programs[PERMUTATION_COUNT];
+    unsigned features;              ///< Current ShaderFeature combination
+    unsigned requestedFeatures;     ///< Flags as set, before normalization
+    bool isCompiled;                ///< Compilation status flag
+    
+    float color[3];                 ///< Color requested by setColor (applies to every program)
+    bool colorSet;
+    float pointSize;                ///< Point size requested by setPointSize (2D programs)
+    float quantization[10];         ///< Box requested by setVertexQuantization (origin, scale, UV transform)
+    bool quantizationSet;
+    
+    GLuint frameGlobalsBuffer;      ///< Uniform buffer behind FrameGlobals
+    FrameGlobals frameGlobals;      ///< Last uploaded globals
+    bool frameGlobalsKnown;
+    GLuint boundTexture;            ///< Texture on GL_TEXTURE_2D of unit 0 (0 = unknown)
+    GLuint boundTextureArray;       ///< Texture on GL_TEXTURE_2D_ARRAY of unit 0 (0 = unknown)
+    GLuint boundOccupancy;          ///< Texture on WINDOW_OCCUPANCY_UNIT (0 = none)
+    
+    // Program binary caching (ARB_get_program_binary entry points, loaded at runtime)
+    typedef void (APIENTRYP GetProgramBinaryProc)(GLuint, GLsizei, GLsizei*, GLenum*, void*);
+    typedef void (APIENTRYP ProgramBinaryProc)(GLuint, GLenum, const void*, GLsizei);
+    typedef void (APIENTRYP ProgramParameteriProc)(GLuint, GLenum, GLint);
+    GetProgramBinaryProc getProgramBinary;
+    ProgramBinaryProc programBinary;
+    ProgramParameteriProc programParameteri;
+    std::string cacheDirectory;     ///< Empty while the program cache is off
+    
     /**
      * @brief Get vertex shader source code
-     * @return GLSL vertex shader source as string
+     * @return GLSL vertex shader source (without #version and #defines)
      */
     static const char* getVertexShaderSource();
     
     /**
      * @brief Get fragment shader source code
-     * @return GLSL fragment shader source as string
+     * @return GLSL fragment shader source (without #version and #defines)
      */
     static const char* getFragmentShaderSource();
     
+    /**
+     * @brief #define lines enabling a feature combination
+     */
+    static std::string featureDefines(unsigned featureBits);
+    
+    /**
+     * @brief Drop bits that have no effect (window lights or materials without texture)
+     */
+    static unsigned normalizeFeatures(unsigned featureBits);
+    
     /**
      * @brief Compile a shader from source
      * @param type GL_VERTEX_SHADER or GL_FRAGMENT_SHADER
+     * @param defines #define lines inserted after the #version line
      * @param source GLSL source code
      * @return Compiled shader ID, or 0 on failure
      */
-    GLuint compileShader(GLenum type, const char* source);
+    GLuint compileShader(GLenum type, const std::string& defines, const char* source);
+    
+    /**
+     * @brief Link a program for a feature combination from source
+     * @return Program ID, or 0 on failure
+     */
+    GLuint linkProgram(unsigned featureBits);
+    
+    /**
+     * @brief Make the permutation for a feature combination available
+     * @return false if it failed to compile or link
+     * 
+     * Tries the program cache first and stores freshly linked programs in it.
+     */
+    bool buildProgram(unsigned featureBits);
+    
+    /**
+     * @brief Cache key of a permutation (renderer, GL version and source)
+     */
+    uint64_t programCacheKey(unsigned featureBits) const;
+    std::string programCachePath(uint64_t key) const;
+    
+    /**
+     * @brief Create a program from a cached binary
+     * @return Program ID, or 0 if there is no usable binary
+     */
+    GLuint loadCachedProgram(uint64_t key);
+    
+    /**
+     * @brief Write a linked program's binary to the cache (best effort)
+     */
+    void saveCachedProgram(uint64_t key, GLuint program);
+    
+    /**
+     * @brief Cache uniform locations of a permutation for faster access
+     */
+    void cacheUniformLocations(Program& program);
+    
+    /**
+     * @brief Attach a program's FrameGlobals block to the shared buffer
+     * @return false if the program does not declare the block
+     */
+    bool bindFrameGlobals(GLuint program);
+    
+    /**
+     * @brief Set or clear one feature bit of the requested combination
+     */
+    void setFeature(ShaderFeature feature, bool enabled);
+    
+    /**
+     * @brief Send the requested color to the current program if it differs
+     */
+    void syncColor();
+    
+    /**
+     * @brief Send the requested point size to the current program if it differs
+     */
+    void syncPointSize();
     
     /**
-     * @brief Cache uniform locations for faster access
+     * @brief Send the requested quantization box to the current program if it differs
      */
-    void cacheUniformLocations();
+    void syncQuantization();
 };
 
 #endif // SHADER_MANAGER_H
@@ -3,8 +3,23 @@
  * @brief Texture Management System for City Designer
  * 
  * Handles loading, caching, and management of all textures used in the application.
- * Supports JPG and PNG formats using STB Image library.
- * Provides fallback procedural textures if file loading fails.
+ * Supports JPG and PNG formats using STB Image library, and pre-compressed
+ * KTX2 files (BC1/BC3/BC7, ETC2 or plain RGB(A)8 with their mip levels).
+ * Provides fallback procedural textures if file loading fails; those are
+ * generated at the size they are sampled at and, with a cache directory,
+ * stored as KTX2 files keyed by a hash of what they were generated from,
+ * so later runs read them back instead of generating them again.
+ * 
+ * Textures load in the background: every texture exists from the start as
+ * a 1x1 placeholder of its material color, decode threads read and
+ * prepare the real images, and update() swaps them in on the GL thread
+ * through a pixel buffer object. Decoded images are reduced to at most
+ * MAX_TEXTURE_SIZE, get a full mip chain and are BC1-compressed when the
+ * driver supports S3TC.
+ * 
+ * The building materials (brick, concrete, glass) are not separate
+ * textures but the layers of one GL_TEXTURE_2D_ARRAY, so every building
+ * draws with the same binding whatever its material.
  * 
  * @author City Designer Team
  * @date November 2025
@@ -16,6 +31,23 @@
 #include <glad/glad.h>
 #include <string>
 #include <map>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+/**
+ * @enum BuildingMaterial
+ * @brief Layer of a material in the building material array
+ */
+enum BuildingMaterial : unsigned char {
+    MATERIAL_BRICK = 0,
+    MATERIAL_CONCRETE = 1,
+    MATERIAL_GLASS = 2,
+    MATERIAL_COUNT = 3
+};
 
 /**
  * @class TextureManager
@@ -23,13 +55,21 @@
  * 
  * This class provides a centralized system for handling all textures in the application.
  * It supports:
- * - Loading textures from image files (JPG, PNG)
+ * - Loading textures from image files (JPG, PNG) or KTX2 containers
+ * - Decoding on background threads, uploading on the GL thread
  * - Generating procedural textures as fallbacks
  * - Caching loaded textures to avoid redundant loading
  * - Proper cleanup of GPU resources
+ * 
+ * Texture IDs never change: a texture's placeholder storage is replaced
+ * in place when its image arrives, so callers can keep the ID.
  */
 class TextureManager {
 public:
+    static constexpr int MAX_TEXTURE_SIZE = 2048;   ///< Largest edge kept from a decoded image
+    static constexpr int PROCEDURAL_SIZE = 256;     ///< Edge of generated 2D fallbacks (layers use MATERIAL_LAYER_SIZE)
+    static constexpr int MATERIAL_LAYER_SIZE = 1024; ///< Edge of every building material layer
+    
     /**
      * @brief Construct a new Texture Manager
      */
@@ -37,24 +77,49 @@ public:
     
     /**
      * @brief Destroy the Texture Manager and cleanup all textures
+     * 
+     * Waits for the decode threads to finish the image they are working on.
      */
     ~TextureManager();
     
     /**
-     * @brief Load all required textures for the city designer
+     * @brief Keep generated fallback textures in a directory and reuse them next run
+     * @param directory Cache directory (created if missing), e.g. "texture_cache/"
+     * 
+     * Call before loadAllTextures(). Files are keyed by the generator
+     * version, the texture type, its size and the upload format, so a
+     * driver without S3TC or a changed pattern simply misses the cache.
+     */
+    void enableProceduralCache(const std::string& directory);
+    
+    /**
+     * @brief Start loading all required textures for the city designer
      * 
      * Loads the following textures:
-     * - brick.jpg (for low-rise buildings)
-     * - concrete.jpg (for mid-rise buildings)
-     * - glass.jpg (for high-rise buildings)
-     * - road.jpg (for 3D road surfaces)
-     * - grass.jpg (for 3D park surfaces)
-     * - fountains.jpg (for 3D fountain surfaces)
+     * - brick, concrete and glass (building material layers, see getMaterialArray())
+     * - road (for 3D road surfaces)
+     * - grass (for 3D park surfaces)
+     * - fountains (for 3D fountain surfaces)
+     * 
+     * For each, assets/<name>.ktx2 is used if present and supported,
+     * otherwise assets/<name>.jpg. If neither loads, a procedural texture
+     * is read from the procedural cache or generated as fallback.
      * 
-     * If any texture fails to load, a procedural texture is generated as fallback.
+     * Returns immediately; every texture is usable right away as a
+     * placeholder and becomes ready once update() has uploaded it.
      */
     void loadAllTextures();
     
+    /**
+     * @brief Upload textures that finished decoding (call once per frame)
+     * 
+     * Uploads at most one texture per call so a frame never stalls on
+     * several large uploads. Must run on the thread that owns the GL
+     * context, and binds textures (ShaderManager::use() forgets its
+     * texture binding for this reason).
+     */
+    void update();
+    
     /**
      * @brief Get a texture by name
      * @param name Texture identifier (e.g., "brick", "road", "grass")
@@ -62,6 +127,16 @@ public:
      */
     GLuint getTexture(const std::string& name) const;
     
+    /**
+     * @brief Get the building material array
+     * @return GL_TEXTURE_2D_ARRAY with one MATERIAL_LAYER_SIZE square layer
+     *         per BuildingMaterial (0 before loadAllTextures())
+     * 
+     * Images are resampled to the square layer size, so materials tile
+     * the same way whatever the source aspect ratio.
+     */
+    GLuint getMaterialArray() const { return getTexture("materials"); }
+    
     /**
      * @brief Check if a texture is loaded
      * @param name Texture identifier
@@ -69,6 +144,18 @@ public:
      */
     bool hasTexture(const std::string& name) const;
     
+    /**
+     * @brief Check if a texture's final image has been uploaded
+     * @param name Texture identifier (material names such as "brick" refer to their layer)
+     * @return false while it is still a placeholder (or unknown)
+     */
+    bool isTextureReady(const std::string& name) const;
+    
+    /**
+     * @brief Check if every requested texture has been uploaded
+     */
+    bool allTexturesReady() const { return pendingUploads == 0; }
+    
     /**
      * @brief Cleanup all loaded textures
      * 
@@ -76,35 +163,180 @@ public:
      * Called automatically in destructor.
      */
     void cleanup();
-    
+
 private:
+    /// One mip level inside DecodedTexture::data
+    struct TextureLevel {
+        int width;
+        int height;
+        size_t offset;
+        size_t size;
+    };
+    
+    /// A texture's image, prepared off the GL thread and ready to upload
+    struct DecodedTexture {
+        std::string name;
+        std::string source;                 ///< Where it came from (for the log)
+        int layer = -1;                     ///< Material array layer, -1 for a 2D texture
+        GLenum internalFormat = GL_RGB8;
+        GLenum pixelFormat = GL_RGB;        ///< Uncompressed data layout (unused if compressed)
+        bool compressed = false;
+        bool generateMipmaps = false;       ///< Let GL build the chain (KTX2 without levels)
+        std::vector<unsigned char> data;    ///< Every level back to back
+        std::vector<TextureLevel> levels;   ///< Largest first
+    };
+    
+    /// A texture to load: file base name and the fallback it falls back to
+    struct TextureRequest {
+        std::string name;                   ///< Cache key
+        std::string file;                   ///< assets/<file>.ktx2 or .jpg
+        std::string fallbackType;           ///< generateProceduralPixels() type
+        int layer;                          ///< BuildingMaterial, or -1 for a 2D texture
+        unsigned char placeholder[3];       ///< Color shown until the image is ready
+    };
+    
+    /// Compressed formats the driver can sample (read-only while decoding)
+    struct CompressionSupport {
+        bool s3tc = false;                  ///< BC1/BC3
+        bool bptc = false;                  ///< BC7
+        bool etc2 = false;
+    };
+    
+    /**
+     * @brief Cache of loaded textures
+     * Maps texture name to OpenGL texture ID
+     */
+    std::map<std::string, GLuint> textureCache;
+    std::map<std::string, bool> textureReady;
+    
+    // Background decoding
+    std::vector<TextureRequest> requests;
+    std::vector<std::thread> decodeThreads;
+    std::atomic<size_t> nextRequest;
+    std::atomic<bool> stopping;
+    std::mutex decodedMutex;
+    std::vector<DecodedTexture> decoded;    ///< Finished, waiting for update()
+    size_t pendingUploads;                  ///< Requests not uploaded yet
+    CompressionSupport support;
+    
+    GLuint uploadBuffer;                    ///< GL_PIXEL_UNPACK_BUFFER for uploads
+    size_t textureBytes;                    ///< GPU memory of the uploaded textures
+    std::chrono::steady_clock::time_point loadStart;
+    std::string proceduralCacheDirectory;   ///< Empty while the procedural cache is off
+    
+    /**
+     * @brief Decode thread: prepare requests until none are left
+     */
+    void decodeLoop();
+    
+    /**
+     * @brief Load, reduce, mip and compress one request (any thread)
+     */
+    DecodedTexture decodeTexture(const TextureRequest& request) const;
+    
+    /**
+     * @brief Read a KTX2 file with its mip levels
+     * @param filepath Path to the .ktx2 file
+     * @param texture Filled on success
+     * @return false if the file is missing, malformed or in a format the driver cannot sample
+     * 
+     * Only 2D, single-layer, non-supercompressed files are accepted. Images
+     * are uploaded as stored, so they must be authored bottom row first
+     * (e.g. toktx --lower_left_maps_to_s0t0), like the flipped JPEGs.
+     */
+    bool loadKtx2(const std::string& filepath, DecodedTexture& texture) const;
+    
+    /**
+     * @brief Write a mip chain made by buildMipChain() as a KTX2 file
+     * @return false if the file could not be written (the cache is best effort)
+     * 
+     * Levels are stored smallest first with a basic data format
+     * descriptor, so the files also open in KTX tools.
+     */
+    static bool saveKtx2(const std::string& filepath, const DecodedTexture& texture);
+    
+    /**
+     * @brief Cache file of a generated texture ("" while the cache is off)
+     */
+    std::string proceduralCachePath(const std::string& type, int size) const;
+    
     /**
      * @brief Load a texture from an image file
      * @param filepath Path to the image file (JPG or PNG)
-     * @return GLuint OpenGL texture ID (0 if loading fails)
-     * 
-     * Uses STB Image to load the file and creates an OpenGL texture with:
-     * - Mipmapping enabled
-     * - Linear filtering for smooth appearance
-     * - Repeat wrapping mode
+     * @param pixels RGB pixels, bottom row first
+     * @param width Image width
+     * @param height Image height
+     * @return false if loading fails
      */
-    GLuint loadTextureFromFile(const std::string& filepath);
+    static bool loadImageFile(const std::string& filepath, std::vector<unsigned char>& pixels,
+                              int& width, int& height);
     
     /**
      * @brief Generate a procedural texture as fallback
-     * @param type Type of texture to generate ("brick", "concrete", "glass", "asphalt", "grass")
-     * @return GLuint OpenGL texture ID
+     * @param type Type of texture to generate ("brick", "concrete", "glass", "asphalt", "grass", "water")
+     * @param size Edge in texels; patterns scale with it, so any size shows the same layout
+     * @return size x size RGB pixels
      * 
      * Creates a simple colored texture when file loading fails.
      * Colors are chosen to match the material type.
      */
-    GLuint generateProceduralTexture(const std::string& type);
+    static std::vector<unsigned char> generateProceduralPixels(const std::string& type, int size);
     
     /**
-     * @brief Cache of loaded textures
-     * Maps texture name to OpenGL texture ID
+     * @brief Turn RGB pixels into an uploadable mip chain
+     * 
+     * Halves the image until it fits MAX_TEXTURE_SIZE, then stores every
+     * level down to 1x1, BC1-compressed if S3TC is available.
      */
-    std::map<std::string, GLuint> textureCache;
+    void buildMipChain(std::vector<unsigned char> pixels, int width, int height,
+                       DecodedTexture& texture) const;
+    
+    /**
+     * @brief Resample RGB pixels to a MATERIAL_LAYER_SIZE square
+     */
+    static std::vector<unsigned char> resampleToLayer(std::vector<unsigned char> pixels, int width, int height);
+    
+    /**
+     * @brief Check that a decoded texture can be copied into the material array
+     */
+    bool matchesMaterialArray(const DecodedTexture& texture) const;
+    
+    /**
+     * @brief Create a texture object holding a 1x1 placeholder color
+     */
+    static GLuint createPlaceholder(const unsigned char color[3]);
+    
+    /**
+     * @brief Create the material array with every layer a placeholder color
+     */
+    GLuint createMaterialArray();
+    
+    /**
+     * @brief Copy a texture's data into the pixel buffer for upload
+     * @return Base pointer for the upload calls (offsets into the buffer,
+     *         or client memory if mapping failed)
+     */
+    const unsigned char* stageUpload(const DecodedTexture& texture);
+    
+    /**
+     * @brief Replace a texture's storage with a decoded image through the PBO
+     */
+    void uploadTexture(GLuint textureID, const DecodedTexture& texture);
+    
+    /**
+     * @brief Overwrite one layer of the material array (every mip level)
+     */
+    void uploadMaterialLayer(GLuint arrayID, const DecodedTexture& texture);
+    
+    /**
+     * @brief Query which compressed formats the driver supports (GL thread)
+     */
+    static CompressionSupport queryCompressionSupport();
+    
+    /**
+     * @brief Stop and join the decode threads
+     */
+    void stopDecoding();
 };
 
 #endif // TEXTURE_MANAGER_H
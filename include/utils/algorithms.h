@@ -15,6 +15,7 @@
 
 #include <vector>
 #include <cmath>
+#include <cstddef>
 
 /**
  * @struct Point
@@ -36,6 +37,92 @@ struct Point {
     Point(int x = 0, int y = 0) : x(x), y(y) {}
 };
 
+/**
+ * @struct Circle
+ * @brief Analytic circle (center + radius) in pixel coordinates
+ * 
+ * Parks and the fountain are stored in this form so collision tests are
+ * O(1). The midpoint-circle outline is only derived when a renderer
+ * actually needs its pixels.
+ */
+struct Circle {
+    float x;       ///< Center X coordinate
+    float y;       ///< Center Y coordinate
+    float radius;  ///< Radius in pixels (0 = no circle)
+    
+    /**
+     * @brief Construct a new Circle
+     * @param x Center X coordinate (default: 0)
+     * @param y Center Y coordinate (default: 0)
+     * @param radius Radius in pixels (default: 0)
+     */
+    Circle(float x = 0.0f, float y = 0.0f, float radius = 0.0f) : x(x), y(y), radius(radius) {}
+    
+    /**
+     * @brief Check whether the circle exists (non-zero radius)
+     */
+    bool isValid() const { return radius > 0.0f; }
+    
+    /**
+     * @brief Check if a point lies inside or on the circle
+     */
+    bool contains(float px, float py) const {
+        float dx = px - x;
+        float dy = py - y;
+        return dx * dx + dy * dy <= radius * radius;
+    }
+    
+    /**
+     * @brief Check if the circle, grown by a buffer, touches a rectangle
+     * @param left Rectangle left edge
+     * @param top Rectangle top edge
+     * @param right Rectangle right edge
+     * @param bottom Rectangle bottom edge
+     * @param buffer Extra clearance added to both rectangle and circle
+     */
+    bool intersectsRect(float left, float top, float right, float bottom, float buffer = 0.0f) const;
+    
+    /**
+     * @brief Clip a line segment against the circle
+     * 
+     * Solves |p0 + s * (p1 - p0) - center| = radius for s.
+     * 
+     * @param x0 Segment start X
+     * @param y0 Segment start Y
+     * @param x1 Segment end X
+     * @param y1 Segment end Y
+     * @param sEnter Output: segment parameter (0-1) where it enters the circle
+     * @param sExit Output: segment parameter (0-1) where it leaves the circle
+     * @return true if part of the segment lies inside the circle
+     */
+    bool clipSegment(float x0, float y0, float x1, float y1, float& sEnter, float& sExit) const;
+    
+    /**
+     * @brief Rasterize the outline with the Midpoint Circle Algorithm
+     * @return std::vector<Point> Outline pixels (empty if not valid)
+     */
+    std::vector<Point> rasterize() const;
+    
+    /**
+     * @brief Number of outline pixels rasterize() produces (0 if not valid)
+     */
+    size_t rasterizedLength() const;
+    
+    /**
+     * @brief Rasterize the outline into a caller-provided buffer
+     * @param out Receives rasterizedLength() points
+     * @return size_t Number of points written
+     */
+    size_t rasterize(Point* out) const;
+    
+    /**
+     * @brief Recover a circle from outline pixels (centroid + max distance)
+     * @param points Outline pixels, e.g. from a legacy save
+     * @return Circle Fitted circle (invalid if points is empty)
+     */
+    static Circle fromPoints(const std::vector<Point>& points);
+};
+
 /**
  * @brief Bresenham's Line Algorithm
  * 
@@ -62,6 +149,42 @@ struct Point {
  */
 std::vector<Point> bresenhamLine(int x0, int y0, int x1, int y1);
 
+/**
+ * @brief Number of points bresenhamLine() produces for a segment
+ * 
+ * Exact: one point per step along the major axis, plus the start.
+ */
+size_t bresenhamLineLength(int x0, int y0, int x1, int y1);
+
+/**
+ * @brief Bresenham's Line Algorithm into a caller-provided buffer
+ * @param out Receives bresenhamLineLength(x0, y0, x1, y1) points
+ * @return size_t Number of points written
+ * 
+ * Same points as the vector version. Horizontal, vertical and 45-degree
+ * runs (every grid road and many radial ones) step both axes by a
+ * constant, so they are written by a branch-free loop the compiler
+ * vectorizes; other slopes run the integer error loop.
+ */
+size_t bresenhamLine(int x0, int y0, int x1, int y1, Point* out);
+
+/**
+ * @brief Number of points bresenhamPolyline() produces for a path
+ */
+size_t bresenhamPolylineLength(const Point* path, size_t count);
+
+/**
+ * @brief Rasterize every segment of a path in one call
+ * @param path Polyline vertices
+ * @param count Number of vertices (a lone vertex yields one point)
+ * @param out Receives bresenhamPolylineLength(path, count) points
+ * @return size_t Number of points written
+ * 
+ * Consecutive segments share their joint pixel, so the output is one
+ * gap-free chain (the form Road::rasterize() returns).
+ */
+size_t bresenhamPolyline(const Point* path, size_t count, Point* out);
+
 /**
  * @brief Midpoint Circle Algorithm
  * 
@@ -88,4 +211,54 @@ std::vector<Point> bresenhamLine(int x0, int y0, int x1, int y1);
  */
 std::vector<Point> midpointCircle(int centerX, int centerY, int radius);
 
+/**
+ * @brief Number of points midpointCircle() produces for a radius
+ * 
+ * Runs the decision loop without storing anything: O(radius), no allocation.
+ */
+size_t midpointCircleLength(int radius);
+
+/**
+ * @brief Midpoint Circle Algorithm into a caller-provided buffer
+ * @param out Receives midpointCircleLength(radius) points
+ * @return size_t Number of points written (same points as the vector version)
+ */
+size_t midpointCircle(int centerX, int centerY, int radius, Point* out);
+
+/**
+ * @brief Split a pixel chain into gap-free runs
+ * 
+ * Starts a new run wherever two consecutive points are not 8-connected
+ * (e.g. where a rasterized line was cut by an obstacle).
+ * 
+ * @param pixels Ordered pixel chain
+ * @return std::vector<std::vector<Point>> Connected runs, in order
+ */
+std::vector<std::vector<Point>> splitPixelRuns(const std::vector<Point>& pixels);
+
+/**
+ * @brief Collapse an ordered pixel chain into polyline vertices
+ * 
+ * Greedily extends each polyline segment while every skipped pixel stays
+ * within @p tolerance of the segment, so a Bresenham line collapses back
+ * to its two endpoints and a curve keeps only its corners.
+ * 
+ * @param pixels Ordered, gap-free pixel chain (see splitPixelRuns)
+ * @param tolerance Maximum distance in pixels of a dropped pixel from its segment
+ * @return std::vector<Point> Polyline vertices (first and last pixel always kept)
+ * 
+ * **Time Complexity**: O(n * k) where k is the longest resulting segment
+ */
+std::vector<Point> simplifyPolyline(const std::vector<Point>& pixels, float tolerance = 1.0f);
+
+/**
+ * @brief Test whether a line segment touches an axis-aligned rectangle
+ * 
+ * Liang-Barsky clipping of segment (x0,y0)-(x1,y1) against the rectangle.
+ * 
+ * @return true if any part of the segment lies inside or on the rectangle
+ */
+bool segmentIntersectsRect(float x0, float y0, float x1, float y1,
+                           float left, float top, float right, float bottom);
+
 #endif // ALGORITHMS_H
@@ -0,0 +1,49 @@
+/**
+ * @file cancellation_token.h
+ * @brief Cooperative Stop Flag for Long-Running Work
+ *
+ * The thread that started a task calls cancel(); the task polls
+ * isCancelled() at points where stopping leaves nothing half-written and
+ * returns early. Nothing is interrupted: a task that never polls runs to
+ * completion.
+ *
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef CANCELLATION_TOKEN_H
+#define CANCELLATION_TOKEN_H
+
+#include <atomic>
+
+/**
+ * @class CancellationToken
+ * @brief One atomic flag shared by the owner and the task it controls
+ *
+ * The owner keeps the token alive for as long as the task may poll it.
+ * reset() re-arms it for the next task once the previous one has stopped.
+ */
+class CancellationToken {
+public:
+    CancellationToken() : cancelled(false) {}
+
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken& operator=(const CancellationToken&) = delete;
+
+    /**
+     * @brief Ask the task to stop at its next check (safe from any thread)
+     */
+    void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief True once cancel() was called since the last reset()
+     */
+    bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+    void reset() { cancelled.store(false, std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> cancelled;
+};
+
+#endif // CANCELLATION_TOKEN_H
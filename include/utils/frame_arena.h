@@ -0,0 +1,79 @@
+/**
+ * @file frame_arena.h
+ * @brief Reusable Bump Allocator for Scratch Buffers
+ *
+ * Work that builds many small arrays at once (every mesh of a city)
+ * measures what it needs first, reserves it with one reset(), and then
+ * carves exact-size pieces out of a single block. Nothing is freed
+ * individually: the next reset() starts over in the same block, so after
+ * the first regeneration the allocator touches the heap only when a city
+ * is larger than every city before it.
+ *
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <memory>
+
+/**
+ * @class FrameArena
+ * @brief One contiguous block handed out front to back
+ *
+ * Pointers stay valid until the next reset(). allocate() never grows the
+ * block (that would move earlier pieces), so reset() must be given the
+ * total up front. Not thread-safe: allocate on one thread, then hand the
+ * disjoint pieces to as many writers as needed.
+ */
+class FrameArena {
+public:
+    static constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+
+    /**
+     * @brief Drop every allocation and make room for at least bytes
+     * @param bytes Sum of the allocations to come, each rounded up to ALIGNMENT
+     *
+     * Keeps the current block when it is large enough.
+     */
+    void reset(size_t bytes) {
+        top = 0;
+        if (bytes <= blockSize) return;
+        size_t units = (bytes + ALIGNMENT - 1) / ALIGNMENT;
+        block.reset(new std::max_align_t[units]);
+        blockSize = units * ALIGNMENT;
+    }
+
+    /**
+     * @brief Bytes reset() needs for count values of T
+     */
+    template <typename T>
+    static size_t bytesFor(size_t count) {
+        return (count * sizeof(T) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    /**
+     * @brief Carve an uninitialized array of count values
+     * @return nullptr if it does not fit in what reset() reserved
+     */
+    template <typename T>
+    T* allocate(size_t count) {
+        size_t bytes = bytesFor<T>(count);
+        if (top + bytes > blockSize) return nullptr;
+        T* piece = reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(block.get()) + top);
+        top += bytes;
+        return piece;
+    }
+
+    size_t capacity() const { return blockSize; }
+    size_t used() const { return top; }
+
+private:
+    std::unique_ptr<std::max_align_t[]> block;
+    size_t blockSize = 0;
+    size_t top = 0;
+};
+
+#endif // FRAME_ARENA_H
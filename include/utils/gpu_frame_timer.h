@@ -0,0 +1,72 @@
+/**
+ * @file gpu_frame_timer.h
+ * @brief Always-On GPU Time of Whole Frames
+ * 
+ * The profiler's GPU scopes only run while its overlay or a trace is on,
+ * and time single passes. GpuFrameTimer brackets a whole frame with two
+ * GL_TIMESTAMP queries instead, which cost next to nothing and do not
+ * clash with the profiler's GL_TIME_ELAPSED queries, so the frame's GPU
+ * cost is known at all times (for QualityGovernor).
+ * 
+ * Results are read a few frames later, when the GPU is done, without
+ * stalling.
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef GPU_FRAME_TIMER_H
+#define GPU_FRAME_TIMER_H
+
+#include <glad/glad.h>
+
+/**
+ * @class GpuFrameTimer
+ * @brief GPU milliseconds between begin() and end() of recent frames (GL thread only)
+ */
+class GpuFrameTimer {
+public:
+    static constexpr int FRAMES_IN_FLIGHT = 4;    ///< Frames a result may lag behind
+    
+    GpuFrameTimer();
+    
+    /**
+     * @brief Delete the GL query objects (the context must still be current)
+     */
+    ~GpuFrameTimer();
+    
+    GpuFrameTimer(const GpuFrameTimer&) = delete;
+    GpuFrameTimer& operator=(const GpuFrameTimer&) = delete;
+    
+    /**
+     * @brief Mark the start of a frame's GL commands
+     * 
+     * Collects finished frames first. When every slot is still in flight
+     * the frame is not timed.
+     */
+    void begin();
+    
+    /**
+     * @brief Mark the end of the frame begun last
+     */
+    void end();
+    
+    /**
+     * @brief GPU time of the newest finished frame in milliseconds (-1 before the first)
+     */
+    float getLastMs() const { return lastMs; }
+
+private:
+    /**
+     * @brief Read a finished frame; false if the GPU is not done with it yet
+     */
+    bool retire(int slot);
+    
+    GLuint queries[FRAMES_IN_FLIGHT][2];    ///< Start and end timestamps per slot
+    bool pending[FRAMES_IN_FLIGHT];
+    int next;                               ///< Slot of the next frame
+    bool timing;                            ///< begin() started a frame that end() must close
+    float lastMs;
+};
+
+#endif // GPU_FRAME_TIMER_H
@@ -6,7 +6,7 @@
  * - City generation controls (G key)
  * - Parameter adjustment (number keys, R, S, T, etc.)
  * - View mode switching (V for 2D/3D)
- * - Save/Load operations (C, L keys)
+ * - Save/Load operations (Z, X keys; J exports JSON)
  * - Mouse clicks for building placement (2D mode only)
  * 
  * The input handler maintains key states to prevent repeat
@@ -25,6 +25,7 @@
 
 // Forward declaration to avoid circular dependency
 class CityGenerator;
+class Profiler;
 
 /**
  * @class InputHandler
@@ -36,14 +37,23 @@ class CityGenerator;
  * Keyboard Input:
  * - G: Generate new city
  * - V: Toggle 2D/3D view
+ * - O: Toggle occlusion culling
+ * - Q: Toggle adaptive quality (QualityGovernor)
  * - R: Cycle road patterns (Grid → Radial → Random)
  * - S: Cycle skyline types (Low → Mid → High → Mixed)
  * - T: Cycle time of day / Toggle auto-progress
  * - 1-4: Adjust building count
  * - 5-6: Adjust layout size
  * - 7-0: Adjust park parameters
- * - C: Save city to JSON
- * - L: Load city from JSON
+ * - Z: Save city (binary .city)
+ * - J: Export city to JSON
+ * - X: Load city (binary, or JSON if no binary save exists)
+ * - F3: Toggle the frame profiler overlay
+ * - F4: Start/stop a Chrome trace capture (written to TRACE_FILE)
+ * - F5: Start/stop recording the traffic (sets flag)
+ * - F6: Start/stop replaying the last traffic recording (sets flag)
+ * - F7/F8: Seek the replay back/forward by REPLAY_SEEK_SECONDS
+ * - F9: Switch the traffic backend between CPU and GPU
  * - H: Show/hide help
  * - ESC: Exit application
  * 
@@ -56,16 +66,25 @@ class CityGenerator;
  * repeated actions when keys are held down.
  */
 class InputHandler {
+public:
+    static constexpr const char* TRACE_FILE = "profile_trace.json";  ///< Written when F4 stops a capture
+    static constexpr float REPLAY_SEEK_SECONDS = 10.0f;              ///< Replay jump per F7/F8 press
+    
 private:
     CityConfig& config;                         ///< Reference to city configuration
     bool keysPressed[GLFW_KEY_LAST];           ///< Key state tracking array
     CityGenerator* cityGen;                     ///< Pointer to city generator
+    Profiler* profiler;                         ///< Frame profiler (F3/F4), may be null
     
     // Mouse state for building placement
     bool mouseButtonPressed;                    ///< Left mouse button state
     double lastMouseX, lastMouseY;             ///< Mouse position at click
     bool buildingPlacementRequested;            ///< Flag: building placement pending
     bool loadRequested;                         ///< Flag: load operation requested
+    bool streamRequested;                       ///< Flag: start/stop tile streaming
+    bool recordRequested;                       ///< Flag: start/stop traffic recording
+    bool replayRequested;                       ///< Flag: start/stop traffic replay
+    float replaySeekSeconds;                    ///< Pending replay seek (negative = back)
     
 public:
     /**
@@ -86,6 +105,11 @@ public:
      */
     void setCityGenerator(CityGenerator* gen) { cityGen = gen; }
     
+    /**
+     * @brief Set the frame profiler controlled by F3 (overlay) and F4 (trace)
+     */
+    void setProfiler(Profiler* frameProfiler) { profiler = frameProfiler; }
+    
     /**
      * @brief Process all keyboard input
      * @param window GLFW window handle
@@ -94,14 +118,21 @@ public:
      * - ESC: Close window
      * - G: Request city generation
      * - V: Toggle 2D/3D view mode
+     * - O: Toggle occlusion culling
+     * - Q: Toggle adaptive quality
      * - R: Cycle road patterns
      * - S: Cycle skyline types
      * - T: Advance/toggle time
      * - 1-4: Building count adjustment
      * - 5-6: Layout size adjustment
      * - 7-0: Park/fountain parameters
-     * - C: Save city
-     * - L: Load city (sets flag)
+     * - Z: Save city (binary)
+     * - J: Export city as JSON
+     * - X: Load city (sets flag)
+     * - F3/F4: Profiler overlay / trace capture
+     * - F5/F6: Traffic recording / replay (sets flags)
+     * - F7/F8: Replay seek (accumulates seconds)
+     * - F9: Traffic backend (CPU/GPU)
      * - H: Toggle help display
      * 
      * Updates config immediately and sets flags for deferred actions.
@@ -138,8 +169,8 @@ public:
      * @brief Check if city generation was requested
      * @return true if G key was pressed
      * 
-     * Main loop checks this flag to know when to call
-     * cityGenerator.generateCity().
+     * Main loop checks this flag to know when to start a background
+     * generation (AsyncCityGenerator::start) with the current config.
      */
     bool generationRequested() const { return genRequested; }
     
@@ -187,6 +218,50 @@ public:
      */
     void clearLoadRequest() { loadRequested = false; }
     
+    /**
+     * @brief Check if starting/stopping the tile streaming was requested
+     * @return true if Y was pressed
+     */
+    bool streamToggleRequested() const { return streamRequested; }
+    
+    /**
+     * @brief Clear tile streaming request flag
+     */
+    void clearStreamToggleRequest() { streamRequested = false; }
+    
+    /**
+     * @brief Check if starting/stopping the traffic recording was requested
+     * @return true if F5 was pressed
+     */
+    bool recordToggleRequested() const { return recordRequested; }
+    
+    /**
+     * @brief Clear traffic recording request flag
+     */
+    void clearRecordToggleRequest() { recordRequested = false; }
+    
+    /**
+     * @brief Check if starting/stopping the traffic replay was requested
+     * @return true if F6 was pressed
+     */
+    bool replayToggleRequested() const { return replayRequested; }
+    
+    /**
+     * @brief Clear traffic replay request flag
+     */
+    void clearReplayToggleRequest() { replayRequested = false; }
+    
+    /**
+     * @brief Get the replay seek requested since the last clear
+     * @return Seconds to jump (F7 back, F8 forward), 0 if none
+     */
+    float getReplaySeekSeconds() const { return replaySeekSeconds; }
+    
+    /**
+     * @brief Clear the pending replay seek
+     */
+    void clearReplaySeek() { replaySeekSeconds = 0.0f; }
+    
 private:
     /**
      * @brief Check if key transitioned from released to pressed
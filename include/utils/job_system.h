@@ -0,0 +1,91 @@
+/**
+ * @file job_system.h
+ * @brief Worker Thread Pool for Data-Parallel Jobs
+ * 
+ * Splits a range of work items into chunks and runs them on a fixed set
+ * of worker threads plus the calling thread. Used by systems whose
+ * per-item work is independent (e.g. stepping each car).
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <vector>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/**
+ * @class JobSystem
+ * @brief Fixed-size thread pool with a blocking parallelFor
+ * 
+ * Only one parallelFor runs at a time (calls from other threads wait their
+ * turn); the calling thread works on chunks too and returns once every
+ * chunk has finished, so callers can treat it like an ordinary (but
+ * faster) loop.
+ */
+class JobSystem {
+public:
+    /**
+     * @brief Start the worker threads
+     * @param workerCount Number of background threads (0 = run everything inline)
+     */
+    explicit JobSystem(unsigned workerCount = defaultWorkerCount());
+    
+    /**
+     * @brief Stop and join all worker threads
+     */
+    ~JobSystem();
+    
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    
+    /**
+     * @brief Run job over [0, count) in chunks of at least minChunkSize items
+     * @param count Number of work items
+     * @param minChunkSize Smallest chunk worth handing to another thread
+     * @param job Called as job(begin, end) for each chunk, possibly concurrently
+     */
+    void parallelFor(size_t count, size_t minChunkSize,
+                     const std::function<void(size_t, size_t)>& job);
+    
+    /**
+     * @brief Number of background worker threads
+     */
+    unsigned getWorkerCount() const { return static_cast<unsigned>(workers.size()); }
+    
+    /**
+     * @brief One worker per hardware thread, leaving one for the caller
+     */
+    static unsigned defaultWorkerCount();
+    
+private:
+    std::vector<std::thread> workers;
+    std::mutex submitMutex;                  ///< Held for the whole of a parallelFor
+    std::mutex mutex;
+    std::condition_variable workAvailable;   ///< Signals workers that a job started (or stop)
+    std::condition_variable workFinished;    ///< Signals the caller that the last chunk finished
+    
+    // Current job, valid while a parallelFor is in progress
+    const std::function<void(size_t, size_t)>* job;
+    size_t itemCount;
+    size_t chunkSize;
+    size_t chunkCount;
+    std::atomic<size_t> nextChunk;
+    std::atomic<size_t> chunksDone;
+    unsigned activeWorkers;                  ///< Workers currently attached to the job
+    bool stopping;
+    
+    void workerLoop();
+    
+    // Claim and run chunks until none are left
+    void runChunks();
+};
+
+#endif // JOB_SYSTEM_H
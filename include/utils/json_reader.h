@@ -0,0 +1,161 @@
+/**
+ * @file json_reader.h
+ * @brief Streaming JSON Pull Parser
+ *
+ * Tokenizes JSON from an input stream in fixed-size chunks, so files far
+ * larger than memory can be walked front to back in a single pass. The
+ * caller drives the parse (beginObject / nextMember / readFloat ...)
+ * and decides where each value goes, so nothing is built up as an
+ * intermediate document tree.
+ *
+ * Whitespace and layout are insignificant: pretty-printed and minified
+ * files parse the same way.
+ *
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef JSON_READER_H
+#define JSON_READER_H
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <cstddef>
+
+/**
+ * @enum JsonType
+ * @brief Kind of the next value in the stream
+ */
+enum class JsonType {
+    OBJECT,
+    ARRAY,
+    STRING,
+    NUMBER,
+    LITERAL,    ///< true, false or null
+    END         ///< End of input or a parse error
+};
+
+/**
+ * @class JsonReader
+ * @brief Single-pass pull parser over a chunked input stream
+ *
+ * Typical use:
+ * @code
+ * reader.beginObject();
+ * std::string key;
+ * while (reader.nextMember(key)) {
+ *     if (key == "x") reader.readFloat(x);
+ *     else reader.skipValue();
+ * }
+ * @endcode
+ *
+ * Errors are sticky: after the first malformed token every call returns
+ * false, so caller loops always terminate. Check ok() once at the end.
+ *
+ * **Memory**: one chunk buffer plus one reused token buffer
+ */
+class JsonReader {
+public:
+    /**
+     * @brief Construct a reader over a stream
+     * @param input Stream to read from (should be opened in binary mode)
+     * @param chunkSize Bytes read from the stream per refill
+     */
+    explicit JsonReader(std::istream& input, size_t chunkSize = 64 * 1024);
+
+    /**
+     * @brief Type of the next value, without consuming it
+     */
+    JsonType peekType();
+
+    /**
+     * @brief Consume the '{' opening an object
+     */
+    bool beginObject();
+
+    /**
+     * @brief Advance to the next member of the current object
+     * @param key Receives the member name; its value is read next
+     * @return true if a member follows, false once '}' is consumed
+     */
+    bool nextMember(std::string& key);
+
+    /**
+     * @brief Consume the '[' opening an array
+     */
+    bool beginArray();
+
+    /**
+     * @brief Advance to the next element of the current array
+     * @return true if an element follows, false once ']' is consumed
+     */
+    bool nextElement();
+
+    /**
+     * @brief Read a number value
+     */
+    bool readFloat(float& out);
+
+    /**
+     * @brief Read a number value, truncating any fractional part
+     */
+    bool readInt(int& out);
+
+    /**
+     * @brief Read a string value (escapes are decoded)
+     */
+    bool readString(std::string& out);
+
+    /**
+     * @brief Consume the next value of any type, including nested containers
+     */
+    bool skipValue();
+
+    /**
+     * @brief False once any parse error has occurred
+     */
+    bool ok() const { return error.empty(); }
+
+    /**
+     * @brief Description of the first parse error (empty if none)
+     */
+    const std::string& getError() const { return error; }
+
+private:
+    std::istream& input;
+    std::vector<char> buffer;   ///< Current chunk
+    size_t position;            ///< Next unread byte in buffer
+    size_t length;              ///< Valid bytes in buffer
+    size_t consumed;            ///< Bytes consumed from earlier chunks (for error offsets)
+    bool firstInContainer;      ///< Just after '{' or '[' (no ',' expected yet)
+    std::string token;          ///< Scratch buffer for numbers and keys
+    std::string error;
+
+    bool refill();
+
+    int peekChar() {
+        if (position == length && !refill()) return -1;
+        return static_cast<unsigned char>(buffer[position]);
+    }
+
+    int getChar() {
+        int c = peekChar();
+        if (c >= 0) position++;
+        return c;
+    }
+
+    /**
+     * @brief Skip whitespace and return the next character without consuming it
+     */
+    int peekToken();
+
+    bool expect(char c);
+    bool fail(const char* message);
+    bool readNumberToken();
+    bool readLiteral();
+    bool readStringInto(std::string& out);
+    bool nextInContainer(char close);
+};
+
+#endif // JSON_READER_H
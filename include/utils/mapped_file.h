@@ -0,0 +1,63 @@
+/**
+ * @file mapped_file.h
+ * @brief Read-Only Memory Map of a Whole File
+ * 
+ * Binary loaders map their input and read records in place instead of
+ * copying the file into a buffer first. A file that cannot be opened or
+ * mapped leaves data null.
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @struct MappedFile
+ * @brief Maps a file on construction and unmaps it on destruction
+ */
+struct MappedFile {
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    
+    explicit MappedFile(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                data = static_cast<const unsigned char*>(mapping);
+                size = static_cast<size_t>(info.st_size);
+            }
+        }
+        close(fd);  // The mapping stays valid after the descriptor is closed
+    }
+    
+    ~MappedFile() {
+        if (data) munmap(const_cast<unsigned char*>(data), size);
+    }
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    /**
+     * @brief True if [offset, offset + count * recordSize) lies inside the file
+     */
+    bool contains(uint64_t offset, uint64_t count, uint64_t recordSize) const {
+        if (offset > size) return false;
+        return count <= (size - offset) / recordSize;
+    }
+};
+
+#endif // MAPPED_FILE_H
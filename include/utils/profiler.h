@@ -0,0 +1,198 @@
+/**
+ * @file profiler.h
+ * @brief Frame Profiler (CPU scopes, GPU timer queries, Chrome traces)
+ *
+ * Scoped timers measure how long each part of a frame takes:
+ * - CpuScope: wall time on the calling thread (steady clock)
+ * - GpuScope: GPU time of the commands issued inside it (GL_TIME_ELAPSED)
+ *
+ * Every scope keeps a rolling history from which the overlay reports the
+ * mean, 95th percentile and maximum. While a trace is being captured each
+ * scope is also recorded as an event and written as Chrome trace JSON
+ * (open it in chrome://tracing or https://ui.perfetto.dev).
+ *
+ * Scopes cost nothing while neither the overlay nor a trace is active,
+ * and a null profiler turns them off entirely.
+ *
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <glad/glad.h>
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class Profiler
+ * @brief Per-scope frame timing statistics and trace capture
+ *
+ * Scopes are identified by their name (a string literal). Each profiler
+ * is used from one thread; GPU scopes need that thread to own the GL
+ * context. A thread label tells the overlays and traces of several
+ * profilers apart.
+ *
+ * GPU timer queries cannot nest, so GPU scopes go around leaf passes
+ * only; a GPU scope opened inside another is ignored. Results are read a
+ * few frames later, when the GPU has finished, without stalling.
+ */
+class Profiler {
+public:
+    static constexpr size_t HISTORY_SAMPLES = 240;     ///< Samples per scope in the statistics
+    static constexpr int GPU_QUERIES_PER_SCOPE = 4;    ///< Frames a GPU result may lag behind
+    static constexpr size_t MAX_TRACE_EVENTS = 1000000;
+    static constexpr double OVERLAY_INTERVAL = 1.0;    ///< Seconds between overlay reports
+
+    /// Rolling statistics of one scope, in milliseconds
+    struct Stats {
+        double mean = 0.0;
+        double p95 = 0.0;
+        double max = 0.0;
+        size_t samples = 0;
+    };
+
+    /**
+     * @class CpuScope
+     * @brief Times the enclosing block on the CPU
+     */
+    class CpuScope {
+    public:
+        CpuScope(Profiler* profiler, const char* name);
+        ~CpuScope();
+        CpuScope(const CpuScope&) = delete;
+        CpuScope& operator=(const CpuScope&) = delete;
+
+    private:
+        Profiler* profiler;     ///< nullptr when not recording
+        int scope;
+        int64_t start;          ///< Microseconds since the profiler started
+    };
+
+    /**
+     * @class GpuScope
+     * @brief Times the GL commands issued in the enclosing block
+     */
+    class GpuScope {
+    public:
+        GpuScope(Profiler* profiler, const char* name);
+        ~GpuScope();
+        GpuScope(const GpuScope&) = delete;
+        GpuScope& operator=(const GpuScope&) = delete;
+
+    private:
+        Profiler* profiler;     ///< nullptr when not recording
+        int scope;
+        int query;              ///< Query slot of the scope (-1 = not timed)
+    };
+
+    /**
+     * @param threadLabel Name of the profiled thread in the overlay and traces
+     */
+    explicit Profiler(const std::string& threadLabel = "main");
+
+    /**
+     * @brief Delete the GL query objects (the context must still be current)
+     */
+    ~Profiler();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    /**
+     * @brief Show or hide the periodic console overlay
+     */
+    void setOverlayEnabled(bool enabled);
+    bool isOverlayEnabled() const { return overlayEnabled; }
+
+    /**
+     * @brief True while statistics or a trace are being recorded
+     */
+    bool isActive() const { return overlayEnabled || tracing; }
+
+    /**
+     * @brief Mark the end of a frame
+     *
+     * Adds each CPU scope's total for the frame to its history, collects
+     * finished GPU queries and prints the overlay when it is due.
+     */
+    void endFrame();
+
+    /**
+     * @brief Statistics of a scope ("name" for CPU, or a GPU scope's name)
+     * @param gpu Look the scope up among GPU scopes
+     */
+    Stats getStats(const char* name, bool gpu) const;
+
+    /**
+     * @brief Print every scope's statistics to the console
+     */
+    void printOverlay() const;
+
+    /**
+     * @brief Start recording trace events (clears any earlier capture)
+     */
+    void startTrace();
+
+    /**
+     * @brief Stop recording and write the capture as Chrome trace JSON
+     * @param path Output file
+     * @return false if the file could not be written
+     */
+    bool stopTrace(const std::string& path);
+
+    bool isTracing() const { return tracing; }
+
+private:
+    /// Statistics and GL queries of one named scope
+    struct Scope {
+        const char* name;
+        bool gpu;
+        double frameTotal = 0.0;            ///< CPU milliseconds accumulated this frame
+        bool hitThisFrame = false;
+        std::vector<float> history;         ///< Ring of samples in milliseconds
+        size_t historyNext = 0;
+        GLuint queries[GPU_QUERIES_PER_SCOPE] = {};
+        bool pending[GPU_QUERIES_PER_SCOPE] = {};
+        int64_t queryStart[GPU_QUERIES_PER_SCOPE] = {};  ///< CPU time the query began (for traces)
+        int nextQuery = 0;
+    };
+
+    /// One completed scope in a trace capture
+    struct TraceEvent {
+        const char* name;
+        bool gpu;
+        int64_t start;          ///< Microseconds since the profiler started
+        int64_t duration;
+    };
+
+    std::string label;
+    std::vector<Scope> scopes;
+    std::vector<TraceEvent> traceEvents;
+    bool overlayEnabled;
+    bool tracing;
+    bool traceFull;             ///< MAX_TRACE_EVENTS reached during this capture
+    bool gpuQueryOpen;          ///< A GL_TIME_ELAPSED query is running
+    int64_t lastOverlay;        ///< Time of the last overlay report
+    int64_t epoch;              ///< Steady-clock microseconds at construction
+
+    int64_t now() const;
+    int findScope(const char* name, bool gpu);
+    int lookupScope(const char* name, bool gpu) const;
+    void addSample(Scope& scope, double milliseconds);
+    void addTraceEvent(const char* name, bool gpu, int64_t start, int64_t duration);
+
+    void endCpu(int scope, int64_t start);
+    int beginGpu(int scope);
+    void endGpu(int scope, int query);
+
+    /**
+     * @brief Read a finished query; false if the GPU is not done with it yet
+     */
+    bool retireQuery(Scope& scope, int query);
+};
+
+#endif // PROFILER_H
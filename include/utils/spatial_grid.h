@@ -0,0 +1,98 @@
+/**
+ * @file spatial_grid.h
+ * @brief Uniform Spatial Hash Grid
+ * 
+ * Buckets axis-aligned bounding boxes into fixed-size cells keyed by
+ * their integer cell coordinates, so overlap queries only visit the
+ * cells around the query box instead of every stored item.
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+/**
+ * @class SpatialGrid
+ * @brief Uniform hash grid over item bounding boxes
+ * 
+ * Items are identified by the order they were inserted (0, 1, 2, ...),
+ * which lets callers keep the actual geometry in their own arrays and use
+ * the grid purely for broad-phase culling. Each item is stored in every
+ * cell its box overlaps; queries return each candidate id once. Callers
+ * that remove items choose the ids themselves (see erase()).
+ * 
+ * **Insert**: O(cells covered by the box)
+ * **Erase**: O(cells covered by the box + items sharing those cells)
+ * **Query**: O(cells covered by the query + candidates found)
+ * 
+ * Queries do not modify the grid, so any number may run concurrently
+ * (parallel building placement reads one grid from every tile).
+ */
+class SpatialGrid {
+public:
+    /**
+     * @brief Construct an empty grid
+     * @param cellSize Edge length of a cell in pixels
+     */
+    explicit SpatialGrid(float cellSize = 64.0f);
+    
+    /**
+     * @brief Remove all items (cell size is kept)
+     */
+    void clear();
+    
+    /**
+     * @brief Insert an item's bounding box
+     * @return uint32_t Id of the new item (its insertion index)
+     */
+    uint32_t insert(float minX, float minY, float maxX, float maxY);
+    
+    /**
+     * @brief Insert a bounding box under a caller-chosen id
+     * 
+     * For callers that keep ids dense while erasing (move the last item
+     * into the hole). Later insertions without an id continue after it.
+     */
+    void insert(uint32_t id, float minX, float minY, float maxX, float maxY);
+    
+    /**
+     * @brief Remove an item
+     * @param id Id of the item
+     * 
+     * The box must be the one the item was inserted with: only its
+     * cells are searched.
+     */
+    void erase(uint32_t id, float minX, float minY, float maxX, float maxY);
+    
+    /**
+     * @brief Collect ids of items whose cells overlap a box
+     * @param out Receives candidate ids (cleared first); each id appears once
+     * 
+     * This is a broad phase: candidates share a cell with the query box
+     * but still need an exact overlap test by the caller.
+     */
+    void query(float minX, float minY, float maxX, float maxY, std::vector<uint32_t>& out) const;
+    
+    /**
+     * @brief Number of stored items
+     */
+    size_t size() const { return itemCount; }
+    
+private:
+    float cellSize;                                             ///< Cell edge length in pixels
+    std::unordered_map<int64_t, std::vector<uint32_t>> cells;   ///< Cell key -> item ids
+    uint32_t itemCount;                                         ///< Stored items
+    uint32_t nextId;                                            ///< Id of the next insert()
+    
+    int cellCoord(float value) const;
+    static int64_t cellKey(int cellX, int cellY);
+};
+
+#endif // SPATIAL_GRID_H
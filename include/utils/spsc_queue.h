@@ -0,0 +1,67 @@
+/**
+ * @file spsc_queue.h
+ * @brief Lock-Free Single-Producer Single-Consumer Ring Buffer
+ * 
+ * One thread pushes and one other thread pops; neither ever waits for the
+ * other. Each side owns one index and only reads the other's, so a push
+ * or pop is two atomic loads and one store. Used to hand frame snapshots
+ * from the simulation thread to the render thread and back.
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class SpscQueue
+ * @brief Fixed-capacity FIFO for exactly one producer and one consumer thread
+ * 
+ * Values are copied in and out, so T should be cheap to copy (a pointer
+ * or index into storage the two threads hand back and forth).
+ */
+template <typename T, size_t CAPACITY>
+class SpscQueue {
+public:
+    static_assert(CAPACITY > 0, "SpscQueue needs room for at least one value");
+    
+    SpscQueue() : head(0), tail(0) {}
+    
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+    
+    /**
+     * @brief Append a value (producer thread only)
+     * @return false if the queue is full
+     */
+    bool tryPush(const T& value) {
+        size_t back = tail.load(std::memory_order_relaxed);
+        if (back - head.load(std::memory_order_acquire) == CAPACITY) return false;
+        slots[back % CAPACITY] = value;
+        tail.store(back + 1, std::memory_order_release);  // Publishes the slot to the consumer
+        return true;
+    }
+    
+    /**
+     * @brief Take the oldest value (consumer thread only)
+     * @return false if the queue is empty
+     */
+    bool tryPop(T& value) {
+        size_t front = head.load(std::memory_order_relaxed);
+        if (front == tail.load(std::memory_order_acquire)) return false;
+        value = slots[front % CAPACITY];
+        head.store(front + 1, std::memory_order_release);  // Hands the slot back to the producer
+        return true;
+    }
+
+private:
+    T slots[CAPACITY];
+    alignas(64) std::atomic<size_t> head;   ///< Next slot to pop; written by the consumer
+    alignas(64) std::atomic<size_t> tail;   ///< Next slot to push; written by the producer
+};
+
+#endif // SPSC_QUEUE_H
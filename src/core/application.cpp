@@ -9,6 +9,7 @@
 #include "core/application.h"
 #include "rendering/camera.h"
 #include <iostream>
+#include <atomic>
 
 // Static camera pointer for callbacks
 static Camera* g_callbackCamera = nullptr;
@@ -16,9 +17,14 @@ static bool g_firstMouse = true;
 static float g_lastX = 400.0f;
 static float g_lastY = 300.0f;
 
-// Framebuffer size callback
+// Framebuffer size, applied as the viewport by the thread that renders
+static std::atomic<int> g_framebufferWidth(0);
+static std::atomic<int> g_framebufferHeight(0);
+
+// Framebuffer size callback (the main thread may not hold the context)
 static void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
-    glViewport(0, 0, width, height);
+    g_framebufferWidth = width;
+    g_framebufferHeight = height;
 }
 
 // Mouse callback
@@ -28,12 +34,12 @@ static void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
         g_lastY = ypos;
         g_firstMouse = false;
     }
-
+    
     float xoffset = xpos - g_lastX;
     float yoffset = g_lastY - ypos;
     g_lastX = xpos;
     g_lastY = ypos;
-
+    
     if (g_callbackCamera) {
         g_callbackCamera->processMouseMovement(xoffset, yoffset);
     }
@@ -67,6 +73,8 @@ Application::Application(int width, int height, const std::string& title)
     
     // Set viewport
     glViewport(0, 0, width, height);
+    g_framebufferWidth = width;
+    g_framebufferHeight = height;
 }
 
 // Destructor
@@ -125,8 +133,23 @@ bool Application::shouldClose() const {
     return glfwWindowShouldClose(window);
 }
 
-// Update (swap buffers and poll events)
-void Application::update() {
+// Present the frame
+void Application::swapBuffers() {
     glfwSwapBuffers(window);
+}
+
+// Poll events
+void Application::pollEvents() {
     glfwPollEvents();
 }
+
+// Attach or detach the context on the calling thread
+void Application::makeContextCurrent(bool current) {
+    glfwMakeContextCurrent(current ? window : nullptr);
+}
+
+// Framebuffer size
+void Application::getFramebufferSize(int& framebufferWidth, int& framebufferHeight) const {
+    framebufferWidth = g_framebufferWidth;
+    framebufferHeight = g_framebufferHeight;
+}
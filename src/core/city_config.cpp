@@ -1,10 +1,69 @@
 #include "core/city_config.h"
 #include <iostream>
+#include <fstream>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+std::string trim(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) return "";
+    size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+std::string toLower(std::string text) {
+    for (char& c : text) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return text;
+}
+
+bool parseInt(const std::string& text, int& out) {
+    char* end = nullptr;
+    long value = std::strtol(text.c_str(), &end, 10);
+    if (end == text.c_str() || *end != '\0') return false;
+    out = static_cast<int>(value);
+    return true;
+}
+
+bool parseFloat(const std::string& text, float& out) {
+    char* end = nullptr;
+    float value = std::strtof(text.c_str(), &end);
+    if (end == text.c_str() || *end != '\0') return false;
+    out = value;
+    return true;
+}
+
+bool parseBool(const std::string& text, bool& out) {
+    std::string value = toLower(text);
+    if (value == "true" || value == "1" || value == "yes") { out = true; return true; }
+    if (value == "false" || value == "0" || value == "no") { out = false; return true; }
+    return false;
+}
+
+// One row of the printConfig() table: label column, then the value padded to the border
+std::string configRow(const std::string& label, const std::string& value) {
+    std::string row = "║ " + label + std::string(label.length() < 16 ? 16 - label.length() : 0, ' ') + value;
+    return row + std::string(value.length() < 23 ? 23 - value.length() : 0, ' ') + "║\n";
+}
+
+// A scale factor as "x1.00"
+std::string scaleText(float scale) {
+    char text[16];
+    std::snprintf(text, sizeof(text), "x%.2f", scale);
+    return text;
+}
+
+}  // namespace
 
 void CityConfig::printConfig() const {
     std::cout << "\n╔════════════════════════════════════════╗\n";
     std::cout << "║      CITY DESIGNER CONFIGURATION       ║\n";
     std::cout << "╠════════════════════════════════════════╣\n";
+    std::cout << "║ Seed:           " << seed << std::string(23 - std::to_string(seed).length(), ' ') << "║\n";
     std::cout << "║ Buildings:      " << numBuildings << " buildings" << std::string(18 - std::to_string(numBuildings).length(), ' ') << "║\n";
     std::cout << "║ Layout Size:    " << layoutSize << "x" << layoutSize << " grid" << std::string(17 - 2*std::to_string(layoutSize).length(), ' ') << "║\n";
     std::cout << "║ Road Pattern:   " << getRoadPatternString() << std::string(23 - getRoadPatternString().length(), ' ') << "║\n";
@@ -18,5 +77,112 @@ void CityConfig::printConfig() const {
         std::cout << "║   (Width/Depth: " << static_cast<int>(standardWidth) << "x" << static_cast<int>(standardDepth) << " px)" << std::string(17 - std::to_string(static_cast<int>(standardWidth)).length() - std::to_string(static_cast<int>(standardDepth)).length(), ' ') << "║\n";
     }
     std::cout << "║ View Mode:      " << (view3D ? "3D View" : "2D View") << std::string(23 - (view3D ? 7 : 7), ' ') << "║\n";
+    
+    // Adaptive quality: the budget and what the governor currently runs with
+    char budget[24];
+    std::snprintf(budget, sizeof(budget), "%.1f ms", frameBudgetMs);
+    std::cout << configRow("Quality:", std::string(adaptiveQuality ? "Adaptive" : "Fixed") +
+                                       ", level " + std::to_string(qualityLevel));
+    std::cout << configRow("Frame Budget:", budget);
+    std::cout << configRow("LOD Distances:", scaleText(lodDistanceScale));
+    std::cout << configRow("Cull Angle:", scaleText(cullAngleScale));
+    std::cout << configRow("Point Sizes:", scaleText(pointSizeScale));
+    std::cout << configRow("Traffic Steps:", std::to_string(trafficStepsPerUpdate) + " per frame");
     std::cout << "╚════════════════════════════════════════╝\n\n";
 }
+
+bool CityConfig::generatesSameCity(const CityConfig& other) const {
+    return seed == other.seed &&
+           numBuildings == other.numBuildings &&
+           layoutSize == other.layoutSize &&
+           roadPattern == other.roadPattern &&
+           roadWidth == other.roadWidth &&
+           skylineType == other.skylineType &&
+           parkRadius == other.parkRadius &&
+           numParks == other.numParks &&
+           fountainRadius == other.fountainRadius &&
+           useStandardSize == other.useStandardSize &&
+           standardWidth == other.standardWidth &&
+           standardDepth == other.standardDepth;
+}
+
+bool CityConfig::loadFromFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cout << "❌ Failed to open config file: " << path << "\n";
+        return false;
+    }
+    
+    bool layoutChanged = false;
+    bool sizeSet = false;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        line = trim(line);
+        if (line.empty()) continue;
+        
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            std::cout << "❌ " << path << ":" << lineNumber << ": expected key = value\n";
+            return false;
+        }
+        std::string key = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+        std::string lower = toLower(value);
+        
+        bool ok = true;
+        if (key == "seed") {
+            char* end = nullptr;
+            seed = std::strtoull(value.c_str(), &end, 10);
+            ok = end != value.c_str() && *end == '\0';
+        } else if (key == "numBuildings") ok = parseInt(value, numBuildings);
+        else if (key == "layoutSize") { ok = parseInt(value, layoutSize) && layoutSize > 0; layoutChanged = true; }
+        else if (key == "roadWidth") ok = parseInt(value, roadWidth);
+        else if (key == "parkRadius") ok = parseInt(value, parkRadius);
+        else if (key == "numParks") ok = parseInt(value, numParks);
+        else if (key == "fountainRadius") ok = parseInt(value, fountainRadius);
+        else if (key == "numCars") ok = parseInt(value, numCars);
+        else if (key == "gpuTraffic") ok = parseBool(value, gpuTraffic);
+        else if (key == "gpuNumCars") ok = parseInt(value, gpuNumCars);
+        else if (key == "adaptiveQuality") ok = parseBool(value, adaptiveQuality);
+        else if (key == "frameBudgetMs") ok = parseFloat(value, frameBudgetMs) && frameBudgetMs > 0.0f;
+        else if (key == "useStandardSize") ok = parseBool(value, useStandardSize);
+        else if (key == "standardWidth") { ok = parseFloat(value, standardWidth); sizeSet = true; }
+        else if (key == "standardDepth") { ok = parseFloat(value, standardDepth); sizeSet = true; }
+        else if (key == "roadPattern") {
+            if (lower == "grid") roadPattern = RoadPattern::GRID;
+            else if (lower == "radial") roadPattern = RoadPattern::RADIAL;
+            else if (lower == "random") roadPattern = RoadPattern::RANDOM;
+            else ok = false;
+        } else if (key == "skylineType") {
+            if (lower == "low-rise") skylineType = SkylineType::LOW_RISE;
+            else if (lower == "mid-rise") skylineType = SkylineType::MID_RISE;
+            else if (lower == "skyscraper") skylineType = SkylineType::SKYSCRAPER;
+            else if (lower == "mixed") skylineType = SkylineType::MIXED;
+            else ok = false;
+        } else if (key == "textureTheme") {
+            if (lower == "modern") textureTheme = TextureTheme::MODERN;
+            else if (lower == "classic") textureTheme = TextureTheme::CLASSIC;
+            else if (lower == "industrial") textureTheme = TextureTheme::INDUSTRIAL;
+            else if (lower == "futuristic") textureTheme = TextureTheme::FUTURISTIC;
+            else ok = false;
+        } else {
+            std::cout << "❌ " << path << ":" << lineNumber << ": unknown key '" << key << "'\n";
+            return false;
+        }
+        
+        if (!ok) {
+            std::cout << "❌ " << path << ":" << lineNumber << ": invalid value '" << value
+                      << "' for " << key << "\n";
+            return false;
+        }
+    }
+    
+    if (layoutChanged && !sizeSet) {
+        updateStandardBuildingSize();
+    }
+    return true;
+}
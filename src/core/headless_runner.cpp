@@ -0,0 +1,261 @@
+/**
+ * @file headless_runner.cpp
+ * @brief Implementation of the headless batch generation mode
+ *
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#include "core/headless_runner.h"
+#include "generation/city_generator.h"
+#include "features/save_load/city_serializer.h"
+#include "utils/job_system.h"
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+HeadlessRunner::HeadlessRunner()
+    : cityCount(1), threadCount(JobSystem::defaultWorkerCount() + 1),
+      outputPrefix("batch/city"), writeBinary(true), writeJson(false) {}
+
+bool HeadlessRunner::isRequested(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--headless") == 0) return true;
+    }
+    return false;
+}
+
+void HeadlessRunner::printUsage() {
+    std::cout << "Usage: CityDesigner --headless [options]\n"
+              << "  --config FILE          Override settings from a key = value file\n"
+              << "  --count N              Number of cities to generate (default 1)\n"
+              << "  --threads N            Generation threads (default: one per core)\n"
+              << "  --world WIDTHxHEIGHT   City extent in world units (default "
+              << WorldExtent::DEFAULT_WIDTH << "x" << WorldExtent::DEFAULT_HEIGHT << ")\n"
+              << "  --output PREFIX        Save names, relative to " << CitySerializer::getSaveDirectory()
+              << " (default batch/city)\n"
+              << "  --format FORMAT        city, json, both or none (default city)\n"
+              << "  --seed S               Base seed; city i uses a seed derived from S and i\n"
+              << "                         (default: the config seed, else a random one)\n"
+              << "  --seeds FILE           One seed per line; generates one city per seed\n";
+}
+
+bool HeadlessRunner::parseArguments(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "--headless") continue;
+        if (option == "--help") {
+            printUsage();
+            return false;
+        }
+
+        // Every other option takes one value
+        if (i + 1 >= argc) {
+            std::cout << "❌ Missing value for " << option << "\n";
+            printUsage();
+            return false;
+        }
+        std::string value = argv[++i];
+        char* end = nullptr;
+
+        if (option == "--config") {
+            if (!config.loadFromFile(value)) return false;
+        } else if (option == "--count") {
+            long count = std::strtol(value.c_str(), &end, 10);
+            if (*end != '\0' || count <= 0) {
+                std::cout << "❌ Invalid city count: " << value << "\n";
+                return false;
+            }
+            cityCount = static_cast<int>(count);
+        } else if (option == "--threads") {
+            long threads = std::strtol(value.c_str(), &end, 10);
+            if (*end != '\0' || threads <= 0) {
+                std::cout << "❌ Invalid thread count: " << value << "\n";
+                return false;
+            }
+            threadCount = static_cast<unsigned>(threads);
+        } else if (option == "--world") {
+            long width = std::strtol(value.c_str(), &end, 10);
+            long height = (*end == 'x' || *end == 'X') ? std::strtol(end + 1, &end, 10) : 0;
+            WorldExtent requested(static_cast<int>(width), static_cast<int>(height));
+            if (*end != '\0' || !requested.isValid()) {
+                std::cout << "❌ Invalid world extent (expected WIDTHxHEIGHT): " << value << "\n";
+                return false;
+            }
+            extent = requested;
+        } else if (option == "--seed") {
+            unsigned long long seed = std::strtoull(value.c_str(), &end, 10);
+            if (value.empty() || *end != '\0') {
+                std::cout << "❌ Invalid seed: " << value << "\n";
+                return false;
+            }
+            config.seed = seed;
+        } else if (option == "--seeds") {
+            if (!loadSeeds(value)) return false;
+        } else if (option == "--output") {
+            outputPrefix = value;
+        } else if (option == "--format") {
+            writeBinary = value == "city" || value == "both";
+            writeJson = value == "json" || value == "both";
+            if (!writeBinary && !writeJson && value != "none") {
+                std::cout << "❌ Unknown format: " << value << "\n";
+                return false;
+            }
+        } else {
+            std::cout << "❌ Unknown option: " << option << "\n";
+            printUsage();
+            return false;
+        }
+    }
+    if (!seeds.empty()) cityCount = static_cast<int>(seeds.size());
+    return true;
+}
+
+bool HeadlessRunner::loadSeeds(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cout << "❌ Cannot open seed file: " << path << "\n";
+        return false;
+    }
+
+    seeds.clear();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos) continue;
+        size_t last = line.find_last_not_of(" \t\r");
+        std::string value = line.substr(first, last - first + 1);
+
+        char* end = nullptr;
+        unsigned long long seed = std::strtoull(value.c_str(), &end, 10);
+        if (*end != '\0') {
+            std::cout << "❌ " << path << ":" << lineNumber << ": invalid seed: " << value << "\n";
+            return false;
+        }
+        seeds.push_back(seed);
+    }
+
+    if (seeds.empty()) {
+        std::cout << "❌ No seeds in " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+uint64_t HeadlessRunner::seedFor(size_t index) const {
+    return seeds.empty() ? RandomStream::deriveSeed(config.seed, index) : seeds[index];
+}
+
+bool HeadlessRunner::prepareOutputDirectory() const {
+    if (!writeBinary && !writeJson) return true;
+
+    // mkdir each directory on the way down to the last path component
+    std::string path = CitySerializer::getSaveDirectory();
+    mkdir(path.c_str(), 0755);
+    size_t slash = outputPrefix.find('/');
+    while (slash != std::string::npos) {
+        std::string directory = path + outputPrefix.substr(0, slash);
+        mkdir(directory.c_str(), 0755);
+        slash = outputPrefix.find('/', slash + 1);
+    }
+
+    size_t lastSlash = outputPrefix.rfind('/');
+    std::string target = path + (lastSlash == std::string::npos ? "" : outputPrefix.substr(0, lastSlash));
+    struct stat info;
+    if (stat(target.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+        std::cout << "❌ Cannot create output directory: " << target << "\n";
+        return false;
+    }
+    return true;
+}
+
+int HeadlessRunner::run() {
+    if (!prepareOutputDirectory()) return 1;
+
+    std::cout << "\n🏭 Headless generation: " << cityCount << " cities ("
+              << extent.width << "x" << extent.height << " world units) on "
+              << threadCount << " threads\n";
+    if (seeds.empty()) std::cout << "   - Base seed: " << config.seed << "\n";
+    std::cout << std::flush;
+
+    // Workers share stdout; keep per-city chatter out of it
+    CitySerializer::setVerbose(false);
+
+    std::atomic<int> completed(0);
+    std::atomic<int> failed(0);
+    std::atomic<size_t> buildingCount(0);
+    std::atomic<size_t> roadCount(0);
+    int digits = std::max(5, static_cast<int>(std::to_string(cityCount - 1).size()));
+    int progressStep = std::max(1, cityCount / 10);
+
+    auto start = std::chrono::steady_clock::now();
+
+    JobSystem jobs(threadCount - 1);
+    auto generateRange = [&](size_t begin, size_t end, JobSystem* tileJobs) {
+        // One generator per chunk: generators are not shared between threads
+        CityGenerator generator(extent);
+        generator.setVerbose(false);
+        generator.setJobSystem(tileJobs);
+        CityConfig cityConfig = config;
+
+        for (size_t i = begin; i < end; i++) {
+            cityConfig.seed = seedFor(i);
+            generator.generateCity(cityConfig);
+            const CityData& city = generator.getCityData();
+
+            std::ostringstream name;
+            name << outputPrefix << "_" << std::setw(digits) << std::setfill('0') << i;
+            bool saved = (!writeBinary || CitySerializer::saveCityBinary(city, name.str())) &&
+                         (!writeJson || CitySerializer::saveCity(city, name.str()));
+            if (!saved) failed++;
+
+            buildingCount += city.buildings.size();
+            roadCount += city.roads.size();
+
+            int done = ++completed;
+            if (done % progressStep == 0 || done == cityCount) {
+                std::ostringstream line;
+                line << "   - " << done << "/" << cityCount << " cities\n";
+                std::cout << line.str() << std::flush;
+            }
+        }
+    };
+
+    // Few cities: one at a time, each split into tiles across the threads.
+    // Otherwise whole cities are the unit of work.
+    if (static_cast<unsigned>(cityCount) < threadCount) {
+        generateRange(0, static_cast<size_t>(cityCount), &jobs);
+    } else {
+        jobs.parallelFor(static_cast<size_t>(cityCount), 1, [&](size_t begin, size_t end) {
+            generateRange(begin, end, nullptr);
+        });
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double citiesPerSecond = seconds > 0.0 ? cityCount / seconds : 0.0;
+
+    std::cout << "\n✅ Generated " << cityCount << " cities in " << std::fixed << std::setprecision(2)
+              << seconds << " s (" << citiesPerSecond << " cities/s, "
+              << (seconds * 1000.0 * threadCount / cityCount) << " ms per city per thread)\n";
+    std::cout << "   - " << buildingCount.load() << " buildings, " << roadCount.load() << " roads in total\n";
+    if (writeBinary || writeJson) {
+        std::cout << "   - Saved to " << CitySerializer::getSaveDirectory() << outputPrefix << "_*\n";
+    }
+    if (failed > 0) {
+        std::cout << "❌ " << failed.load() << " cities failed to save\n";
+        return 1;
+    }
+    return 0;
+}
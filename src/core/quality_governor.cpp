@@ -0,0 +1,92 @@
+/**
+ * @file quality_governor.cpp
+ * @brief Implementation of the Adaptive Quality Governor
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#include "core/quality_governor.h"
+#include "features/traffic_system/traffic_generator.h"
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+
+namespace {
+
+// Settings of each level, best first
+struct QualityLevel {
+    float lodDistanceScale;
+    float cullAngleScale;
+    float pointSizeScale;
+    int trafficSteps;
+};
+
+const QualityLevel LEVELS[QualityGovernor::LEVEL_COUNT] = {
+    {1.0f, 1.0f, 1.0f, TrafficGenerator::MAX_STEPS_PER_UPDATE},
+    {0.75f, 2.0f, 1.0f, 3},
+    {0.5f, 4.0f, 0.75f, 2},
+    {0.35f, 8.0f, 0.5f, 1},
+    {0.25f, 16.0f, 0.5f, 1}
+};
+
+}  // namespace
+
+QualityGovernor::QualityGovernor()
+    : elapsed(0.0), mainTotal(0.0), mainFrames(0), renderTotal(0.0), renderFrames(0), frameMs(0.0) {}
+
+void QualityGovernor::addMainFrame(double milliseconds) {
+    mainTotal += milliseconds;
+    mainFrames++;
+}
+
+void QualityGovernor::addRenderFrame(float cpuMilliseconds, float gpuMilliseconds) {
+    // CPU and GPU overlap: the slower of the two sets the frame rate
+    renderTotal += std::max(cpuMilliseconds, gpuMilliseconds);
+    renderFrames++;
+}
+
+bool QualityGovernor::update(double seconds, CityConfig& config) {
+    if (!config.adaptiveQuality) {
+        elapsed = 0.0;
+        mainTotal = renderTotal = 0.0;
+        mainFrames = renderFrames = 0;
+        if (config.qualityLevel == 0) return false;
+        applyLevel(0, config);
+        return true;
+    }
+    
+    elapsed += seconds;
+    if (elapsed < ADJUST_INTERVAL) return false;
+    
+    double mainMs = mainFrames > 0 ? mainTotal / mainFrames : 0.0;
+    double renderMs = renderFrames > 0 ? renderTotal / renderFrames : 0.0;
+    frameMs = std::max(mainMs, renderMs);
+    elapsed = 0.0;
+    mainTotal = renderTotal = 0.0;
+    mainFrames = renderFrames = 0;
+    
+    int level = config.qualityLevel;
+    if (frameMs > config.frameBudgetMs && level < LEVEL_COUNT - 1) {
+        level++;
+    } else if (frameMs < config.frameBudgetMs * HEADROOM && level > 0) {
+        level--;
+    } else {
+        return false;
+    }
+    
+    applyLevel(level, config);
+    std::cout << "⚙️  Quality level " << level << " (" << std::fixed << std::setprecision(1) << frameMs
+              << " ms per frame, budget " << config.frameBudgetMs << " ms)\n" << std::defaultfloat;
+    return true;
+}
+
+void QualityGovernor::applyLevel(int level, CityConfig& config) {
+    level = std::min(std::max(level, 0), LEVEL_COUNT - 1);
+    const QualityLevel& settings = LEVELS[level];
+    config.qualityLevel = level;
+    config.lodDistanceScale = settings.lodDistanceScale;
+    config.cullAngleScale = settings.cullAngleScale;
+    config.pointSizeScale = settings.pointSizeScale;
+    config.trafficStepsPerUpdate = settings.trafficSteps;
+}
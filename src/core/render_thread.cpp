@@ -0,0 +1,262 @@
+/**
+ * @file render_thread.cpp
+ * @brief Implementation of the Render Thread
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#include "core/render_thread.h"
+#include "core/application.h"
+#include "features/building_lights/building_lighting_system.h"
+#include "generation/city_generator.h"
+#include "rendering/city_renderer.h"
+#include "rendering/texture_manager.h"
+#include "utils/profiler.h"
+#include <chrono>
+#include <unordered_set>
+#include <glm/gtc/type_ptr.hpp>
+
+namespace {
+
+// Wait before looking for a new snapshot again when none has arrived
+constexpr std::chrono::microseconds IDLE_WAIT(500);
+
+}  // namespace
+
+RenderThread::RenderThread(Application& application, CityRenderer& cityRenderer, ShaderManager& shaders,
+                           TextureManager& textures, BuildingLightingSystem& lights, Profiler& renderProfiler)
+    : app(application), renderer(cityRenderer), shaderManager(shaders), textureManager(textures),
+      buildingLights(lights), profiler(renderProfiler), stopping(false), shown(nullptr),
+      builtCityVersion(0), builtLayoutVersion(0), builtPlacedCount(0),
+      viewportWidth(0), viewportHeight(0) {
+    // Every snapshot starts out free for the main thread
+    for (FrameSnapshot& frame : frames) {
+        recycled.tryPush(&frame);
+    }
+}
+
+RenderThread::~RenderThread() {
+    stop();
+}
+
+void RenderThread::start() {
+    if (thread.joinable()) return;
+    stopping = false;
+    app.makeContextCurrent(false);
+    thread = std::thread(&RenderThread::run, this);
+}
+
+void RenderThread::stop() {
+    if (!thread.joinable()) return;
+    stopping = true;
+    thread.join();
+    app.makeContextCurrent(true);
+}
+
+FrameSnapshot* RenderThread::acquireFrame() {
+    FrameSnapshot* frame = nullptr;
+    return recycled.tryPop(frame) ? frame : nullptr;
+}
+
+void RenderThread::publishFrame(FrameSnapshot* frame) {
+    // Never full: there are only FRAME_COUNT snapshots
+    published.tryPush(frame);
+}
+
+FrameSnapshot* RenderThread::takeNewestFrame() {
+    FrameSnapshot* newest = nullptr;
+    FrameSnapshot* frame = nullptr;
+    while (published.tryPop(frame)) {
+        if (newest) recycled.tryPush(newest);  // Superseded before it was drawn
+        newest = frame;
+    }
+    return newest;
+}
+
+void RenderThread::run() {
+    app.makeContextCurrent(true);
+    glfwSwapInterval(1);  // Vsync now paces only this thread
+    
+    while (!stopping) {
+        FrameSnapshot* newest = takeNewestFrame();
+        if (!newest) {
+            // Nothing new: the last frame stays on screen
+            std::this_thread::sleep_for(IDLE_WAIT);
+            continue;
+        }
+        if (shown) recycled.tryPush(shown);
+        shown = newest;
+        
+        // Close the previous frame's statistics; this one is the next profiled frame
+        profiler.endFrame();
+        syncProfiler(*shown);
+        Profiler::CpuScope frameScope(&profiler, "frame");
+        
+        // The cost of drawing travels back with the snapshot (for QualityGovernor)
+        auto drawStart = std::chrono::steady_clock::now();
+        gpuTimer.begin();
+        drawFrame(*shown);
+        gpuTimer.end();
+        shown->drawCpuMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - drawStart).count();
+        shown->drawGpuMs = gpuTimer.getLastMs();
+        shown->drawn = true;
+        
+        Profiler::CpuScope scope(&profiler, "swap");
+        app.swapBuffers();
+    }
+    
+    if (shown) {
+        recycled.tryPush(shown);
+        shown = nullptr;
+    }
+    glFinish();
+    app.makeContextCurrent(false);
+}
+
+void RenderThread::syncProfiler(const FrameSnapshot& frame) {
+    if (frame.profilerOverlay != profiler.isOverlayEnabled()) {
+        profiler.setOverlayEnabled(frame.profilerOverlay);
+    }
+    if (frame.profilerTracing != profiler.isTracing()) {
+        if (frame.profilerTracing) {
+            profiler.startTrace();
+        } else {
+            profiler.stopTrace(TRACE_FILE);
+        }
+    }
+}
+
+void RenderThread::syncCity(const FrameSnapshot& frame) {
+    if (!frame.city || frame.cityVersion == builtCityVersion) return;
+    
+    const CityData& city = *frame.city;
+    size_t placedCount = frame.placedBuildings ? frame.placedBuildings->size() : 0;
+    if (frame.cityLayoutVersion != builtLayoutVersion || placedCount < builtPlacedCount) {
+        renderer.updateCity(city);  // Drops the tiles' buffers too
+        builtBuildings = city.buildings;
+        builtPlacedCount = 0;
+        builtTiles.clear();
+        freeBuildingIndices.clear();
+        buildingLights.setBuildings(builtBuildings);
+    }
+    
+    // Placed buildings: add them without rebuilding (snapshots may have been skipped)
+    for (; builtPlacedCount < placedCount; builtPlacedCount++) {
+        const Building& building = (*frame.placedBuildings)[builtPlacedCount];
+        builtBuildings.push_back(building);
+        buildingLights.setBuilding(builtBuildings.size() - 1, building);
+        renderer.addBuilding(builtBuildings, builtBuildings.size() - 1);
+    }
+    syncTiles(frame);
+    builtCityVersion = frame.cityVersion;
+    builtLayoutVersion = frame.cityLayoutVersion;
+}
+
+void RenderThread::syncTiles(const FrameSnapshot& frame) {
+    static const StreamedTiles noTiles;
+    const StreamedTiles& tiles = frame.tiles ? *frame.tiles : noTiles;
+    if (tiles.empty() && builtTiles.empty()) return;
+    Profiler::CpuScope scope(&profiler, "city.tiles");
+    
+    // A tile loaded again is a new object, so it is freed and uploaded afresh
+    std::unordered_set<const StreamedTile*> shownTiles;
+    for (const auto& tile : tiles) {
+        shownTiles.insert(tile.get());
+    }
+    for (auto it = builtTiles.begin(); it != builtTiles.end();) {
+        if (shownTiles.count(it->second.tile.get())) {
+            ++it;
+            continue;
+        }
+        renderer.removeTile(it->first);
+        renderer.removeBuildings(builtBuildings, it->second.buildings);
+        freeBuildingIndices.insert(freeBuildingIndices.end(), it->second.buildings.begin(), it->second.buildings.end());
+        it = builtTiles.erase(it);
+    }
+    
+    // New tiles' buildings fill the holes first, so builtBuildings stays as large as the most ever shown
+    for (const auto& tile : tiles) {
+        if (builtTiles.count(tile->index)) continue;
+        BuiltTile& built = builtTiles[tile->index];
+        built.tile = tile;
+        for (const Building& building : tile->city.buildings) {
+            uint32_t index;
+            if (freeBuildingIndices.empty()) {
+                index = static_cast<uint32_t>(builtBuildings.size());
+                builtBuildings.push_back(building);
+            } else {
+                index = freeBuildingIndices.back();
+                freeBuildingIndices.pop_back();
+                builtBuildings[index] = building;
+            }
+            built.buildings.push_back(index);
+            buildingLights.setBuilding(index, building);
+        }
+        renderer.addTile(tile->index, *tile->meshes);
+        renderer.addBuildings(builtBuildings, built.buildings);
+    }
+}
+
+void RenderThread::drawFrame(const FrameSnapshot& frame) {
+    // The window reports resizes on the main thread, which has no context
+    int width, height;
+    app.getFramebufferSize(width, height);
+    if (width != viewportWidth || height != viewportHeight) {
+        viewportWidth = width;
+        viewportHeight = height;
+        glViewport(0, 0, width, height);
+    }
+    
+    syncCity(frame);
+    
+    // FEATURE 3: Upload the cars of this frame
+    if (!frame.traffic.empty()) {
+        Profiler::CpuScope scope(&profiler, "traffic.upload");
+        renderer.updateTraffic(frame.traffic, frame.trafficAlpha);
+    }
+    
+    // FEATURE 3: GPU backend - step the cars in the buffers they are drawn from
+    if (frame.gpuTraffic || gpuTraffic.hasCars()) {
+        Profiler::CpuScope scope(&profiler, "traffic.gpu");
+        gpuTraffic.sync(frame.gpuTraffic, frame.gpuTrafficStep);
+    }
+    
+    // FEATURE 2: Set sky color
+    glClearColor(frame.skyColor.r, frame.skyColor.g, frame.skyColor.b, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    
+    // Swap in a texture that finished decoding in the background
+    if (!textureManager.allTexturesReady()) {
+        Profiler::CpuScope scope(&profiler, "textures.upload");
+        textureManager.update();
+    }
+    
+    // FEATURE 1: Light this frame's windows (only buildings whose count changed are uploaded)
+    bool drawCity = frame.city && frame.city->isGenerated && renderer.isReady();
+    if (drawCity && frame.config.view3D) {
+        Profiler::CpuScope scope(&profiler, "lights.update");
+        buildingLights.update(frame.globals.timeOfDay);
+    }
+    
+    // Setup shaders and the uniforms every draw shares
+    shaderManager.use();
+    shaderManager.setFrameGlobals(frame.globals);
+    shaderManager.bindWindowOccupancy(buildingLights.getOccupancyTexture());
+    renderer.setCamera(glm::value_ptr(frame.viewProjection), frame.eye.x, frame.eye.y, frame.eye.z);
+    
+    // Render city
+    if (drawCity) {
+        Profiler::CpuScope scope(&profiler, "render");
+        renderer.render(frame.config, frame.config.view3D, shaderManager,
+                        textureManager.getMaterialArray(),
+                        textureManager.getTexture("road"),
+                        textureManager.getTexture("grass"),
+                        textureManager.getTexture("fountain"));
+        
+        if (!frame.traffic.empty()) {
+            renderer.renderTraffic(frame.traffic, frame.config, frame.config.view3D, shaderManager);
+        }
+        renderer.renderGpuTraffic(gpuTraffic, frame.config, frame.config.view3D, shaderManager);
+    }
+}
@@ -8,9 +8,36 @@
 
 #include "features/building_lights/building_lighting_system.h"
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// Share of windows lit at full night, indexed by BuildingType (homes stay lit longer than offices)
+constexpr float LIT_SHARE[3] = {0.7f, 0.6f, 0.5f};
+
+uint32_t mixBits(uint32_t value) {
+    // Murmur3 finalizer
+    value ^= value >> 16;
+    value *= 0x85EBCA6Bu;
+    value ^= value >> 13;
+    value *= 0xC2B2AE35u;
+    value ^= value >> 16;
+    return value;
+}
+
+uint32_t floatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+}  // namespace
 
 BuildingLightingSystem::BuildingLightingSystem()
-    : warmYellowColor(3.0f, 2.5f, 1.5f)  // Warm yellow glow for windows
+    : occupancyTexture(0)
+    , textureRows(0)
+    , warmYellowColor(3.0f, 2.5f, 1.5f)  // Warm yellow glow for windows
     , sunriseStart(4.0f)
     , sunriseEnd(6.0f)
     , sunsetStart(18.0f)
@@ -18,6 +45,12 @@ BuildingLightingSystem::BuildingLightingSystem()
 {
 }
 
+BuildingLightingSystem::~BuildingLightingSystem() {
+    if (occupancyTexture != 0) {
+        glDeleteTextures(1, &occupancyTexture);
+    }
+}
+
 glm::vec3 BuildingLightingSystem::getWindowEmissionColor(float timeOfDay) const {
     float intensity = getLightIntensity(timeOfDay);
     return warmYellowColor * intensity;
@@ -53,3 +86,107 @@ bool BuildingLightingSystem::areLightsActive(float timeOfDay) const {
     // Lights are active from sunset start to sunrise end
     return (timeOfDay >= sunsetStart) || (timeOfDay < sunriseEnd);
 }
+
+void BuildingLightingSystem::setBuildings(const std::vector<Building>& buildings) {
+    schedules.resize(buildings.size());
+    masks.assign(buildings.size() * 2, 0u);
+    for (size_t i = 0; i < buildings.size(); i++) {
+        setBuilding(i, buildings[i]);
+    }
+}
+
+void BuildingLightingSystem::setBuilding(size_t index, const Building& building) {
+    if (index >= schedules.size()) {
+        schedules.resize(index + 1);
+        masks.resize(std::max(masks.size(), (index + 1) * 2), 0u);
+    }
+    uint32_t seed = mixBits(floatBits(building.x) ^ mixBits(floatBits(building.y) + building.type));
+    
+    BuildingSchedule& schedule = schedules[index];
+    schedule.seed = seed;
+    schedule.hourOffset = ((seed & 0xFFFFu) / 65535.0f * 2.0f - 1.0f) * SCHEDULE_SPREAD;
+    schedule.litShare = LIT_SHARE[building.type];
+    schedule.litLevel = -1;
+}
+
+void BuildingLightingSystem::writeMask(const BuildingSchedule& schedule, uint32_t* texel) {
+    // The building's windows in a fixed shuffled order (Fisher-Yates, seeded
+    // per building); raising the level lights the next windows of that order,
+    // so windows already lit stay lit and each level lights exactly one more
+    uint8_t order[WINDOWS_PER_BUILDING];
+    for (int window = 0; window < WINDOWS_PER_BUILDING; window++) {
+        order[window] = static_cast<uint8_t>(window);
+    }
+    uint32_t state = schedule.seed;
+    for (int window = WINDOWS_PER_BUILDING - 1; window > 0; window--) {
+        state = mixBits(state + 0x9E3779B9u);
+        std::swap(order[window], order[state % static_cast<uint32_t>(window + 1)]);
+    }
+    
+    texel[0] = texel[1] = 0u;
+    int lit = std::min(schedule.litLevel, WINDOWS_PER_BUILDING);
+    for (int i = 0; i < lit; i++) {
+        texel[order[i] >> 5] |= 1u << (order[i] & 31);
+    }
+}
+
+void BuildingLightingSystem::ensureTexture() {
+    int rows = std::max(1, static_cast<int>((schedules.size() + OCCUPANCY_WIDTH - 1) / OCCUPANCY_WIDTH));
+    if (occupancyTexture != 0 && rows <= textureRows) return;
+    
+    if (occupancyTexture == 0) {
+        glGenTextures(1, &occupancyTexture);
+    }
+    glBindTexture(GL_TEXTURE_2D, occupancyTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);  // Integer textures cannot filter
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32UI, OCCUPANCY_WIDTH, rows, 0, GL_RG_INTEGER, GL_UNSIGNED_INT, nullptr);
+    textureRows = rows;
+    
+    // A new allocation holds nothing yet
+    for (BuildingSchedule& schedule : schedules) {
+        schedule.litLevel = -1;
+    }
+}
+
+void BuildingLightingSystem::update(float timeOfDay) {
+    ensureTexture();
+    
+    size_t firstChanged = schedules.size();
+    size_t lastChanged = 0;
+    for (size_t i = 0; i < schedules.size(); i++) {
+        BuildingSchedule& schedule = schedules[i];
+        float localTime = std::fmod(timeOfDay + schedule.hourOffset + 24.0f, 24.0f);
+        int level = static_cast<int>(std::lround(getLightIntensity(localTime) * schedule.litShare * WINDOWS_PER_BUILDING));
+        if (level == schedule.litLevel) continue;
+        
+        schedule.litLevel = level;
+        writeMask(schedule, &masks[i * 2]);
+        firstChanged = std::min(firstChanged, i);
+        lastChanged = i;
+    }
+    if (firstChanged > lastChanged) return;
+    
+    // Whole rows from the first changed building's to the last one's
+    int firstRow = static_cast<int>(firstChanged / OCCUPANCY_WIDTH);
+    int lastRow = static_cast<int>(lastChanged / OCCUPANCY_WIDTH);
+    size_t rowTexels = static_cast<size_t>(OCCUPANCY_WIDTH);
+    masks.resize(std::max(masks.size(), (lastRow + 1) * rowTexels * 2), 0u);  // The last row may be partial
+    
+    glBindTexture(GL_TEXTURE_2D, occupancyTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstRow, OCCUPANCY_WIDTH, lastRow - firstRow + 1,
+                    GL_RG_INTEGER, GL_UNSIGNED_INT, &masks[firstRow * rowTexels * 2]);
+}
+
+int BuildingLightingSystem::getLitWindowCount(size_t building) const {
+    if (building * 2 + 1 >= masks.size()) return 0;
+    int count = 0;
+    for (int word = 0; word < 2; word++) {
+        for (uint32_t bits = masks[building * 2 + word]; bits != 0; bits &= bits - 1) {
+            count++;
+        }
+    }
+    return count;
+}
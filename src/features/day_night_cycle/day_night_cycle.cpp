@@ -69,6 +69,10 @@ float DayNightCycle::getAmbientLightFactor() const {
     return calculateAmbientFactor(timeOfDay);
 }
 
+float DayNightCycle::getWindowLightFactor() const {
+    return (timeOfDay >= 19.0f || timeOfDay < 7.0f) ? 0.5f : 0.25f;
+}
+
 float DayNightCycle::calculateAmbientFactor(float time) const {
     // Day hours (7am - 7pm): Full brightness
     if (time >= 7.0f && time < 19.0f) {
@@ -7,12 +7,120 @@
  */
 
 #include "features/save_load/city_serializer.h"
+#include "features/save_load/city_file_format.h"
+#include "utils/json_reader.h"
+#include "utils/mapped_file.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <cmath>
 #include <sys/stat.h>
 #include <sys/types.h>
 
+namespace {
+
+// The format is little-endian; records are written and read in host order
+bool isLittleEndianHost() {
+    const uint16_t probe = 1;
+    unsigned char firstByte;
+    std::memcpy(&firstByte, &probe, 1);
+    return firstByte == 1;
+}
+
+uint64_t alignUp(uint64_t offset) {
+    return (offset + CityFileFormat::ALIGNMENT - 1) & ~static_cast<uint64_t>(CityFileFormat::ALIGNMENT - 1);
+}
+
+bool isAligned(uint64_t offset) {
+    return offset % CityFileFormat::ALIGNMENT == 0;
+}
+
+static_assert(CityTileFormat::ALIGNMENT == CityFileFormat::ALIGNMENT, "Both formats align with alignUp()");
+
+/// Records of one tile of a tiled save, before they are laid out
+struct TileArrays {
+    std::vector<CityFileFormat::BuildingRecord> buildings;
+    std::vector<CityFileFormat::RoadRecord> roads;
+    std::vector<CityFileFormat::PointRecord> points;
+    std::vector<CityFileFormat::CircleRecord> parks;
+};
+
+/// Tile grid of a tiled save
+struct TileGrid {
+    uint32_t tileSize;
+    uint32_t tilesX;
+    uint32_t tilesY;
+    
+    uint32_t tileOf(float x, float y) const {
+        long column = std::lround(std::floor(x / tileSize));
+        long row = std::lround(std::floor(y / tileSize));
+        column = std::min<long>(std::max<long>(column, 0), tilesX - 1);
+        row = std::min<long>(std::max<long>(row, 0), tilesY - 1);
+        return static_cast<uint32_t>(column + row * static_cast<long>(tilesX));
+    }
+};
+
+// Cut a road where it crosses tile edges and append each piece to the tile it runs through
+void splitRoadIntoTiles(const Road& road, const TileGrid& grid, std::vector<TileArrays>& tiles) {
+    std::vector<CityFileFormat::PointRecord> piece;
+    uint32_t pieceTile = 0;
+    auto finishPiece = [&]() {
+        if (piece.size() >= 2) {
+            TileArrays& tile = tiles[pieceTile];
+            tile.roads.push_back({static_cast<uint32_t>(tile.points.size()), static_cast<uint32_t>(piece.size()),
+                                  road.width, 0});
+            tile.points.insert(tile.points.end(), piece.begin(), piece.end());
+        }
+        piece.clear();
+    };
+    
+    std::vector<float> cuts;
+    for (size_t i = 0; i + 1 < road.path.size(); i++) {
+        const Point& a = road.path[i];
+        const Point& b = road.path[i + 1];
+        
+        // Where the segment crosses grid lines, as fractions of its length
+        cuts.assign({0.0f, 1.0f});
+        auto addCrossings = [&](int from, int to) {
+            int low = std::min(from, to);
+            int high = std::max(from, to);
+            for (int line = (low / static_cast<int>(grid.tileSize) + 1) * static_cast<int>(grid.tileSize);
+                 line < high; line += grid.tileSize) {
+                cuts.push_back(static_cast<float>(line - from) / static_cast<float>(to - from));
+            }
+        };
+        if (a.x != b.x) addCrossings(a.x, b.x);
+        if (a.y != b.y) addCrossings(a.y, b.y);
+        std::sort(cuts.begin(), cuts.end());
+        
+        for (size_t c = 0; c + 1 < cuts.size(); c++) {
+            float middle = 0.5f * (cuts[c] + cuts[c + 1]);
+            uint32_t tile = grid.tileOf(a.x + (b.x - a.x) * middle, a.y + (b.y - a.y) * middle);
+            CityFileFormat::PointRecord start = {static_cast<int32_t>(std::lround(a.x + (b.x - a.x) * cuts[c])),
+                                                 static_cast<int32_t>(std::lround(a.y + (b.y - a.y) * cuts[c]))};
+            CityFileFormat::PointRecord end = {static_cast<int32_t>(std::lround(a.x + (b.x - a.x) * cuts[c + 1])),
+                                               static_cast<int32_t>(std::lround(a.y + (b.y - a.y) * cuts[c + 1]))};
+            if (start.x == end.x && start.y == end.y) continue;
+            
+            // A piece continues while the road stays in one tile
+            if (piece.empty() || tile != pieceTile) {
+                finishPiece();
+                pieceTile = tile;
+                piece.push_back(start);
+            }
+            piece.push_back(end);
+        }
+    }
+    finishPiece();
+}
+
+}  // namespace
+
+bool CitySerializer::verbose = true;
+
 std::string CitySerializer::getSaveDirectory() {
     return "saves/";
 }
@@ -60,12 +168,19 @@ bool CitySerializer::saveCity(const CityData& city, const std::string& filename)
         return false;
     }
     
-    std::cout << "\n💾 Saving city to " << filepath << "...\n";
+    if (verbose) std::cout << "\n💾 Saving city to " << filepath << "...\n";
     
     // Write JSON manually (simple format)
     file << "{\n";
     file << "  \"version\": \"1.0\",\n";
     file << "  \"timestamp\": \"" << time(nullptr) << "\",\n";
+    file << "  \"counts\": {\"buildings\": " << city.buildings.size()
+         << ", \"roads\": " << city.roads.size()
+         << ", \"parks\": " << city.parks.size() << "},\n";
+    file << "  \"extent\": {\"width\": " << city.extent.width
+         << ", \"height\": " << city.extent.height << "},\n";
+    // A string: 64-bit seeds do not survive JSON readers that parse numbers as doubles
+    file << "  \"seed\": \"" << city.seed << "\",\n";
     
     // Save buildings
     file << "  \"buildings\": [\n";
@@ -88,11 +203,11 @@ bool CitySerializer::saveCity(const CityData& city, const std::string& filename)
         const Road& r = city.roads[i];
         file << "    {\n";
         file << "      \"width\": " << r.width << ",\n";
-        file << "      \"points\": [\n";
-        for (size_t j = 0; j < r.points.size(); j++) {
-            const Point& p = r.points[j];
+        file << "      \"path\": [\n";
+        for (size_t j = 0; j < r.path.size(); j++) {
+            const Point& p = r.path[j];
             file << "        {\"x\": " << p.x << ", \"y\": " << p.y << "}"
-                 << (j < r.points.size() - 1 ? "," : "") << "\n";
+                 << (j < r.path.size() - 1 ? "," : "") << "\n";
         }
         file << "      ]\n";
         file << "    }" << (i < city.roads.size() - 1 ? "," : "") << "\n";
@@ -102,192 +217,553 @@ bool CitySerializer::saveCity(const CityData& city, const std::string& filename)
     // Save parks
     file << "  \"parks\": [\n";
     for (size_t i = 0; i < city.parks.size(); i++) {
-        const auto& park = city.parks[i];
-        file << "    [\n";
-        for (size_t j = 0; j < park.size(); j++) {
-            const Point& p = park[j];
-            file << "      {\"x\": " << p.x << ", \"y\": " << p.y << "}"
-                 << (j < park.size() - 1 ? "," : "") << "\n";
-        }
-        file << "    ]" << (i < city.parks.size() - 1 ? "," : "") << "\n";
+        const Circle& park = city.parks[i];
+        file << "    {\"x\": " << park.x << ", \"y\": " << park.y
+             << ", \"radius\": " << park.radius << "}"
+             << (i < city.parks.size() - 1 ? "," : "") << "\n";
     }
     file << "  ],\n";
     
     // Save fountain
-    file << "  \"fountain\": [\n";
-    for (size_t i = 0; i < city.fountain.size(); i++) {
-        const Point& p = city.fountain[i];
-        file << "    {\"x\": " << p.x << ", \"y\": " << p.y << "}"
-             << (i < city.fountain.size() - 1 ? "," : "") << "\n";
-    }
-    file << "  ]\n";
+    file << "  \"fountain\": {\"x\": " << city.fountain.x << ", \"y\": " << city.fountain.y
+         << ", \"radius\": " << city.fountain.radius << "}\n";
     
     file << "}\n";
     
     file.close();
     
-    std::cout << "✅ City saved successfully!\n";
-    std::cout << "   - " << city.buildings.size() << " buildings\n";
-    std::cout << "   - " << city.roads.size() << " roads (";
-    int totalRoadPoints = 0;
-    for (const auto& road : city.roads) {
-        totalRoadPoints += road.points.size();
+    if (verbose) {
+        std::cout << "✅ City saved successfully!\n";
+        std::cout << "   - " << city.buildings.size() << " buildings\n";
+        std::cout << "   - " << city.roads.size() << " roads (";
+        int totalRoadPoints = 0;
+        for (const auto& road : city.roads) {
+            totalRoadPoints += road.path.size();
+        }
+        std::cout << totalRoadPoints << " path vertices)\n";
+        std::cout << "   - " << city.parks.size() << " parks\n";
+        std::cout << "   - fountain radius " << city.fountain.radius << "\n";
+        std::cout << "   - File: " << filepath << "\n\n";
     }
-    std::cout << totalRoadPoints << " total points)\n";
-    std::cout << "   - " << city.parks.size() << " parks\n";
-    std::cout << "   - " << city.fountain.size() << " fountain points\n";
-    std::cout << "   - File: " << filepath << "\n\n";
     
     return true;
 }
 
+void CitySerializer::readPoints(JsonReader& json, std::vector<Point>& out) {
+    out.clear();
+    if (!json.beginArray()) return;
+    std::string key;
+    while (json.nextElement()) {
+        Point p;
+        json.beginObject();
+        while (json.nextMember(key)) {
+            if (key == "x") json.readInt(p.x);
+            else if (key == "y") json.readInt(p.y);
+            else json.skipValue();
+        }
+        out.push_back(p);
+    }
+}
+
+// Current saves store {"x", "y", "radius"}; legacy saves stored every outline pixel
+Circle CitySerializer::readCircle(JsonReader& json, std::vector<Point>& scratch) {
+    if (json.peekType() == JsonType::ARRAY) {
+        readPoints(json, scratch);
+        return Circle::fromPoints(scratch);
+    }
+    
+    Circle circle;
+    std::string key;
+    json.beginObject();
+    while (json.nextMember(key)) {
+        if (key == "x") json.readFloat(circle.x);
+        else if (key == "y") json.readFloat(circle.y);
+        else if (key == "radius") json.readFloat(circle.radius);
+        else json.skipValue();
+    }
+    return circle;
+}
+
+void CitySerializer::readBuildings(JsonReader& json, CityData& city) {
+    json.beginArray();
+    std::string key;
+    std::string typeName;
+    while (json.nextElement()) {
+        Building b(0, 0, 0, 0, 0, BuildingType::LOW_RISE);
+        json.beginObject();
+        while (json.nextMember(key)) {
+            if (key == "x") json.readFloat(b.x);
+            else if (key == "y") json.readFloat(b.y);
+            else if (key == "width") json.readFloat(b.width);
+            else if (key == "depth") json.readFloat(b.depth);
+            else if (key == "height") json.readFloat(b.height);
+            else if (key == "type" && json.readString(typeName)) b.type = stringToBuildingType(typeName);
+            else json.skipValue();
+        }
+        city.buildings.push_back(b);
+    }
+}
+
+void CitySerializer::readRoads(JsonReader& json, CityData& city, std::vector<Point>& scratch) {
+    json.beginArray();
+    std::string key;
+    while (json.nextElement()) {
+        int width = Road().width;
+        bool legacyPoints = false;  ///< Pre-polyline saves stored every road pixel
+        scratch.clear();
+        json.beginObject();
+        while (json.nextMember(key)) {
+            if (key == "width") {
+                json.readInt(width);
+            } else if (key == "path" || key == "points") {
+                legacyPoints = key == "points";
+                readPoints(json, scratch);
+            } else {
+                json.skipValue();
+            }
+        }
+        
+        if (legacyPoints) {
+            // Compact the old per-pixel list into polylines
+            for (Road& road : Road::fromPixels(scratch, width)) {
+                city.roads.push_back(std::move(road));
+            }
+        } else if (!scratch.empty()) {
+            // Copy out of the scratch list so each path is allocated exactly once
+            city.roads.emplace_back(scratch, width);
+        }
+    }
+}
+
 bool CitySerializer::loadCity(CityData& city, const std::string& filename) {
     std::string filepath = getSaveDirectory() + filename + ".json";
-    std::ifstream file(filepath);
+    std::ifstream file(filepath, std::ios::binary);
     
     if (!file.is_open()) {
         std::cout << "❌ Failed to open file for reading: " << filepath << "\n";
         return false;
     }
     
-    std::cout << "\n📂 Loading city from " << filepath << "...\n";
+    if (verbose) std::cout << "\n📂 Loading city from " << filepath << "...\n";
     
-    city.clear();
+    // Parse into a fresh city so a malformed file leaves the current one intact
+    CityData loaded;
+    JsonReader json(file);
+    std::vector<Point> scratch;  ///< Reused for every road path and legacy outline
+    std::string key;
     
-    std::string line;
-    std::string section = "";
-    Building currentBuilding(0, 0, 0, 0, 0, BuildingType::LOW_RISE);
-    Road currentRoad;
-    std::vector<Point> currentPark;
-    
-    int braceDepth = 0;
-    bool inBuilding = false;
-    bool inRoad = false;
-    bool inPark = false;
-    bool inFountain = false;
-    bool inPoints = false;
-    
-    while (std::getline(file, line)) {
-        // Track brace depth
-        for (char c : line) {
-            if (c == '{') braceDepth++;
-            if (c == '}') braceDepth--;
-        }
-        
-        // Detect sections
-        if (line.find("\"buildings\"") != std::string::npos) {
-            section = "buildings";
-        } else if (line.find("\"roads\"") != std::string::npos) {
-            section = "roads";
-        } else if (line.find("\"parks\"") != std::string::npos) {
-            section = "parks";
-        } else if (line.find("\"fountain\"") != std::string::npos) {
-            section = "fountain";
-        }
-        
-        // Parse buildings
-        if (section == "buildings") {
-            if (line.find("\"x\":") != std::string::npos) {
-                size_t pos = line.find(":") + 1;
-                currentBuilding.x = std::stof(line.substr(pos));
-            } else if (line.find("\"y\":") != std::string::npos) {
-                size_t pos = line.find(":") + 1;
-                currentBuilding.y = std::stof(line.substr(pos));
-            } else if (line.find("\"width\":") != std::string::npos) {
-                size_t pos = line.find(":") + 1;
-                currentBuilding.width = std::stof(line.substr(pos));
-            } else if (line.find("\"depth\":") != std::string::npos) {
-                size_t pos = line.find(":") + 1;
-                currentBuilding.depth = std::stof(line.substr(pos));
-            } else if (line.find("\"height\":") != std::string::npos) {
-                size_t pos = line.find(":") + 1;
-                currentBuilding.height = std::stof(line.substr(pos));
-            } else if (line.find("\"type\":") != std::string::npos) {
-                size_t start = line.find("\"", line.find(":")) + 1;
-                size_t end = line.find("\"", start);
-                std::string typeStr = line.substr(start, end - start);
-                currentBuilding.type = stringToBuildingType(typeStr);
-                city.buildings.push_back(currentBuilding);
+    json.beginObject();
+    while (json.nextMember(key)) {
+        if (key == "counts") {
+            // Written by saveCity ahead of the arrays so they can be reserved up front
+            std::string countKey;
+            json.beginObject();
+            while (json.nextMember(countKey)) {
+                int count = 0;
+                json.readInt(count);
+                size_t reserveCount = static_cast<size_t>(std::max(count, 0));
+                if (countKey == "buildings") loaded.buildings.reserve(reserveCount);
+                else if (countKey == "roads") loaded.roads.reserve(reserveCount);
+                else if (countKey == "parks") loaded.parks.reserve(reserveCount);
             }
-        }
-        
-        // Parse roads
-        if (section == "roads") {
-            if (line.find("\"width\":") != std::string::npos && !inPoints) {
-                size_t pos = line.find(":") + 1;
-                currentRoad.width = std::stoi(line.substr(pos));
-            } else if (line.find("\"points\":") != std::string::npos) {
-                inPoints = true;
-                currentRoad.points.clear();
-            } else if (inPoints && line.find("\"x\":") != std::string::npos) {
-                Point p;
-                size_t xPos = line.find("\"x\":") + 4;
-                size_t xEnd = line.find(",", xPos);
-                p.x = std::stoi(line.substr(xPos, xEnd - xPos));
-                
-                size_t yPos = line.find("\"y\":") + 4;
-                size_t yEnd = line.find("}", yPos);
-                p.y = std::stoi(line.substr(yPos, yEnd - yPos));
-                
-                currentRoad.points.push_back(p);
-            } else if (inPoints && line.find("]") != std::string::npos) {
-                inPoints = false;
-                if (!currentRoad.points.empty()) {
-                    city.roads.push_back(currentRoad);
-                }
+        } else if (key == "extent") {
+            // Missing in older files, which keep the default extent
+            std::string extentKey;
+            WorldExtent extent;
+            json.beginObject();
+            while (json.nextMember(extentKey)) {
+                if (extentKey == "width") json.readInt(extent.width);
+                else if (extentKey == "height") json.readInt(extent.height);
+                else json.skipValue();
             }
-        }
-        
-        // Parse parks
-        if (section == "parks") {
-            if (line.find("[") != std::string::npos && line.find("\"parks\"") == std::string::npos && section == "parks") {
-                currentPark.clear();
-            } else if (line.find("\"x\":") != std::string::npos && section == "parks") {
-                Point p;
-                size_t xPos = line.find("\"x\":") + 4;
-                size_t xEnd = line.find(",", xPos);
-                p.x = std::stoi(line.substr(xPos, xEnd - xPos));
-                
-                size_t yPos = line.find("\"y\":") + 4;
-                size_t yEnd = line.find("}", yPos);
-                p.y = std::stoi(line.substr(yPos, yEnd - yPos));
-                
-                currentPark.push_back(p);
-            } else if (line.find("]") != std::string::npos && !currentPark.empty() && section == "parks") {
-                city.parks.push_back(currentPark);
-                currentPark.clear();
+            if (extent.isValid()) loaded.extent = extent;
+        } else if (key == "seed") {
+            std::string seed;
+            if (json.readString(seed)) loaded.seed = std::strtoull(seed.c_str(), nullptr, 10);
+        } else if (key == "buildings") {
+            readBuildings(json, loaded);
+        } else if (key == "roads") {
+            readRoads(json, loaded, scratch);
+        } else if (key == "parks") {
+            json.beginArray();
+            while (json.nextElement()) {
+                loaded.parks.push_back(readCircle(json, scratch));
             }
+        } else if (key == "fountain") {
+            loaded.fountain = readCircle(json, scratch);
+        } else {
+            json.skipValue();
         }
-        
-        // Parse fountain
-        if (section == "fountain" && line.find("\"x\":") != std::string::npos) {
-            Point p;
-            size_t xPos = line.find("\"x\":") + 4;
-            size_t xEnd = line.find(",", xPos);
-            p.x = std::stoi(line.substr(xPos, xEnd - xPos));
-            
-            size_t yPos = line.find("\"y\":") + 4;
-            size_t yEnd = line.find("}", yPos);
-            p.y = std::stoi(line.substr(yPos, yEnd - yPos));
-            
-            city.fountain.push_back(p);
+    }
+    
+    if (!json.ok()) {
+        std::cout << "❌ Corrupt city file (" << json.getError() << "): " << filepath << "\n";
+        return false;
+    }
+    
+    file.close();
+    
+    city = std::move(loaded);
+    city.network.build(city.roads);
+    city.rebuildIndex();
+    city.isGenerated = true;
+    
+    if (verbose) {
+        std::cout << "✅ City loaded successfully!\n";
+        std::cout << "   - " << city.buildings.size() << " buildings\n";
+        std::cout << "   - " << city.roads.size() << " roads (";
+        int totalRoadPoints = 0;
+        for (const auto& road : city.roads) {
+            totalRoadPoints += road.path.size();
         }
+        std::cout << totalRoadPoints << " path vertices)\n";
+        std::cout << "   - " << city.parks.size() << " parks\n";
+        std::cout << "   - fountain radius " << city.fountain.radius << "\n\n";
+    }
+    
+    return true;
+}
+
+bool CitySerializer::hasBinarySave(const std::string& filename) {
+    struct stat info;
+    return stat((getSaveDirectory() + filename + ".city").c_str(), &info) == 0;
+}
+
+bool CitySerializer::saveCityBinary(const CityData& city, const std::string& filename) {
+    using namespace CityFileFormat;
+    
+    if (!city.isGenerated) {
+        std::cout << "❌ Cannot save: No city generated yet!\n";
+        return false;
+    }
+    if (!isLittleEndianHost()) {
+        std::cout << "❌ Binary saves are only supported on little-endian machines\n";
+        return false;
+    }
+    
+    std::string saveDir = getSaveDirectory();
+    mkdir(saveDir.c_str(), 0755);
+    
+    std::string filepath = saveDir + filename + ".city";
+    std::ofstream file(filepath, std::ios::binary);
+    
+    if (!file.is_open()) {
+        std::cout << "❌ Failed to open file for writing: " << filepath << "\n";
+        return false;
+    }
+    
+    if (verbose) std::cout << "\n💾 Saving city to " << filepath << "...\n";
+    
+    // Flatten into the on-disk records
+    std::vector<BuildingRecord> buildings;
+    buildings.reserve(city.buildings.size());
+    for (const Building& b : city.buildings) {
+        buildings.push_back({b.x, b.y, b.width, b.depth, b.height, static_cast<uint32_t>(b.type)});
+    }
+    
+    std::vector<RoadRecord> roads;
+    std::vector<PointRecord> points;
+    roads.reserve(city.roads.size());
+    for (const Road& road : city.roads) {
+        roads.push_back({static_cast<uint32_t>(points.size()), static_cast<uint32_t>(road.path.size()),
+                         road.width, 0});
+        for (const Point& p : road.path) {
+            points.push_back({p.x, p.y});
+        }
+    }
+    
+    std::vector<CircleRecord> parks;
+    parks.reserve(city.parks.size());
+    for (const Circle& park : city.parks) {
+        parks.push_back({park.x, park.y, park.radius});
+    }
+    
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.headerSize = sizeof(Header);
+    header.buildingCount = static_cast<uint32_t>(buildings.size());
+    header.roadCount = static_cast<uint32_t>(roads.size());
+    header.pointCount = static_cast<uint32_t>(points.size());
+    header.parkCount = static_cast<uint32_t>(parks.size());
+    header.fountainX = city.fountain.x;
+    header.fountainY = city.fountain.y;
+    header.fountainRadius = city.fountain.radius;
+    header.worldWidth = static_cast<uint32_t>(city.extent.width);
+    header.worldHeight = static_cast<uint32_t>(city.extent.height);
+    header.seed = city.seed;
+    header.buildingsOffset = alignUp(sizeof(Header));
+    header.roadsOffset = alignUp(header.buildingsOffset + buildings.size() * sizeof(BuildingRecord));
+    header.pointsOffset = alignUp(header.roadsOffset + roads.size() * sizeof(RoadRecord));
+    header.parksOffset = alignUp(header.pointsOffset + points.size() * sizeof(PointRecord));
+    
+    // Write each array at its offset, zero-padding the gaps
+    uint64_t written = 0;
+    auto writeAt = [&](uint64_t offset, const void* bytes, size_t size) {
+        static const char padding[ALIGNMENT] = {};
+        file.write(padding, static_cast<std::streamsize>(offset - written));
+        file.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+        written = offset + size;
+    };
+    writeAt(0, &header, sizeof(header));
+    writeAt(header.buildingsOffset, buildings.data(), buildings.size() * sizeof(BuildingRecord));
+    writeAt(header.roadsOffset, roads.data(), roads.size() * sizeof(RoadRecord));
+    writeAt(header.pointsOffset, points.data(), points.size() * sizeof(PointRecord));
+    writeAt(header.parksOffset, parks.data(), parks.size() * sizeof(CircleRecord));
+    
+    file.close();
+    if (!file) {
+        std::cout << "❌ Failed while writing: " << filepath << "\n";
+        return false;
+    }
+    
+    if (verbose) {
+        std::cout << "✅ City saved successfully!\n";
+        std::cout << "   - " << city.buildings.size() << " buildings\n";
+        std::cout << "   - " << city.roads.size() << " roads (" << points.size() << " path vertices)\n";
+        std::cout << "   - " << city.parks.size() << " parks\n";
+        std::cout << "   - fountain radius " << city.fountain.radius << "\n";
+        std::cout << "   - File: " << filepath << " (" << written << " bytes)\n\n";
+    }
+    
+    return true;
+}
+
+std::string CitySerializer::tiledSavePath(const std::string& filename) {
+    return getSaveDirectory() + filename + ".ctiles";
+}
+
+bool CitySerializer::saveCityTiled(const CityData& city, const std::string& filename, uint32_t tileSize) {
+    using namespace CityFileFormat;
+    
+    if (!city.isGenerated) {
+        std::cout << "❌ Cannot save: No city generated yet!\n";
+        return false;
+    }
+    if (!isLittleEndianHost()) {
+        std::cout << "❌ Binary saves are only supported on little-endian machines\n";
+        return false;
+    }
+    
+    TileGrid grid;
+    grid.tileSize = std::max<uint32_t>(tileSize, 1);
+    grid.tilesX = std::max<uint32_t>(1, (static_cast<uint32_t>(city.extent.width) + grid.tileSize - 1) / grid.tileSize);
+    grid.tilesY = std::max<uint32_t>(1, (static_cast<uint32_t>(city.extent.height) + grid.tileSize - 1) / grid.tileSize);
+    if (static_cast<uint64_t>(grid.tilesX) * grid.tilesY > CityTileFormat::MAX_TILES) {
+        std::cout << "❌ Cannot save: " << grid.tilesX << "x" << grid.tilesY << " tiles is too many, "
+                  << "use larger tiles\n";
+        return false;
+    }
+    
+    std::string saveDir = getSaveDirectory();
+    mkdir(saveDir.c_str(), 0755);
+    
+    std::string filepath = tiledSavePath(filename);
+    std::ofstream file(filepath, std::ios::binary);
+    
+    if (!file.is_open()) {
+        std::cout << "❌ Failed to open file for writing: " << filepath << "\n";
+        return false;
+    }
+    
+    if (verbose) std::cout << "\n💾 Saving tiled city to " << filepath << "...\n";
+    
+    // Sort every object into its tile
+    std::vector<TileArrays> tiles(static_cast<size_t>(grid.tilesX) * grid.tilesY);
+    for (const Building& b : city.buildings) {
+        tiles[grid.tileOf(b.x, b.y)].buildings.push_back({b.x, b.y, b.width, b.depth, b.height,
+                                                          static_cast<uint32_t>(b.type)});
+    }
+    for (const Road& road : city.roads) {
+        splitRoadIntoTiles(road, grid, tiles);
+    }
+    for (const Circle& park : city.parks) {
+        tiles[grid.tileOf(park.x, park.y)].parks.push_back({park.x, park.y, park.radius});
+    }
+    
+    CityTileFormat::Header header = {};
+    std::memcpy(header.magic, CityTileFormat::MAGIC, sizeof(header.magic));
+    header.version = CityTileFormat::VERSION;
+    header.headerSize = sizeof(header);
+    header.tileSize = grid.tileSize;
+    header.tilesX = grid.tilesX;
+    header.tilesY = grid.tilesY;
+    header.worldWidth = static_cast<uint32_t>(city.extent.width);
+    header.worldHeight = static_cast<uint32_t>(city.extent.height);
+    header.fountainX = city.fountain.x;
+    header.fountainY = city.fountain.y;
+    header.fountainRadius = city.fountain.radius;
+    header.seed = city.seed;
+    header.tilesOffset = alignUp(sizeof(header));
+    
+    // Lay the tiles out one after another, each array aligned
+    std::vector<CityTileFormat::TileRecord> records(tiles.size());
+    uint64_t cursor = alignUp(header.tilesOffset + records.size() * sizeof(CityTileFormat::TileRecord));
+    auto place = [&](uint64_t& offset, size_t bytes) {
+        offset = bytes > 0 ? cursor : 0;
+        cursor = alignUp(cursor + bytes);
+    };
+    for (size_t i = 0; i < tiles.size(); i++) {
+        const TileArrays& tile = tiles[i];
+        CityTileFormat::TileRecord& record = records[i];
+        record.buildingCount = static_cast<uint32_t>(tile.buildings.size());
+        record.roadCount = static_cast<uint32_t>(tile.roads.size());
+        record.pointCount = static_cast<uint32_t>(tile.points.size());
+        record.parkCount = static_cast<uint32_t>(tile.parks.size());
+        place(record.buildingsOffset, tile.buildings.size() * sizeof(BuildingRecord));
+        place(record.roadsOffset, tile.roads.size() * sizeof(RoadRecord));
+        place(record.pointsOffset, tile.points.size() * sizeof(PointRecord));
+        place(record.parksOffset, tile.parks.size() * sizeof(CircleRecord));
+    }
+    
+    // Write each array at its offset, zero-padding the gaps
+    uint64_t written = 0;
+    auto writeAt = [&](uint64_t offset, const void* bytes, size_t size) {
+        if (size == 0) return;
+        static const char padding[ALIGNMENT] = {};
+        file.write(padding, static_cast<std::streamsize>(offset - written));
+        file.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+        written = offset + size;
+    };
+    writeAt(0, &header, sizeof(header));
+    writeAt(header.tilesOffset, records.data(), records.size() * sizeof(CityTileFormat::TileRecord));
+    size_t roadPieces = 0;
+    for (size_t i = 0; i < tiles.size(); i++) {
+        const TileArrays& tile = tiles[i];
+        const CityTileFormat::TileRecord& record = records[i];
+        writeAt(record.buildingsOffset, tile.buildings.data(), tile.buildings.size() * sizeof(BuildingRecord));
+        writeAt(record.roadsOffset, tile.roads.data(), tile.roads.size() * sizeof(RoadRecord));
+        writeAt(record.pointsOffset, tile.points.data(), tile.points.size() * sizeof(PointRecord));
+        writeAt(record.parksOffset, tile.parks.data(), tile.parks.size() * sizeof(CircleRecord));
+        roadPieces += tile.roads.size();
     }
     
     file.close();
+    if (!file) {
+        std::cout << "❌ Failed while writing: " << filepath << "\n";
+        return false;
+    }
+    
+    if (verbose) {
+        std::cout << "✅ Tiled city saved successfully!\n";
+        std::cout << "   - " << grid.tilesX << "x" << grid.tilesY << " tiles of " << grid.tileSize << " units\n";
+        std::cout << "   - " << city.buildings.size() << " buildings\n";
+        std::cout << "   - " << city.roads.size() << " roads (" << roadPieces << " pieces after cutting at tile edges)\n";
+        std::cout << "   - " << city.parks.size() << " parks\n";
+        std::cout << "   - File: " << filepath << " (" << written << " bytes)\n\n";
+    }
+    
+    return true;
+}
+
+bool CitySerializer::loadCityBinary(CityData& city, const std::string& filename) {
+    using namespace CityFileFormat;
+    
+    std::string filepath = getSaveDirectory() + filename + ".city";
+    MappedFile file(filepath);
+    
+    if (!file.data) {
+        std::cout << "❌ Failed to open file for reading: " << filepath << "\n";
+        return false;
+    }
+    if (!isLittleEndianHost()) {
+        std::cout << "❌ Binary saves are only supported on little-endian machines\n";
+        return false;
+    }
+    
+    if (verbose) std::cout << "\n📂 Loading city from " << filepath << "...\n";
+    
+    // Validate everything before touching city
+    // Older headers are shorter; the fields they lack stay zero
+    Header header = {};
+    if (file.size < HEADER_SIZE_V1) {
+        std::cout << "❌ Not a city file (too small): " << filepath << "\n";
+        return false;
+    }
+    std::memcpy(&header, file.data, HEADER_SIZE_V1);
+    
+    if (std::memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0) {
+        std::cout << "❌ Not a city file (bad magic): " << filepath << "\n";
+        return false;
+    }
+    if (header.version < MIN_VERSION || header.version > VERSION || header.headerSize < HEADER_SIZE_V1 ||
+        header.headerSize > file.size) {
+        std::cout << "❌ Unsupported city file version " << header.version << ": " << filepath << "\n";
+        return false;
+    }
+    std::memcpy(&header, file.data, std::min<size_t>(header.headerSize, sizeof(Header)));
+    
+    // Records are read in place, so every array must start where alignUp() put it
+    if (!isAligned(header.buildingsOffset) || !isAligned(header.roadsOffset) ||
+        !isAligned(header.pointsOffset) || !isAligned(header.parksOffset)) {
+        std::cout << "❌ Corrupt city file (misaligned array): " << filepath << "\n";
+        return false;
+    }
+    if (!file.contains(header.buildingsOffset, header.buildingCount, sizeof(BuildingRecord)) ||
+        !file.contains(header.roadsOffset, header.roadCount, sizeof(RoadRecord)) ||
+        !file.contains(header.pointsOffset, header.pointCount, sizeof(PointRecord)) ||
+        !file.contains(header.parksOffset, header.parkCount, sizeof(CircleRecord))) {
+        std::cout << "❌ Corrupt city file (array out of bounds): " << filepath << "\n";
+        return false;
+    }
+    
+    const RoadRecord* roads = reinterpret_cast<const RoadRecord*>(file.data + header.roadsOffset);
+    for (uint32_t i = 0; i < header.roadCount; i++) {
+        if (roads[i].firstPoint > header.pointCount ||
+            roads[i].pointCount > header.pointCount - roads[i].firstPoint) {
+            std::cout << "❌ Corrupt city file (road " << i << " out of range): " << filepath << "\n";
+            return false;
+        }
+    }
+    
+    // Arrays are read straight out of the mapping
+    city.clear();
+    
+    const BuildingRecord* buildings = reinterpret_cast<const BuildingRecord*>(file.data + header.buildingsOffset);
+    city.buildings.reserve(header.buildingCount);
+    for (uint32_t i = 0; i < header.buildingCount; i++) {
+        const BuildingRecord& b = buildings[i];
+        BuildingType type = b.type <= static_cast<uint32_t>(BuildingType::HIGH_RISE)
+            ? static_cast<BuildingType>(b.type) : BuildingType::LOW_RISE;
+        city.buildings.emplace_back(b.x, b.y, b.width, b.depth, b.height, type);
+    }
+    
+    static_assert(sizeof(Point) == sizeof(PointRecord), "Point must match its file record");
+    const unsigned char* points = file.data + header.pointsOffset;
+    city.roads.resize(header.roadCount);
+    for (uint32_t i = 0; i < header.roadCount; i++) {
+        Road& road = city.roads[i];
+        road.width = roads[i].width;
+        road.path.resize(roads[i].pointCount);
+        std::memcpy(road.path.data(), points + roads[i].firstPoint * sizeof(PointRecord),
+                    roads[i].pointCount * sizeof(PointRecord));
+    }
+    
+    const CircleRecord* parks = reinterpret_cast<const CircleRecord*>(file.data + header.parksOffset);
+    city.parks.reserve(header.parkCount);
+    for (uint32_t i = 0; i < header.parkCount; i++) {
+        city.parks.emplace_back(parks[i].x, parks[i].y, parks[i].radius);
+    }
+    
+    city.fountain = Circle(header.fountainX, header.fountainY, header.fountainRadius);
+    
+    // Files written before the extent was recorded hold zeros
+    city.extent = header.worldWidth > 0 && header.worldHeight > 0
+        ? WorldExtent(static_cast<int>(header.worldWidth), static_cast<int>(header.worldHeight))
+        : WorldExtent();
+    city.seed = header.seed;
     
+    city.network.build(city.roads);
+    city.rebuildIndex();
     city.isGenerated = true;
     
-    std::cout << "✅ City loaded successfully!\n";
-    std::cout << "   - " << city.buildings.size() << " buildings\n";
-    std::cout << "   - " << city.roads.size() << " roads (";
-    int totalRoadPoints = 0;
-    for (const auto& road : city.roads) {
-        totalRoadPoints += road.points.size();
+    if (verbose) {
+        std::cout << "✅ City loaded successfully!\n";
+        std::cout << "   - " << city.buildings.size() << " buildings\n";
+        std::cout << "   - " << city.roads.size() << " roads (" << header.pointCount << " path vertices)\n";
+        std::cout << "   - " << city.parks.size() << " parks\n";
+        std::cout << "   - fountain radius " << city.fountain.radius << "\n\n";
     }
-    std::cout << totalRoadPoints << " total points)\n";
-    std::cout << "   - " << city.parks.size() << " parks\n";
-    std::cout << "   - " << city.fountain.size() << " fountain points\n\n";
     
     return true;
 }
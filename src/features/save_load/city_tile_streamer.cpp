@@ -0,0 +1,385 @@
+/**
+ * @file city_tile_streamer.cpp
+ * @brief Implementation of Tiled City Streaming
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#include "features/save_load/city_tile_streamer.h"
+#include "features/save_load/city_serializer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <unordered_set>
+
+namespace {
+
+bool isAligned(uint64_t offset) {
+    return offset % CityTileFormat::ALIGNMENT == 0;
+}
+
+}  // namespace
+
+CityTileStreamer::CityTileStreamer(unsigned workerCount)
+    : jobs(workerCount), pendingX(0.0f), pendingY(0.0f), loadRadius(DEFAULT_LOAD_RADIUS),
+      memoryBudget(DEFAULT_MEMORY_BUDGET), sourceGeneration(0), hasPending(false), stopping(false),
+      measuredObjectBytes(0), measuredTileBytes(0), cameraTile(-1) {
+    loader = std::thread(&CityTileStreamer::run, this);
+}
+
+CityTileStreamer::~CityTileStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    loader.join();
+}
+
+bool CityTileStreamer::open(const std::string& filename) {
+    using namespace CityTileFormat;
+    
+    std::string filepath = CitySerializer::tiledSavePath(filename);
+    auto opened = std::make_shared<Source>();
+    opened->file.reset(new MappedFile(filepath));
+    const MappedFile& file = *opened->file;
+    if (!file.data) {
+        std::cout << "❌ Failed to open tiled city: " << filepath << "\n";
+        return false;
+    }
+    
+    // Validate the header and every tile's arrays before the loader may read them
+    Header& header = opened->header;
+    if (file.size < sizeof(Header)) {
+        std::cout << "❌ Not a tiled city file (too small): " << filepath << "\n";
+        return false;
+    }
+    std::memcpy(&header, file.data, sizeof(Header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0) {
+        std::cout << "❌ Not a tiled city file (bad magic): " << filepath << "\n";
+        return false;
+    }
+    if (header.version != VERSION || header.headerSize != sizeof(Header)) {
+        std::cout << "❌ Unsupported tiled city file version " << header.version << ": " << filepath << "\n";
+        return false;
+    }
+    uint64_t tileCount = static_cast<uint64_t>(header.tilesX) * header.tilesY;
+    if (header.tileSize == 0 || tileCount == 0 || tileCount > MAX_TILES ||
+        header.worldWidth == 0 || header.worldHeight == 0 ||
+        header.worldWidth > static_cast<uint32_t>(INT32_MAX) || header.worldHeight > static_cast<uint32_t>(INT32_MAX)) {
+        std::cout << "❌ Corrupt tiled city file (bad tile grid): " << filepath << "\n";
+        return false;
+    }
+    if (!isAligned(header.tilesOffset) || !file.contains(header.tilesOffset, tileCount, sizeof(TileRecord))) {
+        std::cout << "❌ Corrupt tiled city file (tile index out of bounds): " << filepath << "\n";
+        return false;
+    }
+    
+    opened->tiles = reinterpret_cast<const TileRecord*>(file.data + header.tilesOffset);
+    for (uint64_t i = 0; i < tileCount; i++) {
+        const TileRecord& tile = opened->tiles[i];
+        auto fits = [&](uint64_t offset, uint32_t count, uint64_t recordSize) {
+            return count == 0 || (isAligned(offset) && file.contains(offset, count, recordSize));
+        };
+        if (!fits(tile.buildingsOffset, tile.buildingCount, sizeof(CityFileFormat::BuildingRecord)) ||
+            !fits(tile.roadsOffset, tile.roadCount, sizeof(CityFileFormat::RoadRecord)) ||
+            !fits(tile.pointsOffset, tile.pointCount, sizeof(CityFileFormat::PointRecord)) ||
+            !fits(tile.parksOffset, tile.parkCount, sizeof(CityFileFormat::CircleRecord))) {
+            std::cout << "❌ Corrupt tiled city file (tile " << i << " out of bounds): " << filepath << "\n";
+            return false;
+        }
+    }
+    
+    // The loader picks the file up with the first update(); what it still
+    // publishes for the previous file is dropped
+    source = opened;
+    cameraTile = -1;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sourceGeneration++;
+        pendingSource.reset();
+        published = TileUpdate();
+    }
+    std::cout << "📡 Streaming " << filepath << " (" << header.tilesX << "x" << header.tilesY << " tiles of "
+              << header.tileSize << " units)\n";
+    return true;
+}
+
+void CityTileStreamer::close() {
+    source.reset();
+    cameraTile = -1;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sourceGeneration++;
+        pendingSource.reset();
+        hasPending = true;      // Lets the loader drop its tiles
+        published = TileUpdate();
+    }
+    wake.notify_one();
+}
+
+void CityTileStreamer::setMemoryBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    memoryBudget = bytes;
+    cameraTile = -1;            // Re-evaluated with the next update()
+}
+
+void CityTileStreamer::setLoadRadius(float worldUnits) {
+    std::lock_guard<std::mutex> lock(mutex);
+    loadRadius = std::max(worldUnits, 0.0f);
+    cameraTile = -1;
+}
+
+void CityTileStreamer::update(float worldX, float worldY) {
+    if (!source) return;
+    
+    // Only a new camera tile changes the wanted set enough to wake the loader
+    const CityTileFormat::Header& header = source->header;
+    long column = std::lround(std::floor(worldX / header.tileSize));
+    long row = std::lround(std::floor(worldY / header.tileSize));
+    column = std::min<long>(std::max<long>(column, -1), header.tilesX);
+    row = std::min<long>(std::max<long>(row, -1), header.tilesY);
+    int64_t tile = static_cast<int64_t>(column + 1) + static_cast<int64_t>(row + 1) * (header.tilesX + 2);
+    if (tile == cameraTile) return;
+    cameraTile = tile;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingSource = source;
+        pendingX = worldX;
+        pendingY = worldY;
+        hasPending = true;
+    }
+    wake.notify_one();
+}
+
+bool CityTileStreamer::takeTiles(TileUpdate& update) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (published.added.empty() && published.removed.empty()) return false;
+    update = std::move(published);
+    published = TileUpdate();
+    return true;
+}
+
+CityData CityTileStreamer::baseCity() const {
+    CityData city;
+    if (!source) return city;
+    const CityTileFormat::Header& header = source->header;
+    city.extent = getExtent();
+    city.seed = header.seed;
+    city.fountain = Circle(header.fountainX, header.fountainY, header.fountainRadius);
+    city.rebuildIndex();
+    city.isGenerated = true;
+    return city;
+}
+
+WorldExtent CityTileStreamer::getExtent() const {
+    if (!source) return WorldExtent();
+    return WorldExtent(static_cast<int>(source->header.worldWidth), static_cast<int>(source->header.worldHeight));
+}
+
+size_t CityTileStreamer::objectBytes(size_t buildings, size_t roads, size_t points, size_t parks) {
+    return buildings * sizeof(Building) * 2 + roads * sizeof(Road) + points * sizeof(Point) + parks * sizeof(Circle);
+}
+
+size_t CityTileStreamer::tileBytes(const StreamedTile& tile) {
+    const CityData& city = tile.city;
+    size_t points = 0;
+    for (const Road& road : city.roads) {
+        points += road.path.size();
+    }
+    return sizeof(StreamedTile) + objectBytes(city.buildings.size(), city.roads.size(), points, city.parks.size()) +
+           2 * CityRenderer::meshBytes(*tile.meshes);
+}
+
+size_t CityTileStreamer::estimatedBytes(const CityTileFormat::TileRecord& record) const {
+    size_t bytes = objectBytes(record.buildingCount, record.roadCount, record.pointCount, record.parkCount);
+    if (measuredObjectBytes == 0) return bytes;
+    return static_cast<size_t>(bytes * (static_cast<double>(measuredTileBytes) / measuredObjectBytes));
+}
+
+std::vector<uint32_t> CityTileStreamer::tilesNear(const Source& from, float x, float y, float radius) const {
+    const CityTileFormat::Header& header = from.header;
+    float tileSize = static_cast<float>(header.tileSize);
+    
+    auto clampColumn = [&](float value) {
+        return static_cast<int>(std::min(std::max(std::floor(value / tileSize), 0.0f), header.tilesX - 1.0f));
+    };
+    auto clampRow = [&](float value) {
+        return static_cast<int>(std::min(std::max(std::floor(value / tileSize), 0.0f), header.tilesY - 1.0f));
+    };
+    std::vector<std::pair<float, uint32_t>> candidates;
+    for (int row = clampRow(y - radius); row <= clampRow(y + radius); row++) {
+        for (int column = clampColumn(x - radius); column <= clampColumn(x + radius); column++) {
+            float dx = std::max({column * tileSize - x, 0.0f, x - (column + 1) * tileSize});
+            float dy = std::max({row * tileSize - y, 0.0f, y - (row + 1) * tileSize});
+            float distance = std::sqrt(dx * dx + dy * dy);
+            if (distance <= radius) {
+                candidates.push_back({distance, static_cast<uint32_t>(column + row * header.tilesX)});
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    
+    std::vector<uint32_t> tiles;
+    tiles.reserve(candidates.size());
+    for (const auto& candidate : candidates) {
+        tiles.push_back(candidate.second);
+    }
+    return tiles;
+}
+
+size_t CityTileStreamer::tilesWithin(const std::vector<uint32_t>& tiles, size_t budget,
+                                     const std::function<size_t(uint32_t)>& bytesOf) {
+    size_t count = 0;
+    size_t bytes = 0;
+    for (uint32_t index : tiles) {
+        size_t size = bytesOf(index);
+        if (count > 0 && bytes + size > budget) break;
+        bytes += size;
+        count++;
+    }
+    return count;
+}
+
+std::shared_ptr<StreamedTile> CityTileStreamer::loadTile(const Source& from, uint32_t index) {
+    using namespace CityFileFormat;
+    const CityTileFormat::TileRecord& record = from.tiles[index];
+    const unsigned char* data = from.file->data;
+    
+    auto tile = std::make_shared<StreamedTile>();
+    tile->index = index;
+    CityData& city = tile->city;
+    city.extent = WorldExtent(static_cast<int>(from.header.worldWidth), static_cast<int>(from.header.worldHeight));
+    city.seed = from.header.seed;
+    
+    const BuildingRecord* buildings = reinterpret_cast<const BuildingRecord*>(data + record.buildingsOffset);
+    city.buildings.reserve(record.buildingCount);
+    for (uint32_t i = 0; i < record.buildingCount; i++) {
+        const BuildingRecord& b = buildings[i];
+        BuildingType type = b.type <= static_cast<uint32_t>(BuildingType::HIGH_RISE)
+            ? static_cast<BuildingType>(b.type) : BuildingType::LOW_RISE;
+        city.buildings.emplace_back(b.x, b.y, b.width, b.depth, b.height, type);
+    }
+    
+    // Roads pointing outside their tile's points are skipped rather than trusted
+    const RoadRecord* roads = reinterpret_cast<const RoadRecord*>(data + record.roadsOffset);
+    const unsigned char* points = data + record.pointsOffset;
+    city.roads.reserve(record.roadCount);
+    for (uint32_t i = 0; i < record.roadCount; i++) {
+        const RoadRecord& r = roads[i];
+        if (r.firstPoint > record.pointCount || r.pointCount > record.pointCount - r.firstPoint) continue;
+        city.roads.emplace_back();
+        Road& road = city.roads.back();
+        road.width = r.width;
+        road.path.resize(r.pointCount);
+        std::memcpy(road.path.data(), points + r.firstPoint * sizeof(PointRecord), r.pointCount * sizeof(PointRecord));
+    }
+    
+    const CircleRecord* parks = reinterpret_cast<const CircleRecord*>(data + record.parksOffset);
+    city.parks.reserve(record.parkCount);
+    for (uint32_t i = 0; i < record.parkCount; i++) {
+        city.parks.emplace_back(parks[i].x, parks[i].y, parks[i].radius);
+    }
+    
+    // Meshed once here, on this job's thread; the render thread only uploads
+    tile->meshes = CityRenderer::prepareMeshes(city, nullptr);
+    tile->bytes = tileBytes(*tile);
+    return tile;
+}
+
+void CityTileStreamer::run() {
+    for (;;) {
+        std::shared_ptr<const Source> from;
+        float x, y, radius;
+        size_t budget;
+        uint64_t generation;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return hasPending || stopping; });
+            if (stopping) return;
+            from = pendingSource;
+            x = pendingX;
+            y = pendingY;
+            radius = loadRadius;
+            budget = memoryBudget;
+            generation = sourceGeneration;
+            hasPending = false;
+        }
+        
+        // The main thread dropped the previous file's tiles itself
+        if (from != loadedSource) {
+            resident.clear();
+            loadedSource = from;
+        }
+        if (!from) continue;
+        
+        // Nearest first, as many as the budget allows: resident tiles at
+        // their measured size, the others estimated
+        std::vector<uint32_t> wanted = tilesNear(*from, x, y, radius);
+        wanted.resize(tilesWithin(wanted, budget, [&](uint32_t index) {
+            auto it = resident.find(index);
+            return it != resident.end() ? it->second->bytes : estimatedBytes(from->tiles[index]);
+        }));
+        
+        // Read and mesh the missing tiles, one job each
+        std::vector<uint32_t> missing;
+        for (uint32_t index : wanted) {
+            if (!resident.count(index)) missing.push_back(index);
+        }
+        std::vector<std::shared_ptr<StreamedTile>> loaded(missing.size());
+        jobs.parallelFor(missing.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) loaded[i] = loadTile(*from, missing[i]);
+        });
+        std::unordered_map<uint32_t, std::shared_ptr<const StreamedTile>> fresh;
+        for (size_t i = 0; i < missing.size(); i++) {
+            const CityTileFormat::TileRecord& record = from->tiles[missing[i]];
+            measuredObjectBytes += objectBytes(record.buildingCount, record.roadCount, record.pointCount, record.parkCount);
+            measuredTileBytes += loaded[i]->bytes;
+            fresh.emplace(missing[i], std::move(loaded[i]));
+        }
+        
+        // An estimate may have been short: keep only what fits at the measured sizes
+        wanted.resize(tilesWithin(wanted, budget, [&](uint32_t index) {
+            auto it = resident.find(index);
+            return it != resident.end() ? it->second->bytes : fresh.at(index)->bytes;
+        }));
+        std::unordered_set<uint32_t> keep(wanted.begin(), wanted.end());
+        
+        TileUpdate update;
+        for (auto it = resident.begin(); it != resident.end();) {
+            if (keep.count(it->first)) {
+                ++it;
+            } else {
+                update.removed.push_back(it->first);
+                it = resident.erase(it);
+            }
+        }
+        for (uint32_t index : wanted) {
+            auto it = fresh.find(index);
+            if (it == fresh.end()) continue;
+            resident.emplace(index, it->second);
+            update.added.push_back(it->second);
+        }
+        if (update.added.empty() && update.removed.empty()) continue;
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        // open() or close() came in meanwhile: the tiles belong to a file no
+        // longer shown, and the next request clears them
+        if (generation != sourceGeneration) continue;
+        
+        // Tiles loaded and evicted again before the main thread took them cancel out
+        for (uint32_t index : update.removed) {
+            auto added = std::find_if(published.added.begin(), published.added.end(),
+                                      [&](const std::shared_ptr<const StreamedTile>& tile) { return tile->index == index; });
+            if (added != published.added.end()) {
+                published.added.erase(added);
+            } else {
+                published.removed.push_back(index);
+            }
+        }
+        published.added.insert(published.added.end(), update.added.begin(), update.added.end());
+    }
+}
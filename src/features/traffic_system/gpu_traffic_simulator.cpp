@@ -0,0 +1,382 @@
+/**
+ * @file gpu_traffic_simulator.cpp
+ * @brief Implementation of the GPU Traffic Backend
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#include "features/traffic_system/gpu_traffic_simulator.h"
+#include "features/traffic_system/traffic_generator.h"
+#include "rendering/mesh/traffic_mesh.h"
+#include "rendering/shaders/shader_manager.h"
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// One invocation per car: read its state, write it one fixed step later
+const char* STEP_SHADER_SOURCE = R"(
+layout (location = 0) in vec4 aMotion;    // (progress, speed, desired speed, unused)
+layout (location = 1) in ivec4 aRoute;    // (road, edge, node ahead, direction)
+layout (location = 2) in vec4 aPose;      // (x, y, previous x, previous y)
+layout (location = 3) in vec2 aHeading;
+
+out vec4 Motion;
+flat out ivec4 Route;
+out vec4 Pose;
+out vec2 Heading;
+
+uniform samplerBuffer roadPoints;   // (x, y, distance along the road, 0) per path point
+uniform usamplerBuffer roads;       // (first point, point count, length bits, 0) per road
+uniform usamplerBuffer edges;       // (road, start node, end node, 0) per edge
+uniform samplerBuffer edgeRanges;   // (startT, endT) per edge
+uniform usamplerBuffer nodes;       // (first nodeEdges entry, degree) per node
+uniform usamplerBuffer nodeEdges;   // Edge indices grouped by node
+uniform uint stepIndex;             // Step being taken, from 0 after the upload
+uniform uint seed;                  // GpuTrafficSetup::seed
+
+uint hash(uint value) {
+    value ^= value >> 16;
+    value *= 0x7feb352du;
+    value ^= value >> 15;
+    value *= 0x846ca68bu;
+    value ^= value >> 16;
+    return value;
+}
+
+float roadLength(int road) {
+    return max(uintBitsToFloat(texelFetch(roads, road).z), 1.0);
+}
+
+// Position at road parameter t, as Road::sample() finds it
+vec2 sampleRoad(int road, float t) {
+    uvec4 info = texelFetch(roads, road);
+    int first = int(info.x);
+    int count = int(info.y);
+    if (count == 0) return vec2(0.0);
+    float distance = clamp(t, 0.0, 1.0) * uintBitsToFloat(info.z);
+    
+    // Last point at or before that distance
+    int low = 0;
+    int high = count - 1;
+    while (low < high) {
+        int middle = (low + high + 1) / 2;
+        if (texelFetch(roadPoints, first + middle).z <= distance) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+    vec4 a = texelFetch(roadPoints, first + low);
+    if (low + 1 >= count) return a.xy;
+    vec4 b = texelFetch(roadPoints, first + low + 1);
+    float span = b.z - a.z;
+    return span > 0.0 ? mix(a.xy, b.xy, (distance - a.z) / span) : a.xy;
+}
+
+void main() {
+    int road = aRoute.x;
+    int edge = aRoute.y;
+    int node = aRoute.z;
+    float direction = float(aRoute.w);
+    float roadSize = roadLength(road);
+    
+    // Free road: accelerate toward the desired speed
+    float speed = min(aMotion.z, aMotion.y + MAX_ACCELERATION * TIMESTEP);
+    float progress = aMotion.x + direction * speed / roadSize * TIMESTEP;
+    
+    // At the node ahead take a random other edge; a dead end, or a road without edges, turns around
+    vec2 range = edge >= 0 ? texelFetch(edgeRanges, edge).xy : vec2(0.0, 1.0);
+    float edgeEnd = direction > 0.0 ? range.y : range.x;
+    bool turned = (progress - edgeEnd) * direction >= 0.0;
+    if (turned && edge < 0) {
+        progress = edgeEnd;
+        direction = -direction;
+    } else if (turned) {
+        uvec2 slice = texelFetch(nodes, node).xy;
+        int next = edge;
+        if (slice.y > 1u) {
+            uint pick = hash(hash(uint(gl_VertexID) ^ seed) + stepIndex) % (slice.y - 1u);
+            uint seen = 0u;
+            for (uint k = 0u; k < slice.y; k++) {
+                int candidate = int(texelFetch(nodeEdges, int(slice.x + k)).x);
+                if (candidate == edge) continue;
+                if (seen++ == pick) {
+                    next = candidate;
+                    break;
+                }
+            }
+        }
+        uvec4 nextEdge = texelFetch(edges, next);
+        vec2 nextRange = texelFetch(edgeRanges, next).xy;
+        bool forward = next == edge ? direction < 0.0 : int(nextEdge.y) == node;
+        road = int(nextEdge.x);
+        edge = next;
+        node = int(forward ? nextEdge.z : nextEdge.y);
+        direction = forward ? 1.0 : -1.0;
+        progress = forward ? nextRange.x : nextRange.y;
+        roadSize = roadLength(road);
+    }
+    
+    // Heading toward the point one unit further on; kept where the road ends
+    vec2 position = sampleRoad(road, progress);
+    vec2 ahead = sampleRoad(road, progress + direction / roadSize) - position;
+    Heading = dot(ahead, ahead) > 1e-8 ? normalize(ahead) : aHeading;
+    Motion = vec4(progress, speed, aMotion.z, 0.0);
+    Route = ivec4(road, edge, node, int(direction));
+    Pose = vec4(position, turned ? position : aPose.xy);   // No blending across a turn
+}
+)";
+
+// Captured in GpuCarState order
+const char* STEP_OUTPUTS[] = {"Motion", "Route", "Pose", "Heading"};
+
+// Sampler names and texel formats of the tables, in GpuTrafficSimulator table order
+const char* TABLE_NAMES[GpuTrafficSimulator::TABLE_COUNT] = {
+    "roadPoints", "roads", "edges", "edgeRanges", "nodes", "nodeEdges"
+};
+const GLenum TABLE_FORMATS[GpuTrafficSimulator::TABLE_COUNT] = {
+    GL_RGBA32F, GL_RGBA32UI, GL_RGBA32UI, GL_RG32F, GL_RG32UI, GL_R32UI
+};
+const size_t TABLE_TEXEL_BYTES[GpuTrafficSimulator::TABLE_COUNT] = {16, 16, 16, 8, 8, 4};
+
+}  // namespace
+
+GpuTrafficSimulator::GpuTrafficSimulator()
+    : carCount(0), stepsDone(0), program(0), stepLocation(-1), seedLocation(-1), programFailed(false),
+      stateBuffers{0, 0}, stepVAOs{0, 0}, drawVAOs{0, 0}, current(0), colorBuffer(0), meshBuffer(0),
+      tableBuffers{}, tableTextures{} {}
+
+GpuTrafficSimulator::~GpuTrafficSimulator() {
+    release();
+    if (program != 0) glDeleteProgram(program);
+}
+
+void GpuTrafficSimulator::sync(const std::shared_ptr<const GpuTrafficSetup>& setup, uint32_t step) {
+    if (setup != uploaded) {
+        release();
+        uploaded = setup;
+        if (!setup || setup->cars.empty()) return;
+        if (!upload(*setup)) {
+            release();
+            return;
+        }
+    }
+    if (carCount == 0 || step <= stepsDone) return;
+    
+    // A backlog beyond one update's worth is dropped, not caught up on
+    uint32_t steps = std::min<uint32_t>(step - stepsDone, TrafficGenerator::MAX_STEPS_PER_UPDATE);
+    runSteps(steps);
+    stepsDone = step;
+}
+
+bool GpuTrafficSimulator::buildProgram() {
+    if (program != 0) return true;
+    if (programFailed) return false;
+    programFailed = true;   // Cleared on success
+    
+    // The simulation constants come from the CPU backend
+    std::string defines = "#version 330 core\n"
+                          "#define TIMESTEP " + std::to_string(TrafficGenerator::FIXED_TIMESTEP) + "\n"
+                          "#define MAX_ACCELERATION " + std::to_string(TrafficGenerator::MAX_ACCELERATION) + "\n";
+    const char* sources[2] = {defines.c_str(), STEP_SHADER_SOURCE};
+    GLuint shader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(shader, 2, sources, NULL);
+    glCompileShader(shader);
+    
+    int success;
+    char infoLog[512];
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        glGetShaderInfoLog(shader, 512, NULL, infoLog);
+        std::cerr << "ERROR: Traffic step shader compilation failed\n" << infoLog << std::endl;
+        glDeleteShader(shader);
+        return false;
+    }
+    
+    // Vertex stage only: its outputs are captured, nothing is rasterized
+    GLuint linked = glCreateProgram();
+    glAttachShader(linked, shader);
+    glTransformFeedbackVaryings(linked, 4, STEP_OUTPUTS, GL_INTERLEAVED_ATTRIBS);
+    glLinkProgram(linked);
+    glDeleteShader(shader);
+    glGetProgramiv(linked, GL_LINK_STATUS, &success);
+    if (!success) {
+        glGetProgramInfoLog(linked, 512, NULL, infoLog);
+        std::cerr << "ERROR: Traffic step program linking failed\n" << infoLog << std::endl;
+        glDeleteProgram(linked);
+        return false;
+    }
+    
+    glUseProgram(linked);
+    for (int i = 0; i < TABLE_COUNT; i++) {
+        glUniform1i(glGetUniformLocation(linked, TABLE_NAMES[i]), static_cast<GLint>(FIRST_TABLE_UNIT + i));
+    }
+    stepLocation = glGetUniformLocation(linked, "stepIndex");
+    seedLocation = glGetUniformLocation(linked, "seed");
+    program = linked;
+    programFailed = false;
+    return true;
+}
+
+bool GpuTrafficSimulator::upload(const GpuTrafficSetup& setup) {
+    if (!buildProgram()) {
+        std::cout << "❌ GPU traffic unavailable: the step program failed to build\n";
+        return false;
+    }
+    
+    // Each table is one buffer texture; empty ones get a zero texel so every sampler has storage
+    const void* tableData[TABLE_COUNT] = {
+        setup.roadPoints.data(), setup.roads.data(), setup.edges.data(),
+        setup.edgeRanges.data(), setup.nodes.data(), setup.nodeEdges.data()
+    };
+    const size_t tableBytes[TABLE_COUNT] = {
+        setup.roadPoints.size() * sizeof(float), setup.roads.size() * sizeof(uint32_t),
+        setup.edges.size() * sizeof(uint32_t), setup.edgeRanges.size() * sizeof(float),
+        setup.nodes.size() * sizeof(uint32_t), setup.nodeEdges.size() * sizeof(uint32_t)
+    };
+    GLint maxTexels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    for (int i = 0; i < TABLE_COUNT; i++) {
+        if (tableBytes[i] / TABLE_TEXEL_BYTES[i] > static_cast<size_t>(maxTexels)) {
+            std::cout << "❌ GPU traffic unavailable: the " << TABLE_NAMES[i] << " table exceeds "
+                      << maxTexels << " texels\n";
+            return false;
+        }
+    }
+    
+    glGenBuffers(TABLE_COUNT, tableBuffers);
+    glGenTextures(TABLE_COUNT, tableTextures);
+    const uint32_t zeroTexel[4] = {};
+    for (int i = 0; i < TABLE_COUNT; i++) {
+        glBindBuffer(GL_TEXTURE_BUFFER, tableBuffers[i]);
+        if (tableBytes[i] > 0) {
+            glBufferData(GL_TEXTURE_BUFFER, tableBytes[i], tableData[i], GL_STATIC_DRAW);
+        } else {
+            glBufferData(GL_TEXTURE_BUFFER, sizeof(zeroTexel), zeroTexel, GL_STATIC_DRAW);
+        }
+        glBindTexture(GL_TEXTURE_BUFFER, tableTextures[i]);
+        glTexBuffer(GL_TEXTURE_BUFFER, TABLE_FORMATS[i], tableBuffers[i]);
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    
+    // Both state buffers hold every car; step 0 starts in the first
+    carCount = setup.cars.size();
+    size_t stateBytes = carCount * sizeof(GpuCarState);
+    glGenBuffers(2, stateBuffers);
+    glBindBuffer(GL_ARRAY_BUFFER, stateBuffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, stateBytes, setup.cars.data(), GL_DYNAMIC_COPY);
+    glBindBuffer(GL_ARRAY_BUFFER, stateBuffers[1]);
+    glBufferData(GL_ARRAY_BUFFER, stateBytes, nullptr, GL_DYNAMIC_COPY);
+    current = 0;
+    stepsDone = 0;
+    
+    glGenBuffers(1, &colorBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, colorBuffer);
+    glBufferData(GL_ARRAY_BUFFER, setup.colors.size(), setup.colors.data(), GL_STATIC_DRAW);
+    
+    std::vector<float> unitMesh = carUnitMesh();
+    glGenBuffers(1, &meshBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, meshBuffer);
+    glBufferData(GL_ARRAY_BUFFER, unitMesh.size() * sizeof(float), unitMesh.data(), GL_STATIC_DRAW);
+    
+    const GLsizei stride = sizeof(GpuCarState);
+    glGenVertexArrays(2, stepVAOs);
+    glGenVertexArrays(2, drawVAOs);
+    for (int i = 0; i < 2; i++) {
+        // Step input: the whole record, one vertex per car
+        glBindVertexArray(stepVAOs[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, stateBuffers[i]);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(GpuCarState, progress));
+        glEnableVertexAttribArray(0);
+        glVertexAttribIPointer(1, 4, GL_INT, stride, (void*)offsetof(GpuCarState, road));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(GpuCarState, x));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(GpuCarState, headingX));
+        glEnableVertexAttribArray(3);
+        
+        // Car draw: the unit mesh, with the pose, heading and color per instance
+        glBindVertexArray(drawVAOs[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, meshBuffer);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+        glBindBuffer(GL_ARRAY_BUFFER, stateBuffers[i]);
+        glVertexAttribPointer(ShaderManager::CAR_POSE_ATTRIBUTE, 4, GL_FLOAT, GL_FALSE, stride,
+                              (void*)offsetof(GpuCarState, x));
+        glEnableVertexAttribArray(ShaderManager::CAR_POSE_ATTRIBUTE);
+        glVertexAttribDivisor(ShaderManager::CAR_POSE_ATTRIBUTE, 1);
+        glVertexAttribPointer(ShaderManager::CAR_HEADING_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, stride,
+                              (void*)offsetof(GpuCarState, headingX));
+        glEnableVertexAttribArray(ShaderManager::CAR_HEADING_ATTRIBUTE);
+        glVertexAttribDivisor(ShaderManager::CAR_HEADING_ATTRIBUTE, 1);
+        glBindBuffer(GL_ARRAY_BUFFER, colorBuffer);
+        glVertexAttribPointer(ShaderManager::CAR_COLOR_ATTRIBUTE, 4, GL_UNSIGNED_BYTE, GL_TRUE, 4, (void*)0);
+        glEnableVertexAttribArray(ShaderManager::CAR_COLOR_ATTRIBUTE);
+        glVertexAttribDivisor(ShaderManager::CAR_COLOR_ATTRIBUTE, 1);
+    }
+    glBindVertexArray(0);
+    
+    std::cout << "🚗 GPU traffic: " << carCount << " cars uploaded ("
+              << (stateBytes * 2 + setup.colors.size()) / 1024 << " KB of car state)\n";
+    return true;
+}
+
+void GpuTrafficSimulator::runSteps(uint32_t steps) {
+    glUseProgram(program);
+    glUniform1ui(seedLocation, uploaded->seed);
+    for (int i = 0; i < TABLE_COUNT; i++) {
+        glActiveTexture(GL_TEXTURE0 + FIRST_TABLE_UNIT + i);
+        glBindTexture(GL_TEXTURE_BUFFER, tableTextures[i]);
+    }
+    glActiveTexture(GL_TEXTURE0);  // ShaderManager expects unit 0 active
+    
+    glEnable(GL_RASTERIZER_DISCARD);
+    for (uint32_t i = 0; i < steps; i++) {
+        glUniform1ui(stepLocation, stepsDone + i);
+        glBindVertexArray(stepVAOs[current]);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, stateBuffers[1 - current]);
+        glBeginTransformFeedback(GL_POINTS);
+        glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(carCount));
+        glEndTransformFeedback();
+        current = 1 - current;
+    }
+    glDisable(GL_RASTERIZER_DISCARD);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glBindVertexArray(0);
+}
+
+void GpuTrafficSimulator::release() {
+    if (stateBuffers[0] != 0) {
+        glDeleteBuffers(2, stateBuffers);
+        glDeleteVertexArrays(2, stepVAOs);
+        glDeleteVertexArrays(2, drawVAOs);
+        glDeleteBuffers(1, &colorBuffer);
+        glDeleteBuffers(1, &meshBuffer);
+    }
+    if (tableBuffers[0] != 0) {
+        glDeleteTextures(TABLE_COUNT, tableTextures);
+        glDeleteBuffers(TABLE_COUNT, tableBuffers);
+    }
+    for (int i = 0; i < 2; i++) {
+        stateBuffers[i] = 0;
+        stepVAOs[i] = 0;
+        drawVAOs[i] = 0;
+    }
+    for (int i = 0; i < TABLE_COUNT; i++) {
+        tableBuffers[i] = 0;
+        tableTextures[i] = 0;
+    }
+    colorBuffer = 0;
+    meshBuffer = 0;
+    carCount = 0;
+    stepsDone = 0;
+    current = 0;
+}
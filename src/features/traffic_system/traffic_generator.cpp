@@ -7,36 +7,221 @@
  */
 
 #include "features/traffic_system/traffic_generator.h"
+#include "features/traffic_system/gpu_traffic_setup.h"
+#include "features/traffic_system/traffic_recorder.h"
+#include "utils/job_system.h"
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 
-TrafficGenerator::TrafficGenerator() : rng(std::random_device{}()), dist01(0.0f, 1.0f), screenWidth(800), screenHeight(600) {}
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TRAFFIC_SIMD_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define TRAFFIC_SIMD_NEON 1
+#endif
 
-bool TrafficGenerator::isInsideCircle(float x, float y, const std::vector<Point>& circlePoints) {
-    if (circlePoints.empty()) return false;
-    
-    // Find the center and radius of the circle
-    float minX = circlePoints[0].x, maxX = circlePoints[0].x;
-    float minY = circlePoints[0].y, maxY = circlePoints[0].y;
-    
-    for (const Point& p : circlePoints) {
-        if (p.x < minX) minX = p.x;
-        if (p.x > maxX) maxX = p.x;
-        if (p.y < minY) minY = p.y;
-        if (p.y > maxY) maxY = p.y;
+void TrafficData::clear() {
+    x.clear();
+    y.clear();
+    prevX.clear();
+    prevY.clear();
+    vx.clear();
+    vy.clear();
+    headingX.clear();
+    headingY.clear();
+    speed.clear();
+    desiredSpeed.clear();
+    direction.clear();
+    progress.clear();
+    progressRate.clear();
+    roadIndex.clear();
+    edgeIndex.clear();
+    edgeEnd.clear();
+    nodeAhead.clear();
+    waitTime.clear();
+    color.clear();
+}
+
+void TrafficData::reserve(size_t count) {
+    x.reserve(count);
+    y.reserve(count);
+    prevX.reserve(count);
+    prevY.reserve(count);
+    vx.reserve(count);
+    vy.reserve(count);
+    headingX.reserve(count);
+    headingY.reserve(count);
+    speed.reserve(count);
+    desiredSpeed.reserve(count);
+    direction.reserve(count);
+    progress.reserve(count);
+    progressRate.reserve(count);
+    roadIndex.reserve(count);
+    edgeIndex.reserve(count);
+    edgeEnd.reserve(count);
+    nodeAhead.reserve(count);
+    waitTime.reserve(count);
+    color.reserve(count);
+}
+
+void TrafficData::copyDrawState(const TrafficData& source) {
+    x.assign(source.x.begin(), source.x.end());
+    y.assign(source.y.begin(), source.y.end());
+    prevX.assign(source.prevX.begin(), source.prevX.end());
+    prevY.assign(source.prevY.begin(), source.prevY.end());
+    headingX.assign(source.headingX.begin(), source.headingX.end());
+    headingY.assign(source.headingY.begin(), source.headingY.end());
+    color.assign(source.color.begin(), source.color.end());
+}
+
+void TrafficData::addCar(const Car& car, float rate) {
+    x.push_back(car.x);
+    y.push_back(car.y);
+    prevX.push_back(car.x);
+    prevY.push_back(car.y);
+    vx.push_back(car.vx);
+    vy.push_back(car.vy);
+    float length = std::sqrt(car.vx * car.vx + car.vy * car.vy);
+    headingX.push_back(length > 0.0f ? car.vx / length : 0.0f);
+    headingY.push_back(length > 0.0f ? car.vy / length : 0.0f);
+    speed.push_back(car.speed);
+    desiredSpeed.push_back(car.speed);
+    direction.push_back(car.direction);
+    progress.push_back(car.roadProgress);
+    progressRate.push_back(rate);
+    roadIndex.push_back(car.roadIndex);
+    edgeIndex.push_back(car.edgeIndex);
+    edgeEnd.push_back(car.edgeEnd);
+    nodeAhead.push_back(car.nodeAhead);
+    waitTime.push_back(0.0f);
+    color.push_back(car.color);
+}
+
+Car TrafficData::getCar(size_t index) const {
+    Car car;
+    car.x = x[index];
+    car.y = y[index];
+    car.vx = vx[index];
+    car.vy = vy[index];
+    car.speed = speed[index];
+    car.direction = direction[index];
+    car.roadIndex = roadIndex[index];
+    car.roadProgress = progress[index];
+    car.edgeIndex = edgeIndex[index];
+    car.edgeEnd = edgeEnd[index];
+    car.nodeAhead = nodeAhead[index];
+    car.color = color[index];
+    return car;
+}
+
+// Advance count cars by deltaTime: position = previous + velocity * dt, progress += rate * dt.
+// Four cars per iteration with SSE2/NEON, scalar for the remainder.
+static void integrateCars(float* x, float* y, const float* prevX, const float* prevY,
+                          const float* vx, const float* vy,
+                          float* progress, const float* rate, size_t count, float deltaTime) {
+    size_t i = 0;
+#if defined(TRAFFIC_SIMD_SSE2)
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(prevX + i), _mm_mul_ps(_mm_loadu_ps(vx + i), dt)));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(prevY + i), _mm_mul_ps(_mm_loadu_ps(vy + i), dt)));
+        _mm_storeu_ps(progress + i, _mm_add_ps(_mm_loadu_ps(progress + i),
+                                               _mm_mul_ps(_mm_loadu_ps(rate + i), dt)));
     }
+#elif defined(TRAFFIC_SIMD_NEON)
+    const float32x4_t dt = vdupq_n_f32(deltaTime);
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(x + i, vmlaq_f32(vld1q_f32(prevX + i), vld1q_f32(vx + i), dt));
+        vst1q_f32(y + i, vmlaq_f32(vld1q_f32(prevY + i), vld1q_f32(vy + i), dt));
+        vst1q_f32(progress + i, vmlaq_f32(vld1q_f32(progress + i), vld1q_f32(rate + i), dt));
+    }
+#endif
+    for (; i < count; i++) {
+        x[i] = prevX[i] + vx[i] * deltaTime;
+        y[i] = prevY[i] + vy[i] * deltaTime;
+        progress[i] += rate[i] * deltaTime;
+    }
+}
+
+TrafficGenerator::TrafficGenerator()
+    : rng(0, RandomStreamId::TRAFFIC),
+      timeAccumulator(0.0f), stepCount(0), maxStepsPerUpdate(MAX_STEPS_PER_UPDATE),
+      jobSystem(nullptr), recorder(nullptr),
+      backend(TrafficBackend::CPU) {}
+
+bool TrafficGenerator::isInsideObstacle(float x, float y) const {
+    for (const auto& park : parkAreas) {
+        if (park.contains(x, y)) return true;
+    }
+    return fountainArea.isValid() && fountainArea.contains(x, y);
+}
+
+void TrafficGenerator::buildRoadTables(const std::vector<Road>& roads) {
+    roadLengths.clear();
+    blockedOffsets.clear();
+    blockedIntervals.clear();
+    roadLengths.reserve(roads.size());
+    blockedOffsets.reserve(roads.size() + 1);
     
-    float centerX = (minX + maxX) / 2.0f;
-    float centerY = (minY + maxY) / 2.0f;
-    float radius = (maxX - minX) / 2.0f;
-    
-    // Check if point is inside circle
-    float dx = x - centerX;
-    float dy = y - centerY;
-    float distSquared = dx * dx + dy * dy;
-    float radiusSquared = radius * radius;
+    std::vector<Circle> obstacles = parkAreas;
+    if (fountainArea.isValid()) obstacles.push_back(fountainArea);
     
-    return distSquared <= radiusSquared;
+    std::vector<std::pair<float, float>> intervals;
+    for (const Road& road : roads) {
+        float total = road.length();
+        roadLengths.push_back(total);
+        blockedOffsets.push_back(static_cast<uint32_t>(blockedIntervals.size() / 2));
+        if (total <= 0.0f) continue;
+        
+        // Clip each polyline segment against each obstacle, in road progress units
+        intervals.clear();
+        float travelled = 0.0f;
+        for (size_t i = 0; i + 1 < road.path.size(); i++) {
+            float x0 = static_cast<float>(road.path[i].x);
+            float y0 = static_cast<float>(road.path[i].y);
+            float x1 = static_cast<float>(road.path[i + 1].x);
+            float y1 = static_cast<float>(road.path[i + 1].y);
+            float segmentLength = std::sqrt((x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0));
+            
+            for (const Circle& obstacle : obstacles) {
+                float sEnter, sExit;
+                if (obstacle.clipSegment(x0, y0, x1, y1, sEnter, sExit)) {
+                    intervals.emplace_back((travelled + sEnter * segmentLength) / total,
+                                           (travelled + sExit * segmentLength) / total);
+                }
+            }
+            travelled += segmentLength;
+        }
+        
+        // Merge overlaps so each road's list is sorted and disjoint
+        std::sort(intervals.begin(), intervals.end());
+        for (size_t i = 0; i < intervals.size(); i++) {
+            size_t count = blockedIntervals.size();
+            size_t first = blockedOffsets.back() * 2;
+            if (count > first && intervals[i].first <= blockedIntervals[count - 1]) {
+                blockedIntervals[count - 1] = std::max(blockedIntervals[count - 1], intervals[i].second);
+            } else {
+                blockedIntervals.push_back(intervals[i].first);
+                blockedIntervals.push_back(intervals[i].second);
+            }
+        }
+    }
+    blockedOffsets.push_back(static_cast<uint32_t>(blockedIntervals.size() / 2));
+}
+
+bool TrafficGenerator::isProgressBlocked(int roadIndex, float progress) const {
+    for (uint32_t i = blockedOffsets[roadIndex]; i < blockedOffsets[roadIndex + 1]; i++) {
+        if (progress < blockedIntervals[i * 2]) return false;  // Sorted: nothing further can match
+        if (progress <= blockedIntervals[i * 2 + 1]) return true;
+    }
+    return false;
+}
+
+float TrafficGenerator::progressRateFor(int roadIndex, float speed) const {
+    return speed / std::max(roadLengths[roadIndex], 1.0f);
 }
 
 glm::vec3 TrafficGenerator::getRandomCarColor() {
@@ -52,35 +237,48 @@ glm::vec3 TrafficGenerator::getRandomCarColor() {
         glm::vec3(1.0f, 1.0f, 1.0f),   // White
     };
     
-    int index = static_cast<int>(dist01(rng) * carColors.size());
+    int index = static_cast<int>(rng.nextFloat() * carColors.size());
     if (index >= carColors.size()) index = carColors.size() - 1;
     return carColors[index];
 }
 
-void TrafficGenerator::generateTraffic(const std::vector<Road>& roads, int numCars,
-                                      const std::vector<std::vector<Point>>& parks,
-                                      const std::vector<Point>& fountain,
-                                      int screenWidth, int screenHeight) {
-    trafficData.cars.clear();
+void TrafficGenerator::generateTraffic(const std::vector<Road>& roads, const RoadNetwork& network, int numCars,
+                                      const std::vector<Circle>& parks,
+                                      const Circle& fountain,
+                                      const WorldExtent& extent,
+                                      uint64_t seed) {
+    trafficData.clear();
+    lanes.clear();
+    gpuSetup.reset();
+    nodeBusyUntil.assign(network.nodes.size(), 0);
+    rng = RandomStream(seed, RandomStreamId::TRAFFIC);
+    timeAccumulator = 0.0f;
+    stepCount = 0;
     parkAreas = parks;
     fountainArea = fountain;
     
-    // Store screen dimensions for boundary checking
-    this->screenWidth = screenWidth;
-    this->screenHeight = screenHeight;
+    // Store the city bounds for boundary checking
+    this->extent = extent;
+    
+    buildRoadTables(roads);
     
     if (roads.empty() || numCars <= 0) {
         return;
     }
     
+    trafficData.reserve(numCars);
+    
+    // Road positions (pixels) taken in each lane so far, sorted
+    std::vector<std::vector<float>> occupied(roads.size() * 2);
+    
     std::cout << "\n🚗 Generating " << numCars << " cars on roads...\n";
     
-    // Screen boundaries with margin
+    // City boundaries with margin
     const float margin = 50.0f;
     const float minX = margin;
-    const float maxX = screenWidth - margin;
+    const float maxX = extent.width - margin;
     const float minY = margin;
-    const float maxY = screenHeight - margin;
+    const float maxY = extent.height - margin;
     
     int attemptedCars = 0;
     for (int i = 0; i < numCars && attemptedCars < numCars * 3; i++) {
@@ -88,22 +286,18 @@ void TrafficGenerator::generateTraffic(const std::vector<Road>& roads, int numCa
         Car car;
         
         // Pick a random road
-        car.roadIndex = static_cast<int>(dist01(rng) * roads.size());
+        car.roadIndex = static_cast<int>(rng.nextFloat() * roads.size());
         if (car.roadIndex >= roads.size()) car.roadIndex = roads.size() - 1;
         
         const Road& road = roads[car.roadIndex];
         
         // Random position along the road
-        car.roadProgress = dist01(rng);
+        car.roadProgress = rng.nextFloat();
         
-        if (!road.points.empty()) {
+        if (!road.path.empty()) {
             // Place car on road
-            int pointIndex = static_cast<int>(car.roadProgress * (road.points.size() - 1));
-            if (pointIndex >= road.points.size()) pointIndex = road.points.size() - 1;
-            
-            const Point& pt = road.points[pointIndex];
-            car.x = pt.x;
-            car.y = pt.y;
+            float dirX, dirY;
+            road.sample(car.roadProgress, car.x, car.y, dirX, dirY);
             
             // Check if car is within screen boundaries
             if (car.x < minX || car.x > maxX || car.y < minY || car.y > maxY) {
@@ -111,44 +305,17 @@ void TrafficGenerator::generateTraffic(const std::vector<Road>& roads, int numCa
                 continue;
             }
             
-            // Check if car position is inside any park or fountain
-            bool insideObstacle = false;
-            
-            // Check parks
-            for (const auto& park : parkAreas) {
-                if (isInsideCircle(car.x, car.y, park)) {
-                    insideObstacle = true;
-                    break;
-                }
-            }
-            
-            // Check fountain
-            if (!insideObstacle && isInsideCircle(car.x, car.y, fountainArea)) {
-                insideObstacle = true;
-            }
-            
-            // Skip this car if it's inside an obstacle
-            if (insideObstacle) {
+            // Skip this car if it's inside a park or the fountain
+            if (isInsideObstacle(car.x, car.y)) {
                 i--;  // Try again with a different position
                 continue;
             }
             
             // Calculate velocity direction from road direction
-            if (pointIndex < road.points.size() - 1) {
-                const Point& nextPt = road.points[pointIndex + 1];
-                float dx = nextPt.x - pt.x;
-                float dy = nextPt.y - pt.y;
-                float length = std::sqrt(dx * dx + dy * dy);
-                
-                if (length > 0.0f) {
-                    car.speed = 20.0f + dist01(rng) * 30.0f;  // Random speed 20-50 pixels/sec
-                    car.vx = (dx / length) * car.speed;
-                    car.vy = (dy / length) * car.speed;
-                } else {
-                    car.vx = 0.0f;
-                    car.vy = 0.0f;
-                    car.speed = 0.0f;
-                }
+            if (dirX != 0.0f || dirY != 0.0f) {
+                car.speed = 20.0f + rng.nextFloat() * 30.0f;  // Random speed 20-50 pixels/sec
+                car.vx = dirX * car.speed;
+                car.vy = dirY * car.speed;
             } else {
                 car.vx = 0.0f;
                 car.vy = 0.0f;
@@ -162,123 +329,355 @@ void TrafficGenerator::generateTraffic(const std::vector<Road>& roads, int numCa
             car.speed = 0.0f;
         }
         
+        // Random direction of travel; the car's edge ends at the node it is heading for
+        float direction = rng.nextFloat() < 0.5f ? -1.0f : 1.0f;
+        car.direction = direction;
+        
+        // Skip this car if it would overlap one already placed in the same lane
+        std::vector<float>& lane = occupied[TrafficLanes::laneOf(car.roadIndex, direction)];
+        float along = car.roadProgress * roadLengths[car.roadIndex];
+        auto slot = std::lower_bound(lane.begin(), lane.end(), along);
+        if ((slot != lane.end() && *slot - along < CAR_LENGTH + MIN_GAP) ||
+            (slot != lane.begin() && along - *(slot - 1) < CAR_LENGTH + MIN_GAP)) {
+            i--;  // Try again with a different position
+            continue;
+        }
+        lane.insert(slot, along);
+        
+        car.vx *= direction;
+        car.vy *= direction;
+        car.edgeIndex = network.findEdge(car.roadIndex, car.roadProgress);
+        if (car.edgeIndex >= 0) {
+            const RoadEdge& edge = network.edges[car.edgeIndex];
+            car.edgeEnd = direction > 0.0f ? edge.endT : edge.startT;
+            car.nodeAhead = static_cast<int>(direction > 0.0f ? edge.endNode : edge.startNode);
+        } else {
+            car.edgeEnd = direction > 0.0f ? 1.0f : 0.0f;
+            car.nodeAhead = -1;
+        }
+        
         car.color = getRandomCarColor();
-        trafficData.cars.push_back(car);
+        trafficData.addCar(car, direction * progressRateFor(car.roadIndex, car.speed));
     }
     
-    std::cout << "   ✓ Spawned " << trafficData.cars.size() << " cars\n";
+    std::cout << "   ✓ Spawned " << trafficData.size() << " cars\n";
+    
+    if (backend == TrafficBackend::GPU) {
+        buildGpuSetup(roads, network, seed);
+    }
 }
 
-void TrafficGenerator::updateTraffic(float deltaTime, const std::vector<Road>& roads) {
-    if (roads.empty()) return;
+void TrafficGenerator::buildGpuSetup(const std::vector<Road>& roads, const RoadNetwork& network, uint64_t seed) {
+    auto setup = std::make_shared<GpuTrafficSetup>();
+    const TrafficData& cars = trafficData;
     
-    for (Car& car : trafficData.cars) {
-        // Calculate new position
-        float newX = car.x + car.vx * deltaTime;
-        float newY = car.y + car.vy * deltaTime;
-        
-        // Check if new position would collide with parks or fountain
-        bool wouldCollide = false;
+    // The spawned cars, as the step shader reads them
+    setup->cars.resize(cars.size());
+    setup->colors.resize(cars.size() * 4);
+    for (size_t i = 0; i < cars.size(); i++) {
+        GpuCarState& car = setup->cars[i];
+        car.progress = cars.progress[i];
+        car.speed = cars.speed[i];
+        car.desiredSpeed = cars.desiredSpeed[i];
+        car.reserved = 0.0f;
+        car.road = cars.roadIndex[i];
+        car.edge = cars.edgeIndex[i];
+        car.nodeAhead = cars.nodeAhead[i];
+        car.direction = cars.direction[i] < 0.0f ? -1 : 1;
+        car.x = car.prevX = cars.x[i];
+        car.y = car.prevY = cars.y[i];
+        car.headingX = cars.headingX[i];
+        car.headingY = cars.headingY[i];
         
-        for (const auto& park : parkAreas) {
-            if (isInsideCircle(newX, newY, park)) {
-                wouldCollide = true;
-                break;
+        const glm::vec3& color = cars.color[i];
+        for (int c = 0; c < 3; c++) {
+            setup->colors[i * 4 + c] = static_cast<uint8_t>(std::min(std::max(color[c], 0.0f), 1.0f) * 255.0f + 0.5f);
+        }
+        setup->colors[i * 4 + 3] = 255;
+    }
+    
+    // Road polylines with the distance along the road at each point (Road::sample() walks the same sums)
+    setup->roads.reserve(roads.size() * 4);
+    for (const Road& road : roads) {
+        uint32_t first = static_cast<uint32_t>(setup->roadPoints.size() / 4);
+        float distance = 0.0f;
+        for (size_t i = 0; i < road.path.size(); i++) {
+            if (i > 0) {
+                float dx = static_cast<float>(road.path[i].x - road.path[i - 1].x);
+                float dy = static_cast<float>(road.path[i].y - road.path[i - 1].y);
+                distance += std::sqrt(dx * dx + dy * dy);
             }
+            setup->roadPoints.insert(setup->roadPoints.end(),
+                                     {static_cast<float>(road.path[i].x), static_cast<float>(road.path[i].y), distance, 0.0f});
         }
-        
-        if (!wouldCollide && isInsideCircle(newX, newY, fountainArea)) {
-            wouldCollide = true;
+        uint32_t lengthBits;
+        std::memcpy(&lengthBits, &distance, sizeof(lengthBits));
+        setup->roads.insert(setup->roads.end(), {first, static_cast<uint32_t>(road.path.size()), lengthBits, 0u});
+    }
+    
+    // The network: edges, and each node's slice of nodeEdges
+    setup->edges.reserve(network.edges.size() * 4);
+    setup->edgeRanges.reserve(network.edges.size() * 2);
+    for (const RoadEdge& edge : network.edges) {
+        setup->edges.insert(setup->edges.end(), {edge.road, edge.startNode, edge.endNode, 0u});
+        setup->edgeRanges.insert(setup->edgeRanges.end(), {edge.startT, edge.endT});
+    }
+    setup->nodes.reserve(network.nodes.size() * 2);
+    for (uint32_t node = 0; node < network.nodes.size(); node++) {
+        setup->nodes.insert(setup->nodes.end(), {network.nodeEdgeOffsets[node], network.degree(node)});
+    }
+    setup->nodeEdges = network.nodeEdges;
+    setup->seed = static_cast<uint32_t>(seed ^ (seed >> 32));
+    
+    // From here on the cars only exist on the GPU
+    std::cout << "   ✓ Handed " << cars.size() << " cars to the GPU traffic backend\n";
+    trafficData.clear();
+    lanes.clear();
+    gpuSetup = std::move(setup);
+}
+
+void TrafficGenerator::updateTraffic(float deltaTime, const std::vector<Road>& roads, const RoadNetwork& network) {
+    if (roads.empty() || !hasTraffic()) return;
+    
+    // Roads were replaced since the tables were built
+    if (blockedOffsets.size() != roads.size() + 1) {
+        buildRoadTables(roads);
+    }
+    
+    timeAccumulator += deltaTime;
+    int steps = 0;
+    while (timeAccumulator >= FIXED_TIMESTEP && steps < maxStepsPerUpdate) {
+        if (gpuSetup) {
+            stepCount++;  // GpuTrafficSimulator takes the step on the render thread
+        } else {
+            stepTraffic(roads, network);
+        }
+        timeAccumulator -= FIXED_TIMESTEP;
+        steps++;
+    }
+    
+    // After a long hitch, drop the backlog instead of trying to catch up next frame
+    if (timeAccumulator >= FIXED_TIMESTEP) {
+        timeAccumulator = std::fmod(timeAccumulator, FIXED_TIMESTEP);
+    }
+}
+
+void TrafficGenerator::stepTraffic(const std::vector<Road>& roads, const RoadNetwork& network) {
+    TrafficData& cars = trafficData;
+    size_t carCount = cars.size();
+    
+    // Leaders and node claims as they stand before anyone moves
+    lanes.update(cars, roads.size());
+    if (nodeBusyUntil.size() != network.nodes.size()) {
+        nodeBusyUntil.assign(network.nodes.size(), 0);
+    }
+    nextSpeed.resize(carCount);
+    
+    const size_t minCarsPerChunk = 4096;
+    if (jobSystem) {
+        jobSystem->parallelFor(carCount, minCarsPerChunk, [&](size_t begin, size_t end) {
+            planSpeeds(begin, end, roads);
+        });
+    } else {
+        planSpeeds(0, carCount, roads);
+    }
+    
+    // Double buffer: last step's positions become the interpolation start
+    std::swap(cars.x, cars.prevX);
+    std::swap(cars.y, cars.prevY);
+    
+    if (jobSystem) {
+        jobSystem->parallelFor(carCount, minCarsPerChunk, [&](size_t begin, size_t end) {
+            stepCars(begin, end, roads);
+        });
+    } else {
+        stepCars(0, carCount, roads);
+    }
+    
+    // Turns draw from the shared RNG and claim nodes, so they run serially in car order
+    for (size_t i = 0; i < carCount; i++) {
+        if ((cars.progress[i] - cars.edgeEnd[i]) * cars.direction[i] >= 0.0f) {
+            if (enterNextEdge(i, roads, network)) {
+                cars.prevX[i] = cars.x[i];
+                cars.prevY[i] = cars.y[i];
+            } else {
+                holdAtNode(i, roads);
+            }
+        }
+    }
+    stepCount++;
+    
+    if (recorder && recorder->isRecording()) {
+        recorder->recordTick(cars);
+    }
+}
+
+void TrafficGenerator::planSpeeds(size_t begin, size_t end, const std::vector<Road>& roads) {
+    TrafficData& cars = trafficData;
+    const float brakingScale = 2.0f * std::sqrt(MAX_ACCELERATION * COMFORT_BRAKING);
+    
+    for (size_t i = begin; i < end; i++) {
+        int road = cars.roadIndex[i];
+        if (road >= static_cast<int>(roads.size())) {
+            road = cars.roadIndex[i] = static_cast<int>(roads.size()) - 1;
         }
+        float length = std::max(roadLengths[road], 1.0f);
+        float speed = cars.speed[i];
+        float direction = cars.direction[i];
         
-        // Only update position if no collision
-        if (!wouldCollide) {
-            car.x = newX;
-            car.y = newY;
-        } else {
-            // Skip ahead on the road to get past the obstacle
-            car.roadProgress += 0.1f;  // Jump forward
+        // Nearest thing to stop for: the leader's rear bumper (infinitely far for the front car of
+        // a lane), or the rear of the car crossing the node ahead
+        int leader = lanes.leaderOf(i);
+        float gap = lanes.leaderGapOf(i) * length - CAR_LENGTH;
+        float closing = leader >= 0 ? speed - cars.speed[leader] : 0.0f;
+        int node = cars.nodeAhead[i];
+        if (node >= 0 && node < static_cast<int>(nodeBusyUntil.size()) && nodeBusyUntil[node] > stepCount) {
+            float toNode = (cars.edgeEnd[i] - cars.progress[i]) * direction * length - CAR_LENGTH;
+            if (toNode < gap) {
+                gap = toNode;
+                closing = speed;
+            }
         }
         
-        car.roadProgress += (car.speed / 500.0f) * deltaTime;  // Normalized progress
+        // Intelligent Driver Model: free-road acceleration minus the interaction term
+        float ratio = speed / std::max(cars.desiredSpeed[i], 1.0f);
+        float wanted = MIN_GAP + std::max(0.0f, speed * TIME_HEADWAY + speed * closing / brakingScale);
+        float pressure = wanted / std::max(gap, 0.1f);
+        float accel = 1.0f - (ratio * ratio) * (ratio * ratio) - pressure * pressure;
+        accel = std::max(accel * MAX_ACCELERATION, -MAX_BRAKING);
         
-        // If car reaches end of road, wrap to beginning
-        if (car.roadProgress >= 1.0f) {
-            car.roadProgress = 0.0f;
-            
-            // Optionally switch to a random connected road or same road
-            if (dist01(rng) < 0.2f) {  // 20% chance to switch roads
-                car.roadIndex = static_cast<int>(dist01(rng) * roads.size());
-                if (car.roadIndex >= roads.size()) car.roadIndex = roads.size() - 1;
+        // Never close more than the gap in one step
+        float next = std::max(0.0f, speed + accel * FIXED_TIMESTEP);
+        next = std::min(next, std::max(gap, 0.0f) / FIXED_TIMESTEP);
+        nextSpeed[i] = next;
+    }
+}
+
+void TrafficGenerator::stepCars(size_t begin, size_t end, const std::vector<Road>& roads) {
+    TrafficData& cars = trafficData;
+    
+    // Take the planned speeds
+    for (size_t i = begin; i < end; i++) {
+        float speed = nextSpeed[i];
+        cars.speed[i] = speed;
+        cars.vx[i] = cars.headingX[i] * speed;
+        cars.vy[i] = cars.headingY[i] * speed;
+        cars.progressRate[i] = cars.direction[i] * progressRateFor(cars.roadIndex[i], speed);
+    }
+    
+    // Advance the whole range at once; the loop below only fixes up the few exceptions
+    integrateCars(cars.x.data() + begin, cars.y.data() + begin,
+                  cars.prevX.data() + begin, cars.prevY.data() + begin,
+                  cars.vx.data() + begin, cars.vy.data() + begin,
+                  cars.progress.data() + begin, cars.progressRate.data() + begin,
+                  end - begin, FIXED_TIMESTEP);
+    
+    if (blockedIntervals.empty()) return;
+    for (size_t i = begin; i < end; i++) {
+        int road = cars.roadIndex[i];
+        
+        // Skip ahead on the road to get past a park or the fountain
+        if (isProgressBlocked(road, cars.progress[i])) {
+            cars.progress[i] += cars.direction[i] * 0.1f;  // Jump forward
+            if (cars.progress[i] > 0.0f && cars.progress[i] < 1.0f) {
+                float dirX, dirY;
+                roads[road].sample(cars.progress[i], cars.x[i], cars.y[i], dirX, dirY);
+                cars.prevX[i] = cars.x[i];  // Don't interpolate across the jump
+                cars.prevY[i] = cars.y[i];
             }
-            
-            // Reset position to start of road with boundary checking
-            const Road& road = roads[car.roadIndex];
-            if (!road.points.empty()) {
-                // Try to find a valid starting point within boundaries
-                // Screen boundaries with margin
-                const float margin = 50.0f;
-                const float minX = margin;
-                const float maxX = static_cast<float>(screenWidth) - margin;
-                const float minY = margin;
-                const float maxY = static_cast<float>(screenHeight) - margin;
-                
-                bool foundValidPosition = false;
-                
-                // Try multiple points along the road to find one within bounds
-                for (int attempt = 0; attempt < 5; attempt++) {
-                    float testProgress = (float)attempt / 5.0f;
-                    int pointIndex = static_cast<int>(testProgress * (road.points.size() - 1));
-                    if (pointIndex >= road.points.size()) pointIndex = road.points.size() - 1;
-                    
-                    const Point& pt = road.points[pointIndex];
-                    
-                    // Check if this point is within boundaries
-                    if (pt.x >= minX && pt.x <= maxX && pt.y >= minY && pt.y <= maxY) {
-                        // Also check it's not in a park or fountain
-                        bool insideObstacle = false;
-                        
-                        for (const auto& park : parkAreas) {
-                            if (isInsideCircle(pt.x, pt.y, park)) {
-                                insideObstacle = true;
-                                break;
-                            }
-                        }
-                        
-                        if (!insideObstacle && isInsideCircle(pt.x, pt.y, fountainArea)) {
-                            insideObstacle = true;
-                        }
-                        
-                        if (!insideObstacle) {
-                            // Valid position found!
-                            car.x = pt.x;
-                            car.y = pt.y;
-                            car.roadProgress = testProgress;
-                            foundValidPosition = true;
-                            
-                            // Recalculate velocity
-                            if (pointIndex < road.points.size() - 1) {
-                                const Point& nextPt = road.points[pointIndex + 1];
-                                float dx = nextPt.x - pt.x;
-                                float dy = nextPt.y - pt.y;
-                                float length = std::sqrt(dx * dx + dy * dy);
-                                
-                                if (length > 0.0f) {
-                                    car.vx = (dx / length) * car.speed;
-                                    car.vy = (dy / length) * car.speed;
-                                }
-                            }
-                            break;
-                        }
-                    }
-                }
-                
-                // If no valid position found, try a different road
-                if (!foundValidPosition) {
-                    car.roadIndex = (car.roadIndex + 1) % roads.size();
-                    car.roadProgress = 0.0f;
-                }
+        }
+    }
+}
+
+bool TrafficGenerator::enterNextEdge(size_t index, const std::vector<Road>& roads, const RoadNetwork& network) {
+    TrafficData& cars = trafficData;
+    bool forward = cars.direction[index] > 0.0f;
+    int currentEdge = cars.edgeIndex[index];
+    
+    // No graph for this road, so turn around at its end
+    if (currentEdge < 0 || currentEdge >= static_cast<int>(network.edges.size())) {
+        enterEdge(index, cars.roadIndex[index], -1, -1, forward ? 1.0f : 0.0f, forward ? 0.0f : 1.0f, roads);
+        return true;
+    }
+    
+    // Queue while another car is crossing the node
+    const RoadEdge& edge = network.edges[currentEdge];
+    uint32_t node = forward ? edge.endNode : edge.startNode;
+    bool forced = cars.waitTime[index] >= MAX_WAIT_TIME;
+    if (!forced && nodeBusyUntil[node] > stepCount) return false;
+    
+    // Pick uniformly among the other edges at this node; a dead end turns around
+    uint32_t degree = network.degree(node);
+    int nextEdge = currentEdge;
+    if (degree > 1) {
+        uint32_t pick = std::min(degree - 2, static_cast<uint32_t>(rng.nextFloat() * (degree - 1)));
+        for (uint32_t k = 0, seen = 0; k < degree; k++) {
+            uint32_t candidate = network.nodeEdge(node, k);
+            if (static_cast<int>(candidate) == currentEdge) continue;
+            if (seen++ == pick) {
+                nextEdge = static_cast<int>(candidate);
+                break;
             }
         }
     }
+    
+    const RoadEdge& next = network.edges[nextEdge];
+    bool nextForward = (nextEdge == currentEdge) ? !forward : next.startNode == node;
+    int road = static_cast<int>(next.road);
+    float startT = nextForward ? next.startT : next.endT;
+    float endT = nextForward ? next.endT : next.startT;
+    if (road >= static_cast<int>(roads.size())) return true;
+    
+    // Wait for room rather than landing on or cutting in front of a car in the chosen lane
+    if (!forced && !isLaneEntryClear(index, road, startT, endT)) return false;
+    
+    nodeBusyUntil[node] = stepCount + NODE_CLEAR_STEPS;
+    enterEdge(index, road, nextEdge, static_cast<int>(nextForward ? next.endNode : next.startNode),
+              startT, endT, roads);
+    return true;
+}
+
+void TrafficGenerator::enterEdge(size_t index, int road, int edge, int node, float startT, float endT,
+                                 const std::vector<Road>& roads) {
+    TrafficData& cars = trafficData;
+    
+    // Position at the node; direction from just inside the edge so it belongs to its first segment
+    float dirX, dirY, unusedX, unusedY;
+    roads[road].sample(startT, cars.x[index], cars.y[index], unusedX, unusedY);
+    roads[road].sample(startT + (endT - startT) * 0.01f, unusedX, unusedY, dirX, dirY);
+    
+    float direction = endT >= startT ? 1.0f : -1.0f;
+    cars.roadIndex[index] = road;
+    cars.edgeIndex[index] = edge;
+    cars.progress[index] = startT;
+    cars.edgeEnd[index] = endT;
+    cars.nodeAhead[index] = node;
+    cars.direction[index] = direction;
+    cars.headingX[index] = direction * dirX;
+    cars.headingY[index] = direction * dirY;
+    cars.vx[index] = cars.headingX[index] * cars.speed[index];
+    cars.vy[index] = cars.headingY[index] * cars.speed[index];
+    cars.progressRate[index] = direction * progressRateFor(road, cars.speed[index]);
+    cars.waitTime[index] = 0.0f;
+}
+
+bool TrafficGenerator::isLaneEntryClear(size_t index, int road, float startT, float endT) const {
+    float direction = endT >= startT ? 1.0f : -1.0f;
+    float clearance = (CAR_LENGTH + MIN_GAP) / std::max(roadLengths[road], 1.0f);
+    return lanes.isClear(TrafficLanes::laneOf(road, direction), TrafficLanes::keyOf(startT, direction),
+                         clearance, index);
+}
+
+void TrafficGenerator::holdAtNode(size_t index, const std::vector<Road>& roads) {
+    TrafficData& cars = trafficData;
+    
+    // Stand on the stop line; planSpeeds lets the car pull away once the node is free
+    float dirX, dirY;
+    cars.progress[index] = cars.edgeEnd[index];
+    roads[cars.roadIndex[index]].sample(cars.edgeEnd[index], cars.x[index], cars.y[index], dirX, dirY);
+    cars.speed[index] = 0.0f;
+    cars.vx[index] = 0.0f;
+    cars.vy[index] = 0.0f;
+    cars.progressRate[index] = 0.0f;
+    cars.waitTime[index] += FIXED_TIMESTEP;
 }
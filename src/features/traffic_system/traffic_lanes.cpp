@@ -0,0 +1,115 @@
+/**
+ * @file traffic_lanes.cpp
+ * @brief Implementation of Per-Road Lanes
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#include "features/traffic_system/traffic_lanes.h"
+#include "features/traffic_system/traffic_generator.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+void TrafficLanes::clear() {
+    laneOffsets.clear();
+    laneCars.clear();
+    laneKeys.clear();
+    leaders.clear();
+    leaderGaps.clear();
+    carLanes.clear();
+    carKeys.clear();
+    previousCars.clear();
+    cursors.clear();
+}
+
+void TrafficLanes::update(const TrafficData& cars, size_t roadCount) {
+    size_t carCount = cars.size();
+    size_t laneCount = roadCount * 2;
+    int lastRoad = static_cast<int>(roadCount) - 1;
+    
+    // A new car set or road set has no useful previous order
+    bool fresh = laneCars.size() != carCount || laneOffsets.size() != laneCount + 1;
+    if (fresh) {
+        previousCars.resize(carCount);
+        std::iota(previousCars.begin(), previousCars.end(), 0u);
+    } else {
+        previousCars.swap(laneCars);
+    }
+    
+    // Counting sort by lane; visiting cars in the previous order keeps each lane nearly sorted
+    carLanes.resize(carCount);
+    carKeys.resize(carCount);
+    laneOffsets.assign(laneCount + 1, 0);
+    for (size_t i = 0; i < carCount; i++) {
+        carLanes[i] = laneOf(std::min(cars.roadIndex[i], lastRoad), cars.direction[i]);
+        carKeys[i] = keyOf(cars.progress[i], cars.direction[i]);
+        laneOffsets[carLanes[i] + 1]++;
+    }
+    for (size_t lane = 0; lane < laneCount; lane++) {
+        laneOffsets[lane + 1] += laneOffsets[lane];
+    }
+    
+    cursors.assign(laneOffsets.begin(), laneOffsets.end() - 1);
+    laneCars.resize(carCount);
+    laneKeys.resize(carCount);
+    for (uint32_t car : previousCars) {
+        uint32_t slot = cursors[carLanes[car]]++;
+        laneCars[slot] = car;
+        laneKeys[slot] = carKeys[car];
+    }
+    
+    for (size_t lane = 0; lane < laneCount; lane++) {
+        uint32_t begin = laneOffsets[lane];
+        uint32_t end = laneOffsets[lane + 1];
+        if (end - begin < 2) continue;
+        
+        if (fresh) {
+            // Arbitrary order: full sort, ties broken by car index
+            std::sort(laneCars.begin() + begin, laneCars.begin() + end, [this](uint32_t a, uint32_t b) {
+                return carKeys[a] < carKeys[b] || (carKeys[a] == carKeys[b] && a < b);
+            });
+            for (uint32_t slot = begin; slot < end; slot++) {
+                laneKeys[slot] = carKeys[laneCars[slot]];
+            }
+        } else {
+            // Nearly sorted: insertion sort only moves the cars that overtook or just arrived
+            for (uint32_t slot = begin + 1; slot < end; slot++) {
+                float key = laneKeys[slot];
+                uint32_t car = laneCars[slot];
+                uint32_t j = slot;
+                while (j > begin && laneKeys[j - 1] > key) {
+                    laneKeys[j] = laneKeys[j - 1];
+                    laneCars[j] = laneCars[j - 1];
+                    j--;
+                }
+                laneKeys[j] = key;
+                laneCars[j] = car;
+            }
+        }
+    }
+    
+    const float noLeader = std::numeric_limits<float>::infinity();
+    leaders.resize(carCount);
+    leaderGaps.resize(carCount);
+    for (size_t lane = 0; lane < laneCount; lane++) {
+        uint32_t end = laneOffsets[lane + 1];
+        for (uint32_t slot = laneOffsets[lane]; slot < end; slot++) {
+            bool front = slot + 1 == end;
+            leaders[laneCars[slot]] = front ? -1 : static_cast<int>(laneCars[slot + 1]);
+            leaderGaps[laneCars[slot]] = front ? noLeader : laneKeys[slot + 1] - laneKeys[slot];
+        }
+    }
+}
+
+bool TrafficLanes::isClear(uint32_t lane, float key, float clearance, size_t ignoredCar) const {
+    if (lane + 1 >= laneOffsets.size()) return true;
+    
+    auto begin = laneKeys.begin() + laneOffsets[lane];
+    auto end = laneKeys.begin() + laneOffsets[lane + 1];
+    for (auto it = std::lower_bound(begin, end, key - clearance); it != end && *it < key + clearance; ++it) {
+        if (laneCars[it - laneKeys.begin()] != ignoredCar) return false;
+    }
+    return true;
+}
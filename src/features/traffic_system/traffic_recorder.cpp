@@ -0,0 +1,204 @@
+/**
+ * @file traffic_recorder.cpp
+ * @brief Implementation of Traffic Recording
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#include "features/traffic_system/traffic_recorder.h"
+#include "features/traffic_system/traffic_generator.h"
+#include "features/save_load/city_serializer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+using namespace TrafficFileFormat;
+
+namespace {
+
+// Round half away from zero without a libm call or a branch on the sign
+// (lrint is not inlined under the default math flags; heading signs are random)
+inline int32_t roundToInt(float value) {
+    return static_cast<int32_t>(value + std::copysign(0.5f, value));
+}
+
+// Quantize one car
+inline KeyframeRecord quantize(const TrafficData& cars, size_t index) {
+    KeyframeRecord record;
+    record.x = roundToInt(cars.x[index] * POSITION_SCALE);
+    record.y = roundToInt(cars.y[index] * POSITION_SCALE);
+    record.speed = static_cast<uint16_t>(std::min(std::max(roundToInt(cars.speed[index] * SPEED_SCALE), 0), 65535));
+    record.headingX = static_cast<int8_t>(roundToInt(cars.headingX[index] * HEADING_SCALE));
+    record.headingY = static_cast<int8_t>(roundToInt(cars.headingY[index] * HEADING_SCALE));
+    return record;
+}
+
+}  // namespace
+
+TrafficRecorder::TrafficRecorder()
+    : recording(false), header(), written(0),
+      chunkFirstTick(0), chunkTicks(0), tickCount(0) {}
+
+std::string TrafficRecorder::getRecordingPath(const std::string& filename) {
+    return CitySerializer::getSaveDirectory() + filename + ".traffic";
+}
+
+bool TrafficRecorder::start(const std::string& filename, const TrafficData& cars, const WorldExtent& extent,
+                            uint64_t seed, float tickSeconds, uint32_t keyframeInterval) {
+    stop();
+    
+    std::string saveDir = CitySerializer::getSaveDirectory();
+    mkdir(saveDir.c_str(), 0755);
+    
+    path = getRecordingPath(filename);
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cout << "❌ Failed to open file for writing: " << path << "\n";
+        return false;
+    }
+    
+    header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.headerSize = sizeof(Header);
+    header.carCount = static_cast<uint32_t>(cars.size());
+    header.worldWidth = static_cast<uint32_t>(extent.width);
+    header.worldHeight = static_cast<uint32_t>(extent.height);
+    header.keyframeInterval = std::max(keyframeInterval, 1u);
+    header.tickSeconds = tickSeconds;
+    header.seed = seed;
+    header.colorsOffset = sizeof(Header);
+    
+    // Colors never change, so they are stored once
+    std::vector<ColorRecord> colors(cars.size());
+    for (size_t i = 0; i < cars.size(); i++) {
+        const glm::vec3& color = cars.color[i];
+        colors[i] = {static_cast<uint8_t>(roundToInt(std::min(std::max(color.r, 0.0f), 1.0f) * 255.0f)),
+                     static_cast<uint8_t>(roundToInt(std::min(std::max(color.g, 0.0f), 1.0f) * 255.0f)),
+                     static_cast<uint8_t>(roundToInt(std::min(std::max(color.b, 0.0f), 1.0f) * 255.0f)),
+                     255};
+    }
+    
+    // The header is rewritten with the tick count and index when recording stops
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(colors.data()),
+               static_cast<std::streamsize>(colors.size() * sizeof(ColorRecord)));
+    written = sizeof(header) + colors.size() * sizeof(ColorRecord);
+    if (!file) {
+        fail("write the recording header");
+        return false;
+    }
+    
+    recording = true;
+    tickCount = 0;
+    chunkFirstTick = 0;
+    chunkTicks = 0;
+    index.clear();
+    payload.clear();
+    current.clear();
+    
+    std::cout << "⏺️  Recording " << cars.size() << " cars to " << path << "\n";
+    recordTick(cars);
+    return recording;
+}
+
+void TrafficRecorder::recordTick(const TrafficData& cars) {
+    if (!recording) return;
+    if (cars.size() != header.carCount) {
+        std::cout << "⚠️  Car count changed - stopping the traffic recording\n";
+        stop();
+        return;
+    }
+    
+    // Quantize first: the byte stores of the encode loop would force every array to be reloaded
+    next.resize(cars.size());
+    for (size_t i = 0; i < next.size(); i++) {
+        next[i] = quantize(cars, i);
+    }
+    
+    if (chunkTicks == 0) {
+        // Every chunk opens with a keyframe, so a seek never decodes past one chunk
+        payload.resize(next.size() * sizeof(KeyframeRecord));
+        std::memcpy(payload.data(), next.data(), payload.size());
+    } else {
+        // Encode into scratch room for the worst case, then append what was used
+        frame.resize(next.size() * MAX_DELTA_BYTES);
+        unsigned char* out = frame.data();
+        const KeyframeRecord* previous = current.data();
+        const KeyframeRecord* latest = next.data();
+        for (size_t i = 0; i < next.size(); i++) {
+            KeyframeRecord before = previous[i];
+            KeyframeRecord after = latest[i];
+            bool turned = after.headingX != before.headingX || after.headingY != before.headingY;
+            out = writeVarint(out, zigzag(after.x - before.x));
+            out = writeVarint(out, zigzag(after.y - before.y));
+            out = writeVarint(out, zigzag(static_cast<int32_t>(after.speed) - before.speed) << 1 |
+                                   (turned ? HEADING_CHANGED : 0));
+            if (turned) {
+                *out++ = static_cast<unsigned char>(after.headingX);
+                *out++ = static_cast<unsigned char>(after.headingY);
+            }
+        }
+        payload.insert(payload.end(), frame.data(), out);
+    }
+    std::swap(current, next);
+    chunkTicks++;
+    tickCount++;
+    
+    if (chunkTicks == header.keyframeInterval && !flushChunk()) {
+        fail("write a chunk");
+    }
+}
+
+bool TrafficRecorder::flushChunk() {
+    if (chunkTicks == 0) return true;
+    
+    ChunkHeader chunk = {chunkFirstTick, chunkTicks, payload.size()};
+    index.push_back({chunkFirstTick, chunkTicks, written});
+    file.write(reinterpret_cast<const char*>(&chunk), sizeof(chunk));
+    file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+    written += sizeof(chunk) + payload.size();
+    
+    chunkFirstTick += chunkTicks;
+    chunkTicks = 0;
+    payload.clear();
+    return static_cast<bool>(file);
+}
+
+bool TrafficRecorder::stop() {
+    if (!recording) return true;
+    
+    if (!flushChunk()) {
+        fail("write the last chunk");
+        return false;
+    }
+    
+    // Index after the last chunk, then the finished header in place of the placeholder
+    header.tickCount = tickCount;
+    header.chunkCount = static_cast<uint32_t>(index.size());
+    header.indexOffset = written;
+    file.write(reinterpret_cast<const char*>(index.data()),
+               static_cast<std::streamsize>(index.size() * sizeof(ChunkIndexRecord)));
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    recording = false;
+    
+    if (!file) {
+        std::cout << "❌ Failed to finish the traffic recording " << path << "\n";
+        return false;
+    }
+    std::cout << "⏹️  Recorded " << tickCount << " ticks (" << tickCount * header.tickSeconds
+              << " s, " << (written + index.size() * sizeof(ChunkIndexRecord)) / 1024 << " KB) to " << path << "\n";
+    return true;
+}
+
+void TrafficRecorder::fail(const char* what) {
+    std::cout << "❌ Traffic recording failed to " << what << ": " << path << "\n";
+    file.close();
+    recording = false;
+}
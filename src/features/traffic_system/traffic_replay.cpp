@@ -0,0 +1,243 @@
+/**
+ * @file traffic_replay.cpp
+ * @brief Implementation of Traffic Replay
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#include "features/traffic_system/traffic_replay.h"
+#include "features/traffic_system/traffic_recorder.h"
+#include "utils/mapped_file.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+using namespace TrafficFileFormat;
+
+TrafficReplay::TrafficReplay()
+    : header(), tickCount(0), chunkIndex(0), cursor(nullptr), chunkEnd(nullptr),
+      tick(0), timeAccumulator(0.0f) {}
+
+TrafficReplay::~TrafficReplay() = default;
+
+bool TrafficReplay::open(const std::string& filename) {
+    close();
+    path = TrafficRecorder::getRecordingPath(filename);
+    
+    std::unique_ptr<MappedFile> file(new MappedFile(path));
+    if (!file->data) {
+        std::cout << "❌ Failed to open traffic recording: " << path << "\n";
+        return false;
+    }
+    
+    // Validate the header before trusting any offset in it
+    if (!file->contains(0, 1, sizeof(Header))) {
+        std::cout << "❌ Traffic recording is truncated: " << path << "\n";
+        return false;
+    }
+    std::memcpy(&header, file->data, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0 || header.version != VERSION ||
+        header.headerSize < sizeof(Header) || !(header.tickSeconds > 0.0f)) {
+        std::cout << "❌ Not a supported traffic recording: " << path << "\n";
+        return false;
+    }
+    if (!file->contains(header.colorsOffset, header.carCount, sizeof(ColorRecord))) {
+        std::cout << "❌ Traffic recording is truncated: " << path << "\n";
+        return false;
+    }
+    
+    // Chunk list: the index of a finished recording, otherwise walk the chunk headers
+    chunks.clear();
+    if (header.indexOffset != 0) {
+        if (!file->contains(header.indexOffset, header.chunkCount, sizeof(ChunkIndexRecord))) {
+            std::cout << "❌ Traffic recording index is out of bounds: " << path << "\n";
+            return false;
+        }
+        chunks.resize(header.chunkCount);
+        std::memcpy(chunks.data(), file->data + header.indexOffset, chunks.size() * sizeof(ChunkIndexRecord));
+    } else {
+        uint64_t offset = header.colorsOffset + static_cast<uint64_t>(header.carCount) * sizeof(ColorRecord);
+        ChunkHeader chunk;
+        while (file->contains(offset, 1, sizeof(ChunkHeader))) {
+            std::memcpy(&chunk, file->data + offset, sizeof(chunk));
+            if (!file->contains(offset + sizeof(ChunkHeader), chunk.payloadSize, 1)) break;  // Cut off mid-chunk
+            chunks.push_back({chunk.firstTick, chunk.tickCount, offset});
+            offset += sizeof(ChunkHeader) + chunk.payloadSize;
+        }
+        std::cout << "⚠️  Recording was not finished; replaying its " << chunks.size() << " complete chunks\n";
+    }
+    
+    // Chunks must cover the ticks in order, each starting with a whole keyframe
+    uint64_t keyframeSize = static_cast<uint64_t>(header.carCount) * sizeof(KeyframeRecord);
+    tickCount = 0;
+    for (const ChunkIndexRecord& entry : chunks) {
+        ChunkHeader chunk;
+        bool valid = entry.firstTick == tickCount && entry.tickCount > 0 &&
+                     file->contains(entry.offset, 1, sizeof(ChunkHeader));
+        if (valid) {
+            std::memcpy(&chunk, file->data + entry.offset, sizeof(chunk));
+            valid = chunk.firstTick == entry.firstTick && chunk.tickCount == entry.tickCount &&
+                    chunk.payloadSize >= keyframeSize &&
+                    file->contains(entry.offset + sizeof(ChunkHeader), chunk.payloadSize, 1);
+        }
+        if (!valid) {
+            std::cout << "❌ Traffic recording has an invalid chunk at tick " << tickCount << ": " << path << "\n";
+            chunks.clear();
+            tickCount = 0;
+            return false;
+        }
+        tickCount += entry.tickCount;
+    }
+    if (tickCount == 0) {
+        std::cout << "❌ Traffic recording holds no ticks: " << path << "\n";
+        return false;
+    }
+    
+    mapping = std::move(file);
+    
+    size_t carCount = header.carCount;
+    cars.clear();
+    cars.x.resize(carCount);
+    cars.y.resize(carCount);
+    cars.prevX.resize(carCount);
+    cars.prevY.resize(carCount);
+    cars.headingX.resize(carCount);
+    cars.headingY.resize(carCount);
+    cars.speed.resize(carCount);
+    cars.color.resize(carCount);
+    for (size_t i = 0; i < carCount; i++) {
+        ColorRecord color;
+        std::memcpy(&color, mapping->data + header.colorsOffset + i * sizeof(ColorRecord), sizeof(color));
+        cars.color[i] = glm::vec3(color.r, color.g, color.b) / 255.0f;
+    }
+    
+    std::cout << "▶️  Replaying " << tickCount << " ticks (" << tickCount * header.tickSeconds << " s) of "
+              << carCount << " cars from " << path << "\n";
+    return seek(0);
+}
+
+void TrafficReplay::close() {
+    mapping.reset();
+    chunks.clear();
+    tickCount = 0;
+    chunkIndex = 0;
+    cursor = nullptr;
+    chunkEnd = nullptr;
+    tick = 0;
+    timeAccumulator = 0.0f;
+    state.clear();
+    previous.clear();
+    cars.clear();
+}
+
+bool TrafficReplay::seek(uint32_t target) {
+    if (!isOpen()) return false;
+    target = std::min(target, tickCount - 1);
+    
+    // Last chunk starting at or before the target
+    auto chunk = std::upper_bound(chunks.begin(), chunks.end(), target,
+                                  [](uint32_t value, const ChunkIndexRecord& entry) {
+                                      return value < entry.firstTick;
+                                  }) - 1;
+    loadKeyframe(static_cast<size_t>(chunk - chunks.begin()));
+    previous = state;
+    while (tick < target) {
+        if (!decodeTick()) return false;
+    }
+    
+    timeAccumulator = 0.0f;
+    publish();
+    return true;
+}
+
+void TrafficReplay::update(float deltaTime) {
+    if (!isOpen()) return;
+    
+    // Same pacing as the live simulation: one tick per fixed step, limited catch-up after a hitch
+    timeAccumulator += deltaTime;
+    int steps = 0;
+    while (timeAccumulator >= header.tickSeconds && steps < TrafficGenerator::MAX_STEPS_PER_UPDATE) {
+        if (isFinished()) {
+            timeAccumulator = 0.0f;  // Hold the last tick
+            break;
+        }
+        if (!decodeTick()) return;
+        timeAccumulator -= header.tickSeconds;
+        steps++;
+    }
+    if (timeAccumulator >= header.tickSeconds) {
+        timeAccumulator = std::fmod(timeAccumulator, header.tickSeconds);
+    }
+    if (steps > 0) publish();
+}
+
+bool TrafficReplay::loadKeyframe(size_t chunk) {
+    // Sizes were validated by open()
+    const ChunkIndexRecord& entry = chunks[chunk];
+    ChunkHeader chunkHeader;
+    std::memcpy(&chunkHeader, mapping->data + entry.offset, sizeof(chunkHeader));
+    const unsigned char* payload = mapping->data + entry.offset + sizeof(ChunkHeader);
+    
+    state.resize(header.carCount);
+    std::memcpy(state.data(), payload, state.size() * sizeof(KeyframeRecord));
+    cursor = payload + state.size() * sizeof(KeyframeRecord);
+    chunkEnd = payload + chunkHeader.payloadSize;
+    chunkIndex = chunk;
+    tick = entry.firstTick;
+    return true;
+}
+
+bool TrafficReplay::decodeTick() {
+    // The next chunk's keyframe is the next tick in full
+    const ChunkIndexRecord& entry = chunks[chunkIndex];
+    if (tick + 1 == entry.firstTick + entry.tickCount) {
+        if (chunkIndex + 1 >= chunks.size()) return false;
+        previous = state;
+        return loadKeyframe(chunkIndex + 1);
+    }
+    
+    previous.swap(state);
+    state.resize(previous.size());
+    for (size_t i = 0; i < state.size(); i++) {
+        uint32_t dx, dy, speedBits;
+        if (!readVarint(cursor, chunkEnd, dx) || !readVarint(cursor, chunkEnd, dy) ||
+            !readVarint(cursor, chunkEnd, speedBits)) {
+            return fail("delta frame ends early");
+        }
+        const KeyframeRecord& before = previous[i];
+        KeyframeRecord& after = state[i];
+        after.x = before.x + unzigzag(dx);
+        after.y = before.y + unzigzag(dy);
+        after.speed = static_cast<uint16_t>(before.speed + unzigzag(speedBits >> 1));
+        if (speedBits & HEADING_CHANGED) {
+            if (chunkEnd - cursor < 2) return fail("heading ends early");
+            after.headingX = static_cast<int8_t>(*cursor++);
+            after.headingY = static_cast<int8_t>(*cursor++);
+        } else {
+            after.headingX = before.headingX;
+            after.headingY = before.headingY;
+        }
+    }
+    tick++;
+    return true;
+}
+
+void TrafficReplay::publish() {
+    for (size_t i = 0; i < state.size(); i++) {
+        cars.x[i] = state[i].x / POSITION_SCALE;
+        cars.y[i] = state[i].y / POSITION_SCALE;
+        cars.prevX[i] = previous[i].x / POSITION_SCALE;
+        cars.prevY[i] = previous[i].y / POSITION_SCALE;
+        cars.headingX[i] = state[i].headingX / HEADING_SCALE;
+        cars.headingY[i] = state[i].headingY / HEADING_SCALE;
+        cars.speed[i] = state[i].speed / SPEED_SCALE;
+    }
+}
+
+bool TrafficReplay::fail(const char* what) {
+    std::cout << "❌ Traffic recording is corrupt at tick " << tick + 1 << " (" << what << "): " << path << "\n";
+    close();
+    return false;
+}
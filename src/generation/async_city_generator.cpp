@@ -0,0 +1,84 @@
+#include "generation/async_city_generator.h"
+
+AsyncCityGenerator::AsyncCityGenerator(const WorldExtent& extent, unsigned workerCount)
+    : jobs(workerCount), generator(extent), requestId(0), hasPending(false), stopping(false),
+      hasSnapshot(false), snapshotComplete(false), busy(false) {
+    generator.setJobSystem(&jobs);
+    worker = std::thread(&AsyncCityGenerator::run, this);
+}
+
+AsyncCityGenerator::~AsyncCityGenerator() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        cancelToken.cancel();
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void AsyncCityGenerator::start(const CityConfig& config) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requestId++;
+        pendingConfig = config;
+        hasPending = true;
+        hasSnapshot = false;
+        cancelToken.cancel();   // The worker re-arms it when it picks up this request
+    }
+    wake.notify_one();
+    requestedConfig = config;
+    busy = true;
+}
+
+void AsyncCityGenerator::cancel() {
+    std::lock_guard<std::mutex> lock(mutex);
+    requestId++;
+    hasPending = false;
+    hasSnapshot = false;
+    cancelToken.cancel();
+    busy = false;
+}
+
+bool AsyncCityGenerator::takeSnapshot(CityData& city, bool& complete) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!hasSnapshot) return false;
+    city = std::move(snapshot);
+    complete = snapshotComplete;
+    hasSnapshot = false;
+    if (complete) busy = false;
+    return true;
+}
+
+void AsyncCityGenerator::run() {
+    for (;;) {
+        CityConfig config;
+        uint64_t request;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return hasPending || stopping; });
+            if (stopping) return;
+            config = pendingConfig;
+            request = requestId;
+            hasPending = false;
+            cancelToken.reset();
+        }
+        
+        // The token is set as soon as a newer request arrives: skip copies nobody will see
+        generator.setProgressCallback([this, request](const CityData& city) {
+            if (!cancelToken.isCancelled()) publish(city, request, false);
+        });
+        if (generator.generateCity(config, &cancelToken)) {
+            publish(std::move(generator.getCityData()), request, true);
+        }
+    }
+}
+
+void AsyncCityGenerator::publish(CityData city, uint64_t request, bool complete) {
+    city.isGenerated = true;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (request != requestId) return;
+    snapshot = std::move(city);
+    hasSnapshot = true;
+    snapshotComplete = complete;
+}
@@ -1,52 +1,109 @@
 #include "generation/city_generator.h"
+#include "utils/job_system.h"
+#include "utils/cancellation_token.h"
 #include <iostream>
-#include <random>
 #include <cmath>
+#include <algorithm>
 
-CityGenerator::CityGenerator(int width, int height) 
-    : roadGen(width, height), screenWidth(width), screenHeight(height) {
+CityGenerator::CityGenerator(const WorldExtent& extent) 
+    : roadGen(extent), extent(extent), verbose(true),
+      placementRng(0, RandomStreamId::PLACEMENT), jobSystem(nullptr),
+      cancelToken(nullptr) {
 }
 
-void CityGenerator::generateCity(const CityConfig& config) {
-    std::cout << "\n╔════════════════════════════════════════╗\n";
-    std::cout << "║     🏗️  GENERATING CITY...  🏗️        ║\n";
-    std::cout << "╚════════════════════════════════════════╝\n" << std::flush;
+void CityGenerator::setVerbose(bool enabled) {
+    verbose = enabled;
+    roadGen.setVerbose(enabled);
+}
+
+void CityGenerator::setExtent(const WorldExtent& newExtent) {
+    extent = newExtent;
+    roadGen.setExtent(newExtent);
+}
+
+bool CityGenerator::generateCity(const CityConfig& config, const CancellationToken* cancel) {
+    cancelToken = cancel;
+    if (verbose) {
+        std::cout << "\n╔════════════════════════════════════════╗\n";
+        std::cout << "║     🏗️  GENERATING CITY...  🏗️        ║\n";
+        std::cout << "╚════════════════════════════════════════╝\n";
+        std::cout << "   - Seed: " << config.seed << "\n" << std::flush;
+    }
     
     // Clear previous city data
     cityData.clear();
+    cityData.extent = extent;
+    cityData.seed = config.seed;
+    placementRng = RandomStream(config.seed, RandomStreamId::PLACEMENT);
     
     // GENERATION ORDER:
     // 1. Generate parks and fountains first (using Midpoint Circle Algorithm)
     generateParks(config);
     
-    // 2. Generate roads (using Bresenham's Line Algorithm) - avoid parks/fountains
-    cityData.roads = roadGen.generateRoadsAvoidingObstacles(config, cityData.parks, cityData.fountain);
+    // 2. Generate roads (using Bresenham's Line Algorithm) - avoid parks/fountains.
+    //    Meanwhile the other threads draw building candidates, which only need the parks.
+    cityData.rebuildIndex();
+    planPlacementTiles(config);
+    forEach(placementTiles.size() + 1, [&](size_t i) {
+        if (i == 0) {
+            cityData.roads = roadGen.generateRoadsAvoidingObstacles(config, cityData.parks, cityData.fountain);
+            cityData.network.build(cityData.roads);
+        } else {
+            presampleTile(placementTiles[i - 1], config);
+        }
+    });
     
     // 3. Generate buildings last (avoid parks, fountains, and roads)
-    generateBuildings(config);
+    if (!isCancelled()) {
+        reportProgress();
+        cityData.rebuildIndex();
+        generateBuildings(config);
+    }
+    placementTiles.clear();
+    
+    if (isCancelled()) {
+        cancelToken = nullptr;
+        if (verbose) std::cout << "\n⚠️  City generation cancelled\n" << std::flush;
+        return false;
+    }
+    cancelToken = nullptr;
     
     // Mark as generated
     cityData.isGenerated = true;
     
-    std::cout << "\n✅ City generation complete!\n";
-    std::cout << "   - Total parks: " << cityData.parks.size() << "\n";
-    std::cout << "   - Total buildings: " << cityData.buildings.size() << "\n";
-    std::cout << "   - Total roads: " << cityData.roads.size() << "\n\n" << std::flush;
+    if (verbose) {
+        std::cout << "\n✅ City generation complete!\n";
+        std::cout << "   - Total parks: " << cityData.parks.size() << "\n";
+        std::cout << "   - Total buildings: " << cityData.buildings.size() << "\n";
+        std::cout << "   - Total roads: " << cityData.roads.size() << " (" << cityData.network.nodes.size()
+                  << " nodes, " << cityData.network.edges.size() << " edges)\n\n" << std::flush;
+    }
+    return true;
+}
+
+void CityGenerator::adoptCity(CityData&& city) {
+    cityData = std::move(city);
+    placementRng = RandomStream(cityData.seed, RandomStreamId::PLACEMENT);
+}
+
+bool CityGenerator::isCancelled() const {
+    return cancelToken && cancelToken->isCancelled();
+}
+
+void CityGenerator::reportProgress() const {
+    if (progressCallback) progressCallback(cityData);
 }
 
 void CityGenerator::generateParks(const CityConfig& config) {
     if (config.numParks == 0) {
-        std::cout << "\n🌳 No parks requested\n";
+        if (verbose) std::cout << "\n🌳 No parks requested\n";
         return;
     }
     
-    std::cout << "\n🌳 Generating " << config.numParks << " parks...\n";
+    if (verbose) std::cout << "\n🌳 Generating " << config.numParks << " parks...\n";
     
-    // Random number generator for park placement
-    std::random_device rd;
-    std::mt19937 rng(rd());
-    std::uniform_int_distribution<int> xDist(100, screenWidth - 100);
-    std::uniform_int_distribution<int> yDist(100, screenHeight - 100);
+    // Park placement stream of the city seed
+    RandomStream rng(config.seed, RandomStreamId::PARKS);
     
     int attempts = 0;
     int maxAttempts = config.numParks * 100; // More attempts for finding valid positions
@@ -57,11 +114,8 @@ void CityGenerator::generateParks(const CityConfig& config) {
         // Random position for park with margins
         int marginX = config.parkRadius + 50;
         int marginY = config.parkRadius + 50;
-        std::uniform_int_distribution<int> xDistMargin(marginX, screenWidth - marginX);
-        std::uniform_int_distribution<int> yDistMargin(marginY, screenHeight - marginY);
-        
-        int x = xDistMargin(rng);
-        int y = yDistMargin(rng);
+        int x = rng.nextInt(marginX, extent.width - marginX);
+        int y = rng.nextInt(marginY, extent.height - marginY);
         
         bool validPosition = true;
         
@@ -69,20 +123,9 @@ void CityGenerator::generateParks(const CityConfig& config) {
         const float minParkDistance = config.parkRadius * 2.5f; // Good spacing between parks
         
         for (const auto& existingPark : cityData.parks) {
-            if (existingPark.empty()) continue;
-            
-            // Calculate center of existing park
-            float existingX = 0, existingY = 0;
-            for (const auto& point : existingPark) {
-                existingX += point.x;
-                existingY += point.y;
-            }
-            existingX /= existingPark.size();
-            existingY /= existingPark.size();
-            
             // Check center-to-center distance
-            float dx = x - existingX;
-            float dy = y - existingY;
+            float dx = x - existingPark.x;
+            float dy = y - existingPark.y;
             float distance = std::sqrt(dx * dx + dy * dy);
             
             if (distance < minParkDistance) {
@@ -93,8 +136,8 @@ void CityGenerator::generateParks(const CityConfig& config) {
         
         // CHECK 2: Overlap with fountain (reserved center space)
         if (validPosition && config.fountainRadius > 0) {
-            int centerX = screenWidth / 2;
-            int centerY = screenHeight / 2;
+            int centerX = extent.width / 2;
+            int centerY = extent.height / 2;
             float dx = x - centerX;
             float dy = y - centerY;
             float distance = std::sqrt(dx * dx + dy * dy);
@@ -106,305 +149,294 @@ void CityGenerator::generateParks(const CityConfig& config) {
         }
         
         if (validPosition) {
-            // Use Midpoint Circle Algorithm to generate park
-            std::vector<Point> park = midpointCircle(x, y, config.parkRadius);
-            cityData.parks.push_back(park);
+            // Store the park analytically; the 2D renderer rasterizes it
+            // with the Midpoint Circle Algorithm
+            cityData.parks.push_back(Circle(x, y, config.parkRadius));
             
-            std::cout << "   - Park " << (i + 1) << " at (" << x << ", " << y 
-                      << ") with radius " << config.parkRadius << "\n";
+            if (verbose) {
+                std::cout << "   - Park " << (i + 1) << " at (" << x << ", " << y 
+                          << ") with radius " << config.parkRadius << "\n";
+            }
             i++; // Successfully placed a park
         }
     }
     
-    if (cityData.parks.size() < (size_t)config.numParks) {
+    if (verbose && cityData.parks.size() < (size_t)config.numParks) {
         std::cout << "   ⚠️  Only placed " << cityData.parks.size() << " parks (strict overlap checking)\n";
     }
     
     // Add a central fountain if requested (stored separately for different rendering color)
     if (config.fountainRadius > 0) {
-        int centerX = screenWidth / 2;
-        int centerY = screenHeight / 2;
+        int centerX = extent.width / 2;
+        int centerY = extent.height / 2;
         
-        cityData.fountain = midpointCircle(centerX, centerY, config.fountainRadius);
+        cityData.fountain = Circle(centerX, centerY, config.fountainRadius);
         
-        std::cout << "   - Central fountain at (" << centerX << ", " << centerY 
-                  << ") with radius " << config.fountainRadius << "\n";
+        if (verbose) {
+            std::cout << "   - Central fountain at (" << centerX << ", " << centerY 
+                      << ") with radius " << config.fountainRadius << "\n";
+        }
     }
 }
 
-void CityGenerator::generateBuildings(const CityConfig& config) {
-    if (config.numBuildings == 0) {
-        std::cout << "\n🏢 No buildings requested\n";
-        return;
+void CityGenerator::planPlacementTiles(const CityConfig& config) {
+    placementTiles.clear();
+    if (config.numBuildings <= 0) return;
+    
+    // Building centres are drawn from the integers in [80, extent - 80]
+    const int margin = 80;
+    int spanX = std::max(1, extent.width - 2 * margin + 1);
+    int spanY = std::max(1, extent.height - 2 * margin + 1);
+    
+    // Two buildings of tiles a whole tile apart must not be able to conflict
+    float largestFootprint = config.useStandardSize
+        ? std::max(config.standardWidth, config.standardDepth) : 60.0f;
+    int tileSize = std::max(PLACEMENT_TILE_SIZE, static_cast<int>(std::ceil(largestFootprint + PlacementIndex::BUILDING_BUFFER)) + 1);
+    int tilesX = (spanX + tileSize - 1) / tileSize;
+    int tilesY = (spanY + tileSize - 1) / tileSize;
+    
+    placementTiles.reserve(static_cast<size_t>(tilesX) * tilesY);
+    for (int ty = 0; ty < tilesY; ty++) {
+        for (int tx = 0; tx < tilesX; tx++) {
+            uint64_t index = placementTiles.size();
+            PlacementTile tile(RandomStream(RandomStream::deriveSeed(config.seed, index), RandomStreamId::BUILDINGS));
+            tile.minX = margin + tx * tileSize;
+            tile.minY = margin + ty * tileSize;
+            tile.maxX = std::min(tile.minX + tileSize, margin + spanX) - 1;
+            tile.maxY = std::min(tile.minY + tileSize, margin + spanY) - 1;
+            tile.phase = (ty % 2) * 2 + (tx % 2);
+            placementTiles.push_back(tile);
+        }
     }
     
-    std::cout << "\n🏢 Generating " << config.numBuildings << " buildings...\n";
-    
-    // Random number generator
-    std::random_device rd;
-    std::mt19937 rng(rd());
-    
-    // Position distribution (avoid edges)
-    std::uniform_int_distribution<int> xDist(50, screenWidth - 50);
-    std::uniform_int_distribution<int> yDist(50, screenHeight - 50);
+    // Share the building count by tile area (largest remainder, so the quotas add up)
+    long long totalArea = static_cast<long long>(spanX) * spanY;
+    std::vector<std::pair<long long, size_t>> remainders;
+    int assigned = 0;
+    for (size_t i = 0; i < placementTiles.size(); i++) {
+        PlacementTile& tile = placementTiles[i];
+        long long share = static_cast<long long>(config.numBuildings) *
+                          (tile.maxX - tile.minX + 1) * (tile.maxY - tile.minY + 1);
+        tile.quota = static_cast<int>(share / totalArea);
+        assigned += tile.quota;
+        remainders.push_back({share % totalArea, i});
+    }
+    std::sort(remainders.begin(), remainders.end(),
+              [](const std::pair<long long, size_t>& a, const std::pair<long long, size_t>& b) {
+                  return a.first != b.first ? a.first > b.first : a.second < b.second;
+              });
+    for (size_t i = 0; assigned < config.numBuildings; i++, assigned++) {
+        placementTiles[remainders[i % remainders.size()].second].quota++;
+    }
     
-    // Building dimensions
-    std::uniform_real_distribution<float> widthDist(20.0f, 60.0f);
-    std::uniform_real_distribution<float> depthDist(20.0f, 60.0f);
+    for (PlacementTile& tile : placementTiles) {
+        tile.attemptLimit = tile.quota * ATTEMPTS_PER_BUILDING;
+    }
+}
+
+CityGenerator::BuildingCandidate CityGenerator::sampleCandidate(PlacementTile& tile, const CityConfig& config) {
+    RandomStream& rng = tile.rng;
+    BuildingCandidate candidate;
+    candidate.x = static_cast<float>(rng.nextInt(tile.minX, tile.maxX));
+    candidate.y = static_cast<float>(rng.nextInt(tile.minY, tile.maxY));
+    
+    // Use standard size or random size based on configuration
+    if (config.useStandardSize) {
+        candidate.width = config.standardWidth;
+        candidate.depth = config.standardDepth;
+    } else {
+        candidate.width = rng.nextFloat(20.0f, 60.0f);
+        candidate.depth = rng.nextFloat(20.0f, 60.0f);
+    }
     
-    // Height distribution based on skyline type
-    std::uniform_real_distribution<float> lowRiseHeight(10.0f, 30.0f);
-    std::uniform_real_distribution<float> midRiseHeight(40.0f, 100.0f);
-    std::uniform_real_distribution<float> highRiseHeight(120.0f, 250.0f);
-    std::uniform_int_distribution<int> typeDist(0, 2);
+    // Type and height are drawn for every candidate, so a tile's stream does
+    // not depend on which candidates are accepted
+    switch (config.skylineType) {
+        case SkylineType::LOW_RISE:
+            // All low-rise buildings
+            candidate.type = BuildingType::LOW_RISE;
+            candidate.height = rng.nextFloat(10.0f, 30.0f);
+            break;
+            
+        case SkylineType::MID_RISE:
+            // All mid-rise buildings
+            candidate.type = BuildingType::MID_RISE;
+            candidate.height = rng.nextFloat(40.0f, 100.0f);
+            break;
+            
+        case SkylineType::MIXED:
+        default:
+            // Mix of all types
+            {
+                int typeChoice = rng.nextInt(0, 2);
+                if (typeChoice == 0) {
+                    candidate.type = BuildingType::LOW_RISE;
+                    candidate.height = rng.nextFloat(10.0f, 30.0f);
+                } else if (typeChoice == 1) {
+                    candidate.type = BuildingType::MID_RISE;
+                    candidate.height = rng.nextFloat(40.0f, 100.0f);
+                } else {
+                    candidate.type = BuildingType::HIGH_RISE;
+                    candidate.height = rng.nextFloat(120.0f, 250.0f);
+                }
+            }
+            break;
+            
+        case SkylineType::SKYSCRAPER:
+            // Mostly high-rise with some mid-rise
+            {
+                int typeChoice = rng.nextInt(0, 2);
+                if (typeChoice <= 1) {
+                    candidate.type = BuildingType::HIGH_RISE;
+                    candidate.height = rng.nextFloat(120.0f, 250.0f);
+                } else {
+                    candidate.type = BuildingType::MID_RISE;
+                    candidate.height = rng.nextFloat(40.0f, 100.0f);
+                }
+            }
+            break;
+    }
     
-    int attempts = 0;
-    int maxAttempts = config.numBuildings * 50; // Increased attempts for stricter collision checks
+    return candidate;
+}
+
+void CityGenerator::presampleTile(PlacementTile& tile, const CityConfig& config) const {
+    std::vector<uint32_t> scratch;
+    int count = std::min(tile.quota * PRESAMPLED_PER_BUILDING, tile.attemptLimit);
+    tile.presampled.reserve(count);
+    
+    // Rejected candidates still count as attempts, exactly as if drawn later
+    for (; tile.attempts < count; tile.attempts++) {
+        BuildingCandidate candidate = sampleCandidate(tile, config);
+        if (cityData.placementIndex.findObstacleConflict(candidate.x, candidate.y, candidate.width, candidate.depth,
+                                                         cityData.extent, scratch) == PlacementConflict::NONE) {
+            tile.presampled.push_back(candidate);
+        }
+    }
+}
+
+void CityGenerator::placeTileBuildings(PlacementTile& tile, const CityConfig& config) const {
+    std::vector<uint32_t> scratch;
+    const PlacementIndex& cityIndex = cityData.placementIndex;
+    PlacementIndex tileIndex;   // Buildings accepted by this tile in this phase
+    for (const Building& b : tile.placed) {
+        tileIndex.addBuilding(b.x, b.y, b.width, b.depth);
+    }
     
-    while (cityData.buildings.size() < (size_t)config.numBuildings && attempts < maxAttempts) {
-        attempts++;
-        
-        // Generate random position with better margins
-        std::uniform_int_distribution<int> xDistBetter(80, screenWidth - 80);
-        std::uniform_int_distribution<int> yDistBetter(80, screenHeight - 80);
-        
-        float x = xDistBetter(rng);
-        float y = yDistBetter(rng);
-        
-        // Use standard size or random size based on configuration
-        float width, depth;
-        if (config.useStandardSize) {
-            width = config.standardWidth;
-            depth = config.standardDepth;
+    int target = tile.quota - static_cast<int>(tile.placed.size());
+    int accepted = 0;
+    while (accepted < target) {
+        // Pre-sampled candidates come first: they are the start of the same stream
+        BuildingCandidate candidate;
+        if (tile.nextPresampled < tile.presampled.size()) {
+            candidate = tile.presampled[tile.nextPresampled++];
+        } else if (tile.attempts < tile.attemptLimit) {
+            tile.attempts++;
+            candidate = sampleCandidate(tile, config);
+            if (cityIndex.findObstacleConflict(candidate.x, candidate.y, candidate.width, candidate.depth,
+                                               cityData.extent, scratch) != PlacementConflict::NONE) {
+                continue;
+            }
         } else {
-            width = widthDist(rng);
-            depth = depthDist(rng);
+            break;
         }
         
-        // Check if position is valid (doesn't overlap roads/parks)
-        if (!isValidBuildingPosition(x, y, width, depth)) {
+        if (!cityIndex.isClearOfRoads(candidate.x, candidate.y, candidate.width, candidate.depth, scratch) ||
+            !cityIndex.isClearOfBuildings(candidate.x, candidate.y, candidate.width, candidate.depth, scratch) ||
+            !tileIndex.isClearOfBuildings(candidate.x, candidate.y, candidate.width, candidate.depth, scratch)) {
             continue;
         }
         
-        // Determine building type and height based on skyline configuration
-        BuildingType type;
-        float height;
-        
-        switch (config.skylineType) {
-            case SkylineType::LOW_RISE:
-                // All low-rise buildings
-                type = BuildingType::LOW_RISE;
-                height = lowRiseHeight(rng);
-                break;
-                
-            case SkylineType::MID_RISE:
-                // All mid-rise buildings
-                type = BuildingType::MID_RISE;
-                height = midRiseHeight(rng);
-                break;
-                
-            case SkylineType::MIXED:
-                // Mix of all types
-                {
-                    int typeChoice = typeDist(rng);
-                    if (typeChoice == 0) {
-                        type = BuildingType::LOW_RISE;
-                        height = lowRiseHeight(rng);
-                    } else if (typeChoice == 1) {
-                        type = BuildingType::MID_RISE;
-                        height = midRiseHeight(rng);
-                    } else {
-                        type = BuildingType::HIGH_RISE;
-                        height = highRiseHeight(rng);
-                    }
-                }
-                break;
-                
-            case SkylineType::SKYSCRAPER:
-                // Mostly high-rise with some mid-rise
-                {
-                    int typeChoice = typeDist(rng);
-                    if (typeChoice <= 1) {
-                        type = BuildingType::HIGH_RISE;
-                        height = highRiseHeight(rng);
-                    } else {
-                        type = BuildingType::MID_RISE;
-                        height = midRiseHeight(rng);
-                    }
-                }
-                break;
-        }
-        
-        // Create and add building
-        cityData.buildings.emplace_back(x, y, width, depth, height, type);
-        
-        if (cityData.buildings.size() % 5 == 0) {
-            std::cout << "   - Generated " << cityData.buildings.size() << " buildings...\n" << std::flush;
-        }
+        tile.placed.emplace_back(candidate.x, candidate.y, candidate.width, candidate.depth,
+                                 candidate.height, candidate.type);
+        tileIndex.addBuilding(candidate.x, candidate.y, candidate.width, candidate.depth);
+        accepted++;
     }
-    
-    std::cout << "   ✓ Completed " << cityData.buildings.size() << " buildings\n";
-    
-    // Count by type
-    int lowRise = 0, midRise = 0, highRise = 0;
-    for (const auto& building : cityData.buildings) {
-        switch (building.type) {
-            case BuildingType::LOW_RISE: lowRise++; break;
-            case BuildingType::MID_RISE: midRise++; break;
-            case BuildingType::HIGH_RISE: highRise++; break;
-        }
+}
+
+void CityGenerator::forEach(size_t count, const std::function<void(size_t)>& job) const {
+    if (!jobSystem) {
+        for (size_t i = 0; i < count; i++) job(i);
+        return;
     }
-    
-    std::cout << "   - Low-rise: " << lowRise << " | Mid-rise: " << midRise << " | High-rise: " << highRise << "\n";
+    jobSystem->parallelFor(count, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) job(i);
+    });
 }
 
-bool CityGenerator::isValidBuildingPosition(float x, float y, float width, float depth) const {
-    // Calculate building bounding box with generous margins
-    float halfWidth = width / 2.0f;
-    float halfDepth = depth / 2.0f;
-    const float buildingBuffer = 25.0f; // Increased buffer between buildings
-    
-    float buildingLeft = x - halfWidth;
-    float buildingRight = x + halfWidth;
-    float buildingTop = y - halfDepth;
-    float buildingBottom = y + halfDepth;
-    
-    // Check screen boundaries with margin
-    const float screenMargin = 60.0f;
-    if (buildingLeft < screenMargin || buildingRight > screenWidth - screenMargin ||
-        buildingTop < screenMargin || buildingBottom > screenHeight - screenMargin) {
-        return false; // Too close to screen edges
+void CityGenerator::generateBuildings(const CityConfig& config) {
+    if (config.numBuildings == 0) {
+        if (verbose) std::cout << "\n🏢 No buildings requested\n";
+        return;
     }
     
-    // 1. Check overlap with existing buildings (STRICT - no touching)
-    for (const auto& existingBuilding : cityData.buildings) {
-        float existingHalfWidth = existingBuilding.width / 2.0f;
-        float existingHalfDepth = existingBuilding.depth / 2.0f;
-        float existingLeft = existingBuilding.x - existingHalfWidth;
-        float existingRight = existingBuilding.x + existingHalfWidth;
-        float existingTop = existingBuilding.y - existingHalfDepth;
-        float existingBottom = existingBuilding.y + existingHalfDepth;
-        
-        // Check AABB collision with strict buffer
-        // Buildings must have at least 'buildingBuffer' pixels between them
-        if (!(buildingRight + buildingBuffer < existingLeft ||
-              buildingLeft - buildingBuffer > existingRight ||
-              buildingBottom + buildingBuffer < existingTop ||
-              buildingTop - buildingBuffer > existingBottom)) {
-            return false; // Buildings too close or overlapping
-        }
+    if (verbose) {
+        std::cout << "\n🏢 Generating " << config.numBuildings << " buildings in "
+                  << placementTiles.size() << " tiles...\n";
     }
     
-    // 2. Check overlap with parks (STRICT - check ALL park points)
-    const float parkBuffer = 35.0f; // Increased buffer around parks
-    
-    for (const auto& park : cityData.parks) {
-        if (park.empty()) continue;
-        
-        // Method 1: Check center distance (fast rejection)
-        float parkCenterX = 0, parkCenterY = 0;
-        for (const auto& point : park) {
-            parkCenterX += point.x;
-            parkCenterY += point.y;
-        }
-        parkCenterX /= park.size();
-        parkCenterY /= park.size();
-        
-        // Calculate radius from center to furthest point
-        float parkRadius = 0;
-        for (const auto& point : park) {
-            float dx = point.x - parkCenterX;
-            float dy = point.y - parkCenterY;
-            float dist = std::sqrt(dx * dx + dy * dy);
-            parkRadius = std::max(parkRadius, dist);
-        }
-        
-        // Check if building box intersects with park circle (with buffer)
-        float closestX = std::max(buildingLeft - parkBuffer, 
-                                 std::min(parkCenterX, buildingRight + parkBuffer));
-        float closestY = std::max(buildingTop - parkBuffer, 
-                                 std::min(parkCenterY, buildingBottom + parkBuffer));
-        
-        float dx = closestX - parkCenterX;
-        float dy = closestY - parkCenterY;
-        float distanceSquared = dx * dx + dy * dy;
-        float radiusWithBuffer = parkRadius + parkBuffer;
-        
-        if (distanceSquared < radiusWithBuffer * radiusWithBuffer) {
-            return false; // Building too close to park
-        }
-        
-        // Method 2: Check individual park points (thorough verification)
-        for (const auto& point : park) {
-            // Check if any park point is inside or near building box
-            if (point.x >= buildingLeft - parkBuffer && 
-                point.x <= buildingRight + parkBuffer &&
-                point.y >= buildingTop - parkBuffer && 
-                point.y <= buildingBottom + parkBuffer) {
-                return false; // Park point too close to building
+    std::vector<size_t> phaseTiles;
+    std::vector<int> placedBefore(placementTiles.size(), 0);
+    for (int round = 0; round < MAX_PLACEMENT_ROUNDS; round++) {
+        for (int phase = 0; phase < 4; phase++) {
+            phaseTiles.clear();
+            for (size_t i = 0; i < placementTiles.size(); i++) {
+                const PlacementTile& tile = placementTiles[i];
+                if (tile.phase == phase && tile.quota > placedBefore[i]) phaseTiles.push_back(i);
+            }
+            
+            forEach(phaseTiles.size(), [&](size_t i) {
+                placeTileBuildings(placementTiles[phaseTiles[i]], config);
+            });
+            
+            // Merge in tile order, so the city does not depend on which thread finished first
+            for (size_t index : phaseTiles) {
+                PlacementTile& tile = placementTiles[index];
+                for (const Building& building : tile.placed) {
+                    cityData.addBuilding(building);
+                }
+                placedBefore[index] += static_cast<int>(tile.placed.size());
+                tile.placed.clear();
             }
+            
+            if (isCancelled()) return;
+            reportProgress();
         }
-    }
-    
-    // 3. Check overlap with fountain (same as parks)
-    if (!cityData.fountain.empty()) {
-        const float fountainBuffer = 35.0f;
         
-        // Calculate fountain center
-        float fountainCenterX = 0, fountainCenterY = 0;
-        for (const auto& point : cityData.fountain) {
-            fountainCenterX += point.x;
-            fountainCenterY += point.y;
+        int shortfall = config.numBuildings - static_cast<int>(cityData.buildings.size());
+        if (verbose) {
+            std::cout << "   - Round " << (round + 1) << ": " << cityData.buildings.size() << " buildings\n"
+                      << std::flush;
         }
-        fountainCenterX /= cityData.fountain.size();
-        fountainCenterY /= cityData.fountain.size();
+        if (shortfall <= 0 || round + 1 == MAX_PLACEMENT_ROUNDS) break;
         
-        // Calculate fountain radius
-        float fountainRadius = 0;
-        for (const auto& point : cityData.fountain) {
-            float dx = point.x - fountainCenterX;
-            float dy = point.y - fountainCenterY;
-            float dist = std::sqrt(dx * dx + dy * dy);
-            fountainRadius = std::max(fountainRadius, dist);
+        // Tiles that met their quota may have room left; tiles that did not are full
+        std::vector<size_t> open;
+        for (size_t i = 0; i < placementTiles.size(); i++) {
+            if (placementTiles[i].quota > 0 && placedBefore[i] == placementTiles[i].quota) open.push_back(i);
         }
-        
-        // Check if building box intersects with fountain circle
-        float closestX = std::max(buildingLeft - fountainBuffer, 
-                                 std::min(fountainCenterX, buildingRight + fountainBuffer));
-        float closestY = std::max(buildingTop - fountainBuffer, 
-                                 std::min(fountainCenterY, buildingBottom + fountainBuffer));
-        
-        float dx = closestX - fountainCenterX;
-        float dy = closestY - fountainCenterY;
-        float distanceSquared = dx * dx + dy * dy;
-        float radiusWithBuffer = fountainRadius + fountainBuffer;
-        
-        if (distanceSquared < radiusWithBuffer * radiusWithBuffer) {
-            return false; // Building too close to fountain
+        if (open.empty()) break;
+        for (size_t i = 0; i < open.size(); i++) {
+            PlacementTile& tile = placementTiles[open[i]];
+            int extra = shortfall / static_cast<int>(open.size()) + (static_cast<int>(i) < shortfall % static_cast<int>(open.size()) ? 1 : 0);
+            tile.quota += extra;
+            tile.attemptLimit += extra * ATTEMPTS_PER_BUILDING;
         }
     }
     
-    // 4. Check overlap with roads (since roads are now generated before buildings)
-    const float roadBuffer = 5.0f; // Small buffer around roads
+    if (verbose) std::cout << "   ✓ Completed " << cityData.buildings.size() << " buildings\n";
     
-    for (const auto& road : cityData.roads) {
-        if (road.points.empty()) continue;
-        
-        // Check if building intersects with any road point
-        for (const auto& point : road.points) {
-            // Expand road point by road width
-            float roadHalfWidth = road.width / 2.0f;
-            
-            if (point.x >= buildingLeft - roadBuffer - roadHalfWidth && 
-                point.x <= buildingRight + roadBuffer + roadHalfWidth &&
-                point.y >= buildingTop - roadBuffer - roadHalfWidth && 
-                point.y <= buildingBottom + roadBuffer + roadHalfWidth) {
-                return false; // Building too close to road
-            }
+    // Count by type
+    int lowRise = 0, midRise = 0, highRise = 0;
+    for (const auto& building : cityData.buildings) {
+        switch (building.type) {
+            case BuildingType::LOW_RISE: lowRise++; break;
+            case BuildingType::MID_RISE: midRise++; break;
+            case BuildingType::HIGH_RISE: highRise++; break;
         }
     }
     
-    return true; // Position is valid - no overlaps detected
+    if (verbose) std::cout << "   - Low-rise: " << lowRise << " | Mid-rise: " << midRise << " | High-rise: " << highRise << "\n";
 }
 
 // Place a building at specific coordinates (for interactive placement)
@@ -418,8 +450,8 @@ bool CityGenerator::placeBuilding(float x, float y, const CityConfig& config) {
     float width = config.standardWidth;
     float depth = config.standardDepth;
     
-    // Check if position is valid
-    if (!isValidBuildingPosition(x, y, width, depth)) {
+    // Check if position is valid (the index follows every change to the city)
+    if (cityData.findPlacementConflict(x, y, width, depth) != PlacementConflict::NONE) {
         std::cout << "❌ Cannot place building: Position overlaps with existing structures\n";
         return false;
     }
@@ -431,35 +463,35 @@ bool CityGenerator::placeBuilding(float x, float y, const CityConfig& config) {
     switch (config.skylineType) {
         case SkylineType::LOW_RISE:
             type = BuildingType::LOW_RISE;
-            height = 20.0f + (rand() % 20); // 20-40
+            height = 20.0f + (placementRng.nextBelow(20)); // 20-40
             break;
         case SkylineType::MID_RISE:
             type = BuildingType::MID_RISE;
-            height = 40.0f + (rand() % 40); // 40-80
+            height = 40.0f + (placementRng.nextBelow(40)); // 40-80
             break;
         case SkylineType::SKYSCRAPER:
             type = BuildingType::HIGH_RISE;
-            height = 80.0f + (rand() % 60); // 80-140
+            height = 80.0f + (placementRng.nextBelow(60)); // 80-140
             break;
         case SkylineType::MIXED:
         default:
             // Random distribution
-            int roll = rand() % 100;
+            int roll = placementRng.nextBelow(100);
             if (roll < 40) {
                 type = BuildingType::LOW_RISE;
-                height = 20.0f + (rand() % 20);
+                height = 20.0f + (placementRng.nextBelow(20));
             } else if (roll < 75) {
                 type = BuildingType::MID_RISE;
-                height = 40.0f + (rand() % 40);
+                height = 40.0f + (placementRng.nextBelow(40));
             } else {
                 type = BuildingType::HIGH_RISE;
-                height = 80.0f + (rand() % 60);
+                height = 80.0f + (placementRng.nextBelow(60));
             }
             break;
     }
     
     // Create and add the building
-    cityData.buildings.emplace_back(x, y, width, depth, height, type);
+    cityData.addBuilding(Building(x, y, width, depth, height, type));
     
     std::cout << "✅ Building placed at (" << (int)x << ", " << (int)y << ") - Type: " 
               << (type == BuildingType::LOW_RISE ? "Low-Rise" : 
@@ -467,3 +499,27 @@ bool CityGenerator::placeBuilding(float x, float y, const CityConfig& config) {
     
     return true;
 }
+
+void CityData::addBuilding(const Building& building) {
+    buildings.push_back(building);
+    placementIndex.addBuilding(building.x, building.y, building.width, building.depth);
+}
+
+void CityData::rebuildIndex() {
+    placementIndex.clear();
+    for (const auto& park : parks) {
+        placementIndex.addObstacle(park, PlacementConflict::PARK);
+    }
+    placementIndex.addObstacle(fountain, PlacementConflict::FOUNTAIN);
+    for (const auto& road : roads) {
+        placementIndex.addRoad(road);
+    }
+    for (const auto& building : buildings) {
+        placementIndex.addBuilding(building.x, building.y, building.width, building.depth);
+    }
+}
+
+PlacementConflict CityData::findPlacementConflict(float x, float y, float width, float depth) const {
+    std::vector<uint32_t> scratch;
+    return placementIndex.findConflict(x, y, width, depth, extent, scratch);
+}
@@ -0,0 +1,130 @@
+#include "generation/placement_index.h"
+#include <algorithm>
+
+void PlacementIndex::clear() {
+    obstacleGrid.clear();
+    roadGrid.clear();
+    buildingGrid.clear();
+    obstacles.clear();
+    roadSegments.clear();
+    buildings.clear();
+    maxRoadHalfWidth = 0.0f;
+}
+
+void PlacementIndex::addObstacle(const Circle& circle, PlacementConflict kind) {
+    if (!circle.isValid()) return;
+    obstacles.push_back({circle, kind});
+    obstacleGrid.insert(circle.x - circle.radius, circle.y - circle.radius,
+                        circle.x + circle.radius, circle.y + circle.radius);
+}
+
+void PlacementIndex::addRoad(const Road& road) {
+    float halfWidth = road.width / 2.0f;
+    maxRoadHalfWidth = std::max(maxRoadHalfWidth, halfWidth);
+    
+    auto addSegment = [&](const Point& a, const Point& b) {
+        roadSegments.push_back({a, b, halfWidth});
+        roadGrid.insert(std::min(a.x, b.x), std::min(a.y, b.y),
+                        std::max(a.x, b.x), std::max(a.y, b.y));
+    };
+    
+    if (road.path.size() == 1) {
+        addSegment(road.path[0], road.path[0]);
+    }
+    for (size_t i = 0; i + 1 < road.path.size(); i++) {
+        addSegment(road.path[i], road.path[i + 1]);
+    }
+}
+
+void PlacementIndex::addBuilding(float x, float y, float width, float depth) {
+    Footprint footprint = {x - width / 2.0f, y - depth / 2.0f, x + width / 2.0f, y + depth / 2.0f};
+    buildingGrid.insert(static_cast<uint32_t>(buildings.size()),
+                        footprint.minX, footprint.minY, footprint.maxX, footprint.maxY);
+    buildings.push_back(footprint);
+}
+
+PlacementConflict PlacementIndex::findConflict(float x, float y, float width, float depth,
+                                               const WorldExtent& extent, std::vector<uint32_t>& scratch) const {
+    PlacementConflict conflict = findObstacleConflict(x, y, width, depth, extent, scratch);
+    if (conflict != PlacementConflict::NONE) return conflict;
+    if (!isClearOfRoads(x, y, width, depth, scratch)) return PlacementConflict::ROAD;
+    if (!isClearOfBuildings(x, y, width, depth, scratch)) return PlacementConflict::BUILDING;
+    return PlacementConflict::NONE;
+}
+
+PlacementConflict PlacementIndex::findObstacleConflict(float x, float y, float width, float depth,
+                                                       const WorldExtent& extent,
+                                                       std::vector<uint32_t>& scratch) const {
+    float buildingLeft = x - width / 2.0f;
+    float buildingRight = x + width / 2.0f;
+    float buildingTop = y - depth / 2.0f;
+    float buildingBottom = y + depth / 2.0f;
+    
+    // Check city boundaries with margin
+    if (buildingLeft < EDGE_MARGIN || buildingRight > extent.width - EDGE_MARGIN ||
+        buildingTop < EDGE_MARGIN || buildingBottom > extent.height - EDGE_MARGIN) {
+        return PlacementConflict::CITY_EDGE;
+    }
+    
+    // Check overlap with parks and fountain (same buffer around both)
+    obstacleGrid.query(buildingLeft - OBSTACLE_BUFFER, buildingTop - OBSTACLE_BUFFER,
+                       buildingRight + OBSTACLE_BUFFER, buildingBottom + OBSTACLE_BUFFER, scratch);
+    for (uint32_t id : scratch) {
+        if (obstacles[id].circle.intersectsRect(buildingLeft, buildingTop, buildingRight, buildingBottom,
+                                                OBSTACLE_BUFFER)) {
+            return obstacles[id].kind;
+        }
+    }
+    
+    return PlacementConflict::NONE;
+}
+
+bool PlacementIndex::isClearOfRoads(float x, float y, float width, float depth,
+                                    std::vector<uint32_t>& scratch) const {
+    float buildingLeft = x - width / 2.0f;
+    float buildingRight = x + width / 2.0f;
+    float buildingTop = y - depth / 2.0f;
+    float buildingBottom = y + depth / 2.0f;
+    
+    float roadPad = ROAD_BUFFER + maxRoadHalfWidth;
+    roadGrid.query(buildingLeft - roadPad, buildingTop - roadPad,
+                   buildingRight + roadPad, buildingBottom + roadPad, scratch);
+    for (uint32_t id : scratch) {
+        const RoadSegment& segment = roadSegments[id];
+        
+        // Expand the building box by the road half-width and test the segment
+        float expand = ROAD_BUFFER + segment.halfWidth;
+        if (segmentIntersectsRect(segment.a.x, segment.a.y, segment.b.x, segment.b.y,
+                                  buildingLeft - expand, buildingTop - expand,
+                                  buildingRight + expand, buildingBottom + expand)) {
+            return false; // Building too close to road
+        }
+    }
+    
+    return true;
+}
+
+bool PlacementIndex::isClearOfBuildings(float x, float y, float width, float depth,
+                                        std::vector<uint32_t>& scratch) const {
+    float buildingLeft = x - width / 2.0f;
+    float buildingRight = x + width / 2.0f;
+    float buildingTop = y - depth / 2.0f;
+    float buildingBottom = y + depth / 2.0f;
+    
+    // STRICT - no touching
+    buildingGrid.query(buildingLeft - BUILDING_BUFFER, buildingTop - BUILDING_BUFFER,
+                       buildingRight + BUILDING_BUFFER, buildingBottom + BUILDING_BUFFER, scratch);
+    for (uint32_t id : scratch) {
+        const Footprint& existing = buildings[id];
+        
+        // Buildings must have at least BUILDING_BUFFER units between them
+        if (!(buildingRight + BUILDING_BUFFER < existing.minX ||
+              buildingLeft - BUILDING_BUFFER > existing.maxX ||
+              buildingBottom + BUILDING_BUFFER < existing.minY ||
+              buildingTop - BUILDING_BUFFER > existing.maxY)) {
+            return false; // Buildings too close or overlapping
+        }
+    }
+    
+    return true;
+}
@@ -1,16 +1,15 @@
 #include "generation/road_generator.h"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
-RoadGenerator::RoadGenerator(int width, int height) 
-    : screenWidth(width), screenHeight(height) {
-    // Initialize random number generator with a seed
-    std::random_device rd;
-    rng.seed(rd());
+RoadGenerator::RoadGenerator(const WorldExtent& extent) 
+    : extent(extent), verbose(true), rng(0, RandomStreamId::ROADS) {
 }
 
 std::vector<Road> RoadGenerator::generateRoads(const CityConfig& config) {
-    std::cout << "\n🛣️  Generating roads (" << config.getRoadPatternString() << " pattern)...\n" << std::flush;
+    if (verbose) std::cout << "\n🛣️  Generating roads (" << config.getRoadPatternString() << " pattern)...\n" << std::flush;
+    rng = RandomStream(config.seed, RandomStreamId::ROADS);
     
     switch(config.roadPattern) {
         case RoadPattern::GRID:
@@ -28,25 +27,25 @@ std::vector<Road> RoadGenerator::generateGridRoads(const CityConfig& config) {
     std::vector<Road> roads;
     
     int margin = 50;
-    int spacing = (screenWidth - 2 * margin) / config.layoutSize;
+    int spacing = (extent.width - 2 * margin) / config.layoutSize;
     
-    std::cout << "   - Creating " << config.layoutSize << "x" << config.layoutSize << " grid\n";
+    if (verbose) std::cout << "   - Creating " << config.layoutSize << "x" << config.layoutSize << " grid\n";
     
     // Generate horizontal roads
     for (int i = 0; i <= config.layoutSize; i++) {
         int y = margin + i * spacing;
-        Road road = createRoad(margin, y, screenWidth - margin, y, config.roadWidth);
+        Road road = createRoad(margin, y, extent.width - margin, y, config.roadWidth);
         roads.push_back(road);
     }
     
     // Generate vertical roads
     for (int i = 0; i <= config.layoutSize; i++) {
         int x = margin + i * spacing;
-        Road road = createRoad(x, margin, x, screenHeight - margin, config.roadWidth);
+        Road road = createRoad(x, margin, x, extent.height - margin, config.roadWidth);
         roads.push_back(road);
     }
     
-    std::cout << "   - Generated " << roads.size() << " road segments\n";
+    if (verbose) std::cout << "   - Generated " << roads.size() << " road segments\n";
     return roads;
 }
 
@@ -54,16 +53,16 @@ std::vector<Road> RoadGenerator::generateRadialRoads(const CityConfig& config) {
     std::vector<Road> roads;
     
     // Center of the city
-    int centerX = screenWidth / 2;
-    int centerY = screenHeight / 2;
+    int centerX = extent.width / 2;
+    int centerY = extent.height / 2;
     
     // Number of radial roads (spokes)
     int numSpokes = config.layoutSize;
     
     // Radius for the roads
-    int maxRadius = std::min(screenWidth, screenHeight) / 2 - 50;
+    int maxRadius = std::min(extent.width, extent.height) / 2 - 50;
     
-    std::cout << "   - Creating " << numSpokes << " radial spokes\n";
+    if (verbose) std::cout << "   - Creating " << numSpokes << " radial spokes\n";
     
     // Generate radial roads (spokes from center)
     for (int i = 0; i < numSpokes; i++) {
@@ -73,8 +72,8 @@ std::vector<Road> RoadGenerator::generateRadialRoads(const CityConfig& config) {
         
         // Clamp endpoints to screen boundaries with margin
         int margin = 50;
-        endX = std::max(margin, std::min(screenWidth - margin, endX));
-        endY = std::max(margin, std::min(screenHeight - margin, endY));
+        endX = std::max(margin, std::min(extent.width - margin, endX));
+        endY = std::max(margin, std::min(extent.height - margin, endY));
         
         Road road = createRoad(centerX, centerY, endX, endY, config.roadWidth);
         roads.push_back(road);
@@ -82,20 +81,23 @@ std::vector<Road> RoadGenerator::generateRadialRoads(const CityConfig& config) {
     
     // Generate circular roads (rings)
     int numRings = config.layoutSize / 2;
-    std::cout << "   - Creating " << numRings << " circular rings\n";
+    if (verbose) std::cout << "   - Creating " << numRings << " circular rings\n";
     
     int margin = 50;
+    std::vector<Point> circlePoints;    // Reused by every ring
+    std::vector<Point> validPoints;
     for (int ring = 1; ring <= numRings; ring++) {
         int radius = (maxRadius * ring) / numRings;
         
         // Create circle using midpoint circle algorithm
-        std::vector<Point> circlePoints = midpointCircle(centerX, centerY, radius);
+        circlePoints.resize(midpointCircleLength(radius));
+        midpointCircle(centerX, centerY, radius, circlePoints.data());
         
         // Filter circle points to stay within boundaries
-        std::vector<Point> validPoints;
+        validPoints.clear();
         for (const auto& pt : circlePoints) {
-            if (pt.x >= margin && pt.x <= screenWidth - margin &&
-                pt.y >= margin && pt.y <= screenHeight - margin) {
+            if (pt.x >= margin && pt.x <= extent.width - margin &&
+                pt.y >= margin && pt.y <= extent.height - margin) {
                 validPoints.push_back(pt);
             }
         }
@@ -115,7 +117,7 @@ std::vector<Road> RoadGenerator::generateRadialRoads(const CityConfig& config) {
         }
     }
     
-    std::cout << "   - Generated " << roads.size() << " road segments\n";
+    if (verbose) std::cout << "   - Generated " << roads.size() << " road segments\n";
     return roads;
 }
 
@@ -125,7 +127,7 @@ std::vector<Road> RoadGenerator::generateRandomRoads(const CityConfig& config) {
     // Number of random roads based on layout size
     int numRoads = config.layoutSize * 3;
     
-    std::cout << "   - Creating " << numRoads << " random roads\n";
+    if (verbose) std::cout << "   - Creating " << numRoads << " random roads\n";
     
     // Generate random connection points
     std::vector<Point> nodes;
@@ -135,16 +137,16 @@ std::vector<Road> RoadGenerator::generateRandomRoads(const CityConfig& config) {
     
     // Add screen edge points for connectivity
     nodes.push_back(Point(100, 100));
-    nodes.push_back(Point(screenWidth - 100, 100));
-    nodes.push_back(Point(100, screenHeight - 100));
-    nodes.push_back(Point(screenWidth - 100, screenHeight - 100));
+    nodes.push_back(Point(extent.width - 100, 100));
+    nodes.push_back(Point(100, extent.height - 100));
+    nodes.push_back(Point(extent.width - 100, extent.height - 100));
     
     // Connect random nodes
-    std::uniform_int_distribution<int> nodeDist(0, nodes.size() - 1);
+    int lastNode = static_cast<int>(nodes.size()) - 1;
     
     for (int i = 0; i < numRoads; i++) {
-        int idx1 = nodeDist(rng);
-        int idx2 = nodeDist(rng);
+        int idx1 = rng.nextInt(0, lastNode);
+        int idx2 = rng.nextInt(0, lastNode);
         
         if (idx1 != idx2) {
             Road road = createRoad(
@@ -156,125 +158,214 @@ std::vector<Road> RoadGenerator::generateRandomRoads(const CityConfig& config) {
         }
     }
     
-    std::cout << "   - Generated " << roads.size() << " road segments\n";
+    if (verbose) std::cout << "   - Generated " << roads.size() << " road segments\n";
     return roads;
 }
 
 Road RoadGenerator::createRoad(int x0, int y0, int x1, int y1, int width) {
-    // Use Bresenham's Line Algorithm to generate pixel-perfect road
-    std::vector<Point> points = bresenhamLine(x0, y0, x1, y1);
-    return Road(points, width);
+    // A straight road only needs its endpoints; pixels come from rasterize()
+    return Road({Point(x0, y0), Point(x1, y1)}, width);
 }
 
 Point RoadGenerator::randomPoint(int margin) {
-    std::uniform_int_distribution<int> xDist(margin, screenWidth - margin);
-    std::uniform_int_distribution<int> yDist(margin, screenHeight - margin);
-    
-    return Point(xDist(rng), yDist(rng));
+    int x = rng.nextInt(margin, extent.width - margin);
+    int y = rng.nextInt(margin, extent.height - margin);
+    return Point(x, y);
 }
 
 std::vector<Road> RoadGenerator::generateRoadsAvoidingObstacles(const CityConfig& config, 
-                                                                   const std::vector<std::vector<Point>>& parks,
-                                                                   const std::vector<Point>& fountain) {
+                                                                   const std::vector<Circle>& parks,
+                                                                   const Circle& fountain) {
     // First generate all roads normally
     std::vector<Road> allRoads = generateRoads(config);
     std::vector<Road> filteredRoads;
     
-    // Calculate centers and radii for all circles (parks and fountain)
-    struct Circle {
-        float centerX, centerY, radius;
-    };
-    std::vector<Circle> circles;
+    // Parks and fountain are all obstacles of the same kind
+    std::vector<Circle> circles = parks;
+    if (fountain.isValid()) {
+        circles.push_back(fountain);
+    }
     
-    // Add parks as circles
-    for (const auto& park : parks) {
-        if (park.empty()) continue;
-        
-        Circle circle;
-        circle.centerX = 0;
-        circle.centerY = 0;
-        for (const auto& point : park) {
-            circle.centerX += point.x;
-            circle.centerY += point.y;
-        }
-        circle.centerX /= park.size();
-        circle.centerY /= park.size();
-        
-        // Calculate radius
-        circle.radius = 0;
-        for (const auto& point : park) {
-            float dx = point.x - circle.centerX;
-            float dy = point.y - circle.centerY;
-            float dist = std::sqrt(dx * dx + dy * dy);
-            circle.radius = std::max(circle.radius, dist);
+    // Clip every segment to the stretches outside all circles
+    int originalSegments = allRoads.size();
+    int clippedSegments = 0;
+    for (const auto& road : allRoads) {
+        clippedSegments += clipRoad(road, circles, filteredRoads);
+    }
+    
+    if (verbose) {
+        std::cout << "   - Clipped " << clippedSegments << " road segments at parks and fountain\n";
+        std::cout << "   - Filtered roads: " << originalSegments << " → " << filteredRoads.size() << " segments\n";
+    }
+    
+    return filteredRoads;
+}
+
+// Analytic clipping: each circle covers one parameter interval of a
+// segment, so a segment costs O(circles) however many pixels it spans.
+// Pixel k of a segment with n steps sits at s = k / n; the kept runs are
+// the pixels strictly outside every covered interval, as if the segment
+// had been rasterized and filtered pixel by pixel.
+int RoadGenerator::clipRoad(const Road& road, const std::vector<Circle>& circles, std::vector<Road>& out) {
+    int clipped = 0;
+    std::vector<Point> piece;                       // Polyline being built
+    std::vector<std::pair<float, float>> covered;   // Intervals of the current segment
+    
+    auto flush = [&]() {
+        if (!piece.empty()) out.push_back(Road(piece, road.width));
+        piece.clear();
+    };
+    auto outsideAll = [&](const Point& p) {
+        for (const Circle& circle : circles) {
+            if (circle.contains(p.x, p.y)) return false;
         }
-        
-        circles.push_back(circle);
+        return true;
+    };
+    
+    if (road.path.size() == 1) {
+        if (outsideAll(road.path[0])) out.push_back(road);
+        else clipped++;
+        return clipped;
     }
     
-    // Add fountain as a circle
-    if (!fountain.empty()) {
-        Circle circle;
-        circle.centerX = 0;
-        circle.centerY = 0;
-        for (const auto& point : fountain) {
-            circle.centerX += point.x;
-            circle.centerY += point.y;
+    for (size_t i = 0; i + 1 < road.path.size(); i++) {
+        const Point& a = road.path[i];
+        const Point& b = road.path[i + 1];
+        int steps = std::max(abs(b.x - a.x), abs(b.y - a.y));
+        if (steps == 0) {
+            // Zero-length segment: keep its pixel unless a circle covers it
+            if (!outsideAll(a)) {
+                clipped++;
+                flush();
+            } else if (piece.empty()) {
+                piece.push_back(a);
+            }
+            continue;
         }
-        circle.centerX /= fountain.size();
-        circle.centerY /= fountain.size();
         
-        // Calculate radius
-        circle.radius = 0;
-        for (const auto& point : fountain) {
-            float dx = point.x - circle.centerX;
-            float dy = point.y - circle.centerY;
-            float dist = std::sqrt(dx * dx + dy * dy);
-            circle.radius = std::max(circle.radius, dist);
+        covered.clear();
+        for (const Circle& circle : circles) {
+            float sEnter, sExit;
+            if (circle.clipSegment(a.x, a.y, b.x, b.y, sEnter, sExit)) covered.push_back({sEnter, sExit});
         }
+        if (covered.empty()) {
+            if (piece.empty()) piece.push_back(a);
+            piece.push_back(b);
+            continue;
+        }
+        clipped++;
         
-        circles.push_back(circle);
-    }
-    
-    // Filter out road points that are inside any circle
-    int originalSegments = allRoads.size();
-    int totalPointsRemoved = 0;
-    
-    for (const auto& road : allRoads) {
-        std::vector<Point> filteredPoints;
-        
-        for (const auto& roadPoint : road.points) {
-            bool insideCircle = false;
+        auto pointAt = [&](int k) {
+            if (k == 0) return a;
+            if (k == steps) return b;
+            float s = static_cast<float>(k) / steps;
+            return Point(a.x + static_cast<int>(std::lround((b.x - a.x) * s)),
+                         a.y + static_cast<int>(std::lround((b.y - a.y) * s)));
+        };
+        auto keepRun = [&](int first, int last) {
+            // A run from the segment start continues the piece of the previous segment
+            if (first != 0) flush();
             
-            // Check if road point is inside any circle
-            for (const auto& circle : circles) {
-                float dx = roadPoint.x - circle.centerX;
-                float dy = roadPoint.y - circle.centerY;
-                float distanceSquared = dx * dx + dy * dy;
-                float radiusSquared = circle.radius * circle.radius;
-                
-                // If point is inside circle, mark it for removal
-                if (distanceSquared <= radiusSquared) {
-                    insideCircle = true;
-                    totalPointsRemoved++;
-                    break;
-                }
+            // Rounding can put a cut end a pixel inside a circle: move it out
+            if (first != 0) {
+                while (first <= last && !outsideAll(pointAt(first))) first++;
             }
-            
-            // Only add road point if it's outside all circles
-            if (!insideCircle) {
-                filteredPoints.push_back(roadPoint);
+            if (last != steps) {
+                while (last >= first && !outsideAll(pointAt(last))) last--;
             }
-        }
+            if (first > last) return;
+            
+            if (piece.empty()) piece.push_back(pointAt(first));
+            if (last > first) piece.push_back(pointAt(last));
+            if (last != steps) flush();
+        };
         
-        // Only add road if it has at least some points remaining
-        if (!filteredPoints.empty()) {
-            filteredRoads.push_back(Road(filteredPoints, road.width));
+        // Walk the covered intervals in order; pixels on a circle count as inside
+        std::sort(covered.begin(), covered.end());
+        int next = 0;   // First pixel not yet known to be covered
+        for (const auto& interval : covered) {
+            int lastBefore = static_cast<int>(std::ceil(interval.first * steps)) - 1;
+            if (lastBefore >= next) keepRun(next, lastBefore);
+            next = std::max(next, static_cast<int>(std::floor(interval.second * steps)) + 1);
         }
+        if (next <= steps) {
+            keepRun(next, steps);
+        } else {
+            flush();
+        }
+    }
+    
+    flush();
+    return clipped;
+}
+
+std::vector<Point> Road::rasterize() const {
+    std::vector<Point> pixels(rasterizedLength());
+    rasterize(pixels.data());
+    return pixels;
+}
+
+float Road::length() const {
+    float total = 0.0f;
+    for (size_t i = 0; i + 1 < path.size(); i++) {
+        float dx = static_cast<float>(path[i + 1].x - path[i].x);
+        float dy = static_cast<float>(path[i + 1].y - path[i].y);
+        total += std::sqrt(dx * dx + dy * dy);
+    }
+    return total;
+}
+
+void Road::sample(float t, float& x, float& y, float& dirX, float& dirY) const {
+    dirX = 0.0f;
+    dirY = 0.0f;
+    if (path.empty()) {
+        x = 0.0f;
+        y = 0.0f;
+        return;
     }
     
-    std::cout << "   - Removed " << totalPointsRemoved << " road points inside circles\n";
-    std::cout << "   - Filtered roads: " << originalSegments << " → " << filteredRoads.size() << " segments\n";
+    x = static_cast<float>(path.front().x);
+    y = static_cast<float>(path.front().y);
     
-    return filteredRoads;
+    float remaining = std::max(0.0f, std::min(1.0f, t)) * length();
+    for (size_t i = 0; i + 1 < path.size(); i++) {
+        float dx = static_cast<float>(path[i + 1].x - path[i].x);
+        float dy = static_cast<float>(path[i + 1].y - path[i].y);
+        float segmentLength = std::sqrt(dx * dx + dy * dy);
+        if (segmentLength <= 0.0f) continue;
+        
+        dirX = dx / segmentLength;
+        dirY = dy / segmentLength;
+        
+        bool lastSegment = (i + 2 == path.size());
+        if (remaining <= segmentLength || lastSegment) {
+            float s = std::min(remaining, segmentLength) / segmentLength;
+            x = path[i].x + dx * s;
+            y = path[i].y + dy * s;
+            return;
+        }
+        remaining -= segmentLength;
+    }
+}
+
+bool Road::intersectsRect(float left, float top, float right, float bottom) const {
+    if (path.size() == 1) {
+        return segmentIntersectsRect(path[0].x, path[0].y, path[0].x, path[0].y, left, top, right, bottom);
+    }
+    
+    for (size_t i = 0; i + 1 < path.size(); i++) {
+        if (segmentIntersectsRect(path[i].x, path[i].y, path[i + 1].x, path[i + 1].y,
+                                  left, top, right, bottom)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<Road> Road::fromPixels(const std::vector<Point>& pixels, int width) {
+    std::vector<Road> roads;
+    for (const auto& run : splitPixelRuns(pixels)) {
+        roads.push_back(Road(simplifyPolyline(run), width));
+    }
+    return roads;
 }
@@ -0,0 +1,223 @@
+#include "generation/road_network.h"
+#include "utils/spatial_grid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Stop on a road where it meets a node
+struct RoadStop {
+    float t;
+    uint32_t node;
+    bool operator<(const RoadStop& other) const { return t < other.t; }
+};
+
+// Segment of a road polyline with its range of road parameter
+struct RoadSegment {
+    uint32_t road;
+    float x0, y0, x1, y1;
+    float t0, t1;
+};
+
+// Nodes closer than the snap distance are merged
+class NodeBuilder {
+public:
+    NodeBuilder(std::vector<RoadNode>& nodes, float snapDistance)
+        : nodes(nodes), grid(std::max(snapDistance * 4.0f, 16.0f)), snap(snapDistance) {}
+    
+    uint32_t findOrAdd(float x, float y) {
+        grid.query(x - snap, y - snap, x + snap, y + snap, candidates);
+        for (uint32_t id : candidates) {
+            float dx = nodes[id].x - x;
+            float dy = nodes[id].y - y;
+            if (dx * dx + dy * dy <= snap * snap) return id;
+        }
+        nodes.push_back({x, y});
+        return grid.insert(x, y, x, y);
+    }
+    
+private:
+    std::vector<RoadNode>& nodes;
+    SpatialGrid grid;
+    std::vector<uint32_t> candidates;
+    float snap;
+};
+
+// Closest point on segment, as the segment parameter (0-1)
+float projectOnSegment(const RoadSegment& seg, float px, float py, float& distanceSquared) {
+    float dx = seg.x1 - seg.x0;
+    float dy = seg.y1 - seg.y0;
+    float lengthSquared = dx * dx + dy * dy;
+    float s = lengthSquared > 0.0f ? ((px - seg.x0) * dx + (py - seg.y0) * dy) / lengthSquared : 0.0f;
+    s = std::max(0.0f, std::min(1.0f, s));
+    float cx = seg.x0 + dx * s - px;
+    float cy = seg.y0 + dy * s - py;
+    distanceSquared = cx * cx + cy * cy;
+    return s;
+}
+
+// Proper crossing of two segments; outputs each segment's parameter
+bool crossSegments(const RoadSegment& a, const RoadSegment& b, float& sa, float& sb) {
+    float ax = a.x1 - a.x0, ay = a.y1 - a.y0;
+    float bx = b.x1 - b.x0, by = b.y1 - b.y0;
+    float denominator = ax * by - ay * bx;
+    if (std::fabs(denominator) < 1e-6f) return false;  // Parallel or degenerate
+    
+    float ox = b.x0 - a.x0, oy = b.y0 - a.y0;
+    sa = (ox * by - oy * bx) / denominator;
+    sb = (ox * ay - oy * ax) / denominator;
+    return sa >= 0.0f && sa <= 1.0f && sb >= 0.0f && sb <= 1.0f;
+}
+
+}  // namespace
+
+void RoadNetwork::clear() {
+    nodes.clear();
+    edges.clear();
+    nodeEdgeOffsets.clear();
+    nodeEdges.clear();
+    roadEdgeOffsets.clear();
+}
+
+void RoadNetwork::build(const std::vector<Road>& roads) {
+    clear();
+    
+    // Endpoints only merge on the same pixel; T-junctions may be off by half a road width
+    const float nodeSnap = 0.5f;
+    int maxWidth = 0;
+    for (const Road& road : roads) maxWidth = std::max(maxWidth, road.width);
+    float snap = std::max(nodeSnap, maxWidth / 2.0f);
+    NodeBuilder nodeBuilder(nodes, nodeSnap);
+    
+    // Flatten every road into segments tagged with their road parameter range
+    std::vector<RoadSegment> segments;
+    SpatialGrid segmentGrid(64.0f);
+    for (uint32_t r = 0; r < roads.size(); r++) {
+        const Road& road = roads[r];
+        float total = road.length();
+        if (total <= 0.0f) continue;
+        
+        float travelled = 0.0f;
+        for (size_t i = 0; i + 1 < road.path.size(); i++) {
+            RoadSegment seg;
+            seg.road = r;
+            seg.x0 = static_cast<float>(road.path[i].x);
+            seg.y0 = static_cast<float>(road.path[i].y);
+            seg.x1 = static_cast<float>(road.path[i + 1].x);
+            seg.y1 = static_cast<float>(road.path[i + 1].y);
+            float length = std::sqrt((seg.x1 - seg.x0) * (seg.x1 - seg.x0) + (seg.y1 - seg.y0) * (seg.y1 - seg.y0));
+            seg.t0 = travelled / total;
+            seg.t1 = (travelled + length) / total;
+            travelled += length;
+            
+            segments.push_back(seg);
+            segmentGrid.insert(std::min(seg.x0, seg.x1) - snap, std::min(seg.y0, seg.y1) - snap,
+                               std::max(seg.x0, seg.x1) + snap, std::max(seg.y0, seg.y1) + snap);
+        }
+    }
+    
+    std::vector<std::vector<RoadStop>> stops(roads.size());
+    std::vector<uint32_t> candidates;
+    
+    // 1. Road endpoints, snapped together
+    std::vector<uint32_t> endpointCount;
+    for (uint32_t r = 0; r < roads.size(); r++) {
+        if (roads[r].path.size() < 2 || roads[r].length() <= 0.0f) continue;
+        
+        for (int end = 0; end < 2; end++) {
+            const Point& p = end == 0 ? roads[r].path.front() : roads[r].path.back();
+            uint32_t node = nodeBuilder.findOrAdd(static_cast<float>(p.x), static_cast<float>(p.y));
+            stops[r].push_back({end == 0 ? 0.0f : 1.0f, node});
+            
+            endpointCount.resize(nodes.size(), 0);
+            endpointCount[node]++;
+        }
+    }
+    
+    // Dangling endpoints that stop short of (or just past) another road's centerline join it (T-junctions)
+    for (uint32_t r = 0; r < roads.size(); r++) {
+        for (size_t k = 0; k < stops[r].size(); k++) {
+            uint32_t node = stops[r][k].node;
+            if (endpointCount[node] != 1) continue;
+            
+            float px = nodes[node].x;
+            float py = nodes[node].y;
+            segmentGrid.query(px, py, px, py, candidates);
+            for (uint32_t id : candidates) {
+                const RoadSegment& seg = segments[id];
+                if (seg.road == r) continue;
+                
+                float distanceSquared;
+                float s = projectOnSegment(seg, px, py, distanceSquared);
+                if (distanceSquared <= snap * snap) {
+                    stops[seg.road].push_back({seg.t0 + (seg.t1 - seg.t0) * s, node});
+                }
+            }
+        }
+    }
+    
+    // 2. Crossings between centerlines of different roads
+    for (uint32_t i = 0; i < segments.size(); i++) {
+        const RoadSegment& a = segments[i];
+        segmentGrid.query(std::min(a.x0, a.x1), std::min(a.y0, a.y1),
+                          std::max(a.x0, a.x1), std::max(a.y0, a.y1), candidates);
+        for (uint32_t j : candidates) {
+            if (j <= i || segments[j].road == a.road) continue;
+            
+            const RoadSegment& b = segments[j];
+            float sa, sb;
+            if (crossSegments(a, b, sa, sb)) {
+                uint32_t node = nodeBuilder.findOrAdd(a.x0 + (a.x1 - a.x0) * sa, a.y0 + (a.y1 - a.y0) * sa);
+                stops[a.road].push_back({a.t0 + (a.t1 - a.t0) * sa, node});
+                stops[b.road].push_back({b.t0 + (b.t1 - b.t0) * sb, node});
+            }
+        }
+    }
+    
+    // 3. Consecutive stops along each road become edges
+    roadEdgeOffsets.reserve(roads.size() + 1);
+    for (uint32_t r = 0; r < roads.size(); r++) {
+        roadEdgeOffsets.push_back(static_cast<uint32_t>(edges.size()));
+        
+        std::vector<RoadStop>& roadStops = stops[r];
+        std::sort(roadStops.begin(), roadStops.end());
+        for (size_t i = 0; i + 1 < roadStops.size(); i++) {
+            const RoadStop& from = roadStops[i];
+            const RoadStop& to = roadStops[i + 1];
+            if (from.node == to.node || to.t <= from.t) continue;  // Same junction seen twice
+            edges.push_back({r, from.t, to.t, from.node, to.node});
+        }
+    }
+    roadEdgeOffsets.push_back(static_cast<uint32_t>(edges.size()));
+    
+    // 4. CSR adjacency: count, prefix-sum, scatter
+    nodeEdgeOffsets.assign(nodes.size() + 1, 0);
+    for (const RoadEdge& edge : edges) {
+        nodeEdgeOffsets[edge.startNode + 1]++;
+        nodeEdgeOffsets[edge.endNode + 1]++;
+    }
+    for (size_t n = 0; n < nodes.size(); n++) {
+        nodeEdgeOffsets[n + 1] += nodeEdgeOffsets[n];
+    }
+    
+    nodeEdges.resize(nodeEdgeOffsets.back());
+    std::vector<uint32_t> fill(nodeEdgeOffsets.begin(), nodeEdgeOffsets.end() - 1);
+    for (uint32_t e = 0; e < edges.size(); e++) {
+        nodeEdges[fill[edges[e].startNode]++] = e;
+        nodeEdges[fill[edges[e].endNode]++] = e;
+    }
+}
+
+int RoadNetwork::findEdge(uint32_t road, float t) const {
+    if (road + 1 >= roadEdgeOffsets.size()) return -1;
+    
+    uint32_t first = roadEdgeOffsets[road];
+    uint32_t last = roadEdgeOffsets[road + 1];
+    if (first == last) return -1;
+    
+    // Edges of a road are sorted by t: first edge ending at or after t
+    auto it = std::lower_bound(edges.begin() + first, edges.begin() + last, t,
+                               [](const RoadEdge& edge, float value) { return edge.endT < value; });
+    if (it == edges.begin() + last) --it;
+    return static_cast<int>(it - edges.begin());
+}
@@ -8,7 +8,7 @@
  * 2. Day/Night Cycle (sky colors, time progression)
  * 3. Traffic System (vehicle animation)
  * 4. Click-to-Place Buildings (interactive placement)
- * 5. Save/Load System (JSON serialization)
+ * 5. Save/Load System (binary saves, JSON export)
  * 
  * @author City Designer Team
  * @date November 2025
@@ -17,6 +17,12 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <iostream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -28,9 +34,13 @@
 // Core Systems
 #include "core/application.h"
 #include "core/city_config.h"
+#include "core/headless_runner.h"
+#include "core/quality_governor.h"
+#include "core/render_thread.h"
 
 // Generation Systems
 #include "generation/city_generator.h"
+#include "generation/async_city_generator.h"
 
 // Rendering Systems
 #include "rendering/camera.h"
@@ -42,27 +52,42 @@
 #include "features/building_lights/building_lighting_system.h"
 #include "features/day_night_cycle/day_night_cycle.h"
 #include "features/traffic_system/traffic_generator.h"
+#include "features/traffic_system/traffic_recorder.h"
+#include "features/traffic_system/traffic_replay.h"
 #include "features/building_placement/building_placement_system.h"
 #include "features/save_load/city_serializer.h"
+#include "features/save_load/city_tile_streamer.h"
 
 // Utility Systems
 #include "utils/input_handler.h"
+#include "utils/job_system.h"
+#include "utils/profiler.h"
 
 /**
  * @brief Main application entry point
  * 
  * Initializes all systems, creates the 5 feature systems,
- * and runs the main render loop.
+ * and runs the input/simulation loop on this thread while a render
+ * thread draws the snapshots it publishes (see render_thread.h).
+ * With --headless, batch-generates cities instead, without opening a
+ * window (see headless_runner.h).
  */
-int main()
+int main(int argc, char** argv)
 {
+    if (HeadlessRunner::isRequested(argc, argv)) {
+        HeadlessRunner runner;
+        return runner.parseArguments(argc, argv) ? runner.run() : 1;
+    }
+    
     // ===== CONFIGURATION =====
     const int SCREEN_WIDTH = 800;
     const int SCREEN_HEIGHT = 600;
+    const auto SIM_FRAME_INTERVAL = std::chrono::microseconds(1000000 / 240);  // Input/simulation rate, independent of vsync
     
     CityConfig cityConfig;
     InputHandler inputHandler(cityConfig);
-    CityGenerator cityGenerator(SCREEN_WIDTH, SCREEN_HEIGHT);
+    WorldExtent worldExtent;                // City bounds in world units, independent of the window
+    CityGenerator cityGenerator(worldExtent);
     
     // ===== DISPLAY WELCOME MESSAGE =====
     std::cout << "\n";
@@ -75,7 +100,7 @@ int main()
     std::cout << "║  2️⃣  Day/Night Cycle (sky transitions)                    ║\n";
     std::cout << "║  3️⃣  Traffic System (animated vehicles)                   ║\n";
     std::cout << "║  4️⃣  Click-to-Place Buildings (interactive)               ║\n";
-    std::cout << "║  5️⃣  Save/Load System (JSON persistence)                  ║\n";
+    std::cout << "║  5️⃣  Save/Load System (binary + JSON persistence)         ║\n";
     std::cout << "╚═══════════════════════════════════════════════════════════╝\n";
     InputHandler::displayControls();
     cityConfig.printConfig();
@@ -94,7 +119,7 @@ int main()
     glfwSetInputMode(app.getWindow(), GLFW_CURSOR,
                      cityConfig.view3D ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
     
-    CityRenderer renderer(SCREEN_WIDTH, SCREEN_HEIGHT);
+    CityRenderer renderer;
     
     // ===== FEATURE SYSTEMS INITIALIZATION =====
     BuildingLightingSystem buildingLights;          // Feature 1: Window Lights
@@ -103,45 +128,115 @@ int main()
     BuildingPlacementSystem buildingPlacement;      // Feature 4: Click-to-Place
     // Feature 5 (Save/Load) is used via CitySerializer static methods
     
+    // Worker threads for data-parallel work (traffic steps in chunks, city meshes)
+    JobSystem jobSystem;
+    trafficSystem.setJobSystem(&jobSystem);
+    renderer.setJobSystem(&jobSystem);
+    
+    // F5 records every fixed traffic step to a .traffic file, F6 replays it in place of the live cars
+    TrafficRecorder trafficRecorder;
+    TrafficReplay trafficReplay;
+    trafficSystem.setRecorder(&trafficRecorder);
+    
+    // F9 switches between stepping the cars on the CPU and on the GPU (very large fleets)
+    trafficSystem.setBackend(cityConfig.gpuTraffic ? TrafficBackend::GPU : TrafficBackend::CPU);
+    bool lastGpuTraffic = cityConfig.gpuTraffic;
+    
+    // Cities are generated on a worker thread with its own pool and streamed into
+    // cityGenerator, which holds the displayed city (placement, save/load)
+    AsyncCityGenerator asyncGenerator(worldExtent);
+    bool trafficPending = false;    // Traffic of the requested city not generated yet
+    
+    // Y streams a tiled save (written with K) around the camera in place of the whole city
+    CityTileStreamer tileStreamer;
+    
     // ===== SHADERS & TEXTURES =====
     ShaderManager shaderManager;
+    shaderManager.enableProgramCache("shader_cache/", (GLADloadproc)glfwGetProcAddress);
     if (!shaderManager.compileShaders()) {
         std::cout << "Failed to compile shaders\n";
         return -1;
     }
     
+    // OpenGL 4.3 drivers get all visible buildings in one indirect multi-draw
+    renderer.enableIndirectDraws((GLADloadproc)glfwGetProcAddress);
+    
+    // 2D map points take their size from the shader (ShaderManager::setPointSize)
     glEnable(GL_PROGRAM_POINT_SIZE);
-    glPointSize(2.0f);
     glEnable(GL_DEPTH_TEST);
     
     TextureManager textureManager;
+    textureManager.enableProceduralCache("texture_cache/");
     textureManager.loadAllTextures();
     
     inputHandler.setCityGenerator(&cityGenerator);
     
+    // Frame profilers, one per thread: F3 shows per-scope timings, F4 captures a Chrome trace
+    Profiler profiler("simulation");
+    Profiler renderProfiler("render");
+    renderer.setProfiler(&renderProfiler);
+    inputHandler.setProfiler(&profiler);
+    
+    // Q lets the governor trade detail for frame time (see CityConfig::frameBudgetMs)
+    QualityGovernor qualityGovernor;
+    
     std::cout << "\n✅ All systems initialized!\n";
     std::cout << "Press 'G' to generate a city.\n";
     std::cout << "Press 'H' for keyboard controls.\n\n";
     
-    // ===== RENDER LOOP =====
+    // ===== MAIN LOOP =====
+    // This thread polls input and steps the simulation; from here on the
+    // render thread owns the GL context and draws the published snapshots
+    RenderThread renderThread(app, renderer, shaderManager, textureManager, buildingLights, renderProfiler);
+    renderThread.start();
+    
+    std::shared_ptr<const CityData> shownCity;  // Immutable copy shared with the render thread
+    std::shared_ptr<const std::vector<Building>> shownPlacedBuildings;  // Placed since shownCity was copied
+    uint64_t cityVersion = 0;
+    uint64_t cityLayoutVersion = 0;
+    StreamedTiles streamedTiles;                // Tiles on show while streaming (shared with the streamer, never copied)
+    std::shared_ptr<const StreamedTiles> shownTiles;  // The same pointers, shared with the render thread
+    
     bool lastView3D = cityConfig.view3D;
     float lastTime = glfwGetTime();
     float lastTimeOfDay = dayNightCycle.getTimeOfDay();
+    auto nextFrame = std::chrono::steady_clock::now();
     
     while (!app.shouldClose())
     {
+        // Run at a fixed rate instead of spinning; a frame that overran starts the next at once
+        nextFrame += SIM_FRAME_INTERVAL;
+        auto now = std::chrono::steady_clock::now();
+        if (nextFrame > now) {
+            std::this_thread::sleep_until(nextFrame);
+        } else {
+            nextFrame = now;
+        }
+        auto workStart = std::chrono::steady_clock::now();
+        
+        // Close the previous frame's statistics; this iteration is the next profiled frame
+        profiler.endFrame();
+        Profiler::CpuScope frameScope(&profiler, "frame");
+        app.pollEvents();
+        
         // Calculate delta time
         float currentTime = glfwGetTime();
         float deltaTime = currentTime - lastTime;
         lastTime = currentTime;
         
         // FEATURE 2: Update Day/Night Cycle
-        dayNightCycle.update(deltaTime);
+        {
+            Profiler::CpuScope scope(&profiler, "dayNight.update");
+            dayNightCycle.update(deltaTime);
+        }
         cityConfig.timeOfDay = dayNightCycle.getTimeOfDay();
         
-        // Process input
-        inputHandler.processInput(app.getWindow());
-        inputHandler.processMouseInput(app.getWindow(), SCREEN_WIDTH, SCREEN_HEIGHT);
+        // Process input (G only requests a generation; it runs in the background)
+        {
+            Profiler::CpuScope scope(&profiler, "input");
+            inputHandler.processInput(app.getWindow());
+            inputHandler.processMouseInput(app.getWindow(), SCREEN_WIDTH, SCREEN_HEIGHT);
+        }
         
         // Check if time was manually changed (via 'M' key)
         if (cityConfig.timeOfDay != lastTimeOfDay && cityConfig.timeOfDay != dayNightCycle.getTimeOfDay()) {
@@ -164,45 +259,182 @@ int main()
                            cityConfig.view3D ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
         }
         
+        // City edits this frame, passed on to the render thread with the snapshot
+        bool cityReplaced = false;
+        bool buildingsAdded = false;
+        bool tilesChanged = false;
+        
         // FEATURE 5: Handle load request
         if (inputHandler.loadCityRequested()) {
             inputHandler.clearLoadRequest();
-            if (CitySerializer::loadCity(cityGenerator.getCityData(), "city_save")) {
+            // A city still streaming in would overwrite the loaded one
+            asyncGenerator.cancel();
+            tileStreamer.close();
+            trafficPending = false;
+            // Prefer the binary save; fall back to JSON exports and older saves
+            bool loaded = CitySerializer::hasBinarySave("city_save")
+                ? CitySerializer::loadCityBinary(cityGenerator.getCityData(), "city_save")
+                : CitySerializer::loadCity(cityGenerator.getCityData(), "city_save");
+            if (loaded) {
                 const CityData& city = cityGenerator.getCityData();
-                renderer.updateCity(city, cityConfig.view3D);
+                cityReplaced = true;
                 
-                if (cityConfig.showTraffic && cityConfig.numCars > 0) {
-                    trafficSystem.generateTraffic(city.roads, cityConfig.numCars,
+                trafficRecorder.stop();  // The recording belongs to the old traffic
+                if (cityConfig.showTraffic && cityConfig.trafficCarCount() > 0) {
+                    trafficSystem.generateTraffic(city.roads, city.network, cityConfig.trafficCarCount(),
                                                  city.parks, city.fountain,
-                                                 SCREEN_WIDTH, SCREEN_HEIGHT);
-                    renderer.updateTraffic(trafficSystem.getTrafficData(), cityConfig.view3D);
+                                                 city.extent, city.seed);
                 }
             }
         }
         
-        // Handle generation request
-        if (inputHandler.generationRequested() || viewModeChanged) {
+        // Handle generation request (view switches need no rebuild: both views stay resident)
+        if (inputHandler.generationRequested()) {
             inputHandler.clearGenerationRequest();
+            tileStreamer.close();
+            asyncGenerator.start(cityConfig);
+            trafficPending = true;
+        }
+        
+        // Settings changed mid-generation: the city in progress is stale, so start over
+        if (asyncGenerator.isBusy() && !cityConfig.generatesSameCity(asyncGenerator.getConfig())) {
+            std::cout << "⚠️  Settings changed - restarting city generation\n";
+            asyncGenerator.start(cityConfig);
+            trafficPending = true;
+        }
+        
+        // Show the newest snapshot: the old city stays until the new roads arrive,
+        // then buildings stream in phase by phase
+        CityData snapshot;
+        bool snapshotComplete = false;
+        if (asyncGenerator.takeSnapshot(snapshot, snapshotComplete)) {
+            cityGenerator.adoptCity(std::move(snapshot));
+            const CityData& city = cityGenerator.getCityData();
+            cityReplaced = true;
             
-            if (cityGenerator.hasCity()) {
-                const CityData& city = cityGenerator.getCityData();
-                renderer.updateCity(city, cityConfig.view3D);
-                
-                // FEATURE 3: Generate traffic
-                if (cityConfig.showTraffic && cityConfig.numCars > 0) {
-                    trafficSystem.generateTraffic(city.roads, cityConfig.numCars,
+            // FEATURE 3: Generate traffic (roads, parks and fountain are final in every snapshot)
+            if (trafficPending) {
+                trafficPending = false;
+                trafficSystem.clear();
+                trafficRecorder.stop();  // The recording belongs to the old traffic
+                if (cityConfig.showTraffic && cityConfig.trafficCarCount() > 0) {
+                    trafficSystem.generateTraffic(city.roads, city.network, cityConfig.trafficCarCount(),
                                                  city.parks, city.fountain,
-                                                 SCREEN_WIDTH, SCREEN_HEIGHT);
-                    renderer.updateTraffic(trafficSystem.getTrafficData(), cityConfig.view3D);
+                                                 city.extent, city.seed);
+                }
+            }
+        }
+        
+        // FEATURE 5: Tiled streaming (Y) - keep the tiles around the camera resident
+        if (inputHandler.streamToggleRequested()) {
+            inputHandler.clearStreamToggleRequest();
+            if (tileStreamer.isOpen()) {
+                tileStreamer.close();
+                std::cout << "⏹️  Streaming stopped\n";
+            } else if (tileStreamer.open("city_save")) {
+                asyncGenerator.cancel();
+                trafficPending = false;
+                // Cars need the whole road network, which is never resident
+                trafficSystem.clear();
+                trafficRecorder.stop();
+                // The tiles are shown on top of the map's bare city
+                cityGenerator.adoptCity(tileStreamer.baseCity());
+                cityReplaced = true;
+                streamedTiles.clear();
+                tilesChanged = true;
+            }
+        }
+        if (tileStreamer.isOpen()) {
+            const WorldExtent extent = tileStreamer.getExtent();
+            glm::vec3 eye = camera.getPosition();
+            tileStreamer.update(extent.fromRenderX(eye.x), extent.fromRenderZ(eye.z));
+            
+            // Only the tiles that changed arrive; evictions first
+            TileUpdate tiles;
+            if (tileStreamer.takeTiles(tiles)) {
+                for (uint32_t index : tiles.removed) {
+                    streamedTiles.erase(std::remove_if(streamedTiles.begin(), streamedTiles.end(),
+                                                       [&](const std::shared_ptr<const StreamedTile>& tile) {
+                                                           return tile->index == index;
+                                                       }),
+                                        streamedTiles.end());
                 }
+                streamedTiles.insert(streamedTiles.end(), tiles.added.begin(), tiles.added.end());
+                tilesChanged = true;
             }
+        } else if (!streamedTiles.empty()) {
+            streamedTiles.clear();  // Streaming stopped, or another city replaced it
+            tilesChanged = true;
         }
         
-        // FEATURE 3: Update traffic
-        if (trafficSystem.hasTraffic() && cityGenerator.hasCity()) {
+        // FEATURE 3: Traffic backend (F9) - respawn the cars on the new backend
+        if (cityConfig.gpuTraffic != lastGpuTraffic) {
+            lastGpuTraffic = cityConfig.gpuTraffic;
+            trafficSystem.setBackend(cityConfig.gpuTraffic ? TrafficBackend::GPU : TrafficBackend::CPU);
+            if (trafficSystem.hasTraffic() && cityGenerator.hasCity()) {
+                const CityData& city = cityGenerator.getCityData();
+                trafficRecorder.stop();
+                trafficSystem.generateTraffic(city.roads, city.network, cityConfig.trafficCarCount(),
+                                             city.parks, city.fountain,
+                                             city.extent, city.seed);
+            }
+        }
+        
+        // FEATURE 3: Traffic recording (F5) and replay (F6, seek with F7/F8)
+        if (inputHandler.recordToggleRequested()) {
+            inputHandler.clearRecordToggleRequest();
+            if (trafficRecorder.isRecording()) {
+                trafficRecorder.stop();
+            } else if (trafficReplay.isOpen()) {
+                std::cout << "⚠️  Stop the replay (F6) before recording\n";
+            } else if (trafficSystem.getGpuSetup()) {
+                std::cout << "⚠️  Traffic recording needs the CPU traffic backend (F9)\n";
+            } else if (trafficSystem.hasTraffic()) {
+                const CityData& city = cityGenerator.getCityData();
+                trafficRecorder.start(TrafficRecorder::DEFAULT_NAME, trafficSystem.getTrafficData(),
+                                      city.extent, city.seed, TrafficGenerator::FIXED_TIMESTEP);
+            } else {
+                std::cout << "⚠️  No traffic to record! Generate a city first (press G).\n";
+            }
+        }
+        if (inputHandler.replayToggleRequested()) {
+            inputHandler.clearReplayToggleRequest();
+            if (trafficReplay.isOpen()) {
+                trafficReplay.close();
+                std::cout << "⏹️  Replay stopped - showing live traffic\n";
+            } else {
+                // Finish a recording in progress so the replay sees all of it
+                trafficRecorder.stop();
+                if (trafficReplay.open(TrafficRecorder::DEFAULT_NAME) &&
+                    trafficReplay.getSeed() != cityGenerator.getCityData().seed) {
+                    std::cout << "⚠️  The recording was made in a different city\n";
+                }
+            }
+        }
+        if (inputHandler.getReplaySeekSeconds() != 0.0f) {
+            float seconds = inputHandler.getReplaySeekSeconds();
+            inputHandler.clearReplaySeek();
+            if (trafficReplay.isOpen()) {
+                long target = static_cast<long>(trafficReplay.getTick()) +
+                              std::lround(seconds / trafficReplay.getTickSeconds());
+                trafficReplay.seek(static_cast<uint32_t>(std::max(target, 0L)));
+            }
+        }
+        
+        // Adaptive quality: follow the frame costs of the last interval
+        if (qualityGovernor.update(deltaTime, cityConfig) && !cityConfig.adaptiveQuality) {
+            std::cout << "⚙️  Full quality restored\n";
+        }
+        trafficSystem.setMaxStepsPerUpdate(cityConfig.trafficStepsPerUpdate);
+        
+        // FEATURE 3: Update traffic (the live simulation pauses while a replay plays)
+        if (trafficReplay.isOpen()) {
+            Profiler::CpuScope scope(&profiler, "traffic.replay");
+            trafficReplay.update(deltaTime);
+        } else if (trafficSystem.hasTraffic() && cityGenerator.hasCity()) {
             const CityData& city = cityGenerator.getCityData();
-            trafficSystem.updateTraffic(deltaTime, city.roads);
-            renderer.updateTraffic(trafficSystem.getTrafficData(), cityConfig.view3D);
+            Profiler::CpuScope scope(&profiler, "traffic.update");
+            trafficSystem.updateTraffic(deltaTime, city.roads, city.network);
         }
         
         // FEATURE 4: Handle building placement
@@ -211,60 +443,122 @@ int main()
             inputHandler.getBuildingPlacementPos(mouseX, mouseY);
             inputHandler.clearBuildingPlacement();
             
+            // The top-down view shows the whole extent, so the cursor maps linearly
             CityData& city = cityGenerator.getCityData();
-            if (buildingPlacement.tryPlaceBuilding((float)mouseX, (float)mouseY,
-                                                   city.buildings, city.roads,
-                                                   city.parks, city.fountain,
-                                                   cityConfig, SCREEN_WIDTH, SCREEN_HEIGHT)) {
-                renderer.updateCity(city, cityConfig.view3D);
+            float worldX, worldY;
+            city.extent.fromViewport(mouseX, mouseY, SCREEN_WIDTH, SCREEN_HEIGHT, worldX, worldY);
+            // While a city streams in, its next snapshot would drop the building
+            if (!asyncGenerator.isBusy() && !tileStreamer.isOpen() &&
+                buildingPlacement.tryPlaceBuilding(worldX, worldY, city, cityConfig)) {
+                buildingsAdded = true;
             }
         }
         
-        // FEATURE 2: Set sky color
-        glm::vec3 skyColor = cityConfig.view3D ?
-            dayNightCycle.getSkyColor() : dayNightCycle.getSkyColor2D();
-        
-        glClearColor(skyColor.r, skyColor.g, skyColor.b, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        
-        // Setup shaders
-        shaderManager.use();
-        shaderManager.setTimeOfDay(cityConfig.timeOfDay);
-        
-        // Setup camera matrices
-        glm::mat4 view, projection;
-        if (cityConfig.view3D) {
-            projection = glm::perspective(glm::radians(45.0f),
-                (float)SCREEN_WIDTH / (float)SCREEN_HEIGHT, 0.1f, 100.0f);
-            view = camera.getViewMatrix();
-        } else {
-            projection = glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 10.0f);
-            view = glm::mat4(1.0f);
+        // Share a copy of the city only when it is replaced; a placement
+        // shares just the buildings appended since that copy
+        if (cityReplaced) {
+            Profiler::CpuScope scope(&profiler, "city.share");
+            shownCity = std::make_shared<const CityData>(cityGenerator.getCityData());
+            shownPlacedBuildings = nullptr;
+            cityVersion++;
+            cityLayoutVersion++;
+        } else if (buildingsAdded && shownCity) {
+            Profiler::CpuScope scope(&profiler, "city.share");
+            const std::vector<Building>& buildings = cityGenerator.getCityData().buildings;
+            shownPlacedBuildings = std::make_shared<const std::vector<Building>>(
+                buildings.begin() + shownCity->buildings.size(), buildings.end());
+            cityVersion++;
         }
         
-        shaderManager.setView(glm::value_ptr(view));
-        shaderManager.setProjection(glm::value_ptr(projection));
+        // Streamed tiles: a new list of the same tile pointers, not of their objects
+        if (tilesChanged) {
+            shownTiles = streamedTiles.empty() ? nullptr : std::make_shared<const StreamedTiles>(streamedTiles);
+            cityVersion++;
+        }
         
-        // Render city
-        if (cityGenerator.hasCity() && renderer.isReady()) {
-            const CityData& city = cityGenerator.getCityData();
-            renderer.render(city, cityConfig, cityConfig.view3D, shaderManager,
-                          textureManager.getTexture("brick"),
-                          textureManager.getTexture("concrete"),
-                          textureManager.getTexture("glass"),
-                          textureManager.getTexture("road"),
-                          textureManager.getTexture("grass"),
-                          textureManager.getTexture("fountain"));
+        // Publish this frame; when the render thread holds every snapshot it is behind, so skip one
+        FrameSnapshot* frame = renderThread.acquireFrame();
+        if (frame) {
+            Profiler::CpuScope scope(&profiler, "frame.publish");
+            // A snapshot that was drawn comes back with what drawing it cost
+            if (frame->drawn) {
+                qualityGovernor.addRenderFrame(frame->drawCpuMs, frame->drawGpuMs);
+                frame->drawn = false;
+            }
+            
+            frame->city = cityGenerator.hasCity() ? shownCity : nullptr;
+            frame->cityVersion = cityVersion;
+            frame->cityLayoutVersion = cityLayoutVersion;
+            frame->placedBuildings = shownPlacedBuildings;
+            frame->tiles = shownTiles;
+            frame->config = cityConfig;
+            
+            // FEATURE 3: The cars on show (the replay while one plays)
+            if (trafficReplay.isOpen()) {
+                frame->traffic.copyDrawState(trafficReplay.getTrafficData());
+                frame->trafficAlpha = trafficReplay.getInterpolationAlpha();
+            } else {
+                frame->traffic.copyDrawState(trafficSystem.getTrafficData());
+                frame->trafficAlpha = trafficSystem.getInterpolationAlpha();
+            }
+            // GPU backend: only the step count crosses; the render thread steps the cars itself
+            frame->gpuTraffic = trafficReplay.isOpen() ? nullptr : trafficSystem.getGpuSetup();
+            frame->gpuTrafficStep = trafficSystem.getStepCount();
+            
+            // FEATURE 2: Sky color
+            frame->skyColor = cityConfig.view3D ?
+                dayNightCycle.getSkyColor() : dayNightCycle.getSkyColor2D();
             
-            if (trafficSystem.hasTraffic()) {
-                renderer.renderTraffic(trafficSystem.getTrafficData(), cityConfig,
-                                      cityConfig.view3D, shaderManager);
+            // Camera matrices
+            glm::mat4 view, projection;
+            if (cityConfig.view3D) {
+                projection = glm::perspective(glm::radians(45.0f),
+                    (float)SCREEN_WIDTH / (float)SCREEN_HEIGHT, 0.1f, 100.0f);
+                view = camera.getViewMatrix();
+            } else {
+                // Fit the whole city; the extent is in world units, not pixels
+                const WorldExtent& extent = cityGenerator.getCityData().extent;
+                float halfWidth = extent.renderHalfWidth();
+                float halfDepth = extent.renderHalfDepth();
+                projection = glm::ortho(-halfWidth, halfWidth, -halfDepth, halfDepth, -1.0f, 10.0f);
+                
+                // Top-down: world (x, height, z) -> (x, z, height), so the 3D
+                // meshes draw as a map without being rebuilt
+                view = glm::mat4(0.0f);
+                view[0][0] = 1.0f;
+                view[1][2] = 1.0f;
+                view[2][1] = 1.0f;
+                view[3][3] = 1.0f;
             }
+            
+            // One uniform buffer upload for everything the frame's draws share
+            FrameGlobals& frameGlobals = frame->globals;
+            std::memcpy(frameGlobals.view, glm::value_ptr(view), sizeof(frameGlobals.view));
+            std::memcpy(frameGlobals.projection, glm::value_ptr(projection), sizeof(frameGlobals.projection));
+            cityGenerator.getCityData().extent.renderMapping(frameGlobals.worldToRender);
+            frameGlobals.timeOfDay = cityConfig.timeOfDay;
+            frameGlobals.ambient = dayNightCycle.getAmbientLightFactor();
+            frameGlobals.windowLight = dayNightCycle.getWindowLightFactor();
+            frameGlobals.trafficAlpha = frame->trafficAlpha;
+            
+            frame->viewProjection = projection * view;
+            frame->eye = camera.getPosition();
+            
+            // The render thread's profiler follows F3/F4
+            frame->profilerOverlay = profiler.isOverlayEnabled();
+            frame->profilerTracing = profiler.isTracing();
+            
+            renderThread.publishFrame(frame);
         }
         
-        app.update();
+        // The main thread's share of the frame cost (sleep excluded)
+        qualityGovernor.addMainFrame(
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - workStart).count());
     }
     
+    // Back on this thread: the destructors below free GL objects
+    renderThread.stop();
+    
     // Cleanup handled by destructors
     return 0;
 }
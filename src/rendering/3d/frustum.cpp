@@ -0,0 +1,53 @@
+/**
+ * @file frustum.cpp
+ * @brief Implementation of the view frustum
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#include "rendering/frustum.h"
+#include <cmath>
+
+Frustum::Frustum() {
+    for (auto& plane : planes) {
+        plane[0] = plane[1] = plane[2] = 0.0f;
+        plane[3] = 1.0f;  // 0x + 0y + 0z + 1 >= 0 everywhere
+    }
+}
+
+Frustum Frustum::fromMatrix(const float* m) {
+    // Row i of a column-major matrix is (m[i], m[4 + i], m[8 + i], m[12 + i]).
+    // Each clip plane is row 3 plus or minus row 0 (left/right), 1 (bottom/top)
+    // or 2 (near/far).
+    Frustum frustum;
+    for (int axis = 0; axis < 3; axis++) {
+        for (int side = 0; side < 2; side++) {
+            float sign = side == 0 ? 1.0f : -1.0f;
+            float* plane = frustum.planes[axis * 2 + side];
+            float length = 0.0f;
+            for (int c = 0; c < 4; c++) {
+                plane[c] = m[c * 4 + 3] + sign * m[c * 4 + axis];
+                if (c < 3) length += plane[c] * plane[c];
+            }
+            
+            length = std::sqrt(length);
+            if (length > 0.0f) {
+                for (int c = 0; c < 4; c++) plane[c] /= length;
+            }
+        }
+    }
+    return frustum;
+}
+
+bool Frustum::intersectsBox(const float (&minCorner)[3], const float (&maxCorner)[3]) const {
+    for (const auto& plane : planes) {
+        // Corner of the box furthest along the plane normal
+        float distance = plane[3];
+        for (int c = 0; c < 3; c++) {
+            distance += plane[c] * (plane[c] >= 0.0f ? maxCorner[c] : minCorner[c]);
+        }
+        if (distance < 0.0f) return false;
+    }
+    return true;
+}
@@ -0,0 +1,219 @@
+/**
+ * @file occlusion_buffer.cpp
+ * @brief Implementation of the software Hi-Z occlusion buffer
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#include "rendering/occlusion_buffer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr float FAR_DEPTH = 1.0f;           ///< Depth of an empty texel (the far plane)
+constexpr float MIN_TRIANGLE_AREA = 1e-6f;  ///< Screen area (texels^2) below which a triangle is skipped
+constexpr int MAX_CLIPPED_VERTICES = 8;     ///< A quad clipped at one plane has at most five
+
+}  // namespace
+
+OcclusionBuffer::OcclusionBuffer() : occluderCount(0) {
+    for (int c = 0; c < 16; c++) viewProjection[c] = (c % 5 == 0) ? 1.0f : 0.0f;
+    eye[0] = eye[1] = eye[2] = 0.0f;
+    
+    int width = WIDTH;
+    int height = HEIGHT;
+    for (int level = 0; level < LEVELS; level++) {
+        levelWidth[level] = width;
+        levelHeight[level] = height;
+        levels[level].assign(static_cast<size_t>(width) * height, FAR_DEPTH);
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+}
+
+void OcclusionBuffer::begin(const float* matrix, const float (&eyePosition)[3]) {
+    std::copy(matrix, matrix + 16, viewProjection);
+    std::copy(eyePosition, eyePosition + 3, eye);
+    occluderCount = 0;
+    std::fill(levels[0].begin(), levels[0].end(), FAR_DEPTH);
+}
+
+OcclusionBuffer::ClipVertex OcclusionBuffer::toClip(float x, float y, float z) const {
+    const float* m = viewProjection;
+    return {m[0] * x + m[4] * y + m[8] * z + m[12],
+            m[1] * x + m[5] * y + m[9] * z + m[13],
+            m[2] * x + m[6] * y + m[10] * z + m[14],
+            m[3] * x + m[7] * y + m[11] * z + m[15]};
+}
+
+void OcclusionBuffer::addOccluder(const float (&minCorner)[3], const float (&maxCorner)[3]) {
+    bool drawn = false;
+    for (int axis = 0; axis < 3; axis++) {
+        int u = (axis + 1) % 3;
+        int v = (axis + 2) % 3;
+        for (int side = 0; side < 2; side++) {
+            // Only the faces the eye is outside of can be in front of the rest of the box
+            bool facing = side == 0 ? eye[axis] < minCorner[axis] : eye[axis] > maxCorner[axis];
+            if (!facing) continue;
+            
+            float corner[3];
+            corner[axis] = side == 0 ? minCorner[axis] : maxCorner[axis];
+            ClipVertex quad[4];
+            const float us[4] = {minCorner[u], maxCorner[u], maxCorner[u], minCorner[u]};
+            const float vs[4] = {minCorner[v], minCorner[v], maxCorner[v], maxCorner[v]};
+            for (int i = 0; i < 4; i++) {
+                corner[u] = us[i];
+                corner[v] = vs[i];
+                quad[i] = toClip(corner[0], corner[1], corner[2]);
+            }
+            rasterizePolygon(quad, 4);
+            drawn = true;
+        }
+    }
+    if (drawn) occluderCount++;
+}
+
+void OcclusionBuffer::rasterizePolygon(const ClipVertex* polygon, int count) {
+    // Sutherland-Hodgman against the near plane (z + w >= 0 in GL clip space)
+    ClipVertex clipped[MAX_CLIPPED_VERTICES];
+    int clippedCount = 0;
+    for (int i = 0; i < count; i++) {
+        const ClipVertex& current = polygon[i];
+        const ClipVertex& next = polygon[(i + 1) % count];
+        float currentDistance = current.z + current.w;
+        float nextDistance = next.z + next.w;
+        
+        if (currentDistance >= 0.0f) clipped[clippedCount++] = current;
+        if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f)) {
+            float t = currentDistance / (currentDistance - nextDistance);
+            clipped[clippedCount++] = {current.x + (next.x - current.x) * t,
+                                       current.y + (next.y - current.y) * t,
+                                       current.z + (next.z - current.z) * t,
+                                       current.w + (next.w - current.w) * t};
+        }
+    }
+    if (clippedCount < 3) return;
+    
+    // Texel coordinates and 0-1 depth, then a fan of triangles
+    float screen[MAX_CLIPPED_VERTICES][3];
+    for (int i = 0; i < clippedCount; i++) {
+        float w = std::max(clipped[i].w, 1e-6f);
+        screen[i][0] = (clipped[i].x / w * 0.5f + 0.5f) * WIDTH;
+        screen[i][1] = (clipped[i].y / w * 0.5f + 0.5f) * HEIGHT;
+        screen[i][2] = clipped[i].z / w * 0.5f + 0.5f;
+    }
+    for (int i = 1; i + 1 < clippedCount; i++) {
+        rasterizeTriangle(screen[0], screen[i], screen[i + 1]);
+    }
+}
+
+void OcclusionBuffer::rasterizeTriangle(const float (&a)[3], const float (&b0)[3], const float (&c0)[3]) {
+    const float* b = b0;
+    const float* c = c0;
+    float area = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+    if (std::fabs(area) < MIN_TRIANGLE_AREA) return;
+    if (area < 0.0f) {
+        std::swap(b, c);
+        area = -area;
+    }
+    
+    // Texels whose centers lie inside (centers at integer + 0.5)
+    int x0 = std::max(0, static_cast<int>(std::ceil(std::min({a[0], b[0], c[0]}) - 0.5f)));
+    int x1 = std::min(WIDTH - 1, static_cast<int>(std::floor(std::max({a[0], b[0], c[0]}) - 0.5f)));
+    int y0 = std::max(0, static_cast<int>(std::ceil(std::min({a[1], b[1], c[1]}) - 0.5f)));
+    int y1 = std::min(HEIGHT - 1, static_cast<int>(std::floor(std::max({a[1], b[1], c[1]}) - 0.5f)));
+    if (x0 > x1 || y0 > y1) return;
+    
+    // Depth plane; each texel stores the farthest depth the triangle reaches within it
+    float dzdx = ((b[2] - a[2]) * (c[1] - a[1]) - (c[2] - a[2]) * (b[1] - a[1])) / area;
+    float dzdy = ((c[2] - a[2]) * (b[0] - a[0]) - (b[2] - a[2]) * (c[0] - a[0])) / area;
+    float texelSpread = 0.5f * (std::fabs(dzdx) + std::fabs(dzdy));
+    float farthest = std::max({a[2], b[2], c[2]});
+    
+    float* depth = levels[0].data();
+    for (int y = y0; y <= y1; y++) {
+        float py = y + 0.5f;
+        for (int x = x0; x <= x1; x++) {
+            float px = x + 0.5f;
+            // Inside all three edges (shared edges are inclusive on both sides, so faces leave no gaps)
+            if ((b[0] - a[0]) * (py - a[1]) - (b[1] - a[1]) * (px - a[0]) < 0.0f) continue;
+            if ((c[0] - b[0]) * (py - b[1]) - (c[1] - b[1]) * (px - b[0]) < 0.0f) continue;
+            if ((a[0] - c[0]) * (py - c[1]) - (a[1] - c[1]) * (px - c[0]) < 0.0f) continue;
+            
+            float z = a[2] + dzdx * (px - a[0]) + dzdy * (py - a[1]);
+            z = std::min(z + texelSpread, farthest);
+            float& stored = depth[y * WIDTH + x];
+            stored = std::min(stored, z);
+        }
+    }
+}
+
+void OcclusionBuffer::finish() {
+    for (int level = 1; level < LEVELS; level++) {
+        const std::vector<float>& below = levels[level - 1];
+        int belowWidth = levelWidth[level - 1];
+        int belowHeight = levelHeight[level - 1];
+        std::vector<float>& current = levels[level];
+        for (int y = 0; y < levelHeight[level]; y++) {
+            int y0 = std::min(2 * y, belowHeight - 1);
+            int y1 = std::min(2 * y + 1, belowHeight - 1);
+            for (int x = 0; x < levelWidth[level]; x++) {
+                int x0 = std::min(2 * x, belowWidth - 1);
+                int x1 = std::min(2 * x + 1, belowWidth - 1);
+                current[y * levelWidth[level] + x] = std::max({below[y0 * belowWidth + x0], below[y0 * belowWidth + x1],
+                                                               below[y1 * belowWidth + x0], below[y1 * belowWidth + x1]});
+            }
+        }
+    }
+}
+
+bool OcclusionBuffer::isBoxVisible(const float (&minCorner)[3], const float (&maxCorner)[3]) const {
+    if (occluderCount == 0) return true;
+    
+    // Screen rectangle and nearest depth of the eight corners
+    float minX = static_cast<float>(WIDTH), maxX = 0.0f;
+    float minY = static_cast<float>(HEIGHT), maxY = 0.0f;
+    float nearest = FAR_DEPTH;
+    for (int corner = 0; corner < 8; corner++) {
+        ClipVertex v = toClip((corner & 1) ? maxCorner[0] : minCorner[0],
+                              (corner & 2) ? maxCorner[1] : minCorner[1],
+                              (corner & 4) ? maxCorner[2] : minCorner[2]);
+        if (v.z + v.w < 0.0f || v.w <= 0.0f) return true;  // Crosses the near plane
+        
+        float x = (v.x / v.w * 0.5f + 0.5f) * WIDTH;
+        float y = (v.y / v.w * 0.5f + 0.5f) * HEIGHT;
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+        nearest = std::min(nearest, v.z / v.w * 0.5f + 0.5f);
+    }
+    
+    // Widened by a texel and clamped to the viewport
+    int x0 = std::max(0, static_cast<int>(std::floor(minX)) - 1);
+    int x1 = std::min(WIDTH - 1, static_cast<int>(std::floor(maxX)) + 1);
+    int y0 = std::max(0, static_cast<int>(std::floor(minY)) - 1);
+    int y1 = std::min(HEIGHT - 1, static_cast<int>(std::floor(maxY)) + 1);
+    if (x0 > x1 || y0 > y1) return false;  // Off screen
+    
+    // Coarsest level where the rectangle still spans at most 4x4 texels
+    int level = 0;
+    while (level < LEVELS - 1 && (x1 - x0 >= 4 || y1 - y0 >= 4)) {
+        x0 >>= 1;
+        x1 >>= 1;
+        y0 >>= 1;
+        y1 >>= 1;
+        level++;
+    }
+    
+    const std::vector<float>& depth = levels[level];
+    int width = levelWidth[level];
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            if (nearest <= depth[y * width + x]) return true;
+        }
+    }
+    return false;
+}
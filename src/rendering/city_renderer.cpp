@@ -13,90 +13,231 @@
 #include "rendering/mesh/traffic_mesh.h"
 #include "rendering/mesh/mesh_utils.h"
 #include "features/traffic_system/traffic_generator.h"
+#include "features/traffic_system/gpu_traffic_simulator.h"
+#include "utils/job_system.h"
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr uint32_t NO_BUILDING = 0xFFFFFFFFu;
+constexpr uint32_t MIN_SPARE_BUILDING_SLOTS = 64;  ///< Spare slots per type after each rebuild
+constexpr float BUILDING_CHUNK_SIZE = 100.0f;      ///< Edge length of a culling chunk (world units)
+
+// Visible slot runs at most this many slots apart are drawn as one range;
+// the hidden boxes in between cost less than another draw call
+constexpr GLint MAX_BUILDING_RUN_GAP = 64;
+
+// Not in the 3.3 headers
+constexpr GLenum DRAW_INDIRECT_BUFFER = 0x8F3F;
+
+// Camera distances (world units; the city spans 2) where circular meshes
+// switch to the next coarser level; building chunks beyond the first
+// may drop to their far level
+const float LOD_DISTANCES[MESH_LOD_LEVELS - 1] = {0.75f, 2.0f};
+
+// Chunks whose largest building subtends less than this angle (radians)
+// are skipped; about one pixel at a 45 degree field of view and 600 px
+constexpr float MIN_BUILDING_ANGULAR_SIZE = 0.0013f;
+
+// Occluders per frame: the buildings covering the most of the view, of at
+// least this angular size (radians); smaller ones hide little
+constexpr size_t MAX_OCCLUDERS = 32;
+constexpr float MIN_OCCLUDER_ANGULAR_SIZE = 0.1f;
+
+}  // namespace
 
 // Constructor
-CityRenderer::CityRenderer(int screenWidth, int screenHeight)
-    : screenWidth(screenWidth)
-    , screenHeight(screenHeight)
-    , fountain3DVAO(0)
-    , fountain3DVBO(0)
-    , fountain3DVertexCount(0)
-    , fountainLights3DVAO(0)
-    , fountainLights3DVBO(0)
-    , fountainLights3DVertexCount(0)
+CityRenderer::CityRenderer()
+    : buildingInstanceVBO(0)
+    , buildingLayerVBO(0)
+    , buildingIndexVBO(0)
+    , buildingLayerTheme(TextureTheme::MODERN)
+    , buildingInstanceBase(-1)
+    , chunkColumns(0)
+    , chunkRows(0)
+    , occlusionStale(true)
+    , occlusionEnabled(true)
+    , lodDistanceScale(1.0f)
+    , cullAngleScale(1.0f)
+    , pointSizeScale(1.0f)
+    , multiDrawElementsIndirect(nullptr)
+    , buildingCommandBuffer(0)
+    , trafficVAO(0)
+    , trafficMeshVBO(0)
+    , trafficInstanceVBO(0)
+    , trafficCarCapacity(0)
+    , trafficVisibleVAO(0)
+    , trafficVisibleVBO(0)
+    , profiler(nullptr)
+    , jobSystem(nullptr)
 {
+    cameraEye[0] = cameraEye[1] = cameraEye[2] = 0.0f;  // On the ground: full detail everywhere
+    for (int c = 0; c < 16; c++) {
+        cameraViewProjection[c] = (c % 5 == 0) ? 1.0f : 0.0f;
+    }
+    for (auto& level : buildingLodFirst) {
+        for (GLint& first : level) {
+            first = 0;
+        }
+    }
 }
 
 // Destructor
 CityRenderer::~CityRenderer() {
     cleanup();
+    if (buildingCommandBuffer != 0) {
+        glDeleteBuffers(1, &buildingCommandBuffer);
+    }
+}
+
+bool CityRenderer::enableIndirectDraws(GLADloadproc loader) {
+    multiDrawElementsIndirect = nullptr;
+    
+    // Core in 4.3; base instance (4.2) is what lets a command start at a slot
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    bool supported = major > 4 || (major == 4 && minor >= 3);
+    if (!supported) {
+        bool multiDrawIndirect = false;
+        bool baseInstance = false;
+        GLint extensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+        for (GLint i = 0; i < extensionCount; i++) {
+            const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            if (!name) continue;
+            if (std::strcmp(name, "GL_ARB_multi_draw_indirect") == 0) multiDrawIndirect = true;
+            if (std::strcmp(name, "GL_ARB_base_instance") == 0) baseInstance = true;
+        }
+        supported = multiDrawIndirect && baseInstance;
+    }
+    
+    if (supported) {
+        multiDrawElementsIndirect =
+            reinterpret_cast<MultiDrawElementsIndirectProc>(loader("glMultiDrawElementsIndirect"));
+    }
+    if (!multiDrawElementsIndirect) {
+        std::cout << "⚠️  No indirect multi-draw (needs OpenGL 4.3) - buildings draw per range\n";
+        return false;
+    }
+    std::cout << "✅ Buildings draw through one indirect multi-draw\n";
+    return true;
 }
 
 // Cleanup all buffers
 void CityRenderer::cleanup() {
-    // Cleanup 2D buffers
-    if (!VAOs.empty()) {
-        glDeleteVertexArrays(VAOs.size(), VAOs.data());
-        glDeleteBuffers(VBOs.size(), VBOs.data());
-        VAOs.clear();
-        VBOs.clear();
-        vertexCounts.clear();
-    }
-    
-    // Cleanup 3D road buffers
-    if (!road3DVAOs.empty()) {
-        glDeleteVertexArrays(road3DVAOs.size(), road3DVAOs.data());
-        glDeleteBuffers(road3DVBOs.size(), road3DVBOs.data());
-        road3DVAOs.clear();
-        road3DVBOs.clear();
-        road3DVertexCounts.clear();
-    }
-    
-    // Cleanup 3D park buffers
-    if (!park3DVAOs.empty()) {
-        glDeleteVertexArrays(park3DVAOs.size(), park3DVAOs.data());
-        glDeleteBuffers(park3DVBOs.size(), park3DVBOs.data());
-        park3DVAOs.clear();
-        park3DVBOs.clear();
-        park3DVertexCounts.clear();
-    }
-    
-    // Cleanup 3D fountain buffer
-    if (fountain3DVAO != 0) {
-        glDeleteVertexArrays(1, &fountain3DVAO);
-        glDeleteBuffers(1, &fountain3DVBO);
-        fountain3DVAO = 0;
-        fountain3DVBO = 0;
-        fountain3DVertexCount = 0;
-    }
-    
-    if (fountainLights3DVAO != 0) {
-        glDeleteVertexArrays(1, &fountainLights3DVAO);
-        glDeleteBuffers(1, &fountainLights3DVBO);
-        fountainLights3DVAO = 0;
-        fountainLights3DVBO = 0;
-        fountainLights3DVertexCount = 0;
+    // Cleanup batched buffers
+    deleteBatch(pointBatch);
+    deleteBatch(road3DBatch);
+    deleteBatch(park3DBatch);
+    deleteBuildingBatch();
+    roadPointRange = DrawRange();
+    parkPointRange = DrawRange();
+    fountainPointRange = DrawRange();
+    for (DrawRange& range : buildingTypeRanges) {
+        range = DrawRange();
+    }
+    for (BuildingRegion& region : buildingRegions) {
+        region = BuildingRegion();
     }
+    buildingSlots.clear();
+    slotBuildings.clear();
+    buildingChunks.clear();
+    slotChunks.clear();
+    slotBounds.clear();
+    parkLods.clear();
+    for (auto& tile : tileMeshes) {
+        deleteBatch(tile.second.points);
+        deleteBatch(tile.second.roads);
+        deleteBatch(tile.second.parks);
+    }
+    tileMeshes.clear();
+    fountainLod = LodObject();
+    fountainLightsLod = LodObject();
+    
+    // Cleanup 3D fountain buffers
+    deleteBatch(fountain3DBatch);
+    deleteBatch(fountainLights3DBatch);
     
     // Cleanup traffic buffers
-    if (!traffic3DVAOs.empty()) {
-        glDeleteVertexArrays(traffic3DVAOs.size(), traffic3DVAOs.data());
-        glDeleteBuffers(traffic3DVBOs.size(), traffic3DVBOs.data());
-        traffic3DVAOs.clear();
-        traffic3DVBOs.clear();
-        traffic3DVertexCounts.clear();
+    cleanupTraffic();
+}
+
+// Cleanup the traffic mesh and instance buffers
+void CityRenderer::cleanupTraffic() {
+    if (trafficVAO != 0) {
+        glDeleteVertexArrays(1, &trafficVAO);
+        glDeleteBuffers(1, &trafficMeshVBO);
+        glDeleteBuffers(1, &trafficInstanceVBO);
+        glDeleteVertexArrays(1, &trafficVisibleVAO);
+        glDeleteBuffers(1, &trafficVisibleVBO);
+        trafficVAO = 0;
+        trafficMeshVBO = 0;
+        trafficInstanceVBO = 0;
+        trafficVisibleVAO = 0;
+        trafficVisibleVBO = 0;
     }
-    if (!trafficVAOs.empty()) {
-        glDeleteVertexArrays(trafficVAOs.size(), trafficVAOs.data());
-        glDeleteBuffers(trafficVBOs.size(), trafficVBOs.data());
-        trafficVAOs.clear();
-        trafficVBOs.clear();
-        trafficVertexCounts.clear();
+    trafficCarCapacity = 0;
+    trafficStaging.clear();
+    trafficVisibleStaging.clear();
+}
+
+// Allocate traffic instance buffer sized for carCount cars
+void CityRenderer::allocateTrafficBuffer(size_t carCount) {
+    if (trafficVAO == 0) {
+        glGenVertexArrays(1, &trafficVAO);
+        glGenVertexArrays(1, &trafficVisibleVAO);
+        glGenBuffers(1, &trafficMeshVBO);
+        glGenBuffers(1, &trafficInstanceVBO);
+        glGenBuffers(1, &trafficVisibleVBO);
+        
+        // Shared unit car mesh (x, y, z, u, v)
+        std::vector<float> unitMesh = carUnitMesh();
+        glBindBuffer(GL_ARRAY_BUFFER, trafficMeshVBO);
+        glBufferData(GL_ARRAY_BUFFER, unitMesh.size() * sizeof(float), unitMesh.data(), GL_STATIC_DRAW);
+        
+        // Both VAOs draw the same mesh: every car, or the cars that passed culling
+        const GLuint vaos[2] = {trafficVAO, trafficVisibleVAO};
+        const GLuint instanceBuffers[2] = {trafficInstanceVBO, trafficVisibleVBO};
+        for (int i = 0; i < 2; i++) {
+            glBindVertexArray(vaos[i]);
+            glBindBuffer(GL_ARRAY_BUFFER, trafficMeshVBO);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), 
+                                 (void*)(3 * sizeof(float)));
+            glEnableVertexAttribArray(1);
+            
+            // Per-instance attributes: (x, z, sin, cos) at location 2, color at location 3
+            glBindBuffer(GL_ARRAY_BUFFER, instanceBuffers[i]);
+            glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, CAR_INSTANCE_FLOATS * sizeof(float), (void*)0);
+            glEnableVertexAttribArray(2);
+            glVertexAttribDivisor(2, 1);
+            glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, CAR_INSTANCE_FLOATS * sizeof(float),
+                                 (void*)(4 * sizeof(float)));
+            glEnableVertexAttribArray(3);
+            glVertexAttribDivisor(3, 1);
+        }
     }
+    
+    trafficStaging.assign(carCount * CAR_INSTANCE_FLOATS, 0.0f);
+    trafficVisibleStaging.assign(carCount * CAR_INSTANCE_FLOATS, 0.0f);
+    trafficCarCapacity = carCount;
+    
+    // Storage only - contents are streamed in by updateTraffic() and renderTraffic()
+    glBindBuffer(GL_ARRAY_BUFFER, trafficInstanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, trafficStaging.size() * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, trafficVisibleVBO);
+    glBufferData(GL_ARRAY_BUFFER, trafficVisibleStaging.size() * sizeof(float), nullptr, GL_STREAM_DRAW);
 }
 
 // Create buffer for mesh
-std::pair<GLuint, GLuint> CityRenderer::createBuffer(const std::vector<float>& vertices, bool hasTexCoords) {
+std::pair<GLuint, GLuint> CityRenderer::createBuffer(const std::vector<float>& vertices, bool hasTexCoords,
+                                                     GLenum usage) {
     GLuint VAO, VBO;
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
@@ -104,7 +245,7 @@ std::pair<GLuint, GLuint> CityRenderer::createBuffer(const std::vector<float>& v
     glBindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), 
-                vertices.data(), GL_STATIC_DRAW);
+                vertices.data(), usage);
     
     if (hasTexCoords) {
         // Position attribute (location = 0)
@@ -124,427 +265,1391 @@ std::pair<GLuint, GLuint> CityRenderer::createBuffer(const std::vector<float>& v
     return {VAO, VBO};
 }
 
+// Create an indexed buffer from a float mesh
+CityRenderer::GeometryBatch CityRenderer::createIndexedBuffer(const IndexedMesh& mesh, GLenum usage) {
+    GeometryBatch batch;
+    if (mesh.indices.empty()) return batch;
+    
+    auto [vao, vbo] = createBuffer(mesh.vertices, true, usage);
+    batch.VAO = vao;
+    batch.VBO = vbo;
+    batch.vertexCount = static_cast<GLsizei>(mesh.vertexCount());
+    batch.indexCount = static_cast<GLsizei>(mesh.indices.size());
+    
+    // Element buffer binding is recorded in the (still bound) VAO
+    glGenBuffers(1, &batch.EBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.EBO);
+    
+    if (mesh.vertexCount() <= 65536) {
+        std::vector<uint16_t> shortIndices(mesh.indices.begin(), mesh.indices.end());
+        batch.indexType = GL_UNSIGNED_SHORT;
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(uint16_t),
+                    shortIndices.data(), GL_STATIC_DRAW);
+    } else {
+        batch.indexType = GL_UNSIGNED_INT;
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(uint32_t),
+                    mesh.indices.data(), GL_STATIC_DRAW);
+    }
+    
+    glBindVertexArray(0);
+    return batch;
+}
+
+// Pack a batch's vertices (and narrow its indices) on the CPU
+CityRenderer::BatchData CityRenderer::packBatch(const float* vertices, size_t vertexCount, bool hasTexCoords,
+                                                const uint32_t* indices, size_t indexCount) {
+    BatchData data;
+    data.hasTexCoords = hasTexCoords;
+    data.vertexCount = static_cast<GLsizei>(vertexCount);
+    if (vertexCount == 0) return data;
+    
+    data.quantization = computeQuantization(vertices, vertexCount, hasTexCoords);
+    data.vertices = packVertices(vertices, vertexCount, hasTexCoords, data.quantization);
+    if (vertexCount <= 65536) {
+        data.shortIndices.assign(indices, indices + indexCount);
+    } else {
+        data.indices.assign(indices, indices + indexCount);
+    }
+    return data;
+}
+
+// Upload a packed batch: one glBufferData for its vertices, one for its indices
+CityRenderer::GeometryBatch CityRenderer::uploadBatch(const BatchData& data) {
+    GeometryBatch batch;
+    if (data.vertexCount == 0) return batch;
+    
+    glGenVertexArrays(1, &batch.VAO);
+    glGenBuffers(1, &batch.VBO);
+    glBindVertexArray(batch.VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, batch.VBO);
+    glBufferData(GL_ARRAY_BUFFER, data.vertices.size() * sizeof(uint16_t), data.vertices.data(), GL_STATIC_DRAW);
+    
+    // 16-bit normalized components; the shader maps 0..1 back into the box
+    GLsizei stride = (data.hasTexCoords ? PACKED_TEXTURED_VERTEX_SHORTS : PACKED_POINT_VERTEX_SHORTS) *
+                     sizeof(uint16_t);
+    glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)0);
+    glEnableVertexAttribArray(0);
+    if (data.hasTexCoords) {
+        glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)(4 * sizeof(uint16_t)));
+        glEnableVertexAttribArray(1);
+    }
+    batch.vertexCount = data.vertexCount;
+    batch.quantized = true;
+    batch.quantization = data.quantization;
+    
+    if (!data.shortIndices.empty() || !data.indices.empty()) {
+        // Element buffer binding is recorded in the (still bound) VAO
+        glGenBuffers(1, &batch.EBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.EBO);
+        if (!data.shortIndices.empty()) {
+            batch.indexType = GL_UNSIGNED_SHORT;
+            batch.indexCount = static_cast<GLsizei>(data.shortIndices.size());
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.shortIndices.size() * sizeof(uint16_t),
+                        data.shortIndices.data(), GL_STATIC_DRAW);
+        } else {
+            batch.indexType = GL_UNSIGNED_INT;
+            batch.indexCount = static_cast<GLsizei>(data.indices.size());
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.indices.size() * sizeof(uint32_t),
+                        data.indices.data(), GL_STATIC_DRAW);
+        }
+    }
+    
+    glBindVertexArray(0);
+    return batch;
+}
+
+// Draw a vertex or index range of a bound batch
+void CityRenderer::drawBatchRange(const GeometryBatch& batch, GLenum mode, DrawRange range) {
+    if (range.count == 0) return;
+    
+    if (batch.EBO != 0) {
+        size_t indexSize = batch.indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+        glDrawElements(mode, range.count, batch.indexType, (void*)(range.first * indexSize));
+    } else {
+        glDrawArrays(mode, range.first, range.count);
+    }
+}
+
+// Bind a batch for drawing, with the box its vertices are packed against
+void CityRenderer::bindBatch(const GeometryBatch& batch, ShaderManager& shaderManager) {
+    glBindVertexArray(batch.VAO);
+    if (batch.quantized) {
+        const VertexQuantization& q = batch.quantization;
+        shaderManager.setVertexQuantization(q.origin, q.scale, q.texCoordTransform);
+    }
+}
+
+// Delete a batch
+void CityRenderer::deleteBatch(GeometryBatch& batch) {
+    if (batch.VAO != 0) {
+        glDeleteVertexArrays(1, &batch.VAO);
+        glDeleteBuffers(1, &batch.VBO);
+    }
+    if (batch.EBO != 0) {
+        glDeleteBuffers(1, &batch.EBO);
+    }
+    batch = GeometryBatch();
+}
+
+// Part of a staging array reserved for one object (floats or indices)
+struct StagingSlice {
+    size_t first = 0;
+    size_t capacity = 0;                          ///< Exact size or upper bound
+    size_t count = 0;                             ///< Written by the object's job
+};
+
+static void reserveSlice(std::vector<StagingSlice>& slices, size_t& total, size_t capacity) {
+    slices.push_back({total, capacity, 0});
+    total += capacity;
+}
+
+// Close the gaps that upper-bound slices left behind; slices then point at
+// their final positions. Returns the values kept
+template <typename T>
+static size_t compactSlices(T* data, std::vector<StagingSlice>& slices) {
+    size_t end = 0;
+    for (StagingSlice& slice : slices) {
+        if (slice.count > 0 && slice.first != end) {
+            std::memmove(data + end, data + slice.first, slice.count * sizeof(T));
+        }
+        slice.first = end;
+        end += slice.count;
+    }
+    return end;
+}
+
+void CityRenderer::forEach(size_t count, const std::function<void(size_t)>& job) const {
+    forEach(jobSystem, count, job);
+}
+
+void CityRenderer::forEach(JobSystem* jobs, size_t count, const std::function<void(size_t)>& job) {
+    if (!jobs) {
+        for (size_t i = 0; i < count; i++) job(i);
+        return;
+    }
+    jobs->parallelFor(count, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) job(i);
+    });
+}
+
+// Phase one: build and pack every static mesh, no GL calls
+CityRenderer::CityMeshes CityRenderer::buildCityMeshes(const CityData& city, JobSystem* jobs, FrameArena& meshArena) {
+    CityMeshes meshes;
+    const WorldExtent& cityExtent = city.extent;
+    size_t roadCount = city.roads.size();
+    size_t parkCount = city.parks.size();
+    bool hasFountain = city.fountain.isValid();
+    size_t objectCount = roadCount + parkCount + (hasFountain ? 1 : 0);
+    
+    // Objects are roads, then parks, then the fountain. Lay out every
+    // object's slice of the staging arrays: exact sizes for the rasterized
+    // pixels, parks and the fountain, upper bounds for points and roads
+    auto rasterLength = [&](size_t i) {
+        if (i < roadCount) return city.roads[i].rasterizedLength();
+        return i < roadCount + parkCount ? city.parks[i - roadCount].rasterizedLength()
+                                         : city.fountain.rasterizedLength();
+    };
+    std::vector<StagingSlice> rasterSlices, pointSlices, roadSlices, roadIndexSlices, parkSlices, fountainSlices,
+                              lightSlices;
+    size_t rasterPoints = 0, pointFloats = 0, roadFloats = 0, roadIndices = 0, parkFloats = 0, fountainFloats = 0,
+           lightFloats = 0;
+    for (size_t i = 0; i < objectCount; i++) {
+        size_t length = rasterLength(i);
+        reserveSlice(rasterSlices, rasterPoints, length);
+        reserveSlice(pointSlices, pointFloats, length * 3);
+    }
+    for (const Road& road : city.roads) {
+        reserveSlice(roadSlices, roadFloats, roadMeshFloats(road));
+        reserveSlice(roadIndexSlices, roadIndices, roadMeshIndices(road));
+    }
+    for (int lod = 0; lod < MESH_LOD_LEVELS; lod++) {
+        // Level-major: every park at level 0, then every park at level 1, ...
+        for (size_t i = 0; i < parkCount; i++) {
+            reserveSlice(parkSlices, parkFloats, parkMeshFloats(lod));
+        }
+        if (hasFountain) {
+            reserveSlice(fountainSlices, fountainFloats, fountainMeshFloats(lod));
+            reserveSlice(lightSlices, lightFloats, fountainLightsMeshFloats(lod));
+        }
+    }
+    
+    meshArena.reset(FrameArena::bytesFor<Point>(rasterPoints) +
+                    FrameArena::bytesFor<float>(pointFloats) + FrameArena::bytesFor<float>(roadFloats) +
+                    FrameArena::bytesFor<uint32_t>(roadIndices) + FrameArena::bytesFor<float>(parkFloats) +
+                    FrameArena::bytesFor<float>(fountainFloats) + FrameArena::bytesFor<float>(lightFloats));
+    Point* pixels = meshArena.allocate<Point>(rasterPoints);
+    float* points = meshArena.allocate<float>(pointFloats);
+    float* roads = meshArena.allocate<float>(roadFloats);
+    uint32_t* roadIndexData = meshArena.allocate<uint32_t>(roadIndices);
+    float* parks = meshArena.allocate<float>(parkFloats);
+    float* fountain = meshArena.allocate<float>(fountainFloats);
+    float* lights = meshArena.allocate<float>(lightFloats);
+    
+    // One job per object, writing straight into its slices
+    forEach(jobs, objectCount, [&](size_t i) {
+        auto writeInto = [](float* staging, StagingSlice& slice, auto&& write) {
+            MeshSink out(staging + slice.first, slice.capacity);
+            write(out);
+            slice.count = out.floatCount;
+        };
+        // Rasterize into the object's pixel slice, then turn the pixels into 2D points
+        Point* raster = pixels + rasterSlices[i].first;
+        if (i < roadCount) {
+            rasterSlices[i].count = city.roads[i].rasterize(raster);
+        } else {
+            const Circle& circle = i < roadCount + parkCount ? city.parks[i - roadCount] : city.fountain;
+            rasterSlices[i].count = circle.rasterize(raster);
+        }
+        writeInto(points, pointSlices[i], [&](MeshSink& out) {
+            writePointVertices(raster, rasterSlices[i].count, cityExtent, out);
+        });
+        
+        if (i < roadCount) {
+            MeshSink out(roads + roadSlices[i].first, roadSlices[i].capacity,
+                         roadIndexData + roadIndexSlices[i].first, roadIndexSlices[i].capacity);
+            writeRoadMesh(city.roads[i], cityExtent, out);
+            roadSlices[i].count = out.floatCount;
+            roadIndexSlices[i].count = out.indexCount;
+        } else if (i < roadCount + parkCount) {
+            size_t park = i - roadCount;
+            for (int lod = 0; lod < MESH_LOD_LEVELS; lod++) {
+                writeInto(parks, parkSlices[lod * parkCount + park],
+                          [&](MeshSink& out) { writeParkMesh(city.parks[park], cityExtent, lod, out); });
+            }
+        } else {
+            for (int lod = 0; lod < MESH_LOD_LEVELS; lod++) {
+                writeInto(fountain, fountainSlices[lod],
+                          [&](MeshSink& out) { writeFountainMesh(city.fountain, cityExtent, lod, out); });
+                writeInto(lights, lightSlices[lod],
+                          [&](MeshSink& out) { writeFountainLightsMesh(city.fountain, cityExtent, lod, out); });
+            }
+        }
+    });
+    
+    // Close the gaps, then rebase each road's indices onto its first vertex
+    size_t pointCount = compactSlices(points, pointSlices) / 3;
+    size_t roadVertexCount = compactSlices(roads, roadSlices) / 5;
+    size_t roadIndexCount = compactSlices(roadIndexData, roadIndexSlices);
+    size_t parkVertexCount = compactSlices(parks, parkSlices) / 5;
+    size_t fountainVertexCount = compactSlices(fountain, fountainSlices) / 5;
+    size_t lightVertexCount = compactSlices(lights, lightSlices) / 5;
+    forEach(jobs, roadCount, [&](size_t i) {
+        uint32_t base = static_cast<uint32_t>(roadSlices[i].first / 5);
+        uint32_t* indices = roadIndexData + roadIndexSlices[i].first;
+        for (size_t k = 0; k < roadIndexSlices[i].count; k++) indices[k] += base;
+    });
+    
+    // Draw ranges from the final slice positions
+    auto pointsBefore = [&](size_t object) {
+        return static_cast<GLint>(object == objectCount ? pointCount : pointSlices[object].first / 3);
+    };
+    meshes.roadPointRange = {0, pointsBefore(roadCount)};
+    meshes.parkPointRange = {pointsBefore(roadCount), pointsBefore(roadCount + parkCount) - pointsBefore(roadCount)};
+    meshes.fountainPointRange = {pointsBefore(roadCount + parkCount),
+                                 pointsBefore(objectCount) - pointsBefore(roadCount + parkCount)};
+    
+    auto rangeOf = [](const StagingSlice& slice) {
+        return DrawRange{static_cast<GLint>(slice.first / 5), static_cast<GLsizei>(slice.count / 5)};
+    };
+    for (size_t i = 0; i < parkCount; i++) {
+        meshes.parkLods.push_back(makeLodObject(city.parks[i], cityExtent));
+        for (int lod = 0; lod < MESH_LOD_LEVELS; lod++) {
+            meshes.parkLods[i].levels[lod] = rangeOf(parkSlices[lod * parkCount + i]);
+        }
+    }
+    if (hasFountain) {
+        meshes.fountainLod = makeLodObject(city.fountain, cityExtent);
+        meshes.fountainLightsLod = meshes.fountainLod;
+        for (int lod = 0; lod < MESH_LOD_LEVELS; lod++) {
+            meshes.fountainLod.levels[lod] = rangeOf(fountainSlices[lod]);
+            meshes.fountainLightsLod.levels[lod] = rangeOf(lightSlices[lod]);
+        }
+    }
+    
+    // Quantize and pack, one batch per job
+    forEach(jobs, 5, [&](size_t batch) {
+        switch (batch) {
+            case 0: meshes.points = packBatch(points, pointCount, false); break;
+            case 1: meshes.roads = packBatch(roads, roadVertexCount, true, roadIndexData, roadIndexCount); break;
+            case 2: meshes.parks = packBatch(parks, parkVertexCount, true); break;
+            case 3: meshes.fountain = packBatch(fountain, fountainVertexCount, true); break;
+            case 4: meshes.fountainLights = packBatch(lights, lightVertexCount, true); break;
+        }
+    });
+    return meshes;
+}
+
+// Phase two: one upload per buffer, then adopt the draw ranges
+void CityRenderer::uploadCityMeshes(const CityMeshes& meshes) {
+    pointBatch = uploadBatch(meshes.points);
+    road3DBatch = uploadBatch(meshes.roads);
+    park3DBatch = uploadBatch(meshes.parks);
+    fountain3DBatch = uploadBatch(meshes.fountain);
+    fountainLights3DBatch = uploadBatch(meshes.fountainLights);
+    
+    roadPointRange = meshes.roadPointRange;
+    parkPointRange = meshes.parkPointRange;
+    fountainPointRange = meshes.fountainPointRange;
+    parkLods = meshes.parkLods;
+    fountainLod = meshes.fountainLod;
+    fountainLightsLod = meshes.fountainLightsLod;
+}
+
 // Update city rendering data
-void CityRenderer::updateCity(const CityData& city, bool view3D) {
-    // Cleanup old buffers
+void CityRenderer::updateCity(const CityData& city) {
+    CityMeshes meshes;
+    {
+        Profiler::CpuScope cpu(profiler, "updateCity.build");
+        meshes = buildCityMeshes(city, jobSystem, meshArena);
+    }
+    installCity(city, meshes);
+}
+
+struct CityRenderer::PreparedMeshes {
+    CityMeshes meshes;
+};
+
+std::shared_ptr<const CityRenderer::PreparedMeshes> CityRenderer::prepareMeshes(const CityData& city, JobSystem* jobs) {
+    FrameArena arena;
+    auto prepared = std::make_shared<PreparedMeshes>();
+    prepared->meshes = buildCityMeshes(city, jobs, arena);
+    return prepared;
+}
+
+size_t CityRenderer::meshBytes(const PreparedMeshes& prepared) {
+    auto batchBytes = [](const BatchData& batch) {
+        return batch.vertices.size() * sizeof(uint16_t) + batch.shortIndices.size() * sizeof(uint16_t) +
+               batch.indices.size() * sizeof(uint32_t);
+    };
+    const CityMeshes& meshes = prepared.meshes;
+    return batchBytes(meshes.points) + batchBytes(meshes.roads) + batchBytes(meshes.parks) +
+           batchBytes(meshes.fountain) + batchBytes(meshes.fountainLights) + meshes.parkLods.size() * sizeof(LodObject);
+}
+
+// A streamed tile's meshes get batches of their own, so it is freed on its own
+void CityRenderer::addTile(uint32_t key, const PreparedMeshes& prepared) {
+    Profiler::CpuScope cpu(profiler, "updateCity.tile");
+    removeTile(key);
+    
+    const CityMeshes& meshes = prepared.meshes;
+    TileMeshes& tile = tileMeshes[key];
+    tile.points = uploadBatch(meshes.points);
+    tile.roads = uploadBatch(meshes.roads);
+    tile.parks = uploadBatch(meshes.parks);
+    tile.roadPointRange = meshes.roadPointRange;
+    tile.parkPointRange = meshes.parkPointRange;
+    tile.parkLods = meshes.parkLods;
+}
+
+void CityRenderer::removeTile(uint32_t key) {
+    auto it = tileMeshes.find(key);
+    if (it == tileMeshes.end()) return;
+    deleteBatch(it->second.points);
+    deleteBatch(it->second.roads);
+    deleteBatch(it->second.parks);
+    tileMeshes.erase(it);
+}
+
+// Replace every buffer with the city's meshes and buildings
+void CityRenderer::installCity(const CityData& city, const CityMeshes& meshes) {
+    Profiler::CpuScope cpu(profiler, "updateCity.upload");
     cleanup();
+    extent = city.extent;
+    uploadCityMeshes(meshes);
     
-    // Create buffers for roads (2D points)
-    for (const auto& road : city.roads) {
-        auto vertices = pointsToVertices(road.points, screenWidth, screenHeight);
-        auto [vao, vbo] = createBuffer(vertices, false);
-        VAOs.push_back(vao);
-        VBOs.push_back(vbo);
-        vertexCounts.push_back(vertices.size() / 3);
-    }
-    
-    // Create 3D textured road meshes
-    for (const auto& road : city.roads) {
-        auto vertices = roadTo3DMesh(road, screenWidth, screenHeight, view3D);
-        if (!vertices.empty()) {
-            auto [vao, vbo] = createBuffer(vertices, true);
-            road3DVAOs.push_back(vao);
-            road3DVBOs.push_back(vbo);
-            road3DVertexCounts.push_back(vertices.size() / 5);
-        }
-    }
-    
-    // Create buffers for parks (2D points)
-    for (const auto& park : city.parks) {
-        auto vertices = pointsToVertices(park, screenWidth, screenHeight);
-        auto [vao, vbo] = createBuffer(vertices, false);
-        VAOs.push_back(vao);
-        VBOs.push_back(vbo);
-        vertexCounts.push_back(vertices.size() / 3);
-    }
-    
-    // Create 3D textured park meshes
-    for (const auto& park : city.parks) {
-        auto vertices = parkTo3DMesh(park, screenWidth, screenHeight, view3D);
-        if (!vertices.empty()) {
-            auto [vao, vbo] = createBuffer(vertices, true);
-            park3DVAOs.push_back(vao);
-            park3DVBOs.push_back(vbo);
-            park3DVertexCounts.push_back(vertices.size() / 5);
-        }
-    }
-    
-    // Create buffer for fountain (2D points)
-    if (!city.fountain.empty()) {
-        auto vertices = pointsToVertices(city.fountain, screenWidth, screenHeight);
-        auto [vao, vbo] = createBuffer(vertices, false);
-        VAOs.push_back(vao);
-        VBOs.push_back(vbo);
-        vertexCounts.push_back(vertices.size() / 3);
-        
-        // Create 3D textured fountain mesh
-        auto vertices3D = fountainTo3DMesh(city.fountain, screenWidth, screenHeight, view3D);
-        if (!vertices3D.empty()) {
-            auto [vao3d, vbo3d] = createBuffer(vertices3D, true);
-            fountain3DVAO = vao3d;
-            fountain3DVBO = vbo3d;
-            fountain3DVertexCount = vertices3D.size() / 5;
+    // Pack buildings grouped by type, leaving spare slots for placement
+    rebuildBuildings(city.buildings);
+}
+
+// Rebuild the building batch: each type gets a region of fixed-size slots
+// with headroom, so single buildings can later be patched in place
+void CityRenderer::rebuildBuildings(const std::vector<Building>& buildings, const std::vector<uint8_t>* live) {
+    deleteBuildingBatch();
+    auto isLive = [&](size_t i) { return !live || (*live)[i] != 0; };
+    
+    uint32_t typeCounts[3] = {0, 0, 0};
+    for (size_t i = 0; i < buildings.size(); i++) {
+        if (isLive(i)) typeCounts[buildings[i].type]++;
+    }
+    
+    uint32_t totalSlots = 0;
+    for (int type = BuildingType::LOW_RISE; type <= BuildingType::HIGH_RISE; type++) {
+        BuildingRegion& region = buildingRegions[type];
+        region.firstSlot = totalSlots;
+        region.capacity = typeCounts[type] + std::max(typeCounts[type] / 2, MIN_SPARE_BUILDING_SLOTS);
+        region.used = 0;
+        totalSlots += region.capacity;
+    }
+    
+    // Spare slots stay zeroed: a zero-sized box has no area, so spares may
+    // fall inside a draw range
+    std::vector<float> instances(static_cast<size_t>(totalSlots) * BUILDING_INSTANCE_FLOATS, 0.0f);
+    
+    // Within each region, slots are handed out chunk by chunk, so every
+    // chunk starts as one contiguous run per type
+    resetBuildingChunks();
+    std::vector<uint32_t> chunkOf(buildings.size());
+    std::vector<uint32_t> order;
+    order.reserve(buildings.size());
+    for (size_t i = 0; i < buildings.size(); i++) {
+        chunkOf[i] = chunkOfBuilding(buildings[i]);
+        if (isLive(i)) order.push_back(static_cast<uint32_t>(i));
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](uint32_t a, uint32_t b) { return chunkOf[a] < chunkOf[b]; });
+    
+    buildingSlots.assign(buildings.size(), NO_BUILDING);
+    slotBuildings.assign(totalSlots, NO_BUILDING);
+    slotChunks.assign(totalSlots, NO_BUILDING);
+    slotBounds.assign(static_cast<size_t>(totalSlots) * 6, 0.0f);
+    for (uint32_t i : order) {
+        BuildingRegion& region = buildingRegions[buildings[i].type];
+        uint32_t slot = region.firstSlot + region.used++;
+        buildingSlots[i] = slot;
+        slotBuildings[slot] = i;
+        assignSlotChunk(slot, buildings[i]);
+    }
+    forEach(order.size(), [&](size_t k) {
+        uint32_t i = order[k];
+        writeBuildingInstance(buildings[i], instances.data() + static_cast<size_t>(buildingSlots[i]) * BUILDING_INSTANCE_FLOATS);
+    });
+    
+    // One unit box, its index buffer holding every detail level back to back
+    IndexedMesh box = unitBuildingMesh();
+    box.indices.clear();
+    for (int lod = 0; lod < BUILDING_LOD_LEVELS; lod++) {
+        // Only the far level differs by view; the others share one range
+        for (int view = 0; view < BUILDING_FAR_VIEWS; view++) {
+            if (lod < 2 && view > 0) {
+                buildingLodFirst[lod][view] = buildingLodFirst[lod][0];
+                continue;
+            }
+            buildingLodFirst[lod][view] = static_cast<GLint>(box.indices.size());
+            std::vector<uint32_t> lodIndices = buildingLodIndices(lod, view);
+            box.indices.insert(box.indices.end(), lodIndices.begin(), lodIndices.end());
         }
+    }
+    buildingBatch = createIndexedBuffer(box);
+    
+    // Per-instance streams: the packed building fields, then the material layer
+    glBindVertexArray(buildingBatch.VAO);
+    glGenBuffers(1, &buildingInstanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, buildingInstanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(float), instances.data(), GL_DYNAMIC_DRAW);
+    glEnableVertexAttribArray(ShaderManager::BUILDING_INSTANCE_ATTRIBUTE);
+    glEnableVertexAttribArray(ShaderManager::BUILDING_INSTANCE_ATTRIBUTE + 1);
+    glVertexAttribDivisor(ShaderManager::BUILDING_INSTANCE_ATTRIBUTE, 1);
+    glVertexAttribDivisor(ShaderManager::BUILDING_INSTANCE_ATTRIBUTE + 1, 1);
+    
+    glGenBuffers(1, &buildingLayerVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, buildingLayerVBO);
+    glBufferData(GL_ARRAY_BUFFER, totalSlots, nullptr, GL_DYNAMIC_DRAW);
+    glEnableVertexAttribArray(ShaderManager::MATERIAL_LAYER_ATTRIBUTE);
+    glVertexAttribDivisor(ShaderManager::MATERIAL_LAYER_ATTRIBUTE, 1);
+    
+    // Which building each slot holds, so the window lights find its occupancy texel
+    glGenBuffers(1, &buildingIndexVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, buildingIndexVBO);
+    glBufferData(GL_ARRAY_BUFFER, slotBuildings.size() * sizeof(uint32_t), slotBuildings.data(), GL_DYNAMIC_DRAW);
+    glEnableVertexAttribArray(ShaderManager::BUILDING_INDEX_ATTRIBUTE);
+    glVertexAttribDivisor(ShaderManager::BUILDING_INDEX_ATTRIBUTE, 1);
+    
+    buildingInstanceBase = -1;
+    pointBuildingInstances(0);
+    glBindVertexArray(0);
+    
+    syncBuildingRanges();
+    writeBuildingLayers(buildingLayerTheme);
+}
+
+// Release the building batch together with its instance buffers
+void CityRenderer::deleteBuildingBatch() {
+    deleteBatch(buildingBatch);
+    if (buildingInstanceVBO != 0) {
+        glDeleteBuffers(1, &buildingInstanceVBO);
+        glDeleteBuffers(1, &buildingLayerVBO);
+        glDeleteBuffers(1, &buildingIndexVBO);
+        buildingInstanceVBO = 0;
+        buildingLayerVBO = 0;
+        buildingIndexVBO = 0;
+    }
+    buildingInstanceBase = -1;
+}
+
+// Aim the per-instance attributes at a slot (the VAO must be bound). GL 3.3
+// has no base instance, so this is how a draw starts at a later slot
+void CityRenderer::pointBuildingInstances(GLint firstSlot) {
+    if (firstSlot == buildingInstanceBase) return;
+    buildingInstanceBase = firstSlot;
+    
+    size_t stride = BUILDING_INSTANCE_FLOATS * sizeof(float);
+    size_t offset = static_cast<size_t>(firstSlot) * stride;
+    glBindBuffer(GL_ARRAY_BUFFER, buildingInstanceVBO);
+    glVertexAttribPointer(ShaderManager::BUILDING_INSTANCE_ATTRIBUTE, 4, GL_FLOAT, GL_FALSE,
+                          static_cast<GLsizei>(stride), (void*)offset);
+    glVertexAttribPointer(ShaderManager::BUILDING_INSTANCE_ATTRIBUTE + 1, 1, GL_FLOAT, GL_FALSE,
+                          static_cast<GLsizei>(stride), (void*)(offset + 4 * sizeof(float)));
+    glBindBuffer(GL_ARRAY_BUFFER, buildingLayerVBO);
+    glVertexAttribPointer(ShaderManager::MATERIAL_LAYER_ATTRIBUTE, 1, GL_UNSIGNED_BYTE, GL_FALSE,
+                          sizeof(uint8_t), (void*)static_cast<size_t>(firstSlot));
+    glBindBuffer(GL_ARRAY_BUFFER, buildingIndexVBO);
+    glVertexAttribIPointer(ShaderManager::BUILDING_INDEX_ATTRIBUTE, 1, GL_UNSIGNED_INT,
+                           sizeof(uint32_t), (void*)(static_cast<size_t>(firstSlot) * sizeof(uint32_t)));
+}
+
+// Draw a range of building slots at a detail level (the VAO must be bound)
+void CityRenderer::drawBuildingInstances(DrawRange slots, int lod, int view) {
+    if (slots.count == 0) return;
+    pointBuildingInstances(slots.first);
+    glDrawElementsInstanced(GL_TRIANGLES, BUILDING_LOD_INDICES[lod], buildingBatch.indexType,
+                            (void*)(buildingLodFirst[lod][view] * sizeof(uint16_t)), slots.count);
+}
+
+// Material layer of every slot under a theme. Regions hold one type each,
+// so a slot's layer follows from its region, spare slots included
+void CityRenderer::writeBuildingLayers(TextureTheme theme) {
+    buildingLayerTheme = theme;
+    if (buildingLayerVBO == 0) return;
+    
+    uint32_t totalSlots = static_cast<uint32_t>(slotBuildings.size());
+    std::vector<uint8_t> layers(totalSlots);
+    for (int type = BuildingType::LOW_RISE; type <= BuildingType::HIGH_RISE; type++) {
+        const BuildingRegion& region = buildingRegions[type];
+        uint8_t layer = selectBuildingLayer(theme, static_cast<BuildingType>(type));
+        std::fill(layers.begin() + region.firstSlot, layers.begin() + region.firstSlot + region.capacity, layer);
+    }
+    
+    glBindBuffer(GL_ARRAY_BUFFER, buildingLayerVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, layers.size(), layers.data());
+}
+
+// Overwrite one slot's instance record in place
+void CityRenderer::writeBuildingSlot(uint32_t slot, const Building& building) {
+    assignSlotChunk(slot, building);
+    
+    float record[BUILDING_INSTANCE_FLOATS];
+    writeBuildingInstance(building, record);
+    glBindBuffer(GL_ARRAY_BUFFER, buildingInstanceVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, static_cast<size_t>(slot) * sizeof(record), sizeof(record), record);
+}
+
+// Find the type region a slot belongs to
+CityRenderer::BuildingRegion& CityRenderer::regionOfSlot(uint32_t slot) {
+    for (BuildingRegion& region : buildingRegions) {
+        if (slot >= region.firstSlot && slot < region.firstSlot + region.capacity) return region;
+    }
+    return buildingRegions[BuildingType::HIGH_RISE];
+}
+
+// Mirror a run of slot owners into the building index buffer
+void CityRenderer::writeSlotOwners(uint32_t firstSlot, uint32_t count) {
+    if (buildingIndexVBO == 0 || count == 0) return;
+    glBindBuffer(GL_ARRAY_BUFFER, buildingIndexVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, static_cast<size_t>(firstSlot) * sizeof(uint32_t),
+                    static_cast<size_t>(count) * sizeof(uint32_t), slotBuildings.data() + firstSlot);
+}
+
+// Type ranges cover only the used slots of each region
+void CityRenderer::syncBuildingRanges() {
+    for (int type = BuildingType::LOW_RISE; type <= BuildingType::HIGH_RISE; type++) {
+        buildingTypeRanges[type].first = static_cast<GLint>(buildingRegions[type].firstSlot);
+        buildingTypeRanges[type].count = static_cast<GLsizei>(buildingRegions[type].used);
+    }
+}
+
+// Empty chunks covering the city; bounds grow as buildings are assigned
+void CityRenderer::resetBuildingChunks() {
+    chunkColumns = std::max(1, static_cast<int>(std::ceil(extent.width / BUILDING_CHUNK_SIZE)));
+    chunkRows = std::max(1, static_cast<int>(std::ceil(extent.height / BUILDING_CHUNK_SIZE)));
+    buildingChunks.assign(static_cast<size_t>(chunkColumns) * chunkRows, BuildingChunk());
+    for (BuildingChunk& chunk : buildingChunks) {
+        for (int c = 0; c < 3; c++) {
+            chunk.minBounds[c] = std::numeric_limits<float>::max();
+            chunk.maxBounds[c] = -std::numeric_limits<float>::max();
+        }
+    }
+}
+
+// Chunk under a building's center (buildings outside the city clamp to the border)
+uint32_t CityRenderer::chunkOfBuilding(const Building& building) const {
+    int column = std::clamp(static_cast<int>(building.x / BUILDING_CHUNK_SIZE), 0, chunkColumns - 1);
+    int row = std::clamp(static_cast<int>(building.y / BUILDING_CHUNK_SIZE), 0, chunkRows - 1);
+    return static_cast<uint32_t>(row * chunkColumns + column);
+}
+
+// Move a slot into the chunk of the building it now holds
+void CityRenderer::assignSlotChunk(uint32_t slot, const Building& building) {
+    clearSlotChunk(slot);
+    
+    uint32_t chunkIndex = chunkOfBuilding(building);
+    BuildingChunk& chunk = buildingChunks[chunkIndex];
+    chunk.slots[building.type].push_back(slot);
+    chunk.dirty = true;
+    slotChunks[slot] = chunkIndex;
+    
+    float minCorner[3], maxCorner[3];
+    buildingBounds(building, extent, minCorner, maxCorner);
+    float* bounds = slotBounds.data() + static_cast<size_t>(slot) * 6;
+    for (int c = 0; c < 3; c++) {
+        bounds[c] = minCorner[c];
+        bounds[3 + c] = maxCorner[c];
+        chunk.minBounds[c] = std::min(chunk.minBounds[c], minCorner[c]);
+        chunk.maxBounds[c] = std::max(chunk.maxBounds[c], maxCorner[c]);
+        chunk.maxExtent = std::max(chunk.maxExtent, maxCorner[c] - minCorner[c]);
+    }
+}
+
+// Drop a slot from whichever chunk it belongs to
+void CityRenderer::clearSlotChunk(uint32_t slot) {
+    uint32_t chunkIndex = slotChunks[slot];
+    if (chunkIndex == NO_BUILDING) return;
+    
+    BuildingChunk& chunk = buildingChunks[chunkIndex];
+    for (std::vector<uint32_t>& slots : chunk.slots) {
+        auto it = std::find(slots.begin(), slots.end(), slot);
+        if (it != slots.end()) {
+            *it = slots.back();
+            slots.pop_back();
+            break;
+        }
+    }
+    chunk.dirty = true;
+    slotChunks[slot] = NO_BUILDING;
+}
+
+// Append one building into a spare slot
+void CityRenderer::addBuilding(const std::vector<Building>& buildings, size_t index) {
+    addBuildings(buildings, {static_cast<uint32_t>(index)});
+}
+
+// Fill spare slots after each region's used ones, one write per type
+void CityRenderer::addBuildings(const std::vector<Building>& buildings, const std::vector<uint32_t>& indices) {
+    if (buildingSlots.size() < buildings.size()) {
+        buildingSlots.resize(buildings.size(), NO_BUILDING);
+    }
+    
+    // Only indices without a slot can be added, and only into regions with room
+    bool fits = buildingBatch.VAO != 0;
+    uint32_t typeCounts[3] = {0, 0, 0};
+    for (uint32_t index : indices) {
+        if (index >= buildings.size() || buildingSlots[index] != NO_BUILDING) {
+            fits = false;
+            break;
+        }
+        typeCounts[buildings[index].type]++;
+    }
+    for (int type = BuildingType::LOW_RISE; type <= BuildingType::HIGH_RISE && fits; type++) {
+        const BuildingRegion& region = buildingRegions[type];
+        fits = region.used + typeCounts[type] <= region.capacity;
+    }
+    if (!fits) {
+        std::vector<uint8_t> live(buildings.size());
+        for (size_t i = 0; i < buildings.size(); i++) {
+            live[i] = buildingSlots[i] != NO_BUILDING;
+        }
+        for (uint32_t index : indices) {
+            if (index < buildings.size()) live[index] = 1;
+        }
+        rebuildBuildings(buildings, &live);
+        return;
+    }
+    
+    // The new records of each type are contiguous, like their slots
+    uint32_t firstSlot[3], added[3] = {0, 0, 0};
+    size_t firstRecord[3];
+    size_t recordCount = 0;
+    for (int type = BuildingType::LOW_RISE; type <= BuildingType::HIGH_RISE; type++) {
+        firstSlot[type] = buildingRegions[type].firstSlot + buildingRegions[type].used;
+        firstRecord[type] = recordCount;
+        recordCount += typeCounts[type];
+    }
+    std::vector<float> records(recordCount * BUILDING_INSTANCE_FLOATS);
+    for (uint32_t index : indices) {
+        const Building& building = buildings[index];
+        uint32_t slot = firstSlot[building.type] + added[building.type];
+        size_t record = firstRecord[building.type] + added[building.type]++;
+        buildingSlots[index] = slot;
+        slotBuildings[slot] = index;
+        assignSlotChunk(slot, building);
+        writeBuildingInstance(building, records.data() + record * BUILDING_INSTANCE_FLOATS);
+    }
+    
+    size_t stride = BUILDING_INSTANCE_FLOATS * sizeof(float);
+    for (int type = BuildingType::LOW_RISE; type <= BuildingType::HIGH_RISE; type++) {
+        if (typeCounts[type] == 0) continue;
+        glBindBuffer(GL_ARRAY_BUFFER, buildingInstanceVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, firstSlot[type] * stride, typeCounts[type] * stride,
+                        records.data() + firstRecord[type] * BUILDING_INSTANCE_FLOATS);
+        writeSlotOwners(firstSlot[type], typeCounts[type]);
+        buildingRegions[type].used += typeCounts[type];
+    }
+    syncBuildingRanges();
+}
+
+// Free slots, keeping every region dense: its last used slot moves into the hole
+void CityRenderer::removeBuildings(const std::vector<Building>& buildings, const std::vector<uint32_t>& indices) {
+    uint32_t usedBefore[3];
+    for (int type = BuildingType::LOW_RISE; type <= BuildingType::HIGH_RISE; type++) {
+        usedBefore[type] = buildingRegions[type].used;
+    }
+    
+    for (uint32_t index : indices) {
+        if (index >= buildingSlots.size() || buildingSlots[index] == NO_BUILDING) continue;
+        uint32_t slot = buildingSlots[index];
+        buildingSlots[index] = NO_BUILDING;
+        slotBuildings[slot] = NO_BUILDING;
         
-        // Create 3D fountain lights mesh (light bulbs)
-        auto lightVertices = fountainLightsTo3DMesh(city.fountain, screenWidth, screenHeight);
-        if (!lightVertices.empty()) {
-            auto [lightVao, lightVbo] = createBuffer(lightVertices, true);
-            fountainLights3DVAO = lightVao;
-            fountainLights3DVBO = lightVbo;
-            fountainLights3DVertexCount = lightVertices.size() / 5;
+        // Freed slots are compacted at once, so the last used slot always holds a building
+        BuildingRegion& region = regionOfSlot(slot);
+        uint32_t last = region.firstSlot + region.used - 1;
+        if (slot != last) {
+            uint32_t moved = slotBuildings[last];
+            writeBuildingSlot(slot, buildings[moved]);
+            buildingSlots[moved] = slot;
+            slotBuildings[slot] = moved;
+            slotBuildings[last] = NO_BUILDING;
+            writeSlotOwners(slot, 1);
         }
+        clearSlotChunk(last);
+        region.used--;
     }
     
-    // Create buffers for buildings
-    for (const auto& building : city.buildings) {
-        auto vertices = buildingToVertices(building, screenWidth, screenHeight, view3D);
-        auto [vao, vbo] = createBuffer(vertices, true);
-        VAOs.push_back(vao);
-        VBOs.push_back(vbo);
-        vertexCounts.push_back(vertices.size() / 5);
+    // Spare slots must stay empty boxes, since merged draw ranges cover them
+    size_t stride = BUILDING_INSTANCE_FLOATS * sizeof(float);
+    for (int type = BuildingType::LOW_RISE; type <= BuildingType::HIGH_RISE; type++) {
+        const BuildingRegion& region = buildingRegions[type];
+        uint32_t freed = usedBefore[type] - region.used;
+        if (freed == 0) continue;
+        std::vector<float> empty(static_cast<size_t>(freed) * BUILDING_INSTANCE_FLOATS, 0.0f);
+        glBindBuffer(GL_ARRAY_BUFFER, buildingInstanceVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, (region.firstSlot + region.used) * stride, freed * stride, empty.data());
+    }
+    syncBuildingRanges();
+}
+
+// Apply the shader features and texture of one draw item
+void CityRenderer::applyDrawState(const DrawItem& item, ShaderManager& shaderManager) {
+    // All flags at once, so no intermediate permutation is selected
+    shaderManager.setFeatures((item.is2D ? SHADER_MAP_2D : 0u) |
+                              (item.useTexture ? SHADER_TEXTURED : 0u) |
+                              (item.showWindowLights ? SHADER_WINDOW_LIGHTS : 0u) |
+                              (item.materialArray ? SHADER_MATERIAL_ARRAY : 0u) |
+                              (item.pass == DrawPass::BUILDINGS ? SHADER_BUILDING_INSTANCES : SHADER_QUANTIZED));
+    if (item.materialArray) {
+        shaderManager.bindTextureArray(item.texture);
+    } else {
+        shaderManager.bindTexture(item.texture);
+    }
+}
+
+// Fountain light brightness: fades in at sunset, full at night, fades out at sunrise
+float CityRenderer::fountainGlow(float timeOfDay) {
+    if (timeOfDay >= 18.0f && timeOfDay < 20.0f) {
+        return (timeOfDay - 18.0f) / 2.0f;           // Sunset: fade in
+    }
+    if (timeOfDay >= 20.0f || timeOfDay < 4.0f) {
+        return 1.0f;                                 // Full night: full glow
+    }
+    if (timeOfDay >= 4.0f && timeOfDay < 6.0f) {
+        return 1.0f - ((timeOfDay - 4.0f) / 2.0f);   // Sunrise: fade out
     }
+    return 0.0f;
 }
 
 // Render roads
-void CityRenderer::renderRoads(const CityData& city, bool view3D, ShaderManager& shaderManager,
-                                GLuint roadTexture, size_t roadCount) {
+void CityRenderer::renderRoads(bool view3D, ShaderManager& shaderManager) {
     if (view3D) {
-        // In 3D mode: Draw textured road meshes
-        shaderManager.setIs2D(false);
-        shaderManager.setUseTexture(true);
-        glBindTexture(GL_TEXTURE_2D, roadTexture);
-        
-        for (size_t i = 0; i < road3DVAOs.size(); i++) {
-            glBindVertexArray(road3DVAOs[i]);
-            glDrawArrays(GL_TRIANGLES, 0, road3DVertexCounts[i]);
+        // In 3D mode: Draw every textured road mesh in one call (and one per streamed tile)
+        auto drawRoads = [&](const GeometryBatch& batch) {
+            if (batch.drawCount() == 0) return;
+            bindBatch(batch, shaderManager);
+            drawBatchRange(batch, GL_TRIANGLES, {0, batch.drawCount()});
+        };
+        drawRoads(road3DBatch);
+        for (const auto& tile : tileMeshes) {
+            drawRoads(tile.second.roads);
         }
-        
-        shaderManager.setUseTexture(false);
     } else {
         // In 2D mode: Draw roads as bright yellow points
-        shaderManager.setIs2D(true);
         shaderManager.setColor(1.0f, 1.0f, 0.0f);  // Bright yellow
-        glPointSize(2.0f);
-        
-        for (size_t i = 0; i < roadCount && i < VAOs.size(); i++) {
-            glBindVertexArray(VAOs[i]);
-            glDrawArrays(GL_POINTS, 0, vertexCounts[i]);
+        shaderManager.setPointSize(2.0f * pointSizeScale);
+        auto drawPoints = [&](const GeometryBatch& batch, DrawRange range) {
+            if (range.count == 0) return;
+            bindBatch(batch, shaderManager);
+            glDrawArrays(GL_POINTS, range.first, range.count);
+        };
+        drawPoints(pointBatch, roadPointRange);
+        for (const auto& tile : tileMeshes) {
+            drawPoints(tile.second.points, tile.second.roadPointRange);
         }
     }
 }
 
+// One multi-draw with each park at the level for its distance
+void CityRenderer::drawParkLods(const GeometryBatch& batch, const std::vector<LodObject>& lods,
+                                ShaderManager& shaderManager) {
+    multiDrawFirsts.clear();
+    multiDrawCounts.clear();
+    for (const LodObject& park : lods) {
+        DrawRange range = park.levels[lodOf(park)];
+        if (range.count == 0) continue;
+        multiDrawFirsts.push_back(range.first);
+        multiDrawCounts.push_back(range.count);
+    }
+    if (multiDrawCounts.empty()) return;
+    
+    bindBatch(batch, shaderManager);
+    glMultiDrawArrays(GL_TRIANGLES, multiDrawFirsts.data(), multiDrawCounts.data(),
+                      static_cast<GLsizei>(multiDrawCounts.size()));
+}
+
 // Render parks
-void CityRenderer::renderParks(const CityData& city, bool view3D, ShaderManager& shaderManager,
-                                GLuint grassTexture, size_t roadCount, size_t parkCount) {
+void CityRenderer::renderParks(bool view3D, ShaderManager& shaderManager) {
     if (view3D) {
-        // In 3D mode: Draw textured grass-filled park meshes
-        shaderManager.setIs2D(false);
-        shaderManager.setUseTexture(true);
-        
-        if (grassTexture != 0) {
-            glBindTexture(GL_TEXTURE_2D, grassTexture);
-        } else {
-            // Fallback: use color if texture not loaded
-            shaderManager.setUseTexture(false);
-            shaderManager.setColor(0.2f, 0.8f, 0.3f);
-        }
-        
-        for (size_t i = 0; i < park3DVAOs.size(); i++) {
-            glBindVertexArray(park3DVAOs[i]);
-            glDrawArrays(GL_TRIANGLES, 0, park3DVertexCounts[i]);
+        // Fallback: use color if texture not loaded (useTexture is off then)
+        shaderManager.setColor(0.2f, 0.8f, 0.3f);
+        drawParkLods(park3DBatch, parkLods, shaderManager);
+        for (const auto& tile : tileMeshes) {
+            drawParkLods(tile.second.parks, tile.second.parkLods, shaderManager);
         }
-        
-        shaderManager.setUseTexture(false);
     } else {
         // In 2D mode: Draw parks as bright green points
-        shaderManager.setIs2D(true);
         shaderManager.setColor(0.0f, 1.0f, 0.0f);  // Bright lime green
-        
-        size_t fountainOffset = roadCount + parkCount;
-        for (size_t i = roadCount; i < fountainOffset && i < VAOs.size(); i++) {
-            glBindVertexArray(VAOs[i]);
-            glDrawArrays(GL_POINTS, 0, vertexCounts[i]);
+        shaderManager.setPointSize(2.0f * pointSizeScale);
+        auto drawPoints = [&](const GeometryBatch& batch, DrawRange range) {
+            if (range.count == 0) return;
+            bindBatch(batch, shaderManager);
+            glDrawArrays(GL_POINTS, range.first, range.count);
+        };
+        drawPoints(pointBatch, parkPointRange);
+        for (const auto& tile : tileMeshes) {
+            drawPoints(tile.second.points, tile.second.parkPointRange);
         }
     }
 }
 
 // Render fountain
-void CityRenderer::renderFountain(const CityData& city, bool view3D, ShaderManager& shaderManager,
-                                   GLuint fountainTexture, size_t fountainOffset, size_t fountainCount, float timeOfDay) {
+void CityRenderer::renderFountain(bool view3D, ShaderManager& shaderManager) {
     if (view3D) {
-        // In 3D mode: Draw textured fountain mesh with nighttime lighting
-        shaderManager.setIs2D(false);
-        
-        // Calculate if it's nighttime (18:00-6:00)
-        bool isNight = (timeOfDay >= 18.0f || timeOfDay < 6.0f);
-        
-        // Calculate glow intensity based on time
-        float glowIntensity = 0.0f;
-        if (isNight) {
-            // Smooth transition during sunset (18:00-20:00) and sunrise (4:00-6:00)
-            if (timeOfDay >= 18.0f && timeOfDay < 20.0f) {
-                // Sunset: fade in
-                glowIntensity = (timeOfDay - 18.0f) / 2.0f;
-            } else if (timeOfDay >= 20.0f || timeOfDay < 4.0f) {
-                // Full night: full glow
-                glowIntensity = 1.0f;
-            } else if (timeOfDay >= 4.0f && timeOfDay < 6.0f) {
-                // Sunrise: fade out
-                glowIntensity = 1.0f - ((timeOfDay - 4.0f) / 2.0f);
+        // In 3D mode: Draw the textured fountain structure
+        DrawRange fountainRange = fountainLod.levels[lodOf(fountainLod)];
+        bindBatch(fountain3DBatch, shaderManager);
+        glDrawArrays(GL_TRIANGLES, fountainRange.first, fountainRange.count);
+    } else {
+        // In 2D mode: Draw fountain as bright cyan points
+        shaderManager.setColor(0.0f, 1.0f, 1.0f);  // Bright cyan
+        shaderManager.setPointSize(2.0f * pointSizeScale);
+        bindBatch(pointBatch, shaderManager);
+        glDrawArrays(GL_POINTS, fountainPointRange.first, fountainPointRange.count);
+    }
+}
+
+// Render the fountain's light bulbs at night
+void CityRenderer::renderFountainLights(ShaderManager& shaderManager, float glowIntensity) {
+    DrawRange lightRange = fountainLightsLod.levels[lodOf(fountainLightsLod)];
+    
+    // Enable additive blending for glowing effect
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE);  // Additive blending
+    glDepthMask(GL_FALSE);  // Don't write to depth buffer
+    
+    // Warm white color for lights (like LED bulbs)
+    // Compensate for night ambient dimming by making it VERY bright
+    float warmR = 4.0f * glowIntensity;  // Bright warm white red
+    float warmG = 3.5f * glowIntensity;  // Slightly less green for warmth
+    float warmB = 2.5f * glowIntensity;  // Even less blue for warm tone
+    shaderManager.setColor(warmR, warmG, warmB);
+    
+    // Render the light bulb spheres
+    bindBatch(fountainLights3DBatch, shaderManager);
+    glDrawArrays(GL_TRIANGLES, lightRange.first, lightRange.count);
+    
+    glDepthMask(GL_TRUE);  // Re-enable depth writes
+    glDisable(GL_BLEND);
+}
+
+// Select material based on BOTH building type AND texture theme
+uint8_t CityRenderer::selectBuildingLayer(TextureTheme theme, BuildingType type) {
+    switch (theme) {
+        case TextureTheme::MODERN:
+            // Modern: Glass dominant, some concrete
+            switch (type) {
+                case BuildingType::LOW_RISE:  return MATERIAL_BRICK;
+                case BuildingType::MID_RISE:  return MATERIAL_CONCRETE;
+                case BuildingType::HIGH_RISE: return MATERIAL_GLASS;
             }
-        }
-        
-        if (fountain3DVertexCount > 0) {
-            // Always render the fountain structure with texture
-            shaderManager.setUseTexture(true);
-            if (fountainTexture != 0) {
-                glBindTexture(GL_TEXTURE_2D, fountainTexture);
+            break;
+            
+        case TextureTheme::CLASSIC:
+            // Classic: Brick dominant, traditional materials
+            switch (type) {
+                case BuildingType::LOW_RISE:  return MATERIAL_BRICK;
+                case BuildingType::MID_RISE:  return MATERIAL_BRICK;     // More brick!
+                case BuildingType::HIGH_RISE: return MATERIAL_CONCRETE;  // Less glass
             }
-            glBindVertexArray(fountain3DVAO);
-            glDrawArrays(GL_TRIANGLES, 0, fountain3DVertexCount);
+            break;
             
-            // Render light bulbs at night
-            if (glowIntensity > 0.0f && fountainLights3DVertexCount > 0) {
-                // Enable additive blending for glowing effect
-                glEnable(GL_BLEND);
-                glBlendFunc(GL_SRC_ALPHA, GL_ONE);  // Additive blending
-                glDepthMask(GL_FALSE);  // Don't write to depth buffer
-                
-                shaderManager.setUseTexture(false);
-                
-                // Warm white color for lights (like LED bulbs)
-                // Compensate for night ambient dimming by making it VERY bright
-                float warmR = 4.0f * glowIntensity;  // Bright warm white red
-                float warmG = 3.5f * glowIntensity;  // Slightly less green for warmth
-                float warmB = 2.5f * glowIntensity;  // Even less blue for warm tone
-                shaderManager.setColor(warmR, warmG, warmB);
-                
-                // Render the light bulb spheres
-                glBindVertexArray(fountainLights3DVAO);
-                glDrawArrays(GL_TRIANGLES, 0, fountainLights3DVertexCount);
+        case TextureTheme::INDUSTRIAL:
+            // Industrial: Concrete/metal dominant, minimal glass
+            return MATERIAL_CONCRETE;
+            
+        case TextureTheme::FUTURISTIC:
+            // Futuristic: Glass everywhere, even low buildings
+            return MATERIAL_GLASS;
+    }
+    return MATERIAL_CONCRETE;
+}
+
+// Store this frame's camera for culling and detail selection
+void CityRenderer::setCamera(const float* viewProjection, float eyeX, float eyeY, float eyeZ) {
+    frustum = Frustum::fromMatrix(viewProjection);
+    std::copy(viewProjection, viewProjection + 16, cameraViewProjection);
+    cameraEye[0] = eyeX;
+    cameraEye[1] = eyeY;
+    cameraEye[2] = eyeZ;
+    occlusionStale = true;
+}
+
+// World-space circle of a park or fountain, for distance tests
+CityRenderer::LodObject CityRenderer::makeLodObject(const Circle& circle, const WorldExtent& extent) {
+    LodObject object;
+    object.x = extent.toRenderX(circle.x);
+    object.z = extent.toRenderZ(circle.y);
+    object.radius = extent.scaleZ(circle.radius);
+    return object;
+}
+
+// Level from the camera's distance to the nearest point of the circle
+int CityRenderer::lodOf(const LodObject& object) const {
+    float dx = cameraEye[0] - object.x;
+    float dz = cameraEye[2] - object.z;
+    float horizontal = std::max(0.0f, std::sqrt(dx * dx + dz * dz) - object.radius);
+    float distance = std::sqrt(horizontal * horizontal + cameraEye[1] * cameraEye[1]);
+    
+    int lod = 0;
+    while (lod < MESH_LOD_LEVELS - 1 && distance > LOD_DISTANCES[lod] * lodDistanceScale) {
+        lod++;
+    }
+    return lod;
+}
+
+// Rasterize the buildings that cover the most of the view as occluders
+bool CityRenderer::updateOcclusion() {
+    if (!occlusionEnabled) return false;
+    if (!occlusionStale) return occlusion.hasOccluders();
+    occlusionStale = false;
+    
+    Profiler::CpuScope scope(profiler, "render.occlusion");
+    
+    // Score by the area of a facade over the squared distance to the eye
+    occluderCandidates.clear();
+    for (const BuildingChunk& chunk : buildingChunks) {
+        if (!frustum.intersectsBox(chunk.minBounds, chunk.maxBounds)) continue;
+        for (const std::vector<uint32_t>& slots : chunk.slots) {
+            for (uint32_t slot : slots) {
+                const float* bounds = slotBounds.data() + static_cast<size_t>(slot) * 6;
+                float distanceSquared = 0.0f;
+                for (int c = 0; c < 3; c++) {
+                    float d = std::max({bounds[c] - cameraEye[c], 0.0f, cameraEye[c] - bounds[3 + c]});
+                    distanceSquared += d * d;
+                }
+                if (distanceSquared == 0.0f) continue;  // The eye is inside this building
                 
-                glDepthMask(GL_TRUE);  // Re-enable depth writes
-                glDisable(GL_BLEND);
+                float height = bounds[4] - bounds[1];
+                float breadth = std::max(bounds[3] - bounds[0], bounds[5] - bounds[2]);
+                float score = height * breadth / distanceSquared;
+                if (score < MIN_OCCLUDER_ANGULAR_SIZE * MIN_OCCLUDER_ANGULAR_SIZE) continue;
+                occluderCandidates.push_back({score, slot});
             }
         }
-        
-        shaderManager.setUseTexture(false);
-    } else {
-        // In 2D mode: Draw fountain as bright cyan points
-        shaderManager.setIs2D(true);
-        if (fountainCount > 0 && fountainOffset < VAOs.size()) {
-            shaderManager.setColor(0.0f, 1.0f, 1.0f);  // Bright cyan
-            glBindVertexArray(VAOs[fountainOffset]);
-            glDrawArrays(GL_POINTS, 0, vertexCounts[fountainOffset]);
+    }
+    if (occluderCandidates.size() > MAX_OCCLUDERS) {
+        std::nth_element(occluderCandidates.begin(), occluderCandidates.begin() + MAX_OCCLUDERS,
+                         occluderCandidates.end(),
+                         [](const std::pair<float, uint32_t>& a, const std::pair<float, uint32_t>& b) {
+                             return a.first > b.first;
+                         });
+        occluderCandidates.resize(MAX_OCCLUDERS);
+    }
+    
+    occlusion.begin(cameraViewProjection, cameraEye);
+    for (const std::pair<float, uint32_t>& candidate : occluderCandidates) {
+        const float* bounds = slotBounds.data() + static_cast<size_t>(candidate.second) * 6;
+        const float minCorner[3] = {bounds[0], bounds[1], bounds[2]};
+        const float maxCorner[3] = {bounds[3], bounds[4], bounds[5]};
+        if (frustum.intersectsBox(minCorner, maxCorner)) {
+            occlusion.addOccluder(minCorner, maxCorner);
         }
     }
+    occlusion.finish();
+    return occlusion.hasOccluders();
 }
 
-// Render buildings
-void CityRenderer::renderBuildings(const CityData& city, const CityConfig& config, bool view3D, ShaderManager& shaderManager,
-                                    GLuint brickTexture, GLuint concreteTexture, GLuint glassTexture,
-                                    size_t buildingStart) {
-    shaderManager.setIs2D(false);
+// Instanced draws of the slot runs of every chunk that intersects the frustum
+// and is not hidden behind the occluders
+void CityRenderer::drawVisibleBuildings(int firstType, int lastType) {
+    for (auto& level : visibleBuildingRuns) {
+        for (std::vector<DrawRange>& runs : level) runs.clear();
+    }
+    bool occlusionActive = updateOcclusion();
+    chunkVisibility.assign(buildingChunks.size(), 0);
     
-    if (view3D) {
-        // Use textures in 3D mode based on texture theme
-        shaderManager.setUseTexture(true);
-        shaderManager.setShowWindowLights(true);  // Enable window lights in 3D
-        
-        for (size_t i = buildingStart; i < VAOs.size(); i++) {
-            size_t buildingIndex = i - buildingStart;
-            if (buildingIndex < city.buildings.size()) {
-                const Building& building = city.buildings[buildingIndex];
-                
-                // Select texture based on BOTH building type AND texture theme
-                GLuint selectedTexture;
-                
-                switch (config.textureTheme) {
-                    case TextureTheme::MODERN:
-                        // Modern: Glass dominant, some concrete
-                        switch (building.type) {
-                            case BuildingType::LOW_RISE:
-                                selectedTexture = brickTexture;
-                                break;
-                            case BuildingType::MID_RISE:
-                                selectedTexture = concreteTexture;
-                                break;
-                            case BuildingType::HIGH_RISE:
-                                selectedTexture = glassTexture;
-                                break;
-                        }
-                        break;
-                        
-                    case TextureTheme::CLASSIC:
-                        // Classic: Brick dominant, traditional materials
-                        switch (building.type) {
-                            case BuildingType::LOW_RISE:
-                                selectedTexture = brickTexture;
-                                break;
-                            case BuildingType::MID_RISE:
-                                selectedTexture = brickTexture;  // More brick!
-                                break;
-                            case BuildingType::HIGH_RISE:
-                                selectedTexture = concreteTexture;  // Less glass
-                                break;
-                        }
-                        break;
-                        
-                    case TextureTheme::INDUSTRIAL:
-                        // Industrial: Concrete/metal dominant
-                        switch (building.type) {
-                            case BuildingType::LOW_RISE:
-                                selectedTexture = concreteTexture;  // Industrial materials
-                                break;
-                            case BuildingType::MID_RISE:
-                                selectedTexture = concreteTexture;
-                                break;
-                            case BuildingType::HIGH_RISE:
-                                selectedTexture = concreteTexture;  // Minimal glass
-                                break;
-                        }
-                        break;
-                        
-                    case TextureTheme::FUTURISTIC:
-                        // Futuristic: Glass everywhere
-                        switch (building.type) {
-                            case BuildingType::LOW_RISE:
-                                selectedTexture = glassTexture;  // Even low buildings are glass
-                                break;
-                            case BuildingType::MID_RISE:
-                                selectedTexture = glassTexture;
-                                break;
-                            case BuildingType::HIGH_RISE:
-                                selectedTexture = glassTexture;
-                                break;
+    // Ground faces face down, so they are hidden whenever the eye is above ground
+    int nearLod = cameraEye[1] > 0.0f ? 1 : 0;
+    float farDistance = LOD_DISTANCES[0] * lodDistanceScale;
+    bool anyRuns = false;
+    
+    for (int type = firstType; type <= lastType; type++) {
+        for (BuildingChunk& chunk : buildingChunks) {
+            if (chunk.slots[type].empty() || !frustum.intersectsBox(chunk.minBounds, chunk.maxBounds)) {
+                continue;
+            }
+            
+            // Skip chunks whose buildings would all be smaller than a pixel (or the governor's larger angle)
+            float distanceSquared = 0.0f;
+            for (int c = 0; c < 3; c++) {
+                float d = std::max({chunk.minBounds[c] - cameraEye[c], 0.0f, cameraEye[c] - chunk.maxBounds[c]});
+                distanceSquared += d * d;
+            }
+            float limit = chunk.maxExtent / (MIN_BUILDING_ANGULAR_SIZE * cullAngleScale);
+            if (distanceSquared > limit * limit) continue;
+            
+            // Each chunk is tested once, whichever type reaches it first
+            if (occlusionActive) {
+                uint8_t& visibility = chunkVisibility[&chunk - buildingChunks.data()];
+                if (visibility == 0) visibility = occlusion.isBoxVisible(chunk.minBounds, chunk.maxBounds) ? 1 : 2;
+                if (visibility == 2) continue;
+            }
+            
+            if (chunk.dirty) {
+                // Rebuild every type's runs: sort the slots, merge neighbours
+                for (int t = 0; t < 3; t++) {
+                    std::vector<uint32_t>& slots = chunk.slots[t];
+                    std::sort(slots.begin(), slots.end());
+                    chunk.runs[t].clear();
+                    for (uint32_t slot : slots) {
+                        GLint first = static_cast<GLint>(slot);
+                        if (!chunk.runs[t].empty() &&
+                            chunk.runs[t].back().first + chunk.runs[t].back().count == first) {
+                            chunk.runs[t].back().count++;
+                        } else {
+                            chunk.runs[t].push_back({first, 1});
                         }
-                        break;
+                    }
                 }
-                
-                glBindTexture(GL_TEXTURE_2D, selectedTexture);
-                glBindVertexArray(VAOs[i]);
-                glDrawArrays(GL_TRIANGLES, 0, vertexCounts[i]);
+                chunk.dirty = false;
+            }
+            
+            // Far chunks off the eye's position on both axes show every box
+            // from one side: the roof and the two walls facing the eye
+            int lod = nearLod;
+            int view = 0;
+            bool besideX = cameraEye[0] >= chunk.minBounds[0] && cameraEye[0] <= chunk.maxBounds[0];
+            bool besideZ = cameraEye[2] >= chunk.minBounds[2] && cameraEye[2] <= chunk.maxBounds[2];
+            if (nearLod == 1 && !besideX && !besideZ && distanceSquared > farDistance * farDistance) {
+                lod = 2;
+                view = (cameraEye[0] > chunk.maxBounds[0] ? 1 : 0) | (cameraEye[2] > chunk.maxBounds[2] ? 2 : 0);
             }
+            
+            std::vector<DrawRange>& runs = visibleBuildingRuns[lod][view];
+            runs.insert(runs.end(), chunk.runs[type].begin(), chunk.runs[type].end());
+            anyRuns = true;
         }
-    } else {
-        // Use colors in 2D mode
-        shaderManager.setUseTexture(false);
-        shaderManager.setShowWindowLights(false);  // No window lights in 2D
-        
-        for (size_t i = buildingStart; i < VAOs.size(); i++) {
-            size_t buildingIndex = i - buildingStart;
-            if (buildingIndex < city.buildings.size()) {
-                const Building& building = city.buildings[buildingIndex];
-                
-                // Set bright color based on building type
-                switch (building.type) {
-                    case BuildingType::LOW_RISE:
-                        shaderManager.setColor(1.0f, 0.4f, 0.2f);  // Bright orange-red
-                        break;
-                    case BuildingType::MID_RISE:
-                        shaderManager.setColor(0.9f, 0.9f, 0.9f);  // Bright white-gray
-                        break;
-                    case BuildingType::HIGH_RISE:
-                        shaderManager.setColor(0.3f, 0.8f, 1.0f);  // Bright sky blue
-                        break;
+    }
+    if (!anyRuns) return;
+    
+    for (auto& level : visibleBuildingRuns) {
+        for (std::vector<DrawRange>& runs : level) {
+            std::sort(runs.begin(), runs.end(),
+                      [](const DrawRange& a, const DrawRange& b) { return a.first < b.first; });
+        }
+    }
+    if (multiDrawElementsIndirect) {
+        submitBuildingCommands();
+        return;
+    }
+    
+    // In slot order, runs of one level close together (across chunks and
+    // type regions) become one instanced draw; a fully visible city near
+    // the eye is a single call
+    for (int lod = 0; lod < BUILDING_LOD_LEVELS; lod++) {
+        for (int view = 0; view < BUILDING_FAR_VIEWS; view++) {
+            const std::vector<DrawRange>& runs = visibleBuildingRuns[lod][view];
+            if (runs.empty()) continue;
+            
+            DrawRange range = runs.front();
+            for (size_t i = 1; i < runs.size(); i++) {
+                const DrawRange& run = runs[i];
+                if (run.first - (range.first + range.count) <= MAX_BUILDING_RUN_GAP) {
+                    range.count = run.first + run.count - range.first;
+                } else {
+                    drawBuildingInstances(range, lod, view);
+                    range = run;
                 }
-                
-                glBindVertexArray(VAOs[i]);
-                glDrawArrays(GL_TRIANGLES, 0, vertexCounts[i]);
             }
+            drawBuildingInstances(range, lod, view);
         }
     }
 }
 
-// Main render function
-void CityRenderer::render(const CityData& city, const CityConfig& config, bool view3D, ShaderManager& shaderManager,
-                          GLuint brickTexture, GLuint concreteTexture, GLuint glassTexture,
-                          GLuint roadTexture, GLuint grassTexture, GLuint fountainTexture) {
-    if (!isReady()) return;
+// One command per visible run in a single call: a command costs next to
+// nothing, so runs merge only where they touch and no hidden box is drawn
+void CityRenderer::submitBuildingCommands() {
+    buildingCommands.clear();
+    for (int lod = 0; lod < BUILDING_LOD_LEVELS; lod++) {
+        for (int view = 0; view < BUILDING_FAR_VIEWS; view++) {
+            bool firstRun = true;
+            for (const DrawRange& run : visibleBuildingRuns[lod][view]) {
+                if (!firstRun) {
+                    DrawElementsCommand& last = buildingCommands.back();
+                    if (static_cast<GLint>(last.baseInstance + last.instanceCount) == run.first) {
+                        last.instanceCount += static_cast<GLuint>(run.count);
+                        continue;
+                    }
+                }
+                firstRun = false;
+                buildingCommands.push_back({static_cast<GLuint>(BUILDING_LOD_INDICES[lod]),
+                                            static_cast<GLuint>(run.count),
+                                            static_cast<GLuint>(buildingLodFirst[lod][view]), 0,
+                                            static_cast<GLuint>(run.first)});
+            }
+        }
+    }
     
-    size_t roadCount = city.roads.size();
-    size_t parkCount = city.parks.size();
-    size_t fountainOffset = roadCount + parkCount;
-    size_t fountainCount = city.fountain.empty() ? 0 : 1;
-    size_t buildingStart = fountainOffset + fountainCount;
+    // The commands change every frame the camera moves: respecify the buffer with them
+    if (buildingCommandBuffer == 0) {
+        glGenBuffers(1, &buildingCommandBuffer);
+    }
+    glBindBuffer(DRAW_INDIRECT_BUFFER, buildingCommandBuffer);
+    glBufferData(DRAW_INDIRECT_BUFFER, buildingCommands.size() * sizeof(DrawElementsCommand),
+                 buildingCommands.data(), GL_STREAM_DRAW);
     
-    // Render each city element
-    renderRoads(city, view3D, shaderManager, roadTexture, roadCount);
-    renderParks(city, view3D, shaderManager, grassTexture, roadCount, parkCount);
-    renderFountain(city, view3D, shaderManager, fountainTexture, fountainOffset, fountainCount, config.timeOfDay);
-    renderBuildings(city, config, view3D, shaderManager, brickTexture, concreteTexture, glassTexture, buildingStart);
+    // Base instances count from slot 0
+    pointBuildingInstances(0);
+    multiDrawElementsIndirect(GL_TRIANGLES, buildingBatch.indexType, nullptr,
+                              static_cast<GLsizei>(buildingCommands.size()), 0);
+    glBindBuffer(DRAW_INDIRECT_BUFFER, 0);
 }
 
-// Update traffic rendering buffers
-void CityRenderer::updateTraffic(const TrafficData& trafficData, bool view3D) {
-    // Clear old traffic buffers
-    if (!traffic3DVAOs.empty()) {
-        glDeleteVertexArrays(traffic3DVAOs.size(), traffic3DVAOs.data());
-        glDeleteBuffers(traffic3DVBOs.size(), traffic3DVBOs.data());
-        traffic3DVAOs.clear();
-        traffic3DVBOs.clear();
-        traffic3DVertexCounts.clear();
-    }
-    if (!trafficVAOs.empty()) {
-        glDeleteVertexArrays(trafficVAOs.size(), trafficVAOs.data());
-        glDeleteBuffers(trafficVBOs.size(), trafficVBOs.data());
-        trafficVAOs.clear();
-        trafficVBOs.clear();
-        trafficVertexCounts.clear();
+// Render buildings
+void CityRenderer::renderBuildings(const CityConfig& config, bool view3D, ShaderManager& shaderManager) {
+    // Each vertex carries its material layer, so a theme change only
+    // rewrites the layer buffer
+    if (config.textureTheme != buildingLayerTheme) {
+        writeBuildingLayers(config.textureTheme);
     }
+    glBindVertexArray(buildingBatch.VAO);
     
     if (view3D) {
-        // Generate 3D meshes for each car
-        for (const Car& car : trafficData.cars) {
-            std::vector<float> vertices = carTo3DMesh(car, screenWidth, screenHeight);
-            if (!vertices.empty()) {
-                auto [vao, vbo] = createBuffer(vertices, true);
-                traffic3DVAOs.push_back(vao);
-                traffic3DVBOs.push_back(vbo);
-                traffic3DVertexCounts.push_back(vertices.size() / 5);
-            }
-        }
+        // One multi-draw for every type, only chunks inside the camera frustum
+        drawVisibleBuildings(BuildingType::LOW_RISE, BuildingType::HIGH_RISE);
     } else {
-        // Generate 2D points for each car
-        for (const Car& car : trafficData.cars) {
-            std::vector<float> vertices = carTo2DVertices(car, screenWidth, screenHeight);
-            if (!vertices.empty()) {
-                auto [vao, vbo] = createBuffer(vertices, false);
-                trafficVAOs.push_back(vao);
-                trafficVBOs.push_back(vbo);
-                trafficVertexCounts.push_back(1); // One point per car
+        // Set bright color based on building type
+        const float typeColors[3][3] = {
+            {1.0f, 0.4f, 0.2f},  // LOW_RISE: Bright orange-red
+            {0.9f, 0.9f, 0.9f},  // MID_RISE: Bright white-gray
+            {0.3f, 0.8f, 1.0f}   // HIGH_RISE: Bright sky blue
+        };
+        
+        for (int type = BuildingType::LOW_RISE; type <= BuildingType::HIGH_RISE; type++) {
+            if (buildingTypeRanges[type].count == 0) continue;
+            shaderManager.setColor(typeColors[type][0], typeColors[type][1], typeColors[type][2]);
+            drawBuildingInstances(buildingTypeRanges[type], 0);
+        }
+    }
+}
+
+// Main render function
+void CityRenderer::render(const CityConfig& config, bool view3D, ShaderManager& shaderManager,
+                          GLuint materialArray, GLuint roadTexture, GLuint grassTexture, GLuint fountainTexture) {
+    if (!isReady()) return;
+    occlusionEnabled = config.occlusionCulling;
+    lodDistanceScale = config.lodDistanceScale;
+    cullAngleScale = config.cullAngleScale;
+    pointSizeScale = config.pointSizeScale;
+    
+    // Collect the non-empty passes with the state each one draws with.
+    // Textured 3D passes show window lights only on buildings; the 2D map
+    // is untextured, its points drawn directly in map space
+    drawItems.clear();
+    bool is2DPoints = !view3D;
+    float glowIntensity = fountainGlow(config.timeOfDay);
+    
+    bool hasRoads = view3D ? road3DBatch.drawCount() > 0 : roadPointRange.count > 0;
+    bool hasParks = view3D ? park3DBatch.vertexCount > 0 : parkPointRange.count > 0;
+    for (const auto& tile : tileMeshes) {
+        hasRoads = hasRoads || (view3D ? tile.second.roads.drawCount() > 0 : tile.second.roadPointRange.count > 0);
+        hasParks = hasParks || (view3D ? tile.second.parks.vertexCount > 0 : tile.second.parkPointRange.count > 0);
+    }
+    if (hasRoads) {
+        drawItems.push_back({DrawPass::ROADS, is2DPoints, view3D, false, false, false, view3D ? roadTexture : 0});
+    }
+    if (hasParks) {
+        bool textured = view3D && grassTexture != 0;
+        drawItems.push_back({DrawPass::PARKS, is2DPoints, textured, false, false, false, textured ? grassTexture : 0});
+    }
+    if (view3D ? fountain3DBatch.vertexCount > 0 : fountainPointRange.count > 0) {
+        drawItems.push_back({DrawPass::FOUNTAIN, is2DPoints, view3D, false, false, false, view3D ? fountainTexture : 0});
+    }
+    if (view3D && fountain3DBatch.vertexCount > 0 && glowIntensity > 0.0f &&
+        fountainLightsLod.levels[lodOf(fountainLightsLod)].count > 0) {
+        drawItems.push_back({DrawPass::FOUNTAIN_LIGHTS, false, false, false, false, true, 0});
+    }
+    if (buildingTypeRanges[BuildingType::LOW_RISE].count > 0 || buildingTypeRanges[BuildingType::MID_RISE].count > 0 ||
+        buildingTypeRanges[BuildingType::HIGH_RISE].count > 0) {
+        drawItems.push_back({DrawPass::BUILDINGS, false, view3D, view3D, view3D, false,
+                             view3D ? materialArray : 0});
+    }
+    
+    // Group equal state together; stable, so equal items keep the order above
+    std::stable_sort(drawItems.begin(), drawItems.end(), [](const DrawItem& a, const DrawItem& b) {
+        if (a.stateKey() != b.stateKey()) return a.stateKey() < b.stateKey();
+        return a.texture < b.texture;
+    });
+    
+    for (const DrawItem& item : drawItems) {
+        applyDrawState(item, shaderManager);
+        
+        switch (item.pass) {
+            case DrawPass::ROADS: {
+                Profiler::CpuScope cpu(profiler, "render.roads");
+                Profiler::GpuScope gpu(profiler, "render.roads");
+                renderRoads(view3D, shaderManager);
+                break;
+            }
+            case DrawPass::PARKS: {
+                Profiler::CpuScope cpu(profiler, "render.parks");
+                Profiler::GpuScope gpu(profiler, "render.parks");
+                renderParks(view3D, shaderManager);
+                break;
+            }
+            case DrawPass::FOUNTAIN: {
+                Profiler::CpuScope cpu(profiler, "render.fountain");
+                Profiler::GpuScope gpu(profiler, "render.fountain");
+                renderFountain(view3D, shaderManager);
+                break;
+            }
+            case DrawPass::FOUNTAIN_LIGHTS: {
+                Profiler::CpuScope cpu(profiler, "render.fountain");
+                Profiler::GpuScope gpu(profiler, "render.fountainLights");
+                renderFountainLights(shaderManager, glowIntensity);
+                break;
+            }
+            case DrawPass::BUILDINGS: {
+                Profiler::CpuScope cpu(profiler, "render.buildings");
+                Profiler::GpuScope gpu(profiler, "render.buildings");
+                renderBuildings(config, view3D, shaderManager);
+                break;
             }
         }
     }
 }
 
+// Update traffic rendering buffers
+void CityRenderer::updateTraffic(const TrafficData& trafficData, float alpha) {
+    size_t carCount = trafficData.size();
+    if (carCount == 0) {
+        cleanupTraffic();
+        return;
+    }
+    
+    // Reallocate only when the car count changes
+    bool reallocated = false;
+    if (trafficVAO == 0 || carCount != trafficCarCapacity) {
+        allocateTrafficBuffer(carCount);
+        reallocated = true;
+    }
+    
+    // Rewrite each instance record in place and track the range that changed
+    size_t firstDirty = carCount;
+    size_t lastDirty = 0;
+    float record[CAR_INSTANCE_FLOATS];
+    
+    for (size_t i = 0; i < carCount; i++) {
+        writeCarInstance(trafficData, i, alpha, extent, record);
+        
+        float* slot = trafficStaging.data() + i * CAR_INSTANCE_FLOATS;
+        if (reallocated || std::memcmp(slot, record, sizeof(record)) != 0) {
+            std::memcpy(slot, record, sizeof(record));
+            firstDirty = std::min(firstDirty, i);
+            lastDirty = i;
+        }
+    }
+    
+    if (firstDirty > lastDirty) return;  // Nothing moved this frame
+    
+    size_t byteOffset = firstDirty * CAR_INSTANCE_FLOATS * sizeof(float);
+    size_t byteSize = (lastDirty - firstDirty + 1) * CAR_INSTANCE_FLOATS * sizeof(float);
+    glBindBuffer(GL_ARRAY_BUFFER, trafficInstanceVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, byteOffset, byteSize,
+                    trafficStaging.data() + firstDirty * CAR_INSTANCE_FLOATS);
+}
+
 // Render traffic
 void CityRenderer::renderTraffic(const TrafficData& trafficData, const CityConfig& config, bool view3D, ShaderManager& shaderManager) {
-    if (!config.showTraffic || trafficData.cars.empty()) return;
+    if (!config.showTraffic || trafficData.empty() || trafficVAO == 0) return;
+    
+    Profiler::CpuScope cpu(profiler, "render.traffic");
+    Profiler::GpuScope gpu(profiler, "render.traffic");
+    
+    GLsizei instanceCount = static_cast<GLsizei>(std::min(trafficCarCapacity, trafficData.size()));
+    
+    // Cars are colored per instance by the instanced permutation
+    shaderManager.setFeatures(SHADER_INSTANCED | (view3D ? 0u : SHADER_MAP_2D));
     
     if (view3D) {
-        // Render 3D car meshes
-        shaderManager.setIs2D(false);
-        shaderManager.setUseTexture(false);
-        
-        for (size_t i = 0; i < traffic3DVAOs.size() && i < trafficData.cars.size(); i++) {
-            const Car& car = trafficData.cars[i];
-            shaderManager.setColor(car.color.r, car.color.g, car.color.b);
-            glBindVertexArray(traffic3DVAOs[i]);
-            glDrawArrays(GL_TRIANGLES, 0, traffic3DVertexCounts[i]);
+        // Keep the records of cars inside the frustum and not behind an occluder;
+        // a car's box is its footprint at any heading
+        occlusionEnabled = config.occlusionCulling;
+        bool occlusionActive = updateOcclusion();
+        const float carRadius = std::sqrt(CAR_3D_HALF_WIDTH * CAR_3D_HALF_WIDTH +
+                                          CAR_3D_HALF_LENGTH * CAR_3D_HALF_LENGTH);
+        GLsizei visibleCount = 0;
+        for (GLsizei i = 0; i < instanceCount; i++) {
+            const float* record = trafficStaging.data() + static_cast<size_t>(i) * CAR_INSTANCE_FLOATS;
+            const float minCorner[3] = {record[0] - carRadius, CAR_3D_BASE, record[1] - carRadius};
+            const float maxCorner[3] = {record[0] + carRadius, CAR_3D_BASE + CAR_3D_HEIGHT, record[1] + carRadius};
+            if (!frustum.intersectsBox(minCorner, maxCorner)) continue;
+            if (occlusionActive && !occlusion.isBoxVisible(minCorner, maxCorner)) continue;
+            std::memcpy(trafficVisibleStaging.data() + static_cast<size_t>(visibleCount) * CAR_INSTANCE_FLOATS,
+                        record, CAR_INSTANCE_FLOATS * sizeof(float));
+            visibleCount++;
         }
-    } else {
-        // Render 2D points
-        shaderManager.setIs2D(true);
-        shaderManager.setUseTexture(false);
-        glPointSize(4.0f);  // Larger points for cars
+        if (visibleCount == 0) return;
         
-        for (size_t i = 0; i < trafficVAOs.size() && i < trafficData.cars.size(); i++) {
-            const Car& car = trafficData.cars[i];
-            shaderManager.setColor(car.color.r, car.color.g, car.color.b);
-            glBindVertexArray(trafficVAOs[i]);
-            glDrawArrays(GL_POINTS, 0, trafficVertexCounts[i]);
+        // Every car box in one instanced draw, from the compacted records if any were culled
+        if (visibleCount < instanceCount) {
+            glBindBuffer(GL_ARRAY_BUFFER, trafficVisibleVBO);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<size_t>(visibleCount) * CAR_INSTANCE_FLOATS * sizeof(float),
+                            trafficVisibleStaging.data());
+            glBindVertexArray(trafficVisibleVAO);
+        } else {
+            glBindVertexArray(trafficVAO);
         }
+        glDrawArraysInstanced(GL_TRIANGLES, 0, CAR_3D_VERTEX_COUNT, visibleCount);
+    } else {
+        glBindVertexArray(trafficVAO);
+        // Render one point per car in one instanced draw
+        shaderManager.setPointSize(4.0f * config.pointSizeScale);  // Larger points for cars
+        glDrawArraysInstanced(GL_POINTS, 0, 1, instanceCount);
+    }
+}
+
+// Render the GPU backend's cars straight from its state buffer
+void CityRenderer::renderGpuTraffic(const GpuTrafficSimulator& traffic, const CityConfig& config, bool view3D,
+                                    ShaderManager& shaderManager) {
+    if (!config.showTraffic || !traffic.hasCars()) return;
+    
+    Profiler::CpuScope cpu(profiler, "render.traffic");
+    Profiler::GpuScope gpu(profiler, "render.traffic");
+    
+    shaderManager.setFeatures(SHADER_INSTANCED | SHADER_GPU_CARS | (view3D ? 0u : SHADER_MAP_2D));
+    glBindVertexArray(traffic.getDrawVAO());
+    GLsizei instanceCount = static_cast<GLsizei>(traffic.getCarCount());
+    if (view3D) {
+        glDrawArraysInstanced(GL_TRIANGLES, 0, CAR_3D_VERTEX_COUNT, instanceCount);
+    } else {
+        shaderManager.setPointSize(4.0f * config.pointSizeScale);
+        glDrawArraysInstanced(GL_POINTS, 0, 1, instanceCount);
     }
 }
@@ -7,160 +7,112 @@
  */
 
 #include "rendering/mesh/building_mesh.h"
-#include <vector>
 
-std::vector<float> buildingToVertices(const Building& building, int screenWidth, int screenHeight, bool is3D) {
-    std::vector<float> vertices;
+std::vector<uint32_t> buildingLodIndices(int lod, int view) {
+    std::vector<uint32_t> indices = unitBuildingMesh().indices;
+    if (lod == 1) {
+        // Faces are emitted front, back, left, right, bottom, top (6 indices each)
+        indices.erase(indices.begin() + 4 * 6, indices.begin() + 5 * 6);
+    } else if (lod >= 2) {
+        // Front faces -Z and back +Z, left faces -X and right +X
+        const int faces[3] = {(view & 2) ? 1 : 0, (view & 1) ? 3 : 2, 5};
+        std::vector<uint32_t> kept;
+        for (int face : faces) {
+            kept.insert(kept.end(), indices.begin() + face * 6, indices.begin() + face * 6 + 6);
+        }
+        indices.swap(kept);
+    }
+    return indices;
+}
+
+void buildingBounds(const Building& building, const WorldExtent& extent,
+                    float (&minCorner)[3], float (&maxCorner)[3]) {
+    // Convert world units to render coordinates
+    float centerX = extent.toRenderX(building.x);
+    float centerZ = extent.toRenderZ(building.y);
+    float halfWidth = extent.scaleX(building.width);
+    float halfDepth = extent.scaleZ(building.depth);
+    float heightNorm = extent.scaleZ(building.height);  // Same scale as the ground plane depth
     
-    // Convert pixel coordinates to world coordinates
-    float centerX = (building.x / (screenWidth / 2.0f)) - 1.0f;
-    float centerY = 1.0f - (building.y / (screenHeight / 2.0f));
-    float halfWidth = building.width / (screenWidth / 2.0f);
-    float halfDepth = building.depth / (screenHeight / 2.0f);
-    float heightNorm = building.height / 300.0f;  // Normalize height for viewing
+    minCorner[0] = centerX - halfWidth;
+    minCorner[1] = 0.0f;
+    minCorner[2] = centerZ - halfDepth;
+    maxCorner[0] = centerX + halfWidth;
+    maxCorner[1] = heightNorm;
+    maxCorner[2] = centerZ + halfDepth;
+}
+
+namespace {
+
+// Textured box between two corners, faces in the order buildingLodIndices() expects
+IndexedMesh boxMesh(const float (&minCorner)[3], const float (&maxCorner)[3]) {
+    IndexedMesh mesh;
+    mesh.vertices.reserve(BUILDING_MESH_VERTICES * 5);
+    mesh.indices.reserve(BUILDING_MESH_INDICES);
     
-    if (!is3D) {
-        // 2D MODE: Keep original coordinate system (Y for depth, Z for height)
-        float x0 = centerX - halfWidth;
-        float x1 = centerX + halfWidth;
-        float y0 = centerY - halfDepth;
-        float y1 = centerY + halfDepth;
-        float z0 = 0.0f;
-        float z1 = heightNorm;
-        
-        // Front face
-        vertices.insert(vertices.end(), {
-            x0, y0, z0,  0.0f, 0.0f,
-            x1, y0, z0,  1.0f, 0.0f,
-            x1, y0, z1,  1.0f, 1.0f,
-            x0, y0, z0,  0.0f, 0.0f,
-            x1, y0, z1,  1.0f, 1.0f,
-            x0, y0, z1,  0.0f, 1.0f
-        });
-        
-        // Back face
-        vertices.insert(vertices.end(), {
-            x1, y1, z0,  0.0f, 0.0f,
-            x0, y1, z0,  1.0f, 0.0f,
-            x0, y1, z1,  1.0f, 1.0f,
-            x1, y1, z0,  0.0f, 0.0f,
-            x0, y1, z1,  1.0f, 1.0f,
-            x1, y1, z1,  0.0f, 1.0f
-        });
-        
-        // Left face
-        vertices.insert(vertices.end(), {
-            x0, y1, z0,  0.0f, 0.0f,
-            x0, y0, z0,  1.0f, 0.0f,
-            x0, y0, z1,  1.0f, 1.0f,
-            x0, y1, z0,  0.0f, 0.0f,
-            x0, y0, z1,  1.0f, 1.0f,
-            x0, y1, z1,  0.0f, 1.0f
-        });
-        
-        // Right face
-        vertices.insert(vertices.end(), {
-            x1, y0, z0,  0.0f, 0.0f,
-            x1, y1, z0,  1.0f, 0.0f,
-            x1, y1, z1,  1.0f, 1.0f,
-            x1, y0, z0,  0.0f, 0.0f,
-            x1, y1, z1,  1.0f, 1.0f,
-            x1, y0, z1,  0.0f, 1.0f
-        });
-        
-        // Bottom face
-        vertices.insert(vertices.end(), {
-            x0, y0, z0,  0.0f, 0.0f,
-            x0, y1, z0,  0.0f, 1.0f,
-            x1, y1, z0,  1.0f, 1.0f,
-            x0, y0, z0,  0.0f, 0.0f,
-            x1, y1, z0,  1.0f, 1.0f,
-            x1, y0, z0,  1.0f, 0.0f
-        });
-        
-        // Top face
-        vertices.insert(vertices.end(), {
-            x0, y0, z1,  0.0f, 0.0f,
-            x1, y0, z1,  1.0f, 0.0f,
-            x1, y1, z1,  1.0f, 1.0f,
-            x0, y0, z1,  0.0f, 0.0f,
-            x1, y1, z1,  1.0f, 1.0f,
-            x0, y1, z1,  0.0f, 1.0f
-        });
-        
-        return vertices;
-    }
+    // Box extents as (X=left/right, H=height, D=depth)
+    float x0 = minCorner[0];
+    float x1 = maxCorner[0];
+    float h0 = minCorner[1];   // Ground level
+    float h1 = maxCorner[1];   // Top of building
+    float d0 = minCorner[2];
+    float d1 = maxCorner[2];
     
-    // 3D MODE: Use proper coordinate system (X=left/right, Y=up/down HEIGHT!, Z=depth)
-    float centerZ = 1.0f - (building.y / (screenHeight / 2.0f));
+    // Y is height (UP!), Z is depth
+    auto addFace = [&](const float (&corners)[4][3], const float (&uvs)[4][2]) {
+        float quad[4][5];
+        for (int i = 0; i < 4; i++) {
+            quad[i][0] = corners[i][0];
+            quad[i][1] = corners[i][1];
+            quad[i][2] = corners[i][2];
+            quad[i][3] = uvs[i][0];
+            quad[i][4] = uvs[i][1];
+        }
+        mesh.appendQuad(quad);
+    };
     
-    // Calculate the 8 corners of the cube
-    float x0 = centerX - halfWidth;
-    float x1 = centerX + halfWidth;
-    float y0 = 0.0f;           // Ground level
-    float y1 = heightNorm;     // Top of building (HEIGHT goes UP!)
-    float z0 = centerZ - halfDepth;
-    float z1 = centerZ + halfDepth;
+    const float sideUVs[4][2] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+    const float bottomUVs[4][2] = {{0.0f, 0.0f}, {0.0f, 1.0f}, {1.0f, 1.0f}, {1.0f, 0.0f}};
     
-    // Front face (facing -Z direction) - with UV coordinates
-    vertices.insert(vertices.end(), {
-        x0, y0, z0,  0.0f, 0.0f,
-        x1, y0, z0,  1.0f, 0.0f,
-        x1, y1, z0,  1.0f, 1.0f,
-        x0, y0, z0,  0.0f, 0.0f,
-        x1, y1, z0,  1.0f, 1.0f,
-        x0, y1, z0,  0.0f, 1.0f
-    });
+    // Front face (facing -Z direction)
+    addFace({{x0, h0, d0}, {x1, h0, d0}, {x1, h1, d0}, {x0, h1, d0}}, sideUVs);
     
     // Back face (facing +Z direction)
-    vertices.insert(vertices.end(), {
-        x1, y0, z1,  0.0f, 0.0f,
-        x0, y0, z1,  1.0f, 0.0f,
-        x0, y1, z1,  1.0f, 1.0f,
-        x1, y0, z1,  0.0f, 0.0f,
-        x0, y1, z1,  1.0f, 1.0f,
-        x1, y1, z1,  0.0f, 1.0f
-    });
+    addFace({{x1, h0, d1}, {x0, h0, d1}, {x0, h1, d1}, {x1, h1, d1}}, sideUVs);
     
     // Left face (facing -X direction)
-    vertices.insert(vertices.end(), {
-        x0, y0, z1,  0.0f, 0.0f,
-        x0, y0, z0,  1.0f, 0.0f,
-        x0, y1, z0,  1.0f, 1.0f,
-        x0, y0, z1,  0.0f, 0.0f,
-        x0, y1, z0,  1.0f, 1.0f,
-        x0, y1, z1,  0.0f, 1.0f
-    });
+    addFace({{x0, h0, d1}, {x0, h0, d0}, {x0, h1, d0}, {x0, h1, d1}}, sideUVs);
     
     // Right face (facing +X direction)
-    vertices.insert(vertices.end(), {
-        x1, y0, z0,  0.0f, 0.0f,
-        x1, y0, z1,  1.0f, 0.0f,
-        x1, y1, z1,  1.0f, 1.0f,
-        x1, y0, z0,  0.0f, 0.0f,
-        x1, y1, z1,  1.0f, 1.0f,
-        x1, y0, z1,  0.0f, 1.0f
-    });
+    addFace({{x1, h0, d0}, {x1, h0, d1}, {x1, h1, d1}, {x1, h1, d0}}, sideUVs);
     
     // Bottom face (ground, facing -Y direction)
-    vertices.insert(vertices.end(), {
-        x0, y0, z0,  0.0f, 0.0f,
-        x0, y0, z1,  0.0f, 1.0f,
-        x1, y0, z1,  1.0f, 1.0f,
-        x0, y0, z0,  0.0f, 0.0f,
-        x1, y0, z1,  1.0f, 1.0f,
-        x1, y0, z0,  1.0f, 0.0f
-    });
+    addFace({{x0, h0, d0}, {x0, h0, d1}, {x1, h0, d1}, {x1, h0, d0}}, bottomUVs);
     
     // Top face (roof, facing +Y direction)
-    vertices.insert(vertices.end(), {
-        x0, y1, z0,  0.0f, 0.0f,
-        x1, y1, z0,  1.0f, 0.0f,
-        x1, y1, z1,  1.0f, 1.0f,
-        x0, y1, z0,  0.0f, 0.0f,
-        x1, y1, z1,  1.0f, 1.0f,
-        x0, y1, z1,  0.0f, 1.0f
-    });
+    addFace({{x0, h1, d0}, {x1, h1, d0}, {x1, h1, d1}, {x0, h1, d1}}, sideUVs);
     
-    return vertices;
+    return mesh;
+}
+
+}  // namespace
+
+IndexedMesh buildingToMesh(const Building& building, const WorldExtent& extent) {
+    float minCorner[3], maxCorner[3];
+    buildingBounds(building, extent, minCorner, maxCorner);
+    return boxMesh(minCorner, maxCorner);
+}
+
+IndexedMesh unitBuildingMesh() {
+    const float minCorner[3] = {-1.0f, 0.0f, -1.0f};
+    const float maxCorner[3] = {1.0f, 1.0f, 1.0f};
+    return boxMesh(minCorner, maxCorner);
+}
+
+void writeBuildingInstance(const Building& building, float* record) {
+    record[0] = building.x;
+    record[1] = building.y;
+    record[2] = building.width;
+    record[3] = building.depth;
+    record[4] = building.height;
 }
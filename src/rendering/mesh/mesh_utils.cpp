@@ -7,26 +7,120 @@
  */
 
 #include "rendering/mesh/mesh_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 std::vector<float> pointsToVertices(const std::vector<Point>& points, 
-                                     int screenWidth, 
-                                     int screenHeight) {
-    std::vector<float> vertices;
-    int margin = 50;  // Boundary margin in pixels
+                                     const WorldExtent& extent) {
+    std::vector<float> vertices(points.size() * 3);
+    MeshSink out(vertices.data(), vertices.size());
+    writePointVertices(points, extent, out);
+    vertices.resize(out.floatCount);
+    return vertices;
+}
+
+void writePointVertices(const std::vector<Point>& points, const WorldExtent& extent, MeshSink& out) {
+    writePointVertices(points.data(), points.size(), extent, out);
+}
+
+void writePointVertices(const Point* points, size_t count, const WorldExtent& extent, MeshSink& out) {
+    float margin = 50.0f;  // Boundary margin in world units
     
-    for (const auto& point : points) {
-        // Skip points outside screen boundaries
-        if (point.x < margin || point.x > screenWidth - margin ||
-            point.y < margin || point.y > screenHeight - margin) {
+    for (size_t i = 0; i < count; i++) {
+        const Point& point = points[i];
+        // Skip points outside the city boundaries
+        if (!extent.contains(point.x, point.y, margin)) {
             continue;
         }
         
-        // Convert pixel coordinates to normalized device coordinates (-1 to 1)
-        float x = (point.x / (screenWidth / 2.0f)) - 1.0f;
-        float y = 1.0f - (point.y / (screenHeight / 2.0f));
-        vertices.push_back(x);
-        vertices.push_back(y);
-        vertices.push_back(0.0f);  // Z coordinate for 2D elements
+        // Convert world units to top-down render coordinates
+        float x = extent.toRenderX(point.x);
+        float y = extent.toRenderZ(point.y);
+        out.addVertices({x, y, 0.0f});  // Z coordinate 0 for 2D elements
     }
-    return vertices;
+}
+
+void IndexedMesh::append(const IndexedMesh& other) {
+    uint32_t base = static_cast<uint32_t>(vertexCount());
+    vertices.insert(vertices.end(), other.vertices.begin(), other.vertices.end());
+    indices.reserve(indices.size() + other.indices.size());
+    for (uint32_t index : other.indices) {
+        indices.push_back(base + index);
+    }
+}
+
+void IndexedMesh::appendQuad(const float (&quad)[4][5]) {
+    uint32_t base = static_cast<uint32_t>(vertexCount());
+    for (const auto& vertex : quad) {
+        vertices.insert(vertices.end(), vertex, vertex + 5);
+    }
+    indices.insert(indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+}
+
+VertexQuantization computeQuantization(const std::vector<float>& vertices, bool hasTexCoords) {
+    return computeQuantization(vertices.data(), vertices.size() / (hasTexCoords ? 5 : 3), hasTexCoords);
+}
+
+VertexQuantization computeQuantization(const float* vertices, size_t vertexCount, bool hasTexCoords) {
+    VertexQuantization quantization;
+    int stride = hasTexCoords ? 5 : 3;
+    if (vertexCount == 0) return quantization;
+    
+    // Positions are components 0-2, UVs 3-4
+    float low[5], high[5];
+    for (int c = 0; c < stride; c++) {
+        low[c] = std::numeric_limits<float>::max();
+        high[c] = -std::numeric_limits<float>::max();
+    }
+    for (size_t i = 0; i < vertexCount * stride; i += stride) {
+        for (int c = 0; c < stride; c++) {
+            low[c] = std::min(low[c], vertices[i + c]);
+            high[c] = std::max(high[c], vertices[i + c]);
+        }
+    }
+    
+    for (int c = 0; c < 3; c++) {
+        quantization.origin[c] = low[c];
+        quantization.scale[c] = high[c] - low[c];
+    }
+    if (hasTexCoords) {
+        quantization.texCoordTransform[0] = low[3];
+        quantization.texCoordTransform[1] = low[4];
+        quantization.texCoordTransform[2] = high[3] - low[3];
+        quantization.texCoordTransform[3] = high[4] - low[4];
+    }
+    return quantization;
+}
+
+std::vector<uint16_t> packVertices(const std::vector<float>& vertices, bool hasTexCoords,
+                                   const VertexQuantization& quantization) {
+    return packVertices(vertices.data(), vertices.size() / (hasTexCoords ? 5 : 3), hasTexCoords, quantization);
+}
+
+std::vector<uint16_t> packVertices(const float* vertices, size_t vertexCount, bool hasTexCoords,
+                                   const VertexQuantization& quantization) {
+    int stride = hasTexCoords ? 5 : 3;
+    int packedStride = hasTexCoords ? PACKED_TEXTURED_VERTEX_SHORTS : PACKED_POINT_VERTEX_SHORTS;
+    std::vector<uint16_t> packed(vertexCount * packedStride, 0);
+    
+    // Nearest of the 65536 steps across the box (flat axes pack to 0)
+    auto quantize = [](float value, float origin, float scale) -> uint16_t {
+        if (scale <= 0.0f) return 0;
+        float unit = std::clamp((value - origin) / scale, 0.0f, 1.0f);
+        return static_cast<uint16_t>(std::lround(unit * 65535.0f));
+    };
+    
+    for (size_t i = 0; i < vertexCount; i++) {
+        const float* vertex = vertices + i * stride;
+        uint16_t* out = packed.data() + i * packedStride;
+        for (int c = 0; c < 3; c++) {
+            out[c] = quantize(vertex[c], quantization.origin[c], quantization.scale[c]);
+        }
+        if (hasTexCoords) {
+            out[4] = quantize(vertex[3], quantization.texCoordTransform[0], quantization.texCoordTransform[2]);
+            out[5] = quantize(vertex[4], quantization.texCoordTransform[1], quantization.texCoordTransform[3]);
+        }
+    }
+    return packed;
 }
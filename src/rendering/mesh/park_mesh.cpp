@@ -13,59 +13,83 @@
 #define M_PI 3.14159265358979323846
 #endif
 
-std::vector<float> parkTo3DMesh(const std::vector<Point>& parkPoints, 
-                                 int screenWidth, int screenHeight, bool is3D) {
-    std::vector<float> vertices;
-    
-    if (parkPoints.size() < 3) return vertices;
-    
-    // Find center and radius from the circle points
-    float centerX = 0.0f, centerZ = 0.0f;
-    for (const auto& pt : parkPoints) {
-        float x = (pt.x / (screenWidth / 2.0f)) - 1.0f;
-        float z = 1.0f - (pt.y / (screenHeight / 2.0f));
-        centerX += x;
-        centerZ += z;
-    }
-    centerX /= parkPoints.size();
-    centerZ /= parkPoints.size();
+namespace {
+
+// Tessellation per detail level (index = lod)
+const int PARK_SEGMENTS[MESH_LOD_LEVELS] = {32, 16, 8};
+const int PARK_RINGS[MESH_LOD_LEVELS] = {4, 2, 1};
+const int FOUNTAIN_SEGMENTS[MESH_LOD_LEVELS] = {24, 12, 8};
+const int LIGHT_SEGMENTS[MESH_LOD_LEVELS] = {12, 6, 0};
+const int LIGHT_RINGS[MESH_LOD_LEVELS] = {8, 4, 0};
+const int FOUNTAIN_POOL_LIGHTS = 12;   // Bulbs around the pool rim
+const int FOUNTAIN_BASIN_LIGHTS = 8;   // Bulbs around the top basin
+const int FOUNTAIN_LIGHT_COUNT = FOUNTAIN_POOL_LIGHTS + FOUNTAIN_BASIN_LIGHTS;
+
+int clampLod(int lod) {
+    return lod < 0 ? 0 : (lod >= MESH_LOD_LEVELS ? MESH_LOD_LEVELS - 1 : lod);
+}
+
+}  // namespace
+
+size_t parkMeshFloats(int lod) {
+    int segments = PARK_SEGMENTS[clampLod(lod)];
+    int rings = PARK_RINGS[clampLod(lod)];
+    // Center cap, sloped rings and the edge wall
+    return static_cast<size_t>(segments) * (3 + 6 * rings + 6) * 5;
+}
+
+size_t fountainMeshFloats(int lod) {
+    // Pool base, pool wall, pedestal, basin top and sides
+    return static_cast<size_t>(FOUNTAIN_SEGMENTS[clampLod(lod)]) * (3 + 6 + 6 + 9) * 5;
+}
+
+size_t fountainLightsMeshFloats(int lod) {
+    return static_cast<size_t>(FOUNTAIN_LIGHT_COUNT) * LIGHT_RINGS[clampLod(lod)] *
+           LIGHT_SEGMENTS[clampLod(lod)] * 6 * 5;
+}
+
+std::vector<float> parkTo3DMesh(const Circle& park, 
+                                 const WorldExtent& extent, int lod) {
+    std::vector<float> vertices(parkMeshFloats(lod));
+    MeshSink out(vertices.data(), vertices.size());
+    writeParkMesh(park, extent, lod, out);
+    vertices.resize(out.floatCount);
+    return vertices;
+}
+
+std::vector<float> fountainTo3DMesh(const Circle& fountain, 
+                                     const WorldExtent& extent, int lod) {
+    std::vector<float> vertices(fountainMeshFloats(lod));
+    MeshSink out(vertices.data(), vertices.size());
+    writeFountainMesh(fountain, extent, lod, out);
+    vertices.resize(out.floatCount);
+    return vertices;
+}
+
+std::vector<float> fountainLightsTo3DMesh(const Circle& fountain,
+                                          const WorldExtent& extent,
+                                          int lod) {
+    std::vector<float> vertices(fountainLightsMeshFloats(lod));
+    MeshSink out(vertices.data(), vertices.size());
+    writeFountainLightsMesh(fountain, extent, lod, out);
+    vertices.resize(out.floatCount);
+    return vertices;
+}
+
+void writeParkMesh(const Circle& park, const WorldExtent& extent, int lod, MeshSink& out) {
+    if (!park.isValid()) return;
     
-    // Calculate radius from first point
-    float x0 = (parkPoints[0].x / (screenWidth / 2.0f)) - 1.0f;
-    float z0 = 1.0f - (parkPoints[0].y / (screenHeight / 2.0f));
-    float radius = std::sqrt((x0 - centerX) * (x0 - centerX) + (z0 - centerZ) * (z0 - centerZ));
+    // Convert the circle's world-unit center and radius to render coordinates
+    float centerX = extent.toRenderX(park.x);
+    float centerZ = extent.toRenderZ(park.y);
+    float radius = extent.scaleZ(park.radius);
     
     float baseHeight = 0.006f;    // Base park height (above roads)
     float hillHeight = 0.04f;     // Height of the raised hill in center
-    int segments = 32;            // Number of segments for circular shape
-    int rings = 4;                // Number of concentric rings for terraced effect
+    int segments = PARK_SEGMENTS[clampLod(lod)];  // Number of segments for circular shape
+    int rings = PARK_RINGS[clampLod(lod)];        // Number of concentric rings for terraced effect
     
-    if (!is3D) {
-        // 2D MODE: Simple flat circle for visibility
-        for (int i = 0; i < segments; i++) {
-            float angle1 = (i * 2.0f * M_PI) / segments;
-            float angle2 = ((i + 1) * 2.0f * M_PI) / segments;
-            
-            float x1 = centerX + radius * std::cos(angle1);
-            float z1 = centerZ + radius * std::sin(angle1);
-            float x2 = centerX + radius * std::cos(angle2);
-            float z2 = centerZ + radius * std::sin(angle2);
-            
-            float u1 = 0.5f + 0.5f * std::cos(angle1);
-            float v1 = 0.5f + 0.5f * std::sin(angle1);
-            float u2 = 0.5f + 0.5f * std::cos(angle2);
-            float v2 = 0.5f + 0.5f * std::sin(angle2);
-            
-            vertices.insert(vertices.end(), {
-                centerX, centerZ, baseHeight,  0.5f, 0.5f,
-                x1, z1, baseHeight,  u1, v1,
-                x2, z2, baseHeight,  u2, v2
-            });
-        }
-        return vertices;
-    }
-    
-    // 3D MODE: Create a terraced park with gentle hill in the center
+    // Create a terraced park with gentle hill in the center
     
     // Texture tiling factor - higher = more texture repeats (adjust for your grass texture size)
     float textureTiling = 3.0f;  // Tile the texture 3 times across the radius
@@ -99,7 +123,7 @@ std::vector<float> parkTo3DMesh(const std::vector<Point>& parkPoints,
                 float u2 = (x2 + 1.0f) * textureTiling;
                 float v2 = (z2 + 1.0f) * textureTiling;
                 
-                vertices.insert(vertices.end(), {
+                out.addVertices({
                     centerX, ringHeight, centerZ,  u_center, v_center,
                     x1, ringHeight, z1,  u1, v1,
                     x2, ringHeight, z2,  u2, v2
@@ -140,14 +164,14 @@ std::vector<float> parkTo3DMesh(const std::vector<Point>& parkPoints,
                 
                 // Create quad with two triangles (sloped surface)
                 // Triangle 1
-                vertices.insert(vertices.end(), {
+                out.addVertices({
                     xOut1, heightOuter, zOut1,  uOut1, vOut1,
                     xOut2, heightOuter, zOut2,  uOut2, vOut2,
                     xIn1, heightInner, zIn1,    uIn1, vIn1
                 });
                 
                 // Triangle 2
-                vertices.insert(vertices.end(), {
+                out.addVertices({
                     xOut2, heightOuter, zOut2,  uOut2, vOut2,
                     xIn2, heightInner, zIn2,    uIn2, vIn2,
                     xIn1, heightInner, zIn1,    uIn1, vIn1
@@ -172,42 +196,26 @@ std::vector<float> parkTo3DMesh(const std::vector<Point>& parkPoints,
         float u2 = (float)(i + 1) / segments * textureTiling;
         
         // Outer wall (small vertical edge)
-        vertices.insert(vertices.end(), {
+        out.addVertices({
             x1, baseHeight, z1,  u1, 0.0f,
             x2, baseHeight, z2,  u2, 0.0f,
             x1, baseHeight + wallHeight, z1,  u1, 1.0f
         });
-        vertices.insert(vertices.end(), {
+        out.addVertices({
             x2, baseHeight, z2,  u2, 0.0f,
             x2, baseHeight + wallHeight, z2,  u2, 1.0f,
             x1, baseHeight + wallHeight, z1,  u1, 1.0f
         });
     }
-    
-    return vertices;
 }
 
-std::vector<float> fountainTo3DMesh(const std::vector<Point>& fountainPoints, 
-                                     int screenWidth, int screenHeight, bool is3D) {
-    std::vector<float> vertices;
-    
-    if (fountainPoints.size() < 3) return vertices;
-    
-    // Find center and radius from the circle points
-    float centerX = 0.0f, centerZ = 0.0f;
-    for (const auto& pt : fountainPoints) {
-        float x = (pt.x / (screenWidth / 2.0f)) - 1.0f;
-        float z = 1.0f - (pt.y / (screenHeight / 2.0f));
-        centerX += x;
-        centerZ += z;
-    }
-    centerX /= fountainPoints.size();
-    centerZ /= fountainPoints.size();
+void writeFountainMesh(const Circle& fountain, const WorldExtent& extent, int lod, MeshSink& out) {
+    if (!fountain.isValid()) return;
     
-    // Calculate radius from first point
-    float x0 = (fountainPoints[0].x / (screenWidth / 2.0f)) - 1.0f;
-    float z0 = 1.0f - (fountainPoints[0].y / (screenHeight / 2.0f));
-    float radius = std::sqrt((x0 - centerX) * (x0 - centerX) + (z0 - centerZ) * (z0 - centerZ));
+    // Convert the circle's world-unit center and radius to render coordinates
+    float centerX = extent.toRenderX(fountain.x);
+    float centerZ = extent.toRenderZ(fountain.y);
+    float radius = extent.scaleZ(fountain.radius);
     
     float baseHeight = 0.008f;     // Base pool height (above parks)
     float poolDepth = 0.02f;       // Height of the pool walls
@@ -216,35 +224,9 @@ std::vector<float> fountainTo3DMesh(const std::vector<Point>& fountainPoints,
     float basinHeight = 0.03f;     // Height of top basin
     float basinRadius = radius * 0.4f;  // Basin is 40% of fountain radius
     
-    int segments = 24;  // Number of segments for circular shapes
+    int segments = FOUNTAIN_SEGMENTS[clampLod(lod)];  // Number of segments for circular shapes
     
-    if (!is3D) {
-        // 2D MODE: Simple flat circle for visibility
-        for (int i = 0; i < segments; i++) {
-            float angle1 = (i * 2.0f * M_PI) / segments;
-            float angle2 = ((i + 1) * 2.0f * M_PI) / segments;
-            
-            float x1 = centerX + radius * std::cos(angle1);
-            float z1 = centerZ + radius * std::sin(angle1);
-            float x2 = centerX + radius * std::cos(angle2);
-            float z2 = centerZ + radius * std::sin(angle2);
-            
-            float u_center = 0.5f, v_center = 0.5f;
-            float u1 = 0.5f + 0.5f * std::cos(angle1);
-            float v1 = 0.5f + 0.5f * std::sin(angle1);
-            float u2 = 0.5f + 0.5f * std::cos(angle2);
-            float v2 = 0.5f + 0.5f * std::sin(angle2);
-            
-            vertices.insert(vertices.end(), {
-                centerX, centerZ, baseHeight,  u_center, v_center,
-                x1, z1, baseHeight,  u1, v1,
-                x2, z2, baseHeight,  u2, v2
-            });
-        }
-        return vertices;
-    }
-    
-    // 3D MODE: Create a detailed fountain structure
+    // Create a detailed fountain structure
     
     // === 1. BASE POOL (flat circular base) ===
     for (int i = 0; i < segments; i++) {
@@ -263,7 +245,7 @@ std::vector<float> fountainTo3DMesh(const std::vector<Point>& fountainPoints,
         float v2 = 0.5f + 0.5f * std::sin(angle2);
         
         // Base circle
-        vertices.insert(vertices.end(), {
+        out.addVertices({
             centerX, baseHeight, centerZ,  0.5f, 0.5f,
             x1, baseHeight, z1,  u1, v1,
             x2, baseHeight, z2,  u2, v2
@@ -284,12 +266,12 @@ std::vector<float> fountainTo3DMesh(const std::vector<Point>& fountainPoints,
         float u2 = (float)(i + 1) / segments;
         
         // Outer wall - two triangles per segment
-        vertices.insert(vertices.end(), {
+        out.addVertices({
             x1, baseHeight, z1,  u1, 0.0f,
             x2, baseHeight, z2,  u2, 0.0f,
             x1, baseHeight + poolDepth, z1,  u1, 1.0f
         });
-        vertices.insert(vertices.end(), {
+        out.addVertices({
             x2, baseHeight, z2,  u2, 0.0f,
             x2, baseHeight + poolDepth, z2,  u2, 1.0f,
             x1, baseHeight + poolDepth, z1,  u1, 1.0f
@@ -311,12 +293,12 @@ std::vector<float> fountainTo3DMesh(const std::vector<Point>& fountainPoints,
         float u2 = (float)(i + 1) / segments;
         
         // Pedestal side - two triangles per segment
-        vertices.insert(vertices.end(), {
+        out.addVertices({
             x1, pedestalBase, z1,  u1, 0.0f,
             x2, pedestalBase, z2,  u2, 0.0f,
             x1, pedestalBase + pedestalHeight, z1,  u1, 1.0f
         });
-        vertices.insert(vertices.end(), {
+        out.addVertices({
             x2, pedestalBase, z2,  u2, 0.0f,
             x2, pedestalBase + pedestalHeight, z2,  u2, 1.0f,
             x1, pedestalBase + pedestalHeight, z1,  u1, 1.0f
@@ -340,7 +322,7 @@ std::vector<float> fountainTo3DMesh(const std::vector<Point>& fountainPoints,
         float v2 = 0.5f + 0.4f * std::sin(angle2);
         
         // Basin top (flat circle)
-        vertices.insert(vertices.end(), {
+        out.addVertices({
             centerX, basinBase + basinHeight, centerZ,  0.5f, 0.5f,
             x1, basinBase + basinHeight, z1,  u1, v1,
             x2, basinBase + basinHeight, z2,  u2, v2
@@ -349,43 +331,26 @@ std::vector<float> fountainTo3DMesh(const std::vector<Point>& fountainPoints,
         // Basin sides
         float u_seg1 = (float)i / segments;
         float u_seg2 = (float)(i + 1) / segments;
-        vertices.insert(vertices.end(), {
+        out.addVertices({
             x1, basinBase, z1,  u_seg1, 0.0f,
             x2, basinBase, z2,  u_seg2, 0.0f,
             x1, basinBase + basinHeight, z1,  u_seg1, 1.0f
         });
-        vertices.insert(vertices.end(), {
+        out.addVertices({
             x2, basinBase, z2,  u_seg2, 0.0f,
             x2, basinBase + basinHeight, z2,  u_seg2, 1.0f,
             x1, basinBase + basinHeight, z1,  u_seg1, 1.0f
         });
     }
-    
-    return vertices;
 }
 
-std::vector<float> fountainLightsTo3DMesh(const std::vector<Point>& fountainPoints,
-                                          int screenWidth,
-                                          int screenHeight) {
-    std::vector<float> vertices;
+void writeFountainLightsMesh(const Circle& fountain, const WorldExtent& extent, int lod, MeshSink& out) {
+    if (!fountain.isValid() || LIGHT_SEGMENTS[clampLod(lod)] == 0) return;
     
-    if (fountainPoints.size() < 3) return vertices;
-    
-    // Find center and radius from the circle points
-    float centerX = 0.0f, centerZ = 0.0f;
-    for (const auto& pt : fountainPoints) {
-        float x = (pt.x / (screenWidth / 2.0f)) - 1.0f;
-        float z = 1.0f - (pt.y / (screenHeight / 2.0f));
-        centerX += x;
-        centerZ += z;
-    }
-    centerX /= fountainPoints.size();
-    centerZ /= fountainPoints.size();
-    
-    // Calculate radius from first point
-    float x0 = (fountainPoints[0].x / (screenWidth / 2.0f)) - 1.0f;
-    float z0 = 1.0f - (fountainPoints[0].y / (screenHeight / 2.0f));
-    float radius = std::sqrt((x0 - centerX) * (x0 - centerX) + (z0 - centerZ) * (z0 - centerZ));
+    // Convert the circle's world-unit center and radius to render coordinates
+    float centerX = extent.toRenderX(fountain.x);
+    float centerZ = extent.toRenderZ(fountain.y);
+    float radius = extent.scaleZ(fountain.radius);
     
     float baseHeight = 0.008f;
     float poolDepth = 0.02f;
@@ -393,27 +358,28 @@ std::vector<float> fountainLightsTo3DMesh(const std::vector<Point>& fountainPoin
     float basinHeight = 0.03f;
     
     float lightRadius = 0.008f;  // Size of each light bulb
-    int lightSegments = 12;      // Sphere resolution
-    int lightRings = 8;
+    int lightSegments = LIGHT_SEGMENTS[clampLod(lod)];  // Sphere resolution
+    int lightRings = LIGHT_RINGS[clampLod(lod)];
     
     // Create light positions array
     struct LightPosition {
         float x, y, z;
     };
-    std::vector<LightPosition> lightPositions;
+    LightPosition lightPositions[FOUNTAIN_LIGHT_COUNT];
+    int lightCount = 0;
     
     // Add lights around the base pool rim (12 lights)
-    int numPoolLights = 12;
+    int numPoolLights = FOUNTAIN_POOL_LIGHTS;
     for (int i = 0; i < numPoolLights; i++) {
         float angle = (i * 2.0f * M_PI) / numPoolLights;
         float x = centerX + radius * 0.9f * std::cos(angle);
         float z = centerZ + radius * 0.9f * std::sin(angle);
         float y = baseHeight + poolDepth * 0.8f;  // Near top of pool wall
-        lightPositions.push_back({x, y, z});
+        lightPositions[lightCount++] = {x, y, z};
     }
     
     // Add lights around the top basin (8 lights)
-    int numBasinLights = 8;
+    int numBasinLights = FOUNTAIN_BASIN_LIGHTS;
     float pedestalRadius = radius * 0.15f;
     float basinRadius = radius * 0.4f;
     float pedestalBase = baseHeight + poolDepth * 0.5f;
@@ -423,11 +389,12 @@ std::vector<float> fountainLightsTo3DMesh(const std::vector<Point>& fountainPoin
         float x = centerX + basinRadius * 0.9f * std::cos(angle);
         float z = centerZ + basinRadius * 0.9f * std::sin(angle);
         float y = basinBase + basinHeight * 0.9f;  // Near top of basin
-        lightPositions.push_back({x, y, z});
+        lightPositions[lightCount++] = {x, y, z};
     }
     
     // Generate sphere mesh for each light position
-    for (const auto& lightPos : lightPositions) {
+    for (int light = 0; light < lightCount; light++) {
+        const LightPosition& lightPos = lightPositions[light];
         // Create a simple sphere using latitude/longitude approach
         for (int lat = 0; lat < lightRings; lat++) {
             float theta1 = ((float)lat / lightRings) * M_PI;
@@ -456,14 +423,14 @@ std::vector<float> fountainLightsTo3DMesh(const std::vector<Point>& fountainPoin
                 
                 // Simple UV mapping (can be 0,0 since we'll use solid color)
                 // Triangle 1
-                vertices.insert(vertices.end(), {
+                out.addVertices({
                     x1, y1, z1,  0.0f, 0.0f,
                     x2, y2, z2,  1.0f, 0.0f,
                     x3, y3, z3,  1.0f, 1.0f
                 });
                 
                 // Triangle 2
-                vertices.insert(vertices.end(), {
+                out.addVertices({
                     x1, y1, z1,  0.0f, 0.0f,
                     x3, y3, z3,  1.0f, 1.0f,
                     x4, y4, z4,  0.0f, 1.0f
@@ -471,6 +438,4 @@ std::vector<float> fountainLightsTo3DMesh(const std::vector<Point>& fountainPoin
             }
         }
     }
-    
-    return vertices;
 }
@@ -10,79 +10,115 @@
 #include <glm/glm.hpp>
 #include <cmath>
 
-std::vector<float> roadTo3DMesh(const Road& road, int screenWidth, int screenHeight, bool is3D) {
-    std::vector<float> vertices;
+size_t roadMeshFloats(const Road& road) {
+    // At most one vertex pair per path point: a point belongs to one run
+    return road.path.size() * 2 * 5;
+}
+
+size_t roadMeshIndices(const Road& road) {
+    return road.path.size() < 2 ? 0 : (road.path.size() - 1) * 6;
+}
+
+IndexedMesh roadTo3DMesh(const Road& road, const WorldExtent& extent) {
+    IndexedMesh mesh;
+    mesh.vertices.resize(roadMeshFloats(road));
+    mesh.indices.resize(roadMeshIndices(road));
+    MeshSink out(mesh.vertices.data(), mesh.vertices.size(), mesh.indices.data(), mesh.indices.size());
+    writeRoadMesh(road, extent, out);
+    mesh.vertices.resize(out.floatCount);
+    mesh.indices.resize(out.indexCount);
+    return mesh;
+}
+
+void writeRoadMesh(const Road& road, const WorldExtent& extent, MeshSink& out) {
+    if (road.path.size() < 2) return;
+    
+    // Convert road width from world units to render coordinates
+    float roadWidth = extent.scaleX(static_cast<float>(road.width));
+    float halfWidth = roadWidth / 2.0f;
+    float roadHeight = 0.005f;  // Slightly above ground
+    float margin = 50.0f;  // Boundary margin in world units
     
-    if (road.points.size() < 2) return vertices;
+    auto inBounds = [&](const Point& p) {
+        return extent.contains(p.x, p.y, margin);
+    };
     
-    // Convert road width from pixels to normalized coordinates
-    // screenWidth pixels maps to 2.0 in normalized coords (-1.0 to 1.0)
-    float roadWidth = (road.width / (float)screenWidth) * 2.0f;
-    int margin = 50;  // Boundary margin in pixels
+    // Convert world units to render coordinates
+    auto toNormalized = [&](const Point& p) {
+        return glm::vec2(extent.toRenderX(p.x), extent.toRenderZ(p.y));
+    };
     
-    // Process each segment of the road
-    for (size_t i = 0; i < road.points.size() - 1; i++) {
-        // Skip points outside screen boundaries
-        if (road.points[i].x < margin || road.points[i].x > screenWidth - margin ||
-            road.points[i].y < margin || road.points[i].y > screenHeight - margin ||
-            road.points[i + 1].x < margin || road.points[i + 1].x > screenWidth - margin ||
-            road.points[i + 1].y < margin || road.points[i + 1].y > screenHeight - margin) {
-            continue;  // Skip this segment if either endpoint is outside bounds
+    // Emit one left/right vertex pair across the road at a point
+    auto addPair = [&](glm::vec2 center, glm::vec2 perp, float texV) {
+        glm::vec2 left = center + perp * halfWidth;
+        glm::vec2 right = center - perp * halfWidth;
+        // Y is UP
+        out.addVertices({
+            left.x, roadHeight, left.y,    0.0f, texV,
+            right.x, roadHeight, right.y,  1.0f, texV
+        });
+    };
+    
+    // Walk the road as runs of consecutive in-bounds segments. Each run is a
+    // strip with 2 vertices per point that neighbouring segments share.
+    size_t i = 0;
+    while (i + 1 < road.path.size()) {
+        // Skip segments with an endpoint outside screen boundaries
+        if (!inBounds(road.path[i]) || !inBounds(road.path[i + 1])) {
+            i++;
+            continue;
         }
         
-        // Convert pixel coordinates to normalized device coordinates
-        float x1 = (road.points[i].x / (screenWidth / 2.0f)) - 1.0f;
-        float z1 = 1.0f - (road.points[i].y / (screenHeight / 2.0f));
-        float x2 = (road.points[i + 1].x / (screenWidth / 2.0f)) - 1.0f;
-        float z2 = 1.0f - (road.points[i + 1].y / (screenHeight / 2.0f));
-        
-        // Calculate direction and perpendicular
-        glm::vec2 dir = glm::normalize(glm::vec2(x2 - x1, z2 - z1));
-        glm::vec2 perp(-dir.y, dir.x);  // Perpendicular for width
-        
-        float halfWidth = roadWidth / 2.0f;
-        
-        // Four corners of road segment
-        glm::vec2 v1(x1 + perp.x * halfWidth, z1 + perp.y * halfWidth);
-        glm::vec2 v2(x1 - perp.x * halfWidth, z1 - perp.y * halfWidth);
-        glm::vec2 v3(x2 + perp.x * halfWidth, z2 + perp.y * halfWidth);
-        glm::vec2 v4(x2 - perp.x * halfWidth, z2 - perp.y * halfWidth);
+        size_t runEnd = i + 1;
+        while (runEnd + 1 < road.path.size() && inBounds(road.path[runEnd + 1])) {
+            runEnd++;
+        }
         
-        float roadHeight = 0.005f;  // Slightly above ground
-        float texRepeat = glm::length(glm::vec2(x2 - x1, z2 - z1)) * 5.0f;  // Texture repeats along road
+        bool hasPrevious = false;
+        glm::vec2 previous;
+        glm::vec2 previousDir(0.0f);
+        float texV = 0.0f;
         
-        if (is3D) {
-            // 3D MODE: Y is UP
-            // First triangle
-            vertices.insert(vertices.end(), {
-                v1.x, roadHeight, v1.y,  0.0f, 0.0f,
-                v2.x, roadHeight, v2.y,  1.0f, 0.0f,
-                v3.x, roadHeight, v3.y,  0.0f, texRepeat
-            });
+        for (size_t j = i; j <= runEnd; j++) {
+            glm::vec2 current = toNormalized(road.path[j]);
+            
+            // Direction of the outgoing segment (the incoming one at the end)
+            glm::vec2 dir = previousDir;
+            if (j < runEnd) {
+                glm::vec2 delta = toNormalized(road.path[j + 1]) - current;
+                if (glm::length(delta) > 0.0f) dir = glm::normalize(delta);
+            }
+            if (glm::length(dir) == 0.0f) continue;  // Degenerate (repeated) point
             
-            // Second triangle
-            vertices.insert(vertices.end(), {
-                v2.x, roadHeight, v2.y,  1.0f, 0.0f,
-                v4.x, roadHeight, v4.y,  1.0f, texRepeat,
-                v3.x, roadHeight, v3.y,  0.0f, texRepeat
-            });
-        } else {
-            // 2D MODE: Z is depth (for orthographic view)
-            // First triangle
-            vertices.insert(vertices.end(), {
-                v1.x, v1.y, roadHeight,  0.0f, 0.0f,
-                v2.x, v2.y, roadHeight,  1.0f, 0.0f,
-                v3.x, v3.y, roadHeight,  0.0f, texRepeat
-            });
+            // Average the two segment directions at the joint
+            glm::vec2 jointDir = dir;
+            if (hasPrevious && glm::length(previousDir + dir) > 0.0f) {
+                jointDir = glm::normalize(previousDir + dir);
+            }
+            glm::vec2 perp(-jointDir.y, jointDir.x);  // Perpendicular for width
             
-            // Second triangle
-            vertices.insert(vertices.end(), {
-                v2.x, v2.y, roadHeight,  1.0f, 0.0f,
-                v4.x, v4.y, roadHeight,  1.0f, texRepeat,
-                v3.x, v3.y, roadHeight,  0.0f, texRepeat
-            });
+            if (hasPrevious) {
+                texV += glm::length(current - previous) * 5.0f;  // Texture repeats along road
+            }
+            addPair(current, perp, texV);
+            
+            if (hasPrevious) {
+                // Two triangles between the previous pair and this one
+                uint32_t right = static_cast<uint32_t>(out.texturedVertexCount()) - 1;
+                uint32_t left = right - 1;
+                uint32_t prevRight = right - 2;
+                uint32_t prevLeft = right - 3;
+                out.addIndices({
+                    prevLeft, prevRight, left,
+                    prevRight, right, left
+                });
+            }
+            
+            hasPrevious = true;
+            previous = current;
+            previousDir = dir;
         }
+        
+        i = runEnd;
     }
-    
-    return vertices;
 }
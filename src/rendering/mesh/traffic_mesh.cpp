@@ -1,22 +1,31 @@
 #include "rendering/mesh/traffic_mesh.h"
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
 
-std::vector<float> carTo3DMesh(const Car& car, int screenWidth, int screenHeight) {
-    std::vector<float> vertices;
+std::vector<float> carUnitMesh() {
+    std::vector<float> vertices(CAR_3D_FLOATS);
+    float* out = vertices.data();
     
-    // Normalize car position to OpenGL coordinates
-    float nx = (car.x / (float)screenWidth) * 2.0f - 1.0f;
-    float ny = 1.0f - (car.y / (float)screenHeight) * 2.0f;
-    float nz = 0.01f;  // Slightly above ground
+    // Unit car sits at the origin; per-instance data places and rotates it
+    float nx = 0.0f;
+    float ny = 0.0f;
+    float nz = CAR_3D_BASE;
     
     // Car dimensions (small cube)
-    float carWidth = 0.015f;
-    float carDepth = 0.025f;  // Longer in direction of travel
-    float carHeight = 0.012f;
+    float carWidth = CAR_3D_HALF_WIDTH;
+    float carDepth = CAR_3D_HALF_LENGTH;  // Longer in direction of travel
+    float carHeight = CAR_3D_HEIGHT;
+    
+    // Append one face (6 vertices) to the output buffer
+    auto emit = [&out](std::initializer_list<float> face) {
+        out = std::copy(face.begin(), face.end(), out);
+    };
     
     // Create a small rectangular box for the car (6 faces, 2 triangles each)
     
     // Bottom face
-    vertices.insert(vertices.end(), {
+    emit({
         nx - carWidth, nz, ny - carDepth,  0.0f, 0.0f,
         nx + carWidth, nz, ny - carDepth,  1.0f, 0.0f,
         nx + carWidth, nz, ny + carDepth,  1.0f, 1.0f,
@@ -26,7 +35,7 @@ std::vector<float> carTo3DMesh(const Car& car, int screenWidth, int screenHeight
     });
     
     // Top face
-    vertices.insert(vertices.end(), {
+    emit({
         nx - carWidth, nz + carHeight, ny + carDepth,  0.0f, 0.0f,
         nx + carWidth, nz + carHeight, ny + carDepth,  1.0f, 0.0f,
         nx + carWidth, nz + carHeight, ny - carDepth,  1.0f, 1.0f,
@@ -36,7 +45,7 @@ std::vector<float> carTo3DMesh(const Car& car, int screenWidth, int screenHeight
     });
     
     // Front face
-    vertices.insert(vertices.end(), {
+    emit({
         nx - carWidth, nz, ny + carDepth,  0.0f, 0.0f,
         nx + carWidth, nz, ny + carDepth,  1.0f, 0.0f,
         nx + carWidth, nz + carHeight, ny + carDepth,  1.0f, 1.0f,
@@ -46,7 +55,7 @@ std::vector<float> carTo3DMesh(const Car& car, int screenWidth, int screenHeight
     });
     
     // Back face
-    vertices.insert(vertices.end(), {
+    emit({
         nx + carWidth, nz, ny - carDepth,  0.0f, 0.0f,
         nx - carWidth, nz, ny - carDepth,  1.0f, 0.0f,
         nx - carWidth, nz + carHeight, ny - carDepth,  1.0f, 1.0f,
@@ -56,7 +65,7 @@ std::vector<float> carTo3DMesh(const Car& car, int screenWidth, int screenHeight
     });
     
     // Left face
-    vertices.insert(vertices.end(), {
+    emit({
         nx - carWidth, nz, ny - carDepth,  0.0f, 0.0f,
         nx - carWidth, nz, ny + carDepth,  1.0f, 0.0f,
         nx - carWidth, nz + carHeight, ny + carDepth,  1.0f, 1.0f,
@@ -66,7 +75,7 @@ std::vector<float> carTo3DMesh(const Car& car, int screenWidth, int screenHeight
     });
     
     // Right face
-    vertices.insert(vertices.end(), {
+    emit({
         nx + carWidth, nz, ny + carDepth,  0.0f, 0.0f,
         nx + carWidth, nz, ny - carDepth,  1.0f, 0.0f,
         nx + carWidth, nz + carHeight, ny - carDepth,  1.0f, 1.0f,
@@ -78,13 +87,30 @@ std::vector<float> carTo3DMesh(const Car& car, int screenWidth, int screenHeight
     return vertices;
 }
 
-std::vector<float> carTo2DVertices(const Car& car, int screenWidth, int screenHeight) {
-    // Normalize car position to OpenGL coordinates
-    float nx = (car.x / (float)screenWidth) * 2.0f - 1.0f;
-    float ny = 1.0f - (car.y / (float)screenHeight) * 2.0f;
+void writeCarInstance(const TrafficData& cars, size_t index, float alpha,
+                      const WorldExtent& extent, float* out) {
+    // Interpolate between the last two simulation steps
+    float x = cars.prevX[index] + (cars.x[index] - cars.prevX[index]) * alpha;
+    float y = cars.prevY[index] + (cars.y[index] - cars.prevY[index]) * alpha;
     
-    // Return simple point vertices (x, y, z, u, v)
-    return {
-        nx, ny, 0.0f, 0.0f, 0.0f
-    };
+    // Convert car position to render coordinates
+    out[0] = extent.toRenderX(x);
+    out[1] = extent.toRenderZ(y);
+    
+    // Heading from the direction of travel in render space (world y flips to -z)
+    float dirX = extent.scaleX(cars.headingX[index]);
+    float dirZ = -extent.scaleZ(cars.headingY[index]);
+    float length = std::sqrt(dirX * dirX + dirZ * dirZ);
+    if (length > 1e-6f) {
+        out[2] = dirX / length;  // sin(heading)
+        out[3] = dirZ / length;  // cos(heading)
+    } else {
+        out[2] = 0.0f;
+        out[3] = 1.0f;
+    }
+    
+    const glm::vec3& color = cars.color[index];
+    out[4] = color.r;
+    out[5] = color.g;
+    out[6] = color.b;
 }
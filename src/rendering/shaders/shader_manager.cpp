@@ -8,131 +8,301 @@
 
 #include "rendering/shaders/shader_manager.h"
 #include <iostream>
-#include <glm/gtc/type_ptr.hpp>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <cstring>
+#include <sys/stat.h>
+#include <sys/types.h>
 
-// Vertex Shader Source (supports both 2D and 3D with textures)
+namespace {
+
+// ARB_get_program_binary / OpenGL 4.1 enums (not in the 3.3 loader)
+constexpr GLenum PROGRAM_BINARY_RETRIEVABLE_HINT = 0x8257;
+constexpr GLenum PROGRAM_BINARY_LENGTH = 0x8741;
+constexpr GLenum NUM_PROGRAM_BINARY_FORMATS = 0x87FE;
+
+constexpr uint32_t PROGRAM_CACHE_MAGIC = 0x42504443;  ///< "CDPB"
+constexpr uint32_t PROGRAM_CACHE_VERSION = 1;
+
+/// Header in front of the driver's binary in a cache file
+struct ProgramCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t format;                ///< Driver binary format
+    uint32_t length;                ///< Bytes of binary that follow
+};
+
+// Permutations the renderer draws with; built up front so errors show at startup
+const unsigned WARM_PERMUTATIONS[] = {
+    SHADER_TEXTURED | SHADER_QUANTIZED,         // 3D roads, parks, fountain
+    SHADER_TEXTURED | SHADER_MATERIAL_ARRAY | SHADER_WINDOW_LIGHTS | SHADER_BUILDING_INSTANCES,  // 3D buildings
+    SHADER_BUILDING_INSTANCES,                  // 2D buildings
+    SHADER_QUANTIZED,                           // Fountain lights
+    SHADER_INSTANCED,                           // 3D cars
+    SHADER_MAP_2D | SHADER_QUANTIZED,           // 2D points
+    SHADER_MAP_2D | SHADER_INSTANCED            // 2D cars
+};
+
+uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+    // FNV-1a
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t hashString(uint64_t hash, const char* text) {
+    return text ? hashBytes(hash, text, std::strlen(text) + 1) : hash;
+}
+
+}  // namespace
+
+// Vertex Shader Source (2D map or 3D; per-instance cars with INSTANCED,
+// per-instance buildings with BUILDING_INSTANCES, 16-bit packed static
+// meshes with QUANTIZED)
 const char* ShaderManager::getVertexShaderSource() {
     return R"(
-#version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
+#ifdef GPU_CARS
+layout (location = 2) in vec4 aCarPose;        // (x, y, previous x, previous y) in world units
+layout (location = 8) in vec2 aCarHeading;     // Unit heading in world units
+#elif defined(INSTANCED)
+layout (location = 2) in vec4 aInstance;       // (x, z, sin, cos) per instance
+#endif
+#ifdef INSTANCED
+layout (location = 3) in vec3 aInstanceColor;  // Color per instance
+#endif
+#ifdef BUILDING_INSTANCES
+layout (location = 5) in vec4 aBuilding;       // (x, y, width, depth) in world units
+layout (location = 6) in float aBuildingHeight;
+#endif
+#ifdef MATERIAL_ARRAY
+layout (location = 4) in float aMaterialLayer;  // Layer of materialTex
+flat out float MaterialLayer;
+#endif
+#ifdef WINDOW_LIGHTS
+layout (location = 7) in uint aBuildingIndex;   // Texel of windowOccupancy
+flat out uint BuildingIndex;
+#endif
 
 out vec2 TexCoord;
 out vec3 FragPos;
+out vec3 VertexColor;
+
+layout (std140) uniform FrameGlobals {
+    mat4 view;
+    mat4 projection;
+    vec4 worldToRender;       // (scale X, scale Z, origin X, origin Z) of world units
+    float timeOfDay;          // Time in hours (0-24)
+    float ambient;            // Ambient light factor for the time of day
+    float windowLight;        // Blend factor of lit windows
+    float trafficAlpha;       // Blend between the last two traffic steps
+};
 
-uniform mat4 view;
-uniform mat4 projection;
-uniform bool is2D;
+#ifndef INSTANCED
+uniform vec3 color;
+#endif
+#ifdef MAP_2D
+uniform float pointSize;          // Diameter of map points in pixels
+#endif
+#ifdef QUANTIZED
+uniform vec3 positionOrigin;      // Position of packed value 0
+uniform vec3 positionScale;       // Position span of packed 0..1
+uniform vec4 texCoordTransform;   // (u, v) of packed 0, then the UV span
+#endif
 
 void main() {
-    FragPos = aPos;
-    if (is2D) {
-        gl_Position = vec4(aPos.x, aPos.y, 0.0, 1.0);
-    } else {
-        gl_Position = projection * view * vec4(aPos, 1.0);
-    }
+#ifdef GPU_CARS
+    // Straight from the simulation buffer: blend the last two steps, then
+    // map to render space (world Y runs down the map, render Z up it)
+    vec2 world = mix(aCarPose.zw, aCarPose.xy, trafficAlpha);
+    vec2 heading = vec2(worldToRender.x * aCarHeading.x, -worldToRender.y * aCarHeading.y);
+    heading = dot(heading, heading) > 1e-12 ? normalize(heading) : vec2(0.0, 1.0);
+    vec4 aInstance = vec4(worldToRender.z + worldToRender.x * world.x,
+                          worldToRender.w - worldToRender.y * world.y, heading);
+#endif
+#ifdef INSTANCED
+    // Rotate the unit mesh around Y by the heading, then translate
+    vec3 pos = vec3(aInstance.x + aInstance.w * aPos.x + aInstance.z * aPos.z,
+                    aPos.y,
+                    aInstance.y - aInstance.z * aPos.x + aInstance.w * aPos.z);
+    VertexColor = aInstanceColor;
+#elif defined(BUILDING_INSTANCES)
+    // Unit box (-1..1 wide and deep, 0..1 high) -> the building's box in render
+    // space; world Y runs down the map while render Z runs up it
+    vec3 pos = vec3(worldToRender.z + worldToRender.x * (aBuilding.x + aPos.x * aBuilding.z),
+                    worldToRender.y * aBuildingHeight * aPos.y,
+                    worldToRender.w - worldToRender.y * (aBuilding.y - aPos.z * aBuilding.w));
+    VertexColor = color;
+#elif defined(QUANTIZED)
+    // Normalized 16-bit components -> the mesh's bounding box
+    vec3 pos = positionOrigin + aPos * positionScale;
+    VertexColor = color;
+#else
+    vec3 pos = aPos;
+    VertexColor = color;
+#endif
+
+    FragPos = pos;
+#ifdef MAP_2D
+    // Map points are (x, z) in render space; the top-down projection
+    // fits the city's extent to the window
+#ifdef INSTANCED
+    vec2 mapPos = aInstance.xy;
+#else
+    vec2 mapPos = pos.xy;
+#endif
+    gl_Position = vec4((projection * vec4(mapPos, 0.0, 1.0)).xy, 0.0, 1.0);
+    gl_PointSize = pointSize;
+#else
+    gl_Position = projection * view * vec4(pos, 1.0);
+#endif
+#ifdef QUANTIZED
+    TexCoord = texCoordTransform.xy + aTexCoord * texCoordTransform.zw;
+#else
     TexCoord = aTexCoord;
+#endif
+#ifdef MATERIAL_ARRAY
+    MaterialLayer = aMaterialLayer;
+#endif
+#ifdef WINDOW_LIGHTS
+    BuildingIndex = aBuildingIndex;
+#endif
 }
 )";
 }
 
-// Fragment Shader Source (supports both color and texture)
+// Fragment Shader Source (flat color, or texture with optional window lights)
 const char* ShaderManager::getFragmentShaderSource() {
     return R"(
-#version 330 core
 out vec4 FragColor;
 
 in vec2 TexCoord;
 in vec3 FragPos;
+in vec3 VertexColor;
 
-uniform vec3 color;
-uniform bool useTexture;
+layout (std140) uniform FrameGlobals {
+    mat4 view;
+    mat4 projection;
+    vec4 worldToRender;       // (scale X, scale Z, origin X, origin Z) of world units
+    float timeOfDay;          // Time in hours (0-24)
+    float ambient;            // Ambient light factor for the time of day
+    float windowLight;        // Blend factor of lit windows
+    float trafficAlpha;       // Blend between the last two traffic steps
+};
+
+#ifdef MATERIAL_ARRAY
+flat in float MaterialLayer;
+uniform sampler2DArray materialTex;
+#elif defined(TEXTURED)
 uniform sampler2D buildingTex;
-uniform bool showWindowLights;
-uniform float timeOfDay;  // Time in hours (0-24)
+#endif
 
-// Simple pseudo-random function based on position
-float random(vec2 st) {
-    return fract(sin(dot(st.xy, vec2(12.9898,78.233))) * 43758.5453123);
-}
+#ifdef WINDOW_LIGHTS
+// One texel per building: the lit bits of its 8x8 windows (0-31, 32-63)
+const uint OCCUPANCY_WIDTH = 1024u;  // BuildingLightingSystem::OCCUPANCY_WIDTH
+flat in uint BuildingIndex;
+uniform usampler2D windowOccupancy;
+#endif
 
 void main() {
-    vec4 baseColor;
-    
-    if (useTexture) {
-        baseColor = texture(buildingTex, TexCoord);
-    } else {
-        baseColor = vec4(color, 1.0);
-    }
+#ifdef MATERIAL_ARRAY
+    vec4 baseColor = texture(materialTex, vec3(TexCoord, MaterialLayer));
+#elif defined(TEXTURED)
+    vec4 baseColor = texture(buildingTex, TexCoord);
+#else
+    vec4 baseColor = vec4(VertexColor, 1.0);
+#endif
+
+#ifdef WINDOW_LIGHTS
+    // Window lights effect for buildings in 3D view
+    // Create window grid pattern (8x8 windows per building face)
+    vec2 windowGrid = fract(TexCoord * 8.0);
     
-    // Calculate ambient light based on time of day (default to 1.0 for safety)
-    float ambientStrength = 1.0;
-    if (timeOfDay > 0.0) {  // Only apply if timeOfDay is set
-        if (timeOfDay >= 5.0 && timeOfDay < 7.0) {
-            // Sunrise
-            ambientStrength = mix(0.3, 1.0, (timeOfDay - 5.0) / 2.0);
-        } else if (timeOfDay >= 19.0 && timeOfDay < 21.0) {
-            // Sunset
-            ambientStrength = mix(1.0, 0.3, (timeOfDay - 19.0) / 2.0);
-        } else if (timeOfDay >= 21.0 || timeOfDay < 5.0) {
-            // Night
-            ambientStrength = 0.3;
-        }
-    }
+    // Window frame (dark borders)
+    bool isFrame = windowGrid.x < 0.1 || windowGrid.x > 0.9 ||
+                   windowGrid.y < 0.1 || windowGrid.y > 0.9;
     
-    // Add window lights effect for buildings in 3D view
-    if (showWindowLights && useTexture) {
-        // Create window grid pattern (8x8 windows per building face)
-        vec2 windowGrid = fract(TexCoord * 8.0);
-        
-        // Window frame (dark borders)
-        bool isFrame = windowGrid.x < 0.1 || windowGrid.x > 0.9 || 
-                       windowGrid.y < 0.1 || windowGrid.y > 0.9;
+    if (!isFrame) {
+        // Lit windows come from the building's row of BuildingLightingSystem
+        ivec2 windowId = ivec2(clamp(floor(TexCoord * 8.0), 0.0, 7.0));
+        int window = windowId.y * 8 + windowId.x;
+        uvec2 mask = texelFetch(windowOccupancy, ivec2(int(BuildingIndex % OCCUPANCY_WIDTH), int(BuildingIndex / OCCUPANCY_WIDTH)), 0).rg;
+        uint bits = window < 32 ? mask.x : mask.y;
         
-        if (!isFrame) {
-            // Use fragment position for consistent random per window
-            vec2 windowId = floor(TexCoord * 8.0);
-            float randomValue = random(windowId + FragPos.xy * 0.1);
-            
-            // 60% of windows are lit (random per window)
-            if (randomValue > 0.4) {
-                // Window light intensity based on time (brighter at night)
-                float windowBrightness = 0.25;
-                if (timeOfDay >= 19.0 || timeOfDay < 7.0) {
-                    // Night/early morning: windows glow brighter
-                    windowBrightness = 0.5;
-                }
-                
-                // Subtle warm glow for windows
-                vec3 windowLight = vec3(1.0, 0.95, 0.7) * 0.8;
-                // Blend with texture
-                baseColor.rgb = mix(baseColor.rgb, windowLight, windowBrightness);
-            }
+        if (((bits >> uint(window & 31)) & 1u) != 0u) {
+            // Subtle warm glow for windows, brighter at night (windowLight)
+            vec3 windowColor = vec3(1.0, 0.95, 0.7) * 0.8;
+            // Blend with texture
+            baseColor.rgb = mix(baseColor.rgb, windowColor, windowLight);
         }
     }
-    
-    // Apply ambient lighting to final color
-    FragColor = vec4(baseColor.rgb * ambientStrength, baseColor.a);
+#endif
+
+    // Apply the frame's ambient lighting to final color
+    FragColor = vec4(baseColor.rgb * ambient, baseColor.a);
 }
 )";
 }
 
-ShaderManager::ShaderManager() 
-    : shaderProgram(0), isCompiled(false),
-      colorLocation(-1), viewLocation(-1), projectionLocation(-1),
-      useTextureLocation(-1), is2DLocation(-1), showWindowLightsLocation(-1),
-      timeOfDayLocation(-1) {
+ShaderManager::ShaderManager()
+    : features(0), requestedFeatures(0), isCompiled(false), colorSet(false), pointSize(2.0f), quantizationSet(false),
+      frameGlobalsBuffer(0), frameGlobalsKnown(false), boundTexture(0), boundTextureArray(0), boundOccupancy(0),
+      getProgramBinary(nullptr), programBinary(nullptr), programParameteri(nullptr) {
+    color[0] = color[1] = color[2] = 0.0f;
+    std::memset(quantization, 0, sizeof(quantization));
+    std::memset(&frameGlobals, 0, sizeof(frameGlobals));
 }
 
 ShaderManager::~ShaderManager() {
-    if (shaderProgram != 0) {
-        glDeleteProgram(shaderProgram);
+    for (Program& program : programs) {
+        if (program.id != 0) {
+            glDeleteProgram(program.id);
+        }
+    }
+    if (frameGlobalsBuffer != 0) {
+        glDeleteBuffers(1, &frameGlobalsBuffer);
     }
 }
 
-GLuint ShaderManager::compileShader(GLenum type, const char* source) {
+std::string ShaderManager::featureDefines(unsigned featureBits) {
+    std::string defines;
+    if (featureBits & SHADER_MAP_2D) defines += "#define MAP_2D\n";
+    if (featureBits & SHADER_INSTANCED) defines += "#define INSTANCED\n";
+    if (featureBits & SHADER_TEXTURED) defines += "#define TEXTURED\n";
+    if (featureBits & SHADER_WINDOW_LIGHTS) defines += "#define WINDOW_LIGHTS\n";
+    if (featureBits & SHADER_MATERIAL_ARRAY) defines += "#define MATERIAL_ARRAY\n";
+    if (featureBits & SHADER_BUILDING_INSTANCES) defines += "#define BUILDING_INSTANCES\n";
+    if (featureBits & SHADER_QUANTIZED) defines += "#define QUANTIZED\n";
+    if (featureBits & SHADER_GPU_CARS) defines += "#define GPU_CARS\n";
+    return defines;
+}
+
+unsigned ShaderManager::normalizeFeatures(unsigned featureBits) {
+    featureBits &= PERMUTATION_COUNT - 1;
+    if (!(featureBits & SHADER_TEXTURED)) {
+        featureBits &= ~static_cast<unsigned>(SHADER_WINDOW_LIGHTS | SHADER_MATERIAL_ARRAY);
+    }
+    if (featureBits & SHADER_BUILDING_INSTANCES) featureBits &= ~static_cast<unsigned>(SHADER_INSTANCED);
+    if (!(featureBits & SHADER_INSTANCED)) featureBits &= ~static_cast<unsigned>(SHADER_GPU_CARS);
+    if (!(featureBits & SHADER_BUILDING_INSTANCES)) featureBits &= ~static_cast<unsigned>(SHADER_WINDOW_LIGHTS);
+    if (featureBits & (SHADER_INSTANCED | SHADER_BUILDING_INSTANCES)) {
+        featureBits &= ~static_cast<unsigned>(SHADER_QUANTIZED);
+    }
+    return featureBits;
+}
+
+GLuint ShaderManager::compileShader(GLenum type, const std::string& defines, const char* source) {
+    // #version must come first, so the defines go between it and the body
+    const char* sources[3] = {"#version 330 core\n", defines.c_str(), source};
+    
     GLuint shader = glCreateShader(type);
-    glShaderSource(shader, 1, &source, NULL);
+    glShaderSource(shader, 3, sources, NULL);
     glCompileShader(shader);
     
     // Check compilation status
@@ -141,8 +311,8 @@ GLuint ShaderManager::compileShader(GLenum type, const char* source) {
     glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
     if (!success) {
         glGetShaderInfoLog(shader, 512, NULL, infoLog);
-        std::cerr << "ERROR: Shader compilation failed (" 
-                  << (type == GL_VERTEX_SHADER ? "VERTEX" : "FRAGMENT") 
+        std::cerr << "ERROR: Shader compilation failed ("
+                  << (type == GL_VERTEX_SHADER ? "VERTEX" : "FRAGMENT")
                   << ")\n" << infoLog << std::endl;
         glDeleteShader(shader);
         return 0;
@@ -151,112 +321,354 @@ GLuint ShaderManager::compileShader(GLenum type, const char* source) {
     return shader;
 }
 
-bool ShaderManager::compileShaders() {
-    std::cout << "🔧 Compiling shaders...\n";
+GLuint ShaderManager::linkProgram(unsigned featureBits) {
+    std::string defines = featureDefines(featureBits);
     
     // Compile vertex shader
-    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, getVertexShaderSource());
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, defines, getVertexShaderSource());
     if (vertexShader == 0) {
         std::cerr << "❌ Vertex shader compilation failed!\n";
-        return false;
+        return 0;
     }
-    std::cout << "✓ Vertex shader compiled\n";
     
     // Compile fragment shader
-    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, getFragmentShaderSource());
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, defines, getFragmentShaderSource());
     if (fragmentShader == 0) {
         std::cerr << "❌ Fragment shader compilation failed!\n";
         glDeleteShader(vertexShader);
-        return false;
+        return 0;
     }
-    std::cout << "✓ Fragment shader compiled\n";
     
     // Link shader program
-    shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    if (programParameteri && !cacheDirectory.empty()) {
+        programParameteri(program, PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    glLinkProgram(program);
+    
+    // Clean up shaders (no longer needed after linking)
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
     
     // Check linking status
     int success;
     char infoLog[512];
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
     if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+        glGetProgramInfoLog(program, 512, NULL, infoLog);
         std::cerr << "ERROR: Shader program linking failed\n" << infoLog << std::endl;
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-        glDeleteProgram(shaderProgram);
-        shaderProgram = 0;
+        glDeleteProgram(program);
+        return 0;
+    }
+    
+    return program;
+}
+
+bool ShaderManager::buildProgram(unsigned featureBits) {
+    Program& slot = programs[featureBits];
+    if (slot.id != 0) return true;
+    
+    uint64_t key = programCacheKey(featureBits);
+    GLuint program = loadCachedProgram(key);
+    if (program == 0) {
+        program = linkProgram(featureBits);
+        if (program == 0) {
+            std::cerr << "❌ Shader permutation " << featureBits << " failed to build\n";
+            return false;
+        }
+        saveCachedProgram(key, program);
+    }
+    
+    // Per-frame globals come from the shared uniform buffer
+    if (!bindFrameGlobals(program)) {
+        glDeleteProgram(program);
         return false;
     }
     
-    // Clean up shaders (no longer needed after linking)
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    slot = Program();
+    slot.id = program;
+    cacheUniformLocations(slot);
+    return true;
+}
+
+bool ShaderManager::compileShaders() {
+    std::cout << "🔧 Compiling shaders...\n";
     
-    // Cache uniform locations
-    cacheUniformLocations();
+    for (unsigned featureBits : WARM_PERMUTATIONS) {
+        if (!buildProgram(featureBits)) {
+            return false;
+        }
+    }
     
     isCompiled = true;
-    std::cout << "✅ Shaders compiled and linked successfully\n";
+    std::cout << "✅ Shaders compiled and linked successfully ("
+              << (sizeof(WARM_PERMUTATIONS) / sizeof(WARM_PERMUTATIONS[0])) << " permutations)\n";
     return true;
 }
 
-void ShaderManager::cacheUniformLocations() {
-    colorLocation = glGetUniformLocation(shaderProgram, "color");
-    viewLocation = glGetUniformLocation(shaderProgram, "view");
-    projectionLocation = glGetUniformLocation(shaderProgram, "projection");
-    useTextureLocation = glGetUniformLocation(shaderProgram, "useTexture");
-    is2DLocation = glGetUniformLocation(shaderProgram, "is2D");
-    showWindowLightsLocation = glGetUniformLocation(shaderProgram, "showWindowLights");
-    timeOfDayLocation = glGetUniformLocation(shaderProgram, "timeOfDay");
+void ShaderManager::cacheUniformLocations(Program& program) {
+    program.colorLocation = glGetUniformLocation(program.id, "color");
+    program.pointSizeLocation = glGetUniformLocation(program.id, "pointSize");
+    program.quantizationLocations[0] = glGetUniformLocation(program.id, "positionOrigin");
+    program.quantizationLocations[1] = glGetUniformLocation(program.id, "positionScale");
+    program.quantizationLocations[2] = glGetUniformLocation(program.id, "texCoordTransform");
+    
+    // Samplers keep their unit for good; materialTex and buildingTex stay on unit 0
+    GLint occupancyLocation = glGetUniformLocation(program.id, "windowOccupancy");
+    if (occupancyLocation >= 0) {
+        GLint current = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+        glUseProgram(program.id);
+        glUniform1i(occupancyLocation, static_cast<GLint>(WINDOW_OCCUPANCY_UNIT));
+        glUseProgram(static_cast<GLuint>(current));
+    }
 }
 
-void ShaderManager::use() const {
-    if (isCompiled) {
-        glUseProgram(shaderProgram);
+bool ShaderManager::enableProgramCache(const std::string& directory, GLADloadproc loader) {
+    cacheDirectory.clear();
+    
+    // Core in 4.1, otherwise only with the extension
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    bool supported = major > 4 || (major == 4 && minor >= 1);
+    if (!supported) {
+        GLint extensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+        for (GLint i = 0; i < extensionCount && !supported; i++) {
+            const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            supported = name && std::strcmp(name, "GL_ARB_get_program_binary") == 0;
+        }
+    }
+    
+    if (supported) {
+        getProgramBinary = reinterpret_cast<GetProgramBinaryProc>(loader("glGetProgramBinary"));
+        programBinary = reinterpret_cast<ProgramBinaryProc>(loader("glProgramBinary"));
+        programParameteri = reinterpret_cast<ProgramParameteriProc>(loader("glProgramParameteri"));
+    }
+    
+    // Some drivers expose the API but no format to save in
+    GLint formatCount = 0;
+    if (getProgramBinary && programBinary && programParameteri) {
+        glGetIntegerv(NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    }
+    if (formatCount <= 0) {
+        std::cout << "⚠️  Program binaries not supported by this driver, shaders compile from source\n";
+        return false;
     }
+    
+    mkdir(directory.c_str(), 0755);
+    cacheDirectory = directory;
+    return true;
 }
 
-void ShaderManager::setColor(float r, float g, float b) const {
-    if (colorLocation != -1) {
-        glUniform3f(colorLocation, r, g, b);
-    }
+uint64_t ShaderManager::programCacheKey(unsigned featureBits) const {
+    uint64_t key = 14695981039346656037ULL;
+    if (cacheDirectory.empty()) return key;
+    
+    // A binary is only valid for the driver and the exact source it was built from
+    key = hashString(key, reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+    key = hashString(key, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    key = hashString(key, reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+    key = hashString(key, featureDefines(featureBits).c_str());
+    key = hashString(key, getVertexShaderSource());
+    key = hashString(key, getFragmentShaderSource());
+    return key;
 }
 
-void ShaderManager::setView(const float* viewMatrix) const {
-    if (viewLocation != -1) {
-        glUniformMatrix4fv(viewLocation, 1, GL_FALSE, viewMatrix);
-    }
+std::string ShaderManager::programCachePath(uint64_t key) const {
+    std::ostringstream path;
+    path << cacheDirectory << "program_" << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return path.str();
 }
 
-void ShaderManager::setProjection(const float* projectionMatrix) const {
-    if (projectionLocation != -1) {
-        glUniformMatrix4fv(projectionLocation, 1, GL_FALSE, projectionMatrix);
+GLuint ShaderManager::loadCachedProgram(uint64_t key) {
+    if (cacheDirectory.empty()) return 0;
+    
+    std::ifstream file(programCachePath(key), std::ios::binary);
+    if (!file.is_open()) return 0;
+    
+    ProgramCacheHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.magic != PROGRAM_CACHE_MAGIC || header.version != PROGRAM_CACHE_VERSION ||
+        header.key != key || header.length == 0) {
+        return 0;
     }
+    
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), binary.size())) return 0;
+    
+    // Drivers may still reject a binary (e.g. after an update that kept the version string)
+    GLuint program = glCreateProgram();
+    programBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+    
+    int success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
 }
 
-void ShaderManager::setUseTexture(bool use) const {
-    if (useTextureLocation != -1) {
-        glUniform1i(useTextureLocation, use ? 1 : 0);
+void ShaderManager::saveCachedProgram(uint64_t key, GLuint program) {
+    if (cacheDirectory.empty()) return;
+    
+    GLint length = 0;
+    glGetProgramiv(program, PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+    
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    getProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) return;
+    
+    ProgramCacheHeader header = {PROGRAM_CACHE_MAGIC, PROGRAM_CACHE_VERSION, key,
+                                 static_cast<uint32_t>(format), static_cast<uint32_t>(written)};
+    
+    // A failed write only costs a compile next run
+    std::string path = programCachePath(key);
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open() ||
+        !file.write(reinterpret_cast<const char*>(&header), sizeof(header)) ||
+        !file.write(binary.data(), written)) {
+        std::cout << "⚠️  Could not write program cache file: " << path << "\n";
     }
 }
 
-void ShaderManager::setIs2D(bool is2D) const {
-    if (is2DLocation != -1) {
-        glUniform1i(is2DLocation, is2D ? 1 : 0);
+bool ShaderManager::bindFrameGlobals(GLuint program) {
+    GLuint blockIndex = glGetUniformBlockIndex(program, "FrameGlobals");
+    if (blockIndex == GL_INVALID_INDEX) {
+        std::cerr << "❌ Shader program has no FrameGlobals uniform block\n";
+        return false;
+    }
+    glUniformBlockBinding(program, blockIndex, FRAME_GLOBALS_BINDING);
+    
+    // One buffer serves every program, so it is created with the first one
+    if (frameGlobalsBuffer == 0) {
+        glGenBuffers(1, &frameGlobalsBuffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, frameGlobalsBuffer);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameGlobals), nullptr, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_GLOBALS_BINDING, frameGlobalsBuffer);
     }
+    return true;
 }
 
-void ShaderManager::setShowWindowLights(bool show) const {
-    if (showWindowLightsLocation != -1) {
-        glUniform1i(showWindowLightsLocation, show ? 1 : 0);
+void ShaderManager::use() {
+    if (isCompiled && buildProgram(features)) {
+        glUseProgram(programs[features].id);
+        syncColor();
+        syncPointSize();
+        syncQuantization();
     }
+    boundTexture = 0;
+    boundTextureArray = 0;
+}
+
+void ShaderManager::bindTexture(GLuint texture) {
+    if (texture == 0 || texture == boundTexture) return;
+    glBindTexture(GL_TEXTURE_2D, texture);
+    boundTexture = texture;
 }
 
-void ShaderManager::setTimeOfDay(float time) const {
-    if (timeOfDayLocation != -1) {
-        glUniform1f(timeOfDayLocation, time);
+void ShaderManager::bindTextureArray(GLuint texture) {
+    if (texture == 0 || texture == boundTextureArray) return;
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    boundTextureArray = texture;
+}
+
+void ShaderManager::bindWindowOccupancy(GLuint texture) {
+    if (texture == 0 || texture == boundOccupancy) return;
+    glActiveTexture(GL_TEXTURE0 + WINDOW_OCCUPANCY_UNIT);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glActiveTexture(GL_TEXTURE0);
+    boundOccupancy = texture;
+}
+
+void ShaderManager::setFrameGlobals(const FrameGlobals& globals) {
+    if (frameGlobalsBuffer == 0) return;
+    if (frameGlobalsKnown && std::memcmp(&frameGlobals, &globals, sizeof(FrameGlobals)) == 0) return;
+    frameGlobals = globals;
+    frameGlobalsKnown = true;
+    glBindBuffer(GL_UNIFORM_BUFFER, frameGlobalsBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameGlobals), &globals);
+}
+
+void ShaderManager::setFeatures(unsigned featureBits) {
+    requestedFeatures = featureBits;
+    unsigned permutation = normalizeFeatures(featureBits);
+    if (permutation == features || !isCompiled) {
+        features = permutation;
+        return;
     }
+    
+    // Combinations outside the warm set are built on first use; keep the
+    // current program if that fails (the error is already reported)
+    if (!buildProgram(permutation)) return;
+    
+    features = permutation;
+    glUseProgram(programs[features].id);
+    syncColor();
+    syncPointSize();
+    syncQuantization();
+}
+
+void ShaderManager::setFeature(ShaderFeature feature, bool enabled) {
+    unsigned featureBits = enabled ? (requestedFeatures | feature) : (requestedFeatures & ~static_cast<unsigned>(feature));
+    setFeatures(featureBits);
+}
+
+void ShaderManager::syncColor() {
+    Program& program = programs[features];
+    if (!colorSet || program.colorLocation == -1) return;
+    if (program.colorKnown && program.color[0] == color[0] && program.color[1] == color[1] &&
+        program.color[2] == color[2]) return;
+    std::memcpy(program.color, color, sizeof(color));
+    program.colorKnown = true;
+    glUniform3f(program.colorLocation, color[0], color[1], color[2]);
+}
+
+void ShaderManager::setColor(float r, float g, float b) {
+    color[0] = r;
+    color[1] = g;
+    color[2] = b;
+    colorSet = true;
+    syncColor();
+}
+
+void ShaderManager::syncPointSize() {
+    Program& program = programs[features];
+    if (program.pointSizeLocation == -1) return;
+    if (program.pointSizeKnown && program.pointSize == pointSize) return;
+    program.pointSize = pointSize;
+    program.pointSizeKnown = true;
+    glUniform1f(program.pointSizeLocation, pointSize);
+}
+
+void ShaderManager::setPointSize(float size) {
+    pointSize = size;
+    syncPointSize();
+}
+
+void ShaderManager::syncQuantization() {
+    Program& program = programs[features];
+    if (!quantizationSet || program.quantizationLocations[0] == -1) return;
+    if (program.quantizationKnown && std::memcmp(program.quantization, quantization, sizeof(quantization)) == 0) return;
+    std::memcpy(program.quantization, quantization, sizeof(quantization));
+    program.quantizationKnown = true;
+    glUniform3fv(program.quantizationLocations[0], 1, quantization);
+    glUniform3fv(program.quantizationLocations[1], 1, quantization + 3);
+    glUniform4fv(program.quantizationLocations[2], 1, quantization + 6);
+}
+
+void ShaderManager::setVertexQuantization(const float origin[3], const float scale[3],
+                                          const float texCoordTransform[4]) {
+    std::memcpy(quantization, origin, 3 * sizeof(float));
+    std::memcpy(quantization + 3, scale, 3 * sizeof(float));
+    std::memcpy(quantization + 6, texCoordTransform, 4 * sizeof(float));
+    quantizationSet = true;
+    syncQuantization();
 }
@@ -7,82 +7,865 @@
  */
 
 #include "rendering/texture_manager.h"
+#include "utils/random_stream.h"
+#include "utils/job_system.h"
 #include "stb_image.h"
 #include <iostream>
-#include <vector>
-#include <cstdlib>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+namespace {
+
+// Compressed formats not in the 3.3 loader (S3TC, BPTC and ETC2 extensions)
+constexpr GLenum COMPRESSED_RGB_S3TC_DXT1 = 0x83F0;
+constexpr GLenum COMPRESSED_RGBA_S3TC_DXT1 = 0x83F1;
+constexpr GLenum COMPRESSED_RGBA_S3TC_DXT5 = 0x83F3;
+constexpr GLenum COMPRESSED_RGBA_BPTC_UNORM = 0x8E8C;
+constexpr GLenum COMPRESSED_RGB8_ETC2 = 0x9274;
+constexpr GLenum COMPRESSED_RGBA8_ETC2_EAC = 0x9278;
+
+// Bump whenever generateProceduralPixels() or buildMipChain() change their output
+constexpr uint64_t PROCEDURAL_CACHE_VERSION = 1;
+
+// Largest side taken from a KTX2 file; keeps level sizes far from overflowing
+constexpr uint32_t MAX_KTX2_SIZE = 16384;
+
+const unsigned char KTX2_IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+/// Fixed part of a KTX2 file, up to the level index
+struct Ktx2Header {
+    unsigned char identifier[12];
+    uint32_t vkFormat;
+    uint32_t typeSize;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t layerCount;
+    uint32_t faceCount;
+    uint32_t levelCount;
+    uint32_t supercompressionScheme;
+    uint32_t dfdByteOffset;
+    uint32_t dfdByteLength;
+    uint32_t kvdByteOffset;
+    uint32_t kvdByteLength;
+    uint64_t sgdByteOffset;
+    uint64_t sgdByteLength;
+};
+static_assert(sizeof(Ktx2Header) == 80, "KTX2 header is 80 bytes");
+
+/// One entry of the KTX2 level index
+struct Ktx2Level {
+    uint64_t byteOffset;
+    uint64_t byteLength;
+    uint64_t uncompressedByteLength;
+};
+
+/// GL upload format of a Vulkan format a KTX2 file may use
+struct Ktx2Format {
+    uint32_t vkFormat;
+    GLenum internalFormat;
+    GLenum pixelFormat;     ///< 0 for compressed formats
+    uint32_t unitBytes;     ///< Bytes per 4x4 block if compressed, else per pixel
+};
+
+// sRGB variants map to the plain formats: the JPEG path samples sRGB bytes
+// as linear too, so both look the same
+const Ktx2Format KTX2_FORMATS[] = {
+    {23, GL_RGB8, GL_RGB, 3},                  // R8G8B8_UNORM
+    {29, GL_RGB8, GL_RGB, 3},                  // R8G8B8_SRGB
+    {37, GL_RGBA8, GL_RGBA, 4},                // R8G8B8A8_UNORM
+    {43, GL_RGBA8, GL_RGBA, 4},                // R8G8B8A8_SRGB
+    {131, COMPRESSED_RGB_S3TC_DXT1, 0, 8},     // BC1_RGB_UNORM
+    {132, COMPRESSED_RGB_S3TC_DXT1, 0, 8},     // BC1_RGB_SRGB
+    {133, COMPRESSED_RGBA_S3TC_DXT1, 0, 8},    // BC1_RGBA_UNORM
+    {134, COMPRESSED_RGBA_S3TC_DXT1, 0, 8},    // BC1_RGBA_SRGB
+    {137, COMPRESSED_RGBA_S3TC_DXT5, 0, 16},   // BC3_UNORM
+    {138, COMPRESSED_RGBA_S3TC_DXT5, 0, 16},   // BC3_SRGB
+    {145, COMPRESSED_RGBA_BPTC_UNORM, 0, 16},  // BC7_UNORM
+    {146, COMPRESSED_RGBA_BPTC_UNORM, 0, 16},  // BC7_SRGB
+    {147, COMPRESSED_RGB8_ETC2, 0, 8},         // ETC2_R8G8B8_UNORM
+    {148, COMPRESSED_RGB8_ETC2, 0, 8},         // ETC2_R8G8B8_SRGB
+    {151, COMPRESSED_RGBA8_ETC2_EAC, 0, 16},   // ETC2_R8G8B8A8_UNORM
+    {152, COMPRESSED_RGBA8_ETC2_EAC, 0, 16},   // ETC2_R8G8B8A8_SRGB
+};
+
+// Half-size RGB image, each texel the average of a 2x2 box (edges clamped)
+std::vector<unsigned char> halveImage(const std::vector<unsigned char>& pixels, int width, int height,
+                                      int& halfWidth, int& halfHeight) {
+    halfWidth = std::max(1, width / 2);
+    halfHeight = std::max(1, height / 2);
+    std::vector<unsigned char> half(static_cast<size_t>(halfWidth) * halfHeight * 3);
+    
+    for (int y = 0; y < halfHeight; y++) {
+        int y0 = std::min(2 * y, height - 1);
+        int y1 = std::min(2 * y + 1, height - 1);
+        for (int x = 0; x < halfWidth; x++) {
+            int x0 = std::min(2 * x, width - 1);
+            int x1 = std::min(2 * x + 1, width - 1);
+            for (int c = 0; c < 3; c++) {
+                int sum = pixels[(static_cast<size_t>(y0) * width + x0) * 3 + c] +
+                          pixels[(static_cast<size_t>(y0) * width + x1) * 3 + c] +
+                          pixels[(static_cast<size_t>(y1) * width + x0) * 3 + c] +
+                          pixels[(static_cast<size_t>(y1) * width + x1) * 3 + c];
+                half[(static_cast<size_t>(y) * halfWidth + x) * 3 + c] = static_cast<unsigned char>((sum + 2) / 4);
+            }
+        }
+    }
+    return half;
+}
+
+uint16_t packRgb565(const int rgb[3]) {
+    return static_cast<uint16_t>(((rgb[0] >> 3) << 11) | ((rgb[1] >> 2) << 5) | (rgb[2] >> 3));
+}
+
+void unpackRgb565(uint16_t packed, int rgb[3]) {
+    int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+size_t bc1Size(int width, int height) {
+    return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * 8;
+}
+
+// BC1 (DXT1) encoder: endpoints from the block's color bounding box (inset
+// slightly to reduce error), each texel takes the nearest of the 4 colors
+void encodeBc1(const unsigned char* pixels, int width, int height, unsigned char* out) {
+    for (int blockY = 0; blockY < height; blockY += 4) {
+        for (int blockX = 0; blockX < width; blockX += 4) {
+            int block[16][3];
+            int low[3] = {255, 255, 255}, high[3] = {0, 0, 0};
+            for (int i = 0; i < 16; i++) {
+                int x = std::min(blockX + (i & 3), width - 1);
+                int y = std::min(blockY + (i >> 2), height - 1);
+                const unsigned char* texel = pixels + (static_cast<size_t>(y) * width + x) * 3;
+                for (int c = 0; c < 3; c++) {
+                    block[i][c] = texel[c];
+                    low[c] = std::min(low[c], block[i][c]);
+                    high[c] = std::max(high[c], block[i][c]);
+                }
+            }
+            for (int c = 0; c < 3; c++) {
+                int inset = (high[c] - low[c]) / 16;
+                low[c] += inset;
+                high[c] -= inset;
+            }
+            
+            // color0 > color1 selects the 4-color mode
+            uint16_t color0 = packRgb565(high), color1 = packRgb565(low);
+            if (color0 < color1) std::swap(color0, color1);
+            
+            uint32_t indices = 0;
+            if (color0 != color1) {
+                int palette[4][3];
+                unpackRgb565(color0, palette[0]);
+                unpackRgb565(color1, palette[1]);
+                for (int c = 0; c < 3; c++) {
+                    palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                    palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+                }
+                for (int i = 0; i < 16; i++) {
+                    int best = 0, bestDistance = 1 << 30;
+                    for (int p = 0; p < 4; p++) {
+                        int dr = block[i][0] - palette[p][0];
+                        int dg = block[i][1] - palette[p][1];
+                        int db = block[i][2] - palette[p][2];
+                        int distance = dr * dr + dg * dg + db * db;
+                        if (distance < bestDistance) {
+                            bestDistance = distance;
+                            best = p;
+                        }
+                    }
+                    indices |= static_cast<uint32_t>(best) << (2 * i);
+                }
+            }
+            
+            // Little-endian: color0, color1, then 2 bits per texel, row by row
+            out[0] = color0 & 0xFF;
+            out[1] = color0 >> 8;
+            out[2] = color1 & 0xFF;
+            out[3] = color1 >> 8;
+            for (int b = 0; b < 4; b++) {
+                out[4 + b] = (indices >> (8 * b)) & 0xFF;
+            }
+            out += 8;
+        }
+    }
+}
+
+// Mip levels from a square edge down to 1x1
+int fullLevelCount(int size) {
+    int levels = 1;
+    while (size > 1) {
+        size /= 2;
+        levels++;
+    }
+    return levels;
+}
+
+// FNV-1a
+uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// KHR data format descriptor (basic block) of RGB8 or BC1, linear BT.709
+std::vector<uint32_t> basicDataFormatDescriptor(bool bc1) {
+    const uint32_t sampleCount = bc1 ? 1 : 3;
+    const uint32_t blockSize = 24 + 16 * sampleCount;
+    std::vector<uint32_t> words;
+    words.push_back(4 + blockSize);                     // dfdTotalSize
+    words.push_back(0);                                 // Khronos vendor, basic descriptor type
+    words.push_back(2 | (blockSize << 16));             // Version 2 and the block size
+    words.push_back((bc1 ? 128u : 1u) | (1u << 8) | (1u << 16));  // BC1A or RGBSDA, BT.709, linear
+    words.push_back(bc1 ? (3u | (3u << 8)) : 0u);       // Texel block dimensions minus one
+    words.push_back(bc1 ? 8u : 3u);                     // Bytes per block (plane 0)
+    words.push_back(0);
+    for (uint32_t sample = 0; sample < sampleCount; sample++) {
+        uint32_t bitOffset = bc1 ? 0 : 8 * sample;
+        uint32_t bitLength = bc1 ? 63 : 7;              // Minus one
+        words.push_back(bitOffset | (bitLength << 16) | (sample << 24));  // Channel R, G, B (BC1: color)
+        words.push_back(0);                             // Sample position
+        words.push_back(0);                             // Lower bound
+        words.push_back(bc1 ? UINT32_MAX : 255u);       // Upper bound
+    }
+    return words;
+}
+
+bool hasExtension(const char* wanted) {
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (GLint i = 0; i < extensionCount; i++) {
+        const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (name && std::strcmp(name, wanted) == 0) return true;
+    }
+    return false;
+}
+
+}  // namespace
 
 // Constructor
-TextureManager::TextureManager() {
+TextureManager::TextureManager()
+    : nextRequest(0), stopping(false), pendingUploads(0), uploadBuffer(0), textureBytes(0) {
     // Initialize empty texture cache
 }
 
 // Destructor
 TextureManager::~TextureManager() {
+    stopDecoding();
     cleanup();
 }
 
-// Load all required textures for the application
+// Cache generated textures in a directory
+void TextureManager::enableProceduralCache(const std::string& directory) {
+    mkdir(directory.c_str(), 0755);
+    proceduralCacheDirectory = directory;
+}
+
+// Cache file of a generated texture, keyed by everything that shapes its data
+std::string TextureManager::proceduralCachePath(const std::string& type, int size) const {
+    if (proceduralCacheDirectory.empty()) return "";
+    
+    const int maxSize = MAX_TEXTURE_SIZE;
+    const bool compressed = support.s3tc;
+    uint64_t key = 14695981039346656037ULL;
+    key = hashBytes(key, &PROCEDURAL_CACHE_VERSION, sizeof(PROCEDURAL_CACHE_VERSION));
+    key = hashBytes(key, type.c_str(), type.size() + 1);
+    key = hashBytes(key, &size, sizeof(size));
+    key = hashBytes(key, &maxSize, sizeof(maxSize));
+    key = hashBytes(key, &compressed, sizeof(compressed));
+    
+    std::ostringstream path;
+    path << proceduralCacheDirectory << "procedural_" << type << "_"
+         << std::hex << std::setw(16) << std::setfill('0') << key << ".ktx2";
+    return path.str();
+}
+
+// Start loading all required textures for the application
 void TextureManager::loadAllTextures() {
     std::cout << "\n🎨 Loading Textures...\n";
+    stopDecoding();
+    cleanup();
+    loadStart = std::chrono::steady_clock::now();
     
-    // Load building textures
-    GLuint brickTex = loadTextureFromFile("assets/brick.jpg");
-    if (brickTex == 0) {
-        std::cout << "⚠️  Warning: Could not load brick.jpg, generating procedural\n";
-        brickTex = generateProceduralTexture("brick");
-    } else {
-        std::cout << "✅ Loaded brick texture from assets/brick.jpg\n";
+    // Building material layers, then road, grass for parks and the fountain
+    requests = {
+        {"brick", "brick", "brick", MATERIAL_BRICK, {170, 65, 50}},
+        {"concrete", "concrete", "concrete", MATERIAL_CONCRETE, {150, 150, 150}},
+        {"glass", "glass", "glass", MATERIAL_GLASS, {115, 165, 215}},
+        {"road", "road", "asphalt", -1, {55, 55, 60}},
+        {"grass", "grass", "grass", -1, {65, 150, 60}},
+        {"fountain", "fountains", "water", -1, {95, 180, 228}}
+    };
+    support = queryCompressionSupport();
+    
+    // Placeholders keep the final texture IDs, so rendering can start now
+    textureCache["materials"] = createMaterialArray();
+    for (const TextureRequest& request : requests) {
+        if (request.layer < 0) {
+            textureCache[request.name] = createPlaceholder(request.placeholder);
+        }
+        textureReady[request.name] = false;
+    }
+    pendingUploads = requests.size();
+    
+    // Flip textures vertically to match OpenGL coordinate system (set once,
+    // before any thread decodes)
+    stbi_set_flip_vertically_on_load(true);
+    
+    nextRequest = 0;
+    stopping = false;
+    size_t threadCount = std::min<size_t>(requests.size(), std::max(1u, JobSystem::defaultWorkerCount()));
+    for (size_t i = 0; i < threadCount; i++) {
+        decodeThreads.emplace_back(&TextureManager::decodeLoop, this);
+    }
+    std::cout << "   Decoding " << requests.size() << " textures on " << threadCount
+              << " background thread(s)" << (support.s3tc ? ", BC1 compression" : "") << "\n";
+}
+
+// Decode thread body
+void TextureManager::decodeLoop() {
+    while (!stopping) {
+        size_t index = nextRequest.fetch_add(1);
+        if (index >= requests.size()) return;
+        
+        DecodedTexture texture = decodeTexture(requests[index]);
+        std::lock_guard<std::mutex> lock(decodedMutex);
+        decoded.push_back(std::move(texture));
+    }
+}
+
+// Load one texture: KTX2 first, then the JPEG, then a cached or freshly generated fallback
+TextureManager::DecodedTexture TextureManager::decodeTexture(const TextureRequest& request) const {
+    DecodedTexture texture;
+    texture.name = request.name;
+    
+    std::string ktx2Path = "assets/" + request.file + ".ktx2";
+    if (loadKtx2(ktx2Path, texture)) {
+        texture.layer = request.layer;
+        if (request.layer < 0 || matchesMaterialArray(texture)) {
+            texture.source = ktx2Path;
+            return texture;
+        }
+        std::cout << "⚠️  Warning: " << ktx2Path << " must be " << MATERIAL_LAYER_SIZE << "x"
+                  << MATERIAL_LAYER_SIZE << " with every mip level in the material array format\n";
     }
-    textureCache["brick"] = brickTex;
+    texture.layer = request.layer;
     
-    GLuint concreteTex = loadTextureFromFile("assets/concrete.jpg");
-    if (concreteTex == 0) {
-        std::cout << "⚠️  Warning: Could not load concrete.jpg, generating procedural\n";
-        concreteTex = generateProceduralTexture("concrete");
+    std::string imagePath = "assets/" + request.file + ".jpg";
+    std::vector<unsigned char> pixels;
+    int width = 0, height = 0;
+    if (loadImageFile(imagePath, pixels, width, height)) {
+        texture.source = imagePath;
     } else {
-        std::cout << "✅ Loaded concrete texture from assets/concrete.jpg\n";
+        // Generated at the size it is sampled at: layers need no resampling
+        int size = request.layer >= 0 ? MATERIAL_LAYER_SIZE : PROCEDURAL_SIZE;
+        std::string cachePath = proceduralCachePath(request.fallbackType, size);
+        if (!cachePath.empty() && loadKtx2(cachePath, texture) &&
+            (request.layer < 0 || matchesMaterialArray(texture))) {
+            texture.source = cachePath;
+            return texture;
+        }
+        
+        pixels = generateProceduralPixels(request.fallbackType, size);
+        buildMipChain(std::move(pixels), size, size, texture);
+        if (!cachePath.empty() && !saveKtx2(cachePath, texture)) {
+            std::cout << "⚠️  Warning: Could not write texture cache file " << cachePath << "\n";
+        }
+        return texture;
     }
-    textureCache["concrete"] = concreteTex;
+    if (request.layer >= 0) {
+        pixels = resampleToLayer(std::move(pixels), width, height);
+        width = height = MATERIAL_LAYER_SIZE;
+    }
+    buildMipChain(std::move(pixels), width, height, texture);
+    return texture;
+}
+
+// Load texture from image file using STB Image
+bool TextureManager::loadImageFile(const std::string& filepath, std::vector<unsigned char>& pixels,
+                                   int& width, int& height) {
+    int nrChannels;
+    
+    // Always decode to RGB; the textures are opaque
+    unsigned char* data = stbi_load(filepath.c_str(), &width, &height, &nrChannels, 3);
+    if (!data) {
+        return false; // Failed to load
+    }
+    
+    pixels.assign(data, data + static_cast<size_t>(width) * height * 3);
+    stbi_image_free(data);
+    return true;
+}
+
+// Read a KTX2 container with its mip levels
+bool TextureManager::loadKtx2(const std::string& filepath, DecodedTexture& texture) const {
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) return false;
     
-    GLuint glassTex = loadTextureFromFile("assets/glass.jpg");
-    if (glassTex == 0) {
-        std::cout << "⚠️  Warning: Could not load glass.jpg, generating procedural\n";
-        glassTex = generateProceduralTexture("glass");
+    Ktx2Header header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) {
+        std::cout << "⚠️  Warning: " << filepath << " is not a KTX2 file\n";
+        return false;
+    }
+    if (header.pixelWidth == 0 || header.pixelHeight == 0 ||
+        header.pixelWidth > MAX_KTX2_SIZE || header.pixelHeight > MAX_KTX2_SIZE || header.pixelDepth > 1 ||
+        header.layerCount > 1 || header.faceCount != 1 || header.supercompressionScheme != 0) {
+        std::cout << "⚠️  Warning: " << filepath << " must be a single 2D image (at most " << MAX_KTX2_SIZE
+                  << " texels a side) without supercompression\n";
+        return false;
+    }
+    
+    const Ktx2Format* format = nullptr;
+    for (const Ktx2Format& candidate : KTX2_FORMATS) {
+        if (candidate.vkFormat == header.vkFormat) format = &candidate;
+    }
+    bool compressed = format && format->pixelFormat == 0;
+    bool sampleable = format &&
+        (!compressed ||
+         ((format->internalFormat == COMPRESSED_RGB_S3TC_DXT1 || format->internalFormat == COMPRESSED_RGBA_S3TC_DXT1 ||
+           format->internalFormat == COMPRESSED_RGBA_S3TC_DXT5) && support.s3tc) ||
+         (format->internalFormat == COMPRESSED_RGBA_BPTC_UNORM && support.bptc) ||
+         ((format->internalFormat == COMPRESSED_RGB8_ETC2 || format->internalFormat == COMPRESSED_RGBA8_ETC2_EAC) &&
+          support.etc2));
+    if (!sampleable) {
+        std::cout << "⚠️  Warning: " << filepath << " uses VkFormat " << header.vkFormat
+                  << ", which this driver cannot sample; using the JPEG\n";
+        return false;
+    }
+    
+    // levelCount 0 asks the loader to generate the mip chain; a full chain ends at 1x1
+    uint32_t maxLevels = 1;
+    while ((std::max(header.pixelWidth, header.pixelHeight) >> maxLevels) != 0) maxLevels++;
+    if (header.levelCount > maxLevels) {
+        std::cout << "⚠️  Warning: " << filepath << " declares " << header.levelCount << " mip levels for a "
+                  << header.pixelWidth << "x" << header.pixelHeight << " image\n";
+        return false;
+    }
+    uint32_t levelCount = std::max(1u, header.levelCount);
+    std::vector<Ktx2Level> index(levelCount);
+    if (!file.read(reinterpret_cast<char*>(index.data()), levelCount * sizeof(Ktx2Level))) {
+        std::cout << "⚠️  Warning: " << filepath << " is truncated\n";
+        return false;
+    }
+    
+    texture.internalFormat = format->internalFormat;
+    texture.pixelFormat = compressed ? 0 : format->pixelFormat;
+    texture.compressed = compressed;
+    texture.generateMipmaps = header.levelCount == 0 && !compressed;
+    texture.levels.clear();
+    texture.data.clear();
+    
+    // Every level must lie inside the file and hold exactly its image, so a
+    // corrupt file is rejected before anything is allocated for it
+    file.seekg(0, std::ios::end);
+    std::streamoff end = file.tellg();
+    uint64_t fileSize = end > 0 ? static_cast<uint64_t>(end) : 0;
+    for (uint32_t level = 0; level < levelCount; level++) {
+        uint64_t width = std::max(1u, header.pixelWidth >> level);
+        uint64_t height = std::max(1u, header.pixelHeight >> level);
+        uint64_t expected = compressed ? ((width + 3) / 4) * ((height + 3) / 4) * format->unitBytes
+                                       : width * height * format->unitBytes;
+        const Ktx2Level& range = index[level];
+        if (range.byteLength != expected || range.byteOffset > fileSize || range.byteLength > fileSize - range.byteOffset) {
+            std::cout << "⚠️  Warning: " << filepath << " has a corrupt or truncated mip level " << level << "\n";
+            return false;
+        }
+    }
+    
+    for (uint32_t level = 0; level < levelCount; level++) {
+        TextureLevel entry;
+        entry.width = std::max(1, static_cast<int>(header.pixelWidth >> level));
+        entry.height = std::max(1, static_cast<int>(header.pixelHeight >> level));
+        entry.offset = texture.data.size();
+        entry.size = static_cast<size_t>(index[level].byteLength);
+        
+        texture.data.resize(entry.offset + entry.size);
+        file.seekg(static_cast<std::streamoff>(index[level].byteOffset));
+        if (entry.size == 0 || !file.read(reinterpret_cast<char*>(texture.data.data() + entry.offset), entry.size)) {
+            std::cout << "⚠️  Warning: " << filepath << " is truncated\n";
+            return false;
+        }
+        texture.levels.push_back(entry);
+    }
+    return true;
+}
+
+// Write a texture as KTX2: header, level index, DFD, then the levels smallest first
+bool TextureManager::saveKtx2(const std::string& filepath, const DecodedTexture& texture) {
+    const Ktx2Format* format = nullptr;
+    for (const Ktx2Format& candidate : KTX2_FORMATS) {
+        if (!format && candidate.internalFormat == texture.internalFormat) format = &candidate;
+    }
+    bool bc1 = texture.compressed && texture.internalFormat == COMPRESSED_RGB_S3TC_DXT1;
+    bool rgb8 = !texture.compressed && texture.internalFormat == GL_RGB8 && texture.pixelFormat == GL_RGB;
+    if (!format || (!bc1 && !rgb8) || texture.levels.empty()) return false;
+    
+    std::vector<uint32_t> dfd = basicDataFormatDescriptor(bc1);
+    size_t levelCount = texture.levels.size();
+    
+    Ktx2Header header = {};
+    std::memcpy(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+    header.vkFormat = format->vkFormat;
+    header.typeSize = 1;
+    header.pixelWidth = static_cast<uint32_t>(texture.levels.front().width);
+    header.pixelHeight = static_cast<uint32_t>(texture.levels.front().height);
+    header.faceCount = 1;
+    header.levelCount = static_cast<uint32_t>(levelCount);
+    header.dfdByteOffset = static_cast<uint32_t>(sizeof(Ktx2Header) + levelCount * sizeof(Ktx2Level));
+    header.dfdByteLength = static_cast<uint32_t>(dfd.size() * sizeof(uint32_t));
+    
+    // Levels start at multiples of the texel block size and of 4
+    const uint64_t alignment = bc1 ? 8 : 12;
+    std::vector<Ktx2Level> index(levelCount);
+    uint64_t offset = header.dfdByteOffset + header.dfdByteLength;
+    for (size_t level = levelCount; level-- > 0;) {
+        offset = (offset + alignment - 1) / alignment * alignment;
+        index[level].byteOffset = offset;
+        index[level].byteLength = texture.levels[level].size;
+        index[level].uncompressedByteLength = texture.levels[level].size;
+        offset += texture.levels[level].size;
+    }
+    
+    // Written beside the final name and renamed, so a reader never sees half a file
+    std::string temporaryPath = filepath + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(Ktx2Level));
+        file.write(reinterpret_cast<const char*>(dfd.data()), dfd.size() * sizeof(uint32_t));
+        uint64_t written = header.dfdByteOffset + header.dfdByteLength;
+        const char padding[16] = {};
+        for (size_t level = levelCount; level-- > 0;) {
+            file.write(padding, static_cast<std::streamsize>(index[level].byteOffset - written));
+            const TextureLevel& entry = texture.levels[level];
+            file.write(reinterpret_cast<const char*>(texture.data.data() + entry.offset), entry.size);
+            written = index[level].byteOffset + entry.size;
+        }
+        if (!file.good()) {
+            file.close();
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+    }
+    return std::rename(temporaryPath.c_str(), filepath.c_str()) == 0;
+}
+
+// Bilinear resample to the layer square (after halving to at most twice its size)
+std::vector<unsigned char> TextureManager::resampleToLayer(std::vector<unsigned char> pixels, int width, int height) {
+    while (width >= 2 * MATERIAL_LAYER_SIZE && height >= 2 * MATERIAL_LAYER_SIZE) {
+        pixels = halveImage(pixels, width, height, width, height);
+    }
+    if (width == MATERIAL_LAYER_SIZE && height == MATERIAL_LAYER_SIZE) return pixels;
+    
+    std::vector<unsigned char> layer(static_cast<size_t>(MATERIAL_LAYER_SIZE) * MATERIAL_LAYER_SIZE * 3);
+    float scaleX = static_cast<float>(width) / MATERIAL_LAYER_SIZE;
+    float scaleY = static_cast<float>(height) / MATERIAL_LAYER_SIZE;
+    for (int y = 0; y < MATERIAL_LAYER_SIZE; y++) {
+        float sourceY = std::max(0.0f, (y + 0.5f) * scaleY - 0.5f);
+        int y0 = std::min(static_cast<int>(sourceY), height - 1);
+        int y1 = std::min(y0 + 1, height - 1);
+        float fy = sourceY - y0;
+        for (int x = 0; x < MATERIAL_LAYER_SIZE; x++) {
+            float sourceX = std::max(0.0f, (x + 0.5f) * scaleX - 0.5f);
+            int x0 = std::min(static_cast<int>(sourceX), width - 1);
+            int x1 = std::min(x0 + 1, width - 1);
+            float fx = sourceX - x0;
+            for (int c = 0; c < 3; c++) {
+                float top = pixels[(static_cast<size_t>(y0) * width + x0) * 3 + c] * (1.0f - fx) +
+                            pixels[(static_cast<size_t>(y0) * width + x1) * 3 + c] * fx;
+                float bottom = pixels[(static_cast<size_t>(y1) * width + x0) * 3 + c] * (1.0f - fx) +
+                               pixels[(static_cast<size_t>(y1) * width + x1) * 3 + c] * fx;
+                layer[(static_cast<size_t>(y) * MATERIAL_LAYER_SIZE + x) * 3 + c] =
+                    static_cast<unsigned char>(top * (1.0f - fy) + bottom * fy + 0.5f);
+            }
+        }
+    }
+    return layer;
+}
+
+// A layer must have the array's size, format and full mip chain
+bool TextureManager::matchesMaterialArray(const DecodedTexture& texture) const {
+    GLenum arrayFormat = support.s3tc ? COMPRESSED_RGB_S3TC_DXT1 : GL_RGB8;
+    return !texture.levels.empty() && !texture.generateMipmaps &&
+           texture.levels.front().width == MATERIAL_LAYER_SIZE &&
+           texture.levels.front().height == MATERIAL_LAYER_SIZE &&
+           static_cast<int>(texture.levels.size()) == fullLevelCount(MATERIAL_LAYER_SIZE) &&
+           texture.internalFormat == arrayFormat && (texture.compressed || texture.pixelFormat == GL_RGB);
+}
+
+// Reduce to MAX_TEXTURE_SIZE and store every mip level (BC1 when available)
+void TextureManager::buildMipChain(std::vector<unsigned char> pixels, int width, int height,
+                                   DecodedTexture& texture) const {
+    while (width > MAX_TEXTURE_SIZE || height > MAX_TEXTURE_SIZE) {
+        pixels = halveImage(pixels, width, height, width, height);
+    }
+    
+    texture.compressed = support.s3tc;
+    texture.internalFormat = support.s3tc ? COMPRESSED_RGB_S3TC_DXT1 : GL_RGB8;
+    texture.pixelFormat = GL_RGB;
+    texture.generateMipmaps = false;
+    texture.levels.clear();
+    texture.data.clear();
+    
+    while (true) {
+        TextureLevel level;
+        level.width = width;
+        level.height = height;
+        level.offset = texture.data.size();
+        level.size = texture.compressed ? bc1Size(width, height) : pixels.size();
+        texture.data.resize(level.offset + level.size);
+        
+        if (texture.compressed) {
+            encodeBc1(pixels.data(), width, height, texture.data.data() + level.offset);
+        } else {
+            std::memcpy(texture.data.data() + level.offset, pixels.data(), level.size);
+        }
+        texture.levels.push_back(level);
+        
+        if (width == 1 && height == 1) break;
+        pixels = halveImage(pixels, width, height, width, height);
+    }
+}
+
+// Upload the next decoded texture, if any
+void TextureManager::update() {
+    if (pendingUploads == 0) return;
+    
+    DecodedTexture texture;
+    {
+        std::lock_guard<std::mutex> lock(decodedMutex);
+        if (decoded.empty()) return;
+        texture = std::move(decoded.front());
+        decoded.erase(decoded.begin());
+    }
+    
+    auto it = textureCache.find(texture.layer < 0 ? texture.name : std::string("materials"));
+    if (it == textureCache.end()) return;
+    if (texture.layer < 0) {
+        uploadTexture(it->second, texture);
     } else {
-        std::cout << "✅ Loaded glass texture from assets/glass.jpg\n";
+        uploadMaterialLayer(it->second, texture);
     }
-    textureCache["glass"] = glassTex;
+    textureReady[texture.name] = true;
+    pendingUploads--;
     
-    // Load road texture
-    GLuint roadTex = loadTextureFromFile("assets/road.jpg");
-    if (roadTex == 0) {
-        std::cout << "⚠️  Warning: Could not load road.jpg, generating procedural\n";
-        roadTex = generateProceduralTexture("asphalt");
+    const TextureLevel& top = texture.levels.front();
+    if (texture.source.empty()) {
+        std::cout << "⚠️  Warning: Could not load " << texture.name << " texture, generated procedural\n";
     } else {
-        std::cout << "✅ Loaded road texture from assets/road.jpg\n";
+        std::cout << "✅ Loaded " << texture.name << " texture from " << texture.source << " ("
+                  << top.width << "x" << top.height << ", " << texture.levels.size() << " levels"
+                  << (texture.compressed ? ", compressed" : "")
+                  << (texture.layer >= 0 ? ", material layer" : "") << ")\n";
     }
-    textureCache["road"] = roadTex;
     
-    // Load grass texture for parks
-    GLuint grassTex = loadTextureFromFile("assets/grass.jpg");
-    if (grassTex == 0) {
-        std::cout << "⚠️  Warning: Could not load grass.jpg, using green color\n";
-        grassTex = generateProceduralTexture("grass");
+    if (pendingUploads == 0) {
+        stopDecoding();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStart).count();
+        std::cout << "🎨 All textures ready after " << seconds << " s, "
+                  << (textureBytes / 1024) << " KB of texture memory\n";
+    }
+}
+
+// 1x1 texture of a material color
+GLuint TextureManager::createPlaceholder(const unsigned char color[3]) {
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, color);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    return textureID;
+}
+
+// Material array with every layer filled with its placeholder color
+GLuint TextureManager::createMaterialArray() {
+    GLuint arrayID;
+    glGenTextures(1, &arrayID);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, arrayID);
+    
+    // Storage for every level of every layer (BC1 when S3TC is available)
+    int levelCount = fullLevelCount(MATERIAL_LAYER_SIZE);
+    for (int level = 0; level < levelCount; level++) {
+        int size = std::max(1, MATERIAL_LAYER_SIZE >> level);
+        if (support.s3tc) {
+            glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, COMPRESSED_RGB_S3TC_DXT1, size, size, MATERIAL_COUNT,
+                                   0, static_cast<GLsizei>(bc1Size(size, size) * MATERIAL_COUNT), nullptr);
+        } else {
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGB8, size, size, MATERIAL_COUNT, 0,
+                         GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+        }
+    }
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    
+    // Solid placeholder layers: repeat one texel (or one BC1 block) everywhere
+    for (const TextureRequest& request : requests) {
+        if (request.layer < 0) continue;
+        
+        DecodedTexture placeholder;
+        placeholder.layer = request.layer;
+        placeholder.compressed = support.s3tc;
+        placeholder.internalFormat = support.s3tc ? COMPRESSED_RGB_S3TC_DXT1 : GL_RGB8;
+        unsigned char block[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        int rgb[3] = {request.placeholder[0], request.placeholder[1], request.placeholder[2]};
+        uint16_t packed = packRgb565(rgb);
+        block[0] = block[2] = packed & 0xFF;
+        block[1] = block[3] = packed >> 8;
+        
+        for (int level = 0; level < levelCount; level++) {
+            TextureLevel entry;
+            entry.width = entry.height = std::max(1, MATERIAL_LAYER_SIZE >> level);
+            entry.offset = placeholder.data.size();
+            entry.size = support.s3tc ? bc1Size(entry.width, entry.height)
+                                      : static_cast<size_t>(entry.width) * entry.height * 3;
+            const unsigned char* pattern = support.s3tc ? block : request.placeholder;
+            size_t patternSize = support.s3tc ? sizeof(block) : 3;
+            for (size_t i = 0; i < entry.size; i += patternSize) {
+                placeholder.data.insert(placeholder.data.end(), pattern, pattern + patternSize);
+            }
+            placeholder.levels.push_back(entry);
+        }
+        uploadMaterialLayer(arrayID, placeholder);
+    }
+    
+    // Every layer holds space for its full chain whether or not its image arrives
+    size_t layerBytes = 0;
+    for (int level = 0; level < levelCount; level++) {
+        int size = std::max(1, MATERIAL_LAYER_SIZE >> level);
+        layerBytes += support.s3tc ? bc1Size(size, size) : static_cast<size_t>(size) * size * 4;
+    }
+    textureBytes += layerBytes * MATERIAL_COUNT;
+    return arrayID;
+}
+
+// Stage the levels in a pixel buffer; the texture calls then read from it
+// without blocking on a client-memory copy
+const unsigned char* TextureManager::stageUpload(const DecodedTexture& texture) {
+    if (uploadBuffer == 0) glGenBuffers(1, &uploadBuffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadBuffer);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, texture.data.size(), nullptr, GL_STREAM_DRAW);
+    void* staging = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, texture.data.size(),
+                                     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    const unsigned char* source = nullptr;  // Offsets into the bound buffer
+    if (staging) {
+        std::memcpy(staging, texture.data.data(), texture.data.size());
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
     } else {
-        std::cout << "✅ Loaded grass texture from assets/grass.jpg\n";
+        // Mapping failed: upload straight from client memory instead
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        source = texture.data.data();
     }
-    textureCache["grass"] = grassTex;
+    return source;
+}
+
+// Replace a texture's storage with every level of a decoded image
+void TextureManager::uploadTexture(GLuint textureID, const DecodedTexture& texture) {
+    const unsigned char* source = stageUpload(texture);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (size_t level = 0; level < texture.levels.size(); level++) {
+        const TextureLevel& entry = texture.levels[level];
+        const void* pixels = source + entry.offset;
+        if (texture.compressed) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), texture.internalFormat,
+                                   entry.width, entry.height, 0, static_cast<GLsizei>(entry.size), pixels);
+        } else {
+            glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), texture.internalFormat,
+                         entry.width, entry.height, 0, texture.pixelFormat, GL_UNSIGNED_BYTE, pixels);
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
     
-    // Load fountain texture
-    GLuint fountainTex = loadTextureFromFile("assets/fountains.jpg");
-    if (fountainTex == 0) {
-        std::cout << "⚠️  Warning: Could not load fountains.jpg, using cyan color\n";
-        fountainTex = generateProceduralTexture("water");
+    // Generate mipmaps for better quality at distance unless the file brought them
+    GLint maxLevel = static_cast<GLint>(texture.levels.size() - 1);
+    if (texture.generateMipmaps) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+        glGenerateMipmap(GL_TEXTURE_2D);
     } else {
-        std::cout << "✅ Loaded fountain texture from assets/fountains.jpg\n";
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
     }
-    textureCache["fountain"] = fountainTex;
+    
+    // Set texture parameters
+    bool mipmapped = texture.generateMipmaps || maxLevel > 0;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    
+    // Uncompressed RGB is usually padded to 4 bytes per texel on the GPU
+    size_t bytes = texture.data.size();
+    if (!texture.compressed && texture.pixelFormat == GL_RGB) bytes = bytes / 3 * 4;
+    if (texture.generateMipmaps) bytes += bytes / 3;
+    textureBytes += bytes;
+}
+
+// Overwrite one array layer; the storage already has the right size and format
+void TextureManager::uploadMaterialLayer(GLuint arrayID, const DecodedTexture& texture) {
+    const unsigned char* source = stageUpload(texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, arrayID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (size_t level = 0; level < texture.levels.size(); level++) {
+        const TextureLevel& entry = texture.levels[level];
+        const void* pixels = source + entry.offset;
+        if (texture.compressed) {
+            glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), 0, 0, texture.layer,
+                                      entry.width, entry.height, 1, texture.internalFormat,
+                                      static_cast<GLsizei>(entry.size), pixels);
+        } else {
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), 0, 0, texture.layer,
+                            entry.width, entry.height, 1, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+// Compressed formats the current context can sample
+TextureManager::CompressionSupport TextureManager::queryCompressionSupport() {
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    int version = major * 10 + minor;
+    
+    CompressionSupport result;
+    result.s3tc = hasExtension("GL_EXT_texture_compression_s3tc");
+    result.bptc = version >= 42 || hasExtension("GL_ARB_texture_compression_bptc");
+    result.etc2 = version >= 43 || hasExtension("GL_ARB_ES3_compatibility");
+    return result;
+}
+
+// Stop and join the decode threads
+void TextureManager::stopDecoding() {
+    stopping = true;
+    for (std::thread& thread : decodeThreads) {
+        thread.join();
+    }
+    decodeThreads.clear();
 }
 
 // Get texture by name
@@ -99,6 +882,12 @@ bool TextureManager::hasTexture(const std::string& name) const {
     return textureCache.find(name) != textureCache.end();
 }
 
+// Check if a texture's image has been uploaded
+bool TextureManager::isTextureReady(const std::string& name) const {
+    auto it = textureReady.find(name);
+    return it != textureReady.end() && it->second;
+}
+
 // Cleanup all textures
 void TextureManager::cleanup() {
     for (auto& pair : textureCache) {
@@ -107,60 +896,38 @@ void TextureManager::cleanup() {
         }
     }
     textureCache.clear();
-}
-
-// Load texture from image file using STB Image
-GLuint TextureManager::loadTextureFromFile(const std::string& filepath) {
-    int width, height, nrChannels;
+    textureReady.clear();
+    decoded.clear();
+    pendingUploads = 0;
+    textureBytes = 0;
     
-    // Flip textures vertically to match OpenGL coordinate system
-    stbi_set_flip_vertically_on_load(true);
-    
-    // Load image data
-    unsigned char* data = stbi_load(filepath.c_str(), &width, &height, &nrChannels, 0);
-    
-    if (!data) {
-        return 0; // Failed to load
+    if (uploadBuffer != 0) {
+        glDeleteBuffers(1, &uploadBuffer);
+        uploadBuffer = 0;
     }
-    
-    // Generate OpenGL texture
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    
-    // Determine format (RGB or RGBA)
-    GLenum format = (nrChannels == 3) ? GL_RGB : GL_RGBA;
-    
-    // Upload texture data to GPU
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    
-    // Generate mipmaps for better quality at distance
-    glGenerateMipmap(GL_TEXTURE_2D);
-    
-    // Set texture parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    
-    // Free image data
-    stbi_image_free(data);
-    
-    return textureID;
 }
 
-// Generate procedural texture as fallback
-GLuint TextureManager::generateProceduralTexture(const std::string& type) {
-    const int width = 256;
-    const int height = 256;
-    std::vector<unsigned char> data(width * height * 3);
+// Generate procedural texture pixels as fallback
+std::vector<unsigned char> TextureManager::generateProceduralPixels(const std::string& type, int size) {
+    const int width = size;
+    const int height = size;
+    std::vector<unsigned char> data(static_cast<size_t>(width) * height * 3);
+    
+    // Pattern sizes are given for a 256 texel texture and scale with the size
+    auto scaled = [size](int texels) { return std::max(1, texels * size / 256); };
+    
+    // Fixed per-type seed (FNV-1a of the name): the same fallback texels on every run
+    uint64_t typeSeed = 14695981039346656037ULL;
+    for (char c : type) typeSeed = (typeSeed ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    RandomStream rng(typeSeed, RandomStreamId::TEXTURES);
     
     if (type == "brick") {
         // Red brick pattern with mortar
+        const int course = scaled(32), brickLength = scaled(64), mortar = scaled(2);
         for (int y = 0; y < height; ++y) {
             for (int x = 0; x < width; ++x) {
-                int idx = (y * width + x) * 3;
-                bool isMortar = (y % 32 < 2) || (x % 64 < 2);
+                size_t idx = (static_cast<size_t>(y) * width + x) * 3;
+                bool isMortar = (y % course < mortar) || (x % brickLength < mortar);
                 if (isMortar) {
                     // Gray mortar lines
                     data[idx] = 180; 
@@ -168,9 +935,9 @@ GLuint TextureManager::generateProceduralTexture(const std::string& type) {
                     data[idx+2] = 180;
                 } else {
                     // Red brick with variation for realism
-                    data[idx] = 160 + (rand() % 40);
-                    data[idx+1] = 50 + (rand() % 30);
-                    data[idx+2] = 40 + (rand() % 20);
+                    data[idx] = 160 + (rng.nextBelow(40));
+                    data[idx+1] = 50 + (rng.nextBelow(30));
+                    data[idx+2] = 40 + (rng.nextBelow(20));
                 }
             }
         }
@@ -179,8 +946,8 @@ GLuint TextureManager::generateProceduralTexture(const std::string& type) {
         // Gray concrete with subtle variation
         for (int y = 0; y < height; ++y) {
             for (int x = 0; x < width; ++x) {
-                int idx = (y * width + x) * 3;
-                unsigned char gray = 120 + (rand() % 60);
+                size_t idx = (static_cast<size_t>(y) * width + x) * 3;
+                unsigned char gray = 120 + (rng.nextBelow(60));
                 data[idx] = gray; 
                 data[idx+1] = gray; 
                 data[idx+2] = gray;
@@ -189,10 +956,11 @@ GLuint TextureManager::generateProceduralTexture(const std::string& type) {
     } 
     else if (type == "glass") {
         // Blue glass with window grid pattern
+        const int pane = scaled(32), frame = scaled(2);
         for (int y = 0; y < height; ++y) {
             for (int x = 0; x < width; ++x) {
-                int idx = (y * width + x) * 3;
-                bool isFrame = (y % 32 < 2) || (x % 32 < 2);
+                size_t idx = (static_cast<size_t>(y) * width + x) * 3;
+                bool isFrame = (y % pane < frame) || (x % pane < frame);
                 if (isFrame) {
                     // Dark frame
                     data[idx] = 60; 
@@ -200,21 +968,22 @@ GLuint TextureManager::generateProceduralTexture(const std::string& type) {
                     data[idx+2] = 80;
                 } else {
                     // Blue tinted glass
-                    data[idx] = 100 + (rand() % 30);
-                    data[idx+1] = 150 + (rand() % 30);
-                    data[idx+2] = 200 + (rand() % 30);
+                    data[idx] = 100 + (rng.nextBelow(30));
+                    data[idx+1] = 150 + (rng.nextBelow(30));
+                    data[idx+2] = 200 + (rng.nextBelow(30));
                 }
             }
         }
     } 
     else if (type == "asphalt") {
         // Dark gray asphalt with road markings
+        const int lineHalfWidth = scaled(2), dash = scaled(16);
         for (int y = 0; y < height; ++y) {
             for (int x = 0; x < width; ++x) {
-                int idx = (y * width + x) * 3;
+                size_t idx = (static_cast<size_t>(y) * width + x) * 3;
                 // Yellow dashed center line
-                bool isRoadLine = (y > height / 2 - 2 && y < height / 2 + 2) && 
-                                  ((x / 16) % 4 == 0);
+                bool isRoadLine = (y > height / 2 - lineHalfWidth && y < height / 2 + lineHalfWidth) && 
+                                  ((x / dash) % 4 == 0);
                 if (isRoadLine) {
                     // Yellow road marking
                     data[idx] = 220; 
@@ -222,7 +991,7 @@ GLuint TextureManager::generateProceduralTexture(const std::string& type) {
                     data[idx+2] = 50;
                 } else {
                     // Dark gray asphalt with variation
-                    unsigned char gray = 40 + (rand() % 30);
+                    unsigned char gray = 40 + (rng.nextBelow(30));
                     data[idx] = gray;
                     data[idx+1] = gray;
                     data[idx+2] = gray + 5; // Slightly bluish tint
@@ -234,10 +1003,10 @@ GLuint TextureManager::generateProceduralTexture(const std::string& type) {
         // Green grass with variation
         for (int y = 0; y < height; ++y) {
             for (int x = 0; x < width; ++x) {
-                int idx = (y * width + x) * 3;
-                data[idx] = 40 + (rand() % 50);      // Red channel
-                data[idx+1] = 120 + (rand() % 60);   // Green channel (dominant)
-                data[idx+2] = 40 + (rand() % 40);    // Blue channel
+                size_t idx = (static_cast<size_t>(y) * width + x) * 3;
+                data[idx] = 40 + (rng.nextBelow(50));      // Red channel
+                data[idx+1] = 120 + (rng.nextBelow(60));   // Green channel (dominant)
+                data[idx+2] = 40 + (rng.nextBelow(40));    // Blue channel
             }
         }
     }
@@ -245,25 +1014,13 @@ GLuint TextureManager::generateProceduralTexture(const std::string& type) {
         // Cyan/blue water with wave pattern
         for (int y = 0; y < height; ++y) {
             for (int x = 0; x < width; ++x) {
-                int idx = (y * width + x) * 3;
-                data[idx] = 70 + (rand() % 50);      // Red channel
-                data[idx+1] = 150 + (rand() % 60);   // Green channel
-                data[idx+2] = 200 + (rand() % 55);   // Blue channel (dominant)
+                size_t idx = (static_cast<size_t>(y) * width + x) * 3;
+                data[idx] = 70 + (rng.nextBelow(50));      // Red channel
+                data[idx+1] = 150 + (rng.nextBelow(60));   // Green channel
+                data[idx+2] = 200 + (rng.nextBelow(55));   // Blue channel (dominant)
             }
         }
     }
     
-    // Create OpenGL texture
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data.data());
-    
-    // Set texture parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    
-    return textureID;
+    return data;
 }
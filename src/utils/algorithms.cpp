@@ -1,25 +1,47 @@
 #include "utils/algorithms.h"
+#include <algorithm>
 
 // Bresenham's Line Algorithm Implementation
 // This algorithm calculates which pixels to draw for a straight line
 // between two points using only integer arithmetic for efficiency
 std::vector<Point> bresenhamLine(int x0, int y0, int x1, int y1) {
-    std::vector<Point> points;
-    
+    std::vector<Point> points(bresenhamLineLength(x0, y0, x1, y1));
+    bresenhamLine(x0, y0, x1, y1, points.data());
+    return points;
+}
+
+size_t bresenhamLineLength(int x0, int y0, int x1, int y1) {
+    return static_cast<size_t>(std::max(abs(x1 - x0), abs(y1 - y0))) + 1;
+}
+
+size_t bresenhamLine(int x0, int y0, int x1, int y1, Point* out) {
     int dx = abs(x1 - x0);
     int dy = abs(y1 - y0);
     
     int sx = (x0 < x1) ? 1 : -1;  // Step direction in x
     int sy = (y0 < y1) ? 1 : -1;  // Step direction in y
     
+    // Straight and diagonal runs step each axis by a constant every pixel
+    if (dx == 0 || dy == 0 || dx == dy) {
+        int count = std::max(dx, dy) + 1;
+        int stepX = dx == 0 ? 0 : sx;
+        int stepY = dy == 0 ? 0 : sy;
+        for (int i = 0; i < count; i++) {
+            out[i].x = x0 + i * stepX;
+            out[i].y = y0 + i * stepY;
+        }
+        return static_cast<size_t>(count);
+    }
+    
     int err = dx - dy;  // Error term
     
     int x = x0;
     int y = y0;
+    size_t count = 0;
     
     while (true) {
         // Add current point to the line
-        points.push_back(Point(x, y));
+        out[count++] = Point(x, y);
         
         // Check if we've reached the end point
         if (x == x1 && y == y1) {
@@ -42,14 +64,62 @@ std::vector<Point> bresenhamLine(int x0, int y0, int x1, int y1) {
         }
     }
     
-    return points;
+    return count;
+}
+
+size_t bresenhamPolylineLength(const Point* path, size_t count) {
+    if (count == 0) return 0;
+    size_t total = 1;
+    for (size_t i = 0; i + 1 < count; i++) {
+        // Segments share their joint pixel
+        total += bresenhamLineLength(path[i].x, path[i].y, path[i + 1].x, path[i + 1].y) - 1;
+    }
+    return total;
+}
+
+size_t bresenhamPolyline(const Point* path, size_t count, Point* out) {
+    if (count == 0) return 0;
+    out[0] = path[0];
+    size_t written = 1;
+    for (size_t i = 0; i + 1 < count; i++) {
+        // Each segment starts on the previous one's last pixel, overwriting it with itself
+        written += bresenhamLine(path[i].x, path[i].y, path[i + 1].x, path[i + 1].y, out + written - 1) - 1;
+    }
+    return written;
 }
 
 // Midpoint Circle Algorithm Implementation
 // This algorithm uses 8-way symmetry to efficiently draw circles
 // by calculating points in one octant and mirroring them
 std::vector<Point> midpointCircle(int centerX, int centerY, int radius) {
-    std::vector<Point> points;
+    std::vector<Point> points(midpointCircleLength(radius));
+    midpointCircle(centerX, centerY, radius, points.data());
+    return points;
+}
+
+size_t midpointCircleLength(int radius) {
+    int x = 0;
+    int y = radius;
+    int d = 1 - radius;
+    size_t steps = 1;
+    
+    // Same decision loop as midpointCircle(), counting instead of storing
+    while (x < y) {
+        x++;
+        if (d < 0) {
+            d += 2 * x + 1;
+        } else {
+            y--;
+            d += 2 * (x - y) + 1;
+        }
+        steps++;
+    }
+    
+    return steps * 8;
+}
+
+size_t midpointCircle(int centerX, int centerY, int radius, Point* out) {
+    size_t count = 0;
     
     int x = 0;
     int y = radius;
@@ -57,14 +127,16 @@ std::vector<Point> midpointCircle(int centerX, int centerY, int radius) {
     
     // Function to add all 8 symmetric points
     auto addSymmetricPoints = [&](int x, int y) {
-        points.push_back(Point(centerX + x, centerY + y));  // Octant 1
-        points.push_back(Point(centerX - x, centerY + y));  // Octant 2
-        points.push_back(Point(centerX + x, centerY - y));  // Octant 3
-        points.push_back(Point(centerX - x, centerY - y));  // Octant 4
-        points.push_back(Point(centerX + y, centerY + x));  // Octant 5
-        points.push_back(Point(centerX - y, centerY + x));  // Octant 6
-        points.push_back(Point(centerX + y, centerY - x));  // Octant 7
-        points.push_back(Point(centerX - y, centerY - x));  // Octant 8
+        Point* p = out + count;
+        p[0] = Point(centerX + x, centerY + y);  // Octant 1
+        p[1] = Point(centerX - x, centerY + y);  // Octant 2
+        p[2] = Point(centerX + x, centerY - y);  // Octant 3
+        p[3] = Point(centerX - x, centerY - y);  // Octant 4
+        p[4] = Point(centerX + y, centerY + x);  // Octant 5
+        p[5] = Point(centerX - y, centerY + x);  // Octant 6
+        p[6] = Point(centerX + y, centerY - x);  // Octant 7
+        p[7] = Point(centerX - y, centerY - x);  // Octant 8
+        count += 8;
     };
     
     // Initial points
@@ -86,5 +158,161 @@ std::vector<Point> midpointCircle(int centerX, int centerY, int radius) {
         addSymmetricPoints(x, y);
     }
     
-    return points;
+    return count;
+}
+
+// Split a pixel chain wherever consecutive pixels are not neighbours
+std::vector<std::vector<Point>> splitPixelRuns(const std::vector<Point>& pixels) {
+    std::vector<std::vector<Point>> runs;
+    
+    for (size_t i = 0; i < pixels.size(); i++) {
+        bool connected = i > 0 &&
+                         abs(pixels[i].x - pixels[i - 1].x) <= 1 &&
+                         abs(pixels[i].y - pixels[i - 1].y) <= 1;
+        if (!connected) {
+            runs.emplace_back();
+        }
+        runs.back().push_back(pixels[i]);
+    }
+    
+    return runs;
+}
+
+// Greedy chord simplification: grow each segment until a skipped pixel
+// would deviate more than the tolerance from it
+std::vector<Point> simplifyPolyline(const std::vector<Point>& pixels, float tolerance) {
+    if (pixels.size() <= 2) return pixels;
+    
+    std::vector<Point> polyline;
+    polyline.push_back(pixels.front());
+    
+    size_t anchor = 0;
+    size_t end = 1;
+    while (end < pixels.size()) {
+        size_t candidate = end + 1;
+        if (candidate >= pixels.size()) break;
+        
+        // Check every pixel between anchor and candidate against the chord
+        float ax = pixels[anchor].x, ay = pixels[anchor].y;
+        float dx = pixels[candidate].x - ax;
+        float dy = pixels[candidate].y - ay;
+        float length = std::sqrt(dx * dx + dy * dy);
+        
+        bool fits = length > 0.0f;
+        for (size_t k = anchor + 1; fits && k < candidate; k++) {
+            float distance = std::fabs((pixels[k].x - ax) * dy - (pixels[k].y - ay) * dx) / length;
+            if (distance > tolerance) fits = false;
+        }
+        
+        if (fits) {
+            end = candidate;
+        } else {
+            polyline.push_back(pixels[end]);
+            anchor = end;
+            end = anchor + 1;
+        }
+    }
+    
+    polyline.push_back(pixels.back());
+    return polyline;
+}
+
+// Liang-Barsky segment vs axis-aligned rectangle test
+bool segmentIntersectsRect(float x0, float y0, float x1, float y1,
+                           float left, float top, float right, float bottom) {
+    float dx = x1 - x0;
+    float dy = y1 - y0;
+    float p[4] = {-dx, dx, -dy, dy};
+    float q[4] = {x0 - left, right - x0, y0 - top, bottom - y0};
+    
+    float tEnter = 0.0f;
+    float tExit = 1.0f;
+    for (int i = 0; i < 4; i++) {
+        if (p[i] == 0.0f) {
+            if (q[i] < 0.0f) return false;  // Parallel and outside this edge
+        } else {
+            float t = q[i] / p[i];
+            if (p[i] < 0.0f) {
+                tEnter = std::max(tEnter, t);
+            } else {
+                tExit = std::min(tExit, t);
+            }
+        }
+    }
+    
+    return tEnter <= tExit;
+}
+
+// Circle vs rectangle: closest point of the (buffered) rectangle to the center
+bool Circle::intersectsRect(float left, float top, float right, float bottom, float buffer) const {
+    float closestX = std::max(left - buffer, std::min(x, right + buffer));
+    float closestY = std::max(top - buffer, std::min(y, bottom + buffer));
+    
+    float dx = closestX - x;
+    float dy = closestY - y;
+    float radiusWithBuffer = radius + buffer;
+    return dx * dx + dy * dy < radiusWithBuffer * radiusWithBuffer;
+}
+
+bool Circle::clipSegment(float x0, float y0, float x1, float y1, float& sEnter, float& sExit) const {
+    if (!isValid()) return false;
+    
+    float dx = x1 - x0;
+    float dy = y1 - y0;
+    float fx = x0 - x;
+    float fy = y0 - y;
+    
+    float a = dx * dx + dy * dy;
+    float c = fx * fx + fy * fy - radius * radius;
+    if (a <= 0.0f) {
+        // Degenerate segment: inside iff its single point is
+        sEnter = 0.0f;
+        sExit = 1.0f;
+        return c <= 0.0f;
+    }
+    
+    float b = 2.0f * (fx * dx + fy * dy);
+    float discriminant = b * b - 4.0f * a * c;
+    if (discriminant < 0.0f) return false;
+    
+    float root = std::sqrt(discriminant);
+    sEnter = std::max(0.0f, (-b - root) / (2.0f * a));
+    sExit = std::min(1.0f, (-b + root) / (2.0f * a));
+    return sEnter <= sExit;
+}
+
+std::vector<Point> Circle::rasterize() const {
+    if (!isValid()) return {};
+    return midpointCircle(static_cast<int>(std::lround(x)), static_cast<int>(std::lround(y)),
+                          static_cast<int>(std::lround(radius)));
+}
+
+size_t Circle::rasterizedLength() const {
+    return isValid() ? midpointCircleLength(static_cast<int>(std::lround(radius))) : 0;
+}
+
+size_t Circle::rasterize(Point* out) const {
+    if (!isValid()) return 0;
+    return midpointCircle(static_cast<int>(std::lround(x)), static_cast<int>(std::lround(y)),
+                          static_cast<int>(std::lround(radius)), out);
+}
+
+Circle Circle::fromPoints(const std::vector<Point>& points) {
+    Circle circle;
+    if (points.empty()) return circle;
+    
+    for (const auto& point : points) {
+        circle.x += point.x;
+        circle.y += point.y;
+    }
+    circle.x /= points.size();
+    circle.y /= points.size();
+    
+    for (const auto& point : points) {
+        float dx = point.x - circle.x;
+        float dy = point.y - circle.y;
+        circle.radius = std::max(circle.radius, std::sqrt(dx * dx + dy * dy));
+    }
+    
+    return circle;
 }
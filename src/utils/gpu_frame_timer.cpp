@@ -0,0 +1,54 @@
+/**
+ * @file gpu_frame_timer.cpp
+ * @brief Implementation of the GPU frame timer
+ * 
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#include "utils/gpu_frame_timer.h"
+
+GpuFrameTimer::GpuFrameTimer() : queries{}, pending{}, next(0), timing(false), lastMs(-1.0f) {}
+
+GpuFrameTimer::~GpuFrameTimer() {
+    if (queries[0][0] != 0) {
+        glDeleteQueries(2 * FRAMES_IN_FLIGHT, &queries[0][0]);
+    }
+}
+
+void GpuFrameTimer::begin() {
+    if (queries[0][0] == 0) {
+        glGenQueries(2 * FRAMES_IN_FLIGHT, &queries[0][0]);
+    }
+    
+    // Oldest first, so the newest finished frame is reported
+    for (int i = 0; i < FRAMES_IN_FLIGHT; i++) {
+        int slot = (next + i) % FRAMES_IN_FLIGHT;
+        if (pending[slot]) retire(slot);
+    }
+    
+    timing = !pending[next];
+    if (timing) glQueryCounter(queries[next][0], GL_TIMESTAMP);
+}
+
+void GpuFrameTimer::end() {
+    if (!timing) return;
+    glQueryCounter(queries[next][1], GL_TIMESTAMP);
+    pending[next] = true;
+    next = (next + 1) % FRAMES_IN_FLIGHT;
+    timing = false;
+}
+
+bool GpuFrameTimer::retire(int slot) {
+    GLuint available = 0;
+    glGetQueryObjectuiv(queries[slot][1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return false;
+    
+    GLuint64 start = 0;
+    GLuint64 finish = 0;
+    glGetQueryObjectui64v(queries[slot][0], GL_QUERY_RESULT, &start);
+    glGetQueryObjectui64v(queries[slot][1], GL_QUERY_RESULT, &finish);
+    pending[slot] = false;
+    lastMs = finish > start ? static_cast<float>((finish - start) / 1.0e6) : 0.0f;
+    return true;
+}
@@ -1,13 +1,15 @@
 #include "utils/input_handler.h"
 #include "generation/city_generator.h"
 #include "features/save_load/city_serializer.h"
+#include "utils/profiler.h"
 #include <iostream>
 #include <cstring>
 
 InputHandler::InputHandler(CityConfig& cfg) 
-    : config(cfg), cityGen(nullptr), genRequested(false), 
+    : config(cfg), cityGen(nullptr), profiler(nullptr), genRequested(false), 
       mouseButtonPressed(false), lastMouseX(0), lastMouseY(0), 
-      buildingPlacementRequested(false), loadRequested(false) {
+      buildingPlacementRequested(false), loadRequested(false),
+      streamRequested(false), recordRequested(false), replayRequested(false), replaySeekSeconds(0.0f) {
     // Initialize key states
     std::memset(keysPressed, 0, sizeof(keysPressed));
 }
@@ -162,30 +164,103 @@ void InputHandler::processInput(GLFWwindow* window) {
         std::cout << "View Mode: " << (config.view3D ? "3D" : "2D") << "\n";
     }
     
+    // O - Toggle occlusion culling (compare render times in the F3 overlay)
+    if (isKeyJustPressed(window, GLFW_KEY_O)) {
+        config.occlusionCulling = !config.occlusionCulling;
+        std::cout << "Occlusion Culling: " << (config.occlusionCulling ? "ON" : "OFF") << "\n";
+    }
+    
+    // Q - Toggle adaptive quality (the main loop runs the governor)
+    if (isKeyJustPressed(window, GLFW_KEY_Q)) {
+        config.adaptiveQuality = !config.adaptiveQuality;
+        std::cout << "Adaptive Quality: " << (config.adaptiveQuality ? "ON" : "OFF")
+                  << " (budget " << config.frameBudgetMs << " ms)\n";
+    }
+    
     // G - Generate new city with current settings
     if (isKeyJustPressed(window, GLFW_KEY_G)) {
+        // Show keyboard controls BEFORE generation
+        displayControls();
+        // The first city uses the configured seed; every later press rolls a new one
+        if (cityGen && cityGen->hasCity()) config.seed = RandomStream::randomSeed();
+        // The main loop generates it in the background
         genRequested = true;
-        if (cityGen) {
-            // Show keyboard controls BEFORE generation
-            displayControls();
-            // Now generate the city
-            cityGen->generateCity(config);
-        }
     }
     
-    // Z - Save current city
+    // Z - Save current city (binary)
     if (isKeyJustPressed(window, GLFW_KEY_Z)) {
         if (cityGen && cityGen->hasCity()) {
-            CitySerializer::saveCity(cityGen->getCityData(), "city_save");
+            CitySerializer::saveCityBinary(cityGen->getCityData(), "city_save");
         } else {
             std::cout << "⚠️  No city to save! Generate a city first (press G).\n";
         }
     }
     
+    // J - Export current city as JSON
+    if (isKeyJustPressed(window, GLFW_KEY_J)) {
+        if (cityGen && cityGen->hasCity()) {
+            CitySerializer::saveCity(cityGen->getCityData(), "city_save");
+        } else {
+            std::cout << "⚠️  No city to export! Generate a city first (press G).\n";
+        }
+    }
+    
     // X - Load saved city
     if (isKeyJustPressed(window, GLFW_KEY_X)) {
         loadRequested = true;
     }
+    
+    // K - Save current city as tiles for streaming
+    if (isKeyJustPressed(window, GLFW_KEY_K)) {
+        if (cityGen && cityGen->hasCity()) {
+            CitySerializer::saveCityTiled(cityGen->getCityData(), "city_save");
+        } else {
+            std::cout << "⚠️  No city to save! Generate a city first (press G).\n";
+        }
+    }
+    
+    // Y - Start/stop streaming the tiled save around the camera (the main loop owns the streamer)
+    if (isKeyJustPressed(window, GLFW_KEY_Y)) {
+        streamRequested = true;
+    }
+    
+    // === PROFILING ===
+    // F3 - Toggle frame profiler overlay
+    if (isKeyJustPressed(window, GLFW_KEY_F3) && profiler) {
+        profiler->setOverlayEnabled(!profiler->isOverlayEnabled());
+    }
+    
+    // F4 - Start/stop Chrome trace capture
+    if (isKeyJustPressed(window, GLFW_KEY_F4) && profiler) {
+        if (profiler->isTracing()) {
+            profiler->stopTrace(TRACE_FILE);
+        } else {
+            profiler->startTrace();
+        }
+    }
+    
+    // === TRAFFIC RECORDING ===
+    // F5 - Start/stop recording, F6 - Start/stop replay (the main loop owns both)
+    if (isKeyJustPressed(window, GLFW_KEY_F5)) {
+        recordRequested = true;
+    }
+    if (isKeyJustPressed(window, GLFW_KEY_F6)) {
+        replayRequested = true;
+    }
+    
+    // F7/F8 - Seek the replay back/forward
+    if (isKeyJustPressed(window, GLFW_KEY_F7)) {
+        replaySeekSeconds -= REPLAY_SEEK_SECONDS;
+    }
+    if (isKeyJustPressed(window, GLFW_KEY_F8)) {
+        replaySeekSeconds += REPLAY_SEEK_SECONDS;
+    }
+    
+    // F9 - Switch the traffic backend (the main loop respawns the cars)
+    if (isKeyJustPressed(window, GLFW_KEY_F9)) {
+        config.gpuTraffic = !config.gpuTraffic;
+        std::cout << "Traffic Backend: " << (config.gpuTraffic ? "GPU" : "CPU") << "\n";
+    }
 }
 
 void InputHandler::displayControls() {
@@ -221,10 +296,21 @@ void InputHandler::displayControls() {
     std::cout << "║                                                           ║\n";
     std::cout << "║  VIEW & GENERATION:                                       ║\n";
     std::cout << "║    V    : Toggle 2D/3D view mode                          ║\n";
+    std::cout << "║    O    : Toggle occlusion culling (3D)                   ║\n";
+    std::cout << "║    Q    : Toggle adaptive quality (frame-time budget)     ║\n";
     std::cout << "║    G    : Generate new city with current settings         ║\n";
     std::cout << "║    Z    : Save current city to file                       ║\n";
+    std::cout << "║    J    : Export current city as JSON                     ║\n";
     std::cout << "║    X    : Load saved city from file                       ║\n";
+    std::cout << "║    K    : Save current city as streamable tiles           ║\n";
+    std::cout << "║    Y    : Start/stop streaming tiles around the camera    ║\n";
     std::cout << "║    P    : Print current configuration                     ║\n";
+    std::cout << "║    F3   : Toggle frame profiler overlay                   ║\n";
+    std::cout << "║    F4   : Start/stop trace capture (profile_trace.json)   ║\n";
+    std::cout << "║    F5   : Start/stop traffic recording                    ║\n";
+    std::cout << "║    F6   : Start/stop traffic replay                       ║\n";
+    std::cout << "║    F7/F8: Seek replay back/forward 10 seconds             ║\n";
+    std::cout << "║    F9   : Switch traffic backend (CPU/GPU)                ║\n";
     std::cout << "║    H    : Display this help menu                          ║\n";
     std::cout << "║    ESC  : Exit application                                ║\n";
     std::cout << "║                                                           ║\n";
@@ -0,0 +1,99 @@
+#include "utils/job_system.h"
+#include <algorithm>
+
+JobSystem::JobSystem(unsigned workerCount)
+    : job(nullptr), itemCount(0), chunkSize(0), chunkCount(0),
+      nextChunk(0), chunksDone(0), activeWorkers(0), stopping(false) {
+    workers.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; i++) {
+        workers.emplace_back(&JobSystem::workerLoop, this);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+unsigned JobSystem::defaultWorkerCount() {
+    unsigned hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+void JobSystem::parallelFor(size_t count, size_t minChunkSize,
+                            const std::function<void(size_t, size_t)>& work) {
+    if (count == 0) return;
+    
+    minChunkSize = std::max<size_t>(minChunkSize, 1);
+    if (workers.empty() || count <= minChunkSize) {
+        work(0, count);
+        return;
+    }
+    
+    // The simulation and render threads share the pool, one job at a time
+    std::lock_guard<std::mutex> submitLock(submitMutex);
+    
+    // A few chunks per thread keeps the load balanced when chunks differ in cost
+    size_t threads = workers.size() + 1;
+    size_t size = std::max(minChunkSize, (count + threads * 4 - 1) / (threads * 4));
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &work;
+        itemCount = count;
+        chunkSize = size;
+        chunkCount = (count + size - 1) / size;
+        nextChunk = 0;
+        chunksDone = 0;
+    }
+    workAvailable.notify_all();
+    
+    runChunks();
+    
+    // Wait for the last chunk and for every worker to detach before the job goes away
+    std::unique_lock<std::mutex> lock(mutex);
+    workFinished.wait(lock, [this] { return chunksDone == chunkCount && activeWorkers == 0; });
+    job = nullptr;
+}
+
+void JobSystem::runChunks() {
+    for (;;) {
+        size_t chunk = nextChunk.fetch_add(1);
+        if (chunk >= chunkCount) return;
+        
+        size_t begin = chunk * chunkSize;
+        size_t end = std::min(begin + chunkSize, itemCount);
+        (*job)(begin, end);
+        
+        if (chunksDone.fetch_add(1) + 1 == chunkCount) {
+            std::lock_guard<std::mutex> lock(mutex);
+            workFinished.notify_one();
+        }
+    }
+}
+
+void JobSystem::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        workAvailable.wait(lock, [this] {
+            return stopping || (job != nullptr && nextChunk < chunkCount);
+        });
+        if (stopping) return;
+        
+        activeWorkers++;
+        lock.unlock();
+        runChunks();
+        lock.lock();
+        activeWorkers--;
+        
+        if (activeWorkers == 0 && chunksDone == chunkCount) {
+            workFinished.notify_one();
+        }
+    }
+}
@@ -0,0 +1,259 @@
+/**
+ * @file json_reader.cpp
+ * @brief Implementation of the streaming JSON pull parser
+ *
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#include "utils/json_reader.h"
+#include <charconv>
+#include <cstdlib>
+
+JsonReader::JsonReader(std::istream& input, size_t chunkSize)
+    : input(input), buffer(chunkSize > 0 ? chunkSize : 1), position(0), length(0),
+      consumed(0), firstInContainer(false) {}
+
+bool JsonReader::refill() {
+    if (!input) return false;
+    consumed += length;
+    input.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    length = static_cast<size_t>(input.gcount());
+    position = 0;
+    return length > 0;
+}
+
+bool JsonReader::fail(const char* message) {
+    if (error.empty()) {
+        error = std::string(message) + " at byte " + std::to_string(consumed + position);
+    }
+    return false;
+}
+
+int JsonReader::peekToken() {
+    while (true) {
+        int c = peekChar();
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t') return c;
+        position++;
+    }
+}
+
+bool JsonReader::expect(char c) {
+    if (!ok()) return false;
+    if (peekToken() != c) {
+        std::string message = std::string("Expected '") + c + "'";
+        return fail(message.c_str());
+    }
+    position++;
+    return true;
+}
+
+JsonType JsonReader::peekType() {
+    if (!ok()) return JsonType::END;
+    int c = peekToken();
+    switch (c) {
+        case '{': return JsonType::OBJECT;
+        case '[': return JsonType::ARRAY;
+        case '"': return JsonType::STRING;
+        case 't': case 'f': case 'n': return JsonType::LITERAL;
+        case -1: return JsonType::END;
+        default:
+            if (c == '-' || (c >= '0' && c <= '9')) return JsonType::NUMBER;
+            fail("Unexpected character");
+            return JsonType::END;
+    }
+}
+
+bool JsonReader::beginObject() {
+    if (!expect('{')) return false;
+    firstInContainer = true;
+    return true;
+}
+
+bool JsonReader::beginArray() {
+    if (!expect('[')) return false;
+    firstInContainer = true;
+    return true;
+}
+
+// Shared ',' / close handling for objects and arrays. Nested containers are
+// always fully consumed before the caller advances again, so one flag for
+// "just opened" is enough.
+bool JsonReader::nextInContainer(char close) {
+    if (!ok()) return false;
+    int c = peekToken();
+    if (c == close) {
+        position++;
+        firstInContainer = false;
+        return false;
+    }
+    if (firstInContainer) {
+        firstInContainer = false;
+        return true;
+    }
+    if (c < 0) return fail("Unexpected end of input");
+    if (c != ',') return fail(close == '}' ? "Expected ',' or '}'" : "Expected ',' or ']'");
+    position++;
+    return true;
+}
+
+bool JsonReader::nextMember(std::string& key) {
+    if (!nextInContainer('}')) return false;
+    if (peekToken() != '"') return fail("Expected member name");
+    if (!readStringInto(key)) return false;
+    return expect(':');
+}
+
+bool JsonReader::nextElement() {
+    if (!nextInContainer(']')) return false;
+    if (peekToken() == -1) return fail("Unexpected end of input");
+    return true;
+}
+
+// Collect the characters of a number into token; a number can straddle a
+// chunk boundary, so it is never parsed in place
+bool JsonReader::readNumberToken() {
+    if (!ok()) return false;
+    token.clear();
+    int c = peekToken();
+    while (c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E' || (c >= '0' && c <= '9')) {
+        token.push_back(static_cast<char>(c));
+        position++;
+        c = peekChar();
+    }
+    if (token.empty()) return fail("Expected number");
+    firstInContainer = false;
+    return true;
+}
+
+bool JsonReader::readFloat(float& out) {
+    if (!readNumberToken()) return false;
+    const char* first = token.data();
+    const char* last = first + token.size();
+#if defined(__cpp_lib_to_chars)
+    std::from_chars_result result = std::from_chars(first, last, out);
+    if (result.ec != std::errc() || result.ptr != last) return fail("Malformed number");
+#else
+    // Standard libraries without floating-point from_chars
+    char* end = nullptr;
+    out = std::strtof(first, &end);
+    if (end != last) return fail("Malformed number");
+#endif
+    return true;
+}
+
+bool JsonReader::readInt(int& out) {
+    if (!readNumberToken()) return false;
+    const char* first = token.data();
+    const char* last = first + token.size();
+    std::from_chars_result result = std::from_chars(first, last, out);
+    if (result.ec == std::errc() && result.ptr == last) return true;
+
+    // Not a plain integer ("12.5", "1e3"): parse as a real and truncate
+    char* end = nullptr;
+    double value = std::strtod(first, &end);
+    if (end != last) return fail("Malformed number");
+    out = static_cast<int>(value);
+    return true;
+}
+
+bool JsonReader::readString(std::string& out) {
+    if (!ok()) return false;
+    if (peekToken() != '"') return fail("Expected string");
+    if (!readStringInto(out)) return false;
+    firstInContainer = false;
+    return true;
+}
+
+bool JsonReader::readStringInto(std::string& out) {
+    out.clear();
+    position++;  // Opening quote
+    while (true) {
+        int c = getChar();
+        if (c < 0) return fail("Unterminated string");
+        if (c == '"') return true;
+        if (c != '\\') {
+            out.push_back(static_cast<char>(c));
+            continue;
+        }
+
+        int escape = getChar();
+        switch (escape) {
+            case '"': out.push_back('"'); break;
+            case '\\': out.push_back('\\'); break;
+            case '/': out.push_back('/'); break;
+            case 'b': out.push_back('\b'); break;
+            case 'f': out.push_back('\f'); break;
+            case 'n': out.push_back('\n'); break;
+            case 'r': out.push_back('\r'); break;
+            case 't': out.push_back('\t'); break;
+            case 'u': {
+                unsigned code = 0;
+                for (int i = 0; i < 4; i++) {
+                    int h = getChar();
+                    code <<= 4;
+                    if (h >= '0' && h <= '9') code |= h - '0';
+                    else if (h >= 'a' && h <= 'f') code |= h - 'a' + 10;
+                    else if (h >= 'A' && h <= 'F') code |= h - 'A' + 10;
+                    else return fail("Malformed \\u escape");
+                }
+                // UTF-8 encode (surrogate pairs are passed through as-is)
+                if (code < 0x80) {
+                    out.push_back(static_cast<char>(code));
+                } else if (code < 0x800) {
+                    out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+                    out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                } else {
+                    out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+                    out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                }
+                break;
+            }
+            default:
+                return fail("Invalid escape sequence");
+        }
+    }
+}
+
+bool JsonReader::readLiteral() {
+    token.clear();
+    int c = peekToken();
+    while (c >= 'a' && c <= 'z') {
+        token.push_back(static_cast<char>(c));
+        position++;
+        c = peekChar();
+    }
+    if (token != "true" && token != "false" && token != "null") return fail("Invalid literal");
+    firstInContainer = false;
+    return true;
+}
+
+bool JsonReader::skipValue() {
+    switch (peekType()) {
+        case JsonType::STRING: return readString(token);
+        case JsonType::NUMBER: return readNumberToken();
+        case JsonType::LITERAL: return readLiteral();
+        case JsonType::END: return fail("Unexpected end of input");
+        default: break;
+    }
+
+    // Containers: scan to the matching close without recursing, so deeply
+    // nested unknown values cannot exhaust the stack
+    int depth = 0;
+    do {
+        int c = getChar();
+        if (c < 0) return fail("Unexpected end of input");
+        if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            depth--;
+        } else if (c == '"') {
+            position--;
+            if (!readStringInto(token)) return false;
+        }
+    } while (depth > 0);
+
+    firstInContainer = false;
+    return true;
+}
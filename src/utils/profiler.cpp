@@ -0,0 +1,250 @@
+/**
+ * @file profiler.cpp
+ * @brief Implementation of the frame profiler
+ *
+ * @author City Designer Team
+ * @date November 2025
+ */
+
+#include "utils/profiler.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+
+Profiler::CpuScope::CpuScope(Profiler* owner, const char* name)
+    : profiler(owner && owner->isActive() ? owner : nullptr), scope(-1), start(0) {
+    if (!profiler) return;
+    scope = profiler->findScope(name, false);
+    start = profiler->now();
+}
+
+Profiler::CpuScope::~CpuScope() {
+    if (profiler) profiler->endCpu(scope, start);
+}
+
+Profiler::GpuScope::GpuScope(Profiler* owner, const char* name)
+    : profiler(owner && owner->isActive() ? owner : nullptr), scope(-1), query(-1) {
+    if (!profiler) return;
+    scope = profiler->findScope(name, true);
+    query = profiler->beginGpu(scope);
+}
+
+Profiler::GpuScope::~GpuScope() {
+    if (profiler && query >= 0) profiler->endGpu(scope, query);
+}
+
+Profiler::Profiler(const std::string& threadLabel)
+    : label(threadLabel), overlayEnabled(false), tracing(false), traceFull(false), gpuQueryOpen(false),
+      lastOverlay(0), epoch(0) {
+    epoch = now();
+}
+
+Profiler::~Profiler() {
+    for (Scope& scope : scopes) {
+        for (GLuint query : scope.queries) {
+            if (query != 0) glDeleteQueries(1, &query);
+        }
+    }
+}
+
+int64_t Profiler::now() const {
+    auto sinceStart = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(sinceStart).count() - epoch;
+}
+
+int Profiler::lookupScope(const char* name, bool gpu) const {
+    // Names are literals, so the pointer usually matches; strcmp catches duplicates
+    for (size_t i = 0; i < scopes.size(); i++) {
+        if (scopes[i].gpu == gpu && (scopes[i].name == name || std::strcmp(scopes[i].name, name) == 0)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+int Profiler::findScope(const char* name, bool gpu) {
+    int index = lookupScope(name, gpu);
+    if (index >= 0) return index;
+
+    Scope scope;
+    scope.name = name;
+    scope.gpu = gpu;
+    scope.history.reserve(HISTORY_SAMPLES);
+    scopes.push_back(scope);
+    return static_cast<int>(scopes.size() - 1);
+}
+
+void Profiler::addSample(Scope& scope, double milliseconds) {
+    if (scope.history.size() < HISTORY_SAMPLES) {
+        scope.history.push_back(static_cast<float>(milliseconds));
+    } else {
+        scope.history[scope.historyNext] = static_cast<float>(milliseconds);
+    }
+    scope.historyNext = (scope.historyNext + 1) % HISTORY_SAMPLES;
+}
+
+void Profiler::addTraceEvent(const char* name, bool gpu, int64_t start, int64_t duration) {
+    if (!tracing) return;
+    if (traceEvents.size() >= MAX_TRACE_EVENTS) {
+        if (!traceFull) std::cout << "⚠️  Trace buffer full, later events are dropped\n";
+        traceFull = true;
+        return;
+    }
+    traceEvents.push_back({name, gpu, start, duration});
+}
+
+void Profiler::endCpu(int index, int64_t start) {
+    int64_t end = now();
+    Scope& scope = scopes[index];
+    scope.frameTotal += (end - start) / 1000.0;
+    scope.hitThisFrame = true;
+    addTraceEvent(scope.name, false, start, end - start);
+}
+
+int Profiler::beginGpu(int index) {
+    if (gpuQueryOpen) return -1;   // Timer queries cannot nest
+
+    Scope& scope = scopes[index];
+    int query = scope.nextQuery;
+
+    // Every slot still in flight: the GPU is more than a few frames behind, skip this sample
+    if (scope.pending[query] && !retireQuery(scope, query)) return -1;
+
+    if (scope.queries[query] == 0) glGenQueries(1, &scope.queries[query]);
+    glBeginQuery(GL_TIME_ELAPSED, scope.queries[query]);
+    scope.queryStart[query] = now();
+    gpuQueryOpen = true;
+    return query;
+}
+
+void Profiler::endGpu(int index, int query) {
+    Scope& scope = scopes[index];
+    glEndQuery(GL_TIME_ELAPSED);
+    gpuQueryOpen = false;
+    scope.pending[query] = true;
+    scope.nextQuery = (query + 1) % GPU_QUERIES_PER_SCOPE;
+}
+
+bool Profiler::retireQuery(Scope& scope, int query) {
+    GLuint available = 0;
+    glGetQueryObjectuiv(scope.queries[query], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return false;
+
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(scope.queries[query], GL_QUERY_RESULT, &nanoseconds);
+    scope.pending[query] = false;
+    addSample(scope, nanoseconds / 1.0e6);
+
+    // GPU and CPU clocks are not correlated; the event starts where the CPU issued it
+    addTraceEvent(scope.name, true, scope.queryStart[query], static_cast<int64_t>(nanoseconds / 1000));
+    return true;
+}
+
+void Profiler::endFrame() {
+    for (Scope& scope : scopes) {
+        if (scope.gpu) {
+            // Oldest first, so samples stay in submission order
+            for (int i = 0; i < GPU_QUERIES_PER_SCOPE; i++) {
+                int query = (scope.nextQuery + i) % GPU_QUERIES_PER_SCOPE;
+                if (scope.pending[query]) retireQuery(scope, query);
+            }
+        } else if (scope.hitThisFrame) {
+            addSample(scope, scope.frameTotal);
+            scope.frameTotal = 0.0;
+            scope.hitThisFrame = false;
+        }
+    }
+
+    if (overlayEnabled) {
+        int64_t time = now();
+        if (time - lastOverlay >= static_cast<int64_t>(OVERLAY_INTERVAL * 1.0e6)) {
+            lastOverlay = time;
+            printOverlay();
+        }
+    }
+}
+
+void Profiler::setOverlayEnabled(bool enabled) {
+    overlayEnabled = enabled;
+    lastOverlay = now();
+    std::cout << "Profiler overlay (" << label << "): " << (enabled ? "ON" : "OFF") << "\n";
+}
+
+Profiler::Stats Profiler::getStats(const char* name, bool gpu) const {
+    Stats stats;
+    int index = lookupScope(name, gpu);
+    if (index < 0 || scopes[index].history.empty()) return stats;
+
+    std::vector<float> samples = scopes[index].history;
+    stats.samples = samples.size();
+    double sum = 0.0;
+    for (float sample : samples) {
+        sum += sample;
+        stats.max = std::max(stats.max, static_cast<double>(sample));
+    }
+    stats.mean = sum / samples.size();
+
+    size_t rank = std::min(samples.size() - 1, (samples.size() * 95) / 100);
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    stats.p95 = samples[rank];
+    return stats;
+}
+
+void Profiler::printOverlay() const {
+    // One write, so the reports of profilers on other threads do not interleave with it
+    std::ostringstream report;
+    report << "\n⏱️  Frame profile, " << label << " thread (ms over the last " << HISTORY_SAMPLES << " samples)\n";
+    report << "   " << std::left << std::setw(24) << "scope" << std::setw(6) << "" << std::right
+           << std::setw(9) << "mean" << std::setw(9) << "p95" << std::setw(9) << "max" << "\n";
+
+    report << std::fixed << std::setprecision(3);
+    for (const Scope& scope : scopes) {
+        Stats stats = getStats(scope.name, scope.gpu);
+        if (stats.samples == 0) continue;
+        report << "   " << std::left << std::setw(24) << scope.name << std::setw(6)
+               << (scope.gpu ? "GPU" : "CPU") << std::right
+               << std::setw(9) << stats.mean << std::setw(9) << stats.p95 << std::setw(9) << stats.max << "\n";
+    }
+    std::cout << report.str() << std::flush;
+}
+
+void Profiler::startTrace() {
+    traceEvents.clear();
+    traceFull = false;
+    tracing = true;
+    std::cout << "🔴 Recording trace...\n";
+}
+
+bool Profiler::stopTrace(const std::string& path) {
+    tracing = false;
+
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cout << "❌ Failed to open trace file for writing: " << path << "\n";
+        return false;
+    }
+
+    // Chrome trace event format: complete ("X") events in microseconds, CPU and GPU as two threads
+    file << "{\"traceEvents\":[\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU (" << label << ")\"}},\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+    for (const TraceEvent& event : traceEvents) {
+        file << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"" << (event.gpu ? "gpu" : "cpu")
+             << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << (event.gpu ? 2 : 1)
+             << ",\"ts\":" << event.start << ",\"dur\":" << event.duration << "}";
+    }
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    if (!file.good()) {
+        std::cout << "❌ Failed to write trace file: " << path << "\n";
+        return false;
+    }
+
+    std::cout << "✅ Trace with " << traceEvents.size() << " events written to " << path << "\n";
+    traceEvents.clear();
+    return true;
+}
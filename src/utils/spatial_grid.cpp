@@ -0,0 +1,84 @@
+#include "utils/spatial_grid.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid(float cellSize)
+    : cellSize(cellSize), itemCount(0), nextId(0) {
+}
+
+void SpatialGrid::clear() {
+    cells.clear();
+    itemCount = 0;
+    nextId = 0;
+}
+
+int SpatialGrid::cellCoord(float value) const {
+    return static_cast<int>(std::floor(value / cellSize));
+}
+
+int64_t SpatialGrid::cellKey(int cellX, int cellY) {
+    // Pack both signed 32-bit coordinates into one 64-bit key
+    return (static_cast<int64_t>(cellX) << 32) ^ static_cast<uint32_t>(cellY);
+}
+
+uint32_t SpatialGrid::insert(float minX, float minY, float maxX, float maxY) {
+    uint32_t id = nextId;
+    insert(id, minX, minY, maxX, maxY);
+    return id;
+}
+
+void SpatialGrid::insert(uint32_t id, float minX, float minY, float maxX, float maxY) {
+    itemCount++;
+    nextId = std::max(nextId, id + 1);
+    
+    int x0 = cellCoord(minX), x1 = cellCoord(maxX);
+    int y0 = cellCoord(minY), y1 = cellCoord(maxY);
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            cells[cellKey(cx, cy)].push_back(id);
+        }
+    }
+}
+
+void SpatialGrid::erase(uint32_t id, float minX, float minY, float maxX, float maxY) {
+    bool found = false;
+    int x0 = cellCoord(minX), x1 = cellCoord(maxX);
+    int y0 = cellCoord(minY), y1 = cellCoord(maxY);
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            auto it = cells.find(cellKey(cx, cy));
+            if (it == cells.end()) continue;
+            
+            // Order within a cell does not matter: swap the id out
+            std::vector<uint32_t>& ids = it->second;
+            auto pos = std::find(ids.begin(), ids.end(), id);
+            if (pos == ids.end()) continue;
+            *pos = ids.back();
+            ids.pop_back();
+            if (ids.empty()) cells.erase(it);
+            found = true;
+        }
+    }
+    if (found) itemCount--;
+}
+
+void SpatialGrid::query(float minX, float minY, float maxX, float maxY, std::vector<uint32_t>& out) const {
+    out.clear();
+    if (itemCount == 0) return;
+    
+    int x0 = cellCoord(minX), x1 = cellCoord(maxX);
+    int y0 = cellCoord(minY), y1 = cellCoord(maxY);
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            auto it = cells.find(cellKey(cx, cy));
+            if (it == cells.end()) continue;
+            out.insert(out.end(), it->second.begin(), it->second.end());
+        }
+    }
+    
+    // An item spanning several of the visited cells was collected once per cell
+    if (x0 != x1 || y0 != y1) {
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+}